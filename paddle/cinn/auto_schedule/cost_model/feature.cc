@@ -29,6 +29,7 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "paddle/cinn/common/target.h"
@@ -36,6 +37,13 @@
 namespace cinn {
 namespace auto_schedule {
 
+// The cache sizes of common x86 server cores, the footprints are compared
+// with them to tell which level of cache a loop runs in
+static constexpr int64_t kL1DataCacheBytes = 32 * 1024;
+static constexpr int64_t kL2CacheBytes = 1024 * 1024;
+// The float32 lanes of a 512 bits vector register
+static constexpr int kVectorLanes = 16;
+
 Feature::Feature()
     : target_(common::UnkTarget()),
       stack_encoded_feature_(1),  // initialize a LoopBlockFeature as root block
@@ -58,16 +66,49 @@ std::vector<float> Feature::ToFixedSizeVector() {
 
   // loop[i] feature count should multiply iter_multi_num[i]
   std::vector<int> iter_multi_num;
+  // the vectorize factor of loop[i] or of its vectorized outer loop
+  std::vector<int> vectorize_factors;
+  float arith_ops = 0, vector_arith_ops = 0, mem_bytes = 0;
+  int64_t l1_footprint = 0, l2_footprint = 0;
   for (size_t i = 0; i < stack_encoded_feature_.size(); ++i) {
     int j = 1;
     const LoopBlockFeature& loop_feature = stack_encoded_feature_[i];
     int loop_prod = 1;
     int parent_prod = 1;
+    int vectorize_factor = 0;
     if (i != 0) {
       parent_prod = iter_multi_num[parent_indices_[i]];
       loop_prod = parent_prod * loop_feature.loop_length;
+      vectorize_factor = vectorize_factors[parent_indices_[i]];
+    }
+    if (loop_feature.loop_opt_type == ForOptimizeFeatureEnum::kVectorize) {
+      vectorize_factor = loop_feature.vectorize_factor;
     }
     iter_multi_num.push_back(loop_prod);
+    vectorize_factors.push_back(vectorize_factor);
+
+    int block_ops = loop_feature.float_add_or_sub + loop_feature.float_mul +
+                    loop_feature.float_div_or_mod + loop_feature.float_cmp +
+                    loop_feature.float_math_func + loop_feature.int_add_or_sub +
+                    loop_feature.int_mul + loop_feature.int_div_or_mod +
+                    loop_feature.int_cmp + loop_feature.int_math_func +
+                    loop_feature.bool_op + loop_feature.select_op;
+    float block_arith_ops = static_cast<float>(block_ops) * loop_prod;
+    arith_ops += block_arith_ops;
+    vector_arith_ops += block_arith_ops *
+                        std::min(vectorize_factor, kVectorLanes) /
+                        kVectorLanes;
+    mem_bytes += static_cast<float>(loop_feature.mem_bytes) * loop_prod;
+    int64_t footprint = 0;
+    for (auto& buffer_bytes : loop_feature.buffer_touched_bytes) {
+      footprint += buffer_bytes.second;
+    }
+    if (footprint <= kL1DataCacheBytes) {
+      l1_footprint = std::max(l1_footprint, footprint);
+    }
+    if (footprint <= kL2CacheBytes) {
+      l2_footprint = std::max(l2_footprint, footprint);
+    }
 
     ret[j] += (loop_feature.float_add_or_sub * loop_prod);
     ++j;
@@ -152,6 +193,16 @@ std::vector<float> Feature::ToFixedSizeVector() {
     ++j;
   }
 
+  if (target_.arch == common::Target::Arch::X86) {
+    int j =
+        LoopBlockFeature::kTotalSize + 1 - LoopBlockFeature::kCpuFeatureSize;
+    ret[j++] = l1_footprint;
+    ret[j++] = l2_footprint;
+    ret[j++] = mem_bytes;
+    // the fraction is scaled up as slog is applied on every feature
+    ret[j++] = arith_ops > 0 ? vector_arith_ops / arith_ops * 100 : 0;
+  }
+
   for (size_t i = 0; i < ret.size(); ++i) {
     ret[i] = slog(ret[i]);
   }
@@ -178,5 +229,9 @@ const LoopBlockFeature& Feature::CurrentLoopBlock() const {
   return stack_encoded_feature_[current_loop_block_index_];
 }
 
+LoopBlockFeature& Feature::LoopBlockAt(int index) {
+  return stack_encoded_feature_[index];
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <cmath>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "paddle/cinn/common/target.h"
@@ -114,9 +116,18 @@ class LoopBlockFeature {
 
   static constexpr int kThreadFeatureSize = 8;
 
+  /* CPU features, which are computed over all loop blocks and only on x86.
+   *
+   * 1. The largest cache footprint of a loop block fitting in L1 data cache
+   * 2. The largest cache footprint of a loop block fitting in L2 cache
+   * 3. The total bytes read and written
+   * 4. The fraction of arithmetic operations running on full vector registers
+   */
+  static constexpr int kCpuFeatureSize = 4;
+
   static constexpr int kTotalSize = kArithSize + kMemSize +
                                     kReduceBroadcastSize + kOptApplySize +
-                                    kThreadFeatureSize;
+                                    kThreadFeatureSize + kCpuFeatureSize;
 
   /* Non-feature attributes, used to maintain during feature_extractor */
 
@@ -125,6 +136,13 @@ class LoopBlockFeature {
 
   // Number of repeats of this loop, -1 represents unknown
   int loop_length = 1;
+
+  // Bytes read and written by the memory operations in this loop block
+  int mem_bytes = 0;
+
+  // Bytes of each buffer touched by one execution of this loop, the sum is
+  // the cache footprint of the loop
+  std::unordered_map<std::string, int64_t> buffer_touched_bytes;
 };
 
 /**
@@ -147,6 +165,10 @@ class Feature {
   LoopBlockFeature& CurrentLoopBlock();
   // The current loop block which we should collect feature on
   const LoopBlockFeature& CurrentLoopBlock() const;
+  // The index of the current loop block, used to find it by LoopBlockAt
+  int CurrentLoopBlockIndex() const { return current_loop_block_index_; }
+  // The loop block at the index returned by CurrentLoopBlockIndex
+  LoopBlockFeature& LoopBlockAt(int index);
 
  private:
   // We treat a computation feature to be encoded as variable-length vector.
@@ -27,6 +27,8 @@
 
 #include "paddle/cinn/auto_schedule/cost_model/feature_extractor.h"
 
+#include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 #include "paddle/cinn/common/target.h"
@@ -36,6 +38,7 @@
 #include "paddle/cinn/ir/ir_printer.h"
 #include "paddle/cinn/ir/schedule/ir_schedule.h"
 #include "paddle/cinn/ir/utils/ir_copy.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
 #include "paddle/cinn/optim/transform_polyfor_to_for.h"
 
 namespace cinn {
@@ -52,6 +55,8 @@ void FeatureExtractor::Visit(const Expr *x) {
 Feature FeatureExtractor::Extract(const ir::ModuleExpr &mod_expr,
                                   const common::Target &target) {
   feature_ = Feature(target);
+  loop_stack_.clear();
+  iter_var_to_loops_.clear();
   for (const ir::Expr &e : mod_expr.GetExprs()) {
     Visit(&e);
   }
@@ -78,7 +83,6 @@ VisitDoNothing(_Module_);
 VisitDoNothing(_Var_);
 VisitDoNothing(_LoweredFunc_);
 VisitDoNothing(ScheduleBlock);
-VisitDoNothing(ScheduleBlockRealize);
 VisitDoNothing(Ramp);
 VisitDoNothing(_Buffer_);
 VisitDoNothing(_BufferRange_);
@@ -162,8 +166,89 @@ VisitCountMemberPattern(IfThenElse, select_op);
 VisitCountMemberPattern(Select, select_op);
 VisitCountMemberPattern(Alloc, mem_alloc);
 VisitCountMemberPattern(Free, mem_free);
-VisitCountMemberPattern(Load, mem_read);
-VisitCountMemberPattern(Store, mem_write);
+
+void FeatureExtractor::Visit(const ScheduleBlockRealize *x) {
+  const auto *schedule_block = x->schedule_block.As<ScheduleBlock>();
+  CHECK(schedule_block) << "schedule_block field is not a ScheduleBlock";
+  for (size_t i = 0;
+       i < x->iter_values.size() && i < schedule_block->iter_vars.size();
+       ++i) {
+    auto used_vars = ir::ir_utils::CollectIRNodesWithoutTensor(
+        x->iter_values[i], [](const Expr *e) { return e->As<_Var_>(); });
+    std::vector<std::string> &loops =
+        iter_var_to_loops_[schedule_block->iter_vars[i]->name];
+    loops.clear();
+    for (const Expr &var : used_vars) {
+      loops.push_back(var.As<_Var_>()->name);
+    }
+  }
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    if (e->defined()) {
+      Visit(e);
+    }
+  }
+}
+
+void FeatureExtractor::Visit(const Load *x) {
+  feature_.CurrentLoopBlock().mem_read += 1;
+  RecordMemoryAccess(x->tensor, x->indices, x->type());
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    if (e->defined()) {
+      Visit(e);
+    }
+  }
+}
+
+void FeatureExtractor::Visit(const Store *x) {
+  feature_.CurrentLoopBlock().mem_write += 1;
+  RecordMemoryAccess(x->tensor, x->indices, x->type());
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    if (e->defined()) {
+      Visit(e);
+    }
+  }
+}
+
+void FeatureExtractor::RecordMemoryAccess(const Expr &tensor,
+                                          const std::vector<Expr> &indices,
+                                          const common::Type &type) {
+  const auto *tensor_node = tensor.as_tensor();
+  if (!tensor_node) return;
+  int bytes = std::max(type.bits() / 8, 1) * std::max(type.lanes(), 1);
+  feature_.CurrentLoopBlock().mem_bytes += bytes;
+
+  // the loop vars used by the indices, through the iter vars of ScheduleBlock
+  std::unordered_set<std::string> used_loops;
+  for (const Expr &index : indices) {
+    auto used_vars = ir::ir_utils::CollectIRNodesWithoutTensor(
+        index, [](const Expr *e) { return e->As<_Var_>(); });
+    for (const Expr &var : used_vars) {
+      const std::string &name = var.As<_Var_>()->name;
+      auto it = iter_var_to_loops_.find(name);
+      if (it != iter_var_to_loops_.end()) {
+        used_loops.insert(it->second.begin(), it->second.end());
+      } else {
+        used_loops.insert(name);
+      }
+    }
+  }
+
+  // A loop touches the elements indexed by the loops inside it, so the bytes
+  // are accumulated from the innermost loop outward
+  int64_t touched_bytes = bytes;
+  for (auto it = loop_stack_.rbegin(); it != loop_stack_.rend(); ++it) {
+    if (used_loops.count(it->loop_var)) {
+      touched_bytes *= it->extent;
+    }
+    int64_t &recorded =
+        feature_.LoopBlockAt(it->loop_block_index)
+            .buffer_touched_bytes[tensor_node->name];
+    recorded = std::max(recorded, touched_bytes);
+  }
+}
 
 /* Visit for loops */
 
@@ -209,10 +294,15 @@ void FeatureExtractor::Visit(const For *x) {
     }
   }
 
+  loop_stack_.push_back(
+      {x->loop_var->name,
+       std::max<int64_t>(loop_feature.loop_length, 1),
+       feature_.CurrentLoopBlockIndex()});
   std::vector<const Expr *> sub_exprs = x->expr_fields();
   for (const Expr *e : sub_exprs) {
     Visit(e);
   }
+  loop_stack_.pop_back();
 
   feature_.ExitLoopBlock();
 }
@@ -27,6 +27,10 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "paddle/cinn/auto_schedule/cost_model/feature.h"
 #include "paddle/cinn/common/target.h"
 #include "paddle/cinn/ir/ir.h"
@@ -53,7 +57,24 @@ class FeatureExtractor : public ir::IRVisitorRequireReImpl<void> {
 #undef __
 
  private:
+  // Record the bytes of a buffer accessed with the indices into the features
+  // of the enclosing loops
+  void RecordMemoryAccess(const Expr& tensor,
+                          const std::vector<Expr>& indices,
+                          const common::Type& type);
+
+  // A loop enclosing the visited expression
+  struct LoopInfo {
+    std::string loop_var;
+    int64_t extent;
+    int loop_block_index;
+  };
+
   Feature feature_;
+  // The enclosing loops, from the outermost to the innermost
+  std::vector<LoopInfo> loop_stack_;
+  // The loop vars used by the value bound to each iter var of ScheduleBlocks
+  std::unordered_map<std::string, std::vector<std::string>> iter_var_to_loops_;
 };
 
 }  // namespace auto_schedule
@@ -68,7 +68,7 @@ TEST(FeatureExtractor, SimpleAssign) {
   VLOG(6) << "Feature data before slog:";
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
-    if (i != 0 && i != 17 && i != 18 && i != 29) {
+    if (i != 0 && i != 17 && i != 18 && i != 29 && i < 42) {
       ASSERT_EQ(to_check[i], 0);
     }
   }
@@ -86,6 +86,58 @@ TEST(FeatureExtractor, SimpleAssign) {
             slog(M.get_constant() * N.get_constant()));  // mem_write
   // non-opt loops, including root block
   ASSERT_EQ(to_check[29], slog(3));
+
+  float footprint = M.get_constant() * N.get_constant() * 4 * 2;
+#ifdef CINN_WITH_CUDA
+  ASSERT_EQ(to_check[42], 0);
+  ASSERT_EQ(to_check[43], 0);
+  ASSERT_EQ(to_check[44], 0);
+#else
+  // cache footprint in L1 and L2, both A and B fit in L1
+  ASSERT_EQ(to_check[42], slog(footprint));
+  ASSERT_EQ(to_check[43], slog(footprint));
+  // bytes read and written
+  ASSERT_EQ(to_check[44], slog(footprint));
+#endif
+  // vector utilization
+  ASSERT_EQ(to_check[45], 0);
+}
+
+TEST(FeatureExtractor, CpuFeatures) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  ir::Expr M(32);
+  ir::Expr N(2048);
+
+  lang::Placeholder<float> A("A", {M, N});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * A(i, j); }, "B");
+
+  poly::StageMap stages = poly::CreateStages({A, B});
+  std::vector<ir::LoweredFunc> funcs = lang::LowerVec(
+      "CpuFeatures", stages, {A, B}, {}, {}, nullptr, target, true);
+
+  std::vector<Expr> vec_ast{funcs[0]->body};
+  ir::ModuleExpr mod_expr(vec_ast);
+  ir::IRSchedule ir_sch(mod_expr);
+  std::vector<ir::Expr> loops = ir_sch.GetLoops("B");
+  auto splits = ir_sch.Split(loops.back(), {-1, 16});
+  ir_sch.Vectorize(splits.back(), 16);
+
+  FeatureExtractor extractor;
+  Feature feature = extractor.Extract(mod_expr, target);
+  std::vector<float> to_check = feature.ToFixedSizeVector();
+
+  float row_bytes = N.get_constant() * 4 * 2;
+  // a row of A and B fits in L1, the whole A and B fit in L2
+  ASSERT_EQ(to_check[42], slog(row_bytes));
+  ASSERT_EQ(to_check[43], slog(row_bytes * M.get_constant()));
+  // A is read twice
+  ASSERT_EQ(to_check[44],
+            slog(M.get_constant() * N.get_constant() * 4 * 3));
+  // all multiplications run on full vector registers
+  ASSERT_EQ(to_check[45], slog(100));
 }
 
 TEST(FeatureExtractor, MatrixMultiply) {
@@ -130,7 +182,8 @@ TEST(FeatureExtractor, MatrixMultiply) {
 
   ASSERT_EQ(to_check.size(),
             static_cast<size_t>(LoopBlockFeature::kTotalSize + 1));
-  std::unordered_set<size_t> non_zero_indice = {0, 1, 2, 17, 18, 29, 30, 37};
+  std::unordered_set<size_t> non_zero_indice = {
+      0, 1, 2, 17, 18, 29, 30, 37, 42, 43, 44};
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
     if (!non_zero_indice.count(i)) {
@@ -160,6 +213,17 @@ TEST(FeatureExtractor, MatrixMultiply) {
   ASSERT_EQ(to_check[30], slog(1));
   // GpuBind loop
   ASSERT_EQ(to_check[37], slog(out_loop));
+
+#ifndef CINN_WITH_CUDA
+  // the cache footprint of the outermost loop, C, A and B
+  float footprint = (out_loop + M.get_constant() * K.get_constant() +
+                     K.get_constant() * N.get_constant()) *
+                    4;
+  ASSERT_EQ(to_check[42], slog(footprint));
+  ASSERT_EQ(to_check[43], slog(footprint));
+  // bytes read and written
+  ASSERT_EQ(to_check[44], slog((total_loop * 4 + out_loop) * 4));
+#endif
 }
 
 }  // namespace auto_schedule
@@ -14,12 +14,19 @@
 
 #include "paddle/cinn/auto_schedule/measure/simple_runner.h"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <algorithm>
 #include <chrono>
 #include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
 #include <random>
+#include <vector>
 
 #include "paddle/cinn/common/target.h"
 #include "paddle/cinn/hlir/framework/buffer.h"
@@ -140,6 +147,71 @@ static std::unordered_set<std::string> ParamsNeedInitWithZero(
   return res;
 }
 
+// Pin the calling thread to the core it is running on during the measurement
+// on CPU, so that the repeated runs are not disturbed by thread migrations.
+// The original affinity is restored on destruction.
+class ScopedCpuPinning {
+ public:
+  explicit ScopedCpuPinning(bool enable) {
+#ifdef __linux__
+    if (!enable) return;
+    int cpu = sched_getcpu();
+    if (cpu < 0 || pthread_getaffinity_np(pthread_self(),
+                                          sizeof(cpu_set_t),
+                                          &original_cpus_) != 0) {
+      return;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    pinned_ =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus) == 0;
+    VLOG(6) << "Pin the measurement thread to cpu " << cpu
+            << ", succeeded: " << pinned_;
+#endif
+  }
+
+  ~ScopedCpuPinning() {
+#ifdef __linux__
+    if (pinned_) {
+      pthread_setaffinity_np(
+          pthread_self(), sizeof(cpu_set_t), &original_cpus_);
+    }
+#endif
+  }
+
+ private:
+#ifdef __linux__
+  cpu_set_t original_cpus_;
+#endif
+  bool pinned_ = false;
+};
+
+// Run the instruction once to warm up the caches, then time every run
+// separately and return the median, which is robust to the outliers caused
+// by interrupts and frequency changes on CPU.
+static double MeasureOnCpu(
+    hlir::framework::Instruction* instr,
+    const std::map<std::string, cinn_pod_value_t>* execution_args,
+    int repeat_times) {
+  instr->Run(execution_args);
+  std::vector<double> costs(repeat_times);
+  for (int i = 0; i < repeat_times; ++i) {
+    auto run_start = std::chrono::steady_clock::now();
+    instr->Run(execution_args);
+    costs[i] = std::chrono::duration<double, std::micro>(
+                   std::chrono::steady_clock::now() - run_start)
+                   .count();
+  }
+  std::sort(costs.begin(), costs.end());
+  int mid = repeat_times / 2;
+  double median =
+      repeat_times % 2 ? costs[mid] : (costs[mid - 1] + costs[mid]) / 2;
+  VLOG(5) << "Run " << repeat_times << " times on CPU, min=" << costs.front()
+          << "us, median=" << median << "us, max=" << costs.back() << "us";
+  return median;
+}
+
 SimpleRunner::SimpleRunner(int repeat_times) : repeat_times_(repeat_times) {
   CHECK_GT(repeat_times_, 0) << "repeat_times can't less than 0";
 }
@@ -217,12 +289,20 @@ MeasureResult SimpleRunner::Run(const MeasureInput& input,
   hlir::framework::Scope temp_scope;  // used for store temporary allocated data
   auto execution_args = PrepareArgs(input, build_result, &temp_scope);
 
-  // Execute each instruction repeatedly and take the average as cost.
+  // Execute each instruction repeatedly and take the average as cost, or the
+  // median on CPU.
   result.execution_cost = 0;
   const auto& instructions = build_result.runtime_program->GetRunInstructions();
+  bool run_on_cpu = input.task->target == common::DefaultHostTarget();
+  ScopedCpuPinning cpu_pinning(run_on_cpu);
   for (auto ct = 0; ct < instructions.size(); ++ct) {
     auto&& instr = instructions.at(ct);
     VLOG(5) << "Start running instruction-" << ct;
+    if (run_on_cpu) {
+      result.execution_cost +=
+          MeasureOnCpu(instr.get(), &execution_args, repeat_times_);
+      continue;
+    }
     auto run_start = std::chrono::steady_clock::now();
     for (int i = 0; i < repeat_times_; ++i) {
       instr->Run(&execution_args);
@@ -24,6 +24,14 @@
 namespace cinn {
 namespace auto_schedule {
 
+// Check whether the input ir::For is a serial loop that is not used by any
+// reduce axis of the ScheduleBlocks underneath
+bool IsSpatialLoop(const ir::For* for_node);
+
+// Count the number of loops that can be binded from the input for_node to
+// bottom
+int CountLoopCanBinded(const ir::For* for_node);
+
 // Auto bind GPU index(BlockIdx, ThreadIdx) to the loops around the block
 class AutoBind : public AutoGenRule {
  public:
@@ -0,0 +1,137 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_bind.h"
+#include "paddle/cinn/ir/ir_printer.h"
+#include "paddle/cinn/ir/schedule/ir_schedule.h"
+#include "paddle/cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// count the number of loops with constant extent that can be fused into a
+// parallel loop from the input for_node to bottom
+static int CountLoopCanParallel(const ir::For* for_node) {
+  int cnt = 0;
+  while (for_node) {
+    if (!IsSpatialLoop(for_node)) break;  // only spatial loops to be parallel
+    if (!for_node->extent.is_constant()) break;
+
+    cnt += 1;
+
+    CHECK(for_node->body.defined() && for_node->body.As<ir::Block>())
+        << "Body is not defined";
+    const ir::Block* body = for_node->body.As<ir::Block>();
+    // terminate when body of this loop has more than one statement or the body
+    // is not a ir::For node
+    for_node = body->stmts.size() == 1 ? body->stmts[0].As<ir::For>() : nullptr;
+  }
+  return cnt;
+}
+
+static int64_t LoopExtent(const Expr& loop) {
+  return static_cast<int64_t>(loop.As<ir::For>()->extent.get_constant());
+}
+
+// check whether the loops around the block can be parallelized
+static bool CanParallel(const std::vector<Expr>& all_loops) {
+  if (all_loops.empty()) return false;
+  int num_loops = CountLoopCanParallel(all_loops[0].As<ir::For>());
+  int64_t extent_prod = 1;
+  for (int i = 0; i < num_loops; ++i) {
+    extent_prod *= LoopExtent(all_loops[i]);
+  }
+  // nothing to share between threads
+  return extent_prod > 1;
+}
+
+static void ParallelOuterLoops(ir::IRSchedule* ir_schedule,
+                               const std::string& block_name,
+                               int num_threads) {
+  auto all_loops = ir_schedule->GetLoops(block_name);
+  int num_loops = CountLoopCanParallel(all_loops[0].As<ir::For>());
+  CHECK_GT(num_loops, 0) << "No loop can be parallelized";
+  // keep the innermost loop of the block for vectorization
+  int max_fused = num_loops == all_loops.size() && num_loops > 1
+                      ? num_loops - 1
+                      : num_loops;
+  int min_fused = 1;
+  int64_t extent_prod = LoopExtent(all_loops[0]);
+  while (min_fused < max_fused && extent_prod < num_threads) {
+    extent_prod *= LoopExtent(all_loops[min_fused]);
+    ++min_fused;
+  }
+  int num_fused = min_fused + std::rand() % (max_fused - min_fused + 1);
+  VLOG(6) << "Fuse " << num_fused << " loops of " << block_name
+          << " to parallelize, min_fused=" << min_fused
+          << ", max_fused=" << max_fused;
+
+  Expr parallel_loop = all_loops[0];
+  if (num_fused > 1) {
+    parallel_loop = ir_schedule->Fuse(
+        {all_loops.begin(), all_loops.begin() + num_fused});
+  }
+  ir_schedule->Parallel(parallel_loop);
+}
+
+RuleApplyType AutoParallel::Init(ir::IRSchedule* ir_schedule) {
+  ir_schedule_ = ir_schedule;
+  applicable_schedule_blocks_.clear();
+
+  for (auto&& block_realize : ir_schedule->GetAllBlocks()) {
+    if (CanParallel(ir_schedule->GetLoops(block_realize))) {
+      applicable_schedule_blocks_.emplace_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_schedule_blocks_.size();
+  VLOG(6) << "Collect applicable_schedule_blocks_:" << num_applicable_;
+  return num_applicable_ > 0 ? RuleApplyType::kApplyAndPruneOtherRules
+                             : RuleApplyType::kCannotApply;
+}
+
+void AutoParallel::Apply(int index) {
+  CHECK_LT(index, applicable_schedule_blocks_.size())
+      << "invalid apply index:" << index;
+  auto applied_block = applicable_schedule_blocks_.at(index);
+  ParallelOuterLoops(ir_schedule_,
+                     applied_block.As<ir::ScheduleBlockRealize>()
+                         ->schedule_block.As<ir::ScheduleBlock>()
+                         ->name,
+                     max_concurrency());
+  return;
+}
+
+RuleApplyType AutoParallel::AnalyseApplyType(
+    SearchState state, const std::string& block_name) const {
+  Expr block_expr = state->ir_schedule.GetBlock(block_name);
+  return CanParallel(state->ir_schedule.GetLoops(block_expr))
+             ? RuleApplyType::kApplyAndPruneOtherRules
+             : RuleApplyType::kCannotApply;
+}
+
+std::vector<SearchState> AutoParallel::ApplyOnBlock(
+    SearchState state, const std::string& block_name) {
+  SearchState new_state = state.Copy();
+  ParallelOuterLoops(&new_state->ir_schedule, block_name, max_concurrency());
+  return {new_state};
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
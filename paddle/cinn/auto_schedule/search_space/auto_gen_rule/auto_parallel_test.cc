@@ -0,0 +1,101 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "paddle/cinn/cinn.h"
+#include "paddle/cinn/lang/lower.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoParallel, Init) {
+  using namespace ir;  // NOLINT
+
+  Expr M(1);
+  Placeholder<float> A("A", {M});
+  Tensor B = Compute(
+      {M}, [&](Var i) { return A(i) * A(i); }, "B");
+
+  Target target = common::DefaultHostTarget();
+  auto stages = CreateStages({B});
+  auto funcs = cinn::lang::LowerVec(
+      "test_init", stages, {A, B}, {}, {}, nullptr, target, true);
+
+  auto ast_expr = funcs[0]->body;
+  ir::IRSchedule init_schedule(ir::ModuleExpr({ast_expr}));
+  AutoParallel test_rule(target);
+  // a single iteration can not be shared between threads
+  ASSERT_EQ(test_rule.Init(&init_schedule), RuleApplyType::kCannotApply);
+}
+
+TEST(AutoParallel, ParallelOuterLoops) {
+  using namespace ir;  // NOLINT
+
+  Expr M(32);
+  Expr N(16);
+  Expr K(64);
+  Placeholder<float> A("A", {M, N, K});
+  Placeholder<float> B("B", {M, N, K});
+  Tensor C = Compute(
+      {M, N, K},
+      [&](Var i, Var j, Var k) { return A(i, j, k) + B(i, j, k); },
+      "C");
+
+  Target target = common::DefaultHostTarget();
+  auto stages = CreateStages({C});
+  auto funcs = cinn::lang::LowerVec(
+      "test_parallel", stages, {A, B, C}, {}, {}, nullptr, target, true);
+
+  auto ast_expr = funcs[0]->body;
+  VLOG(6) << "Before auto-parallel:\n" << ast_expr;
+
+  AutoParallel test_rule(target);
+  ir::IRSchedule ir_schedule(ir::ModuleExpr({ast_expr}));
+  SearchState state(ir_schedule, 0, {});
+  ASSERT_EQ(test_rule.Init(&ir_schedule),
+            RuleApplyType::kApplyAndPruneOtherRules);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  test_rule.ApplyRandomly();
+
+  // ApplyOnBlock
+  EXPECT_EQ(test_rule.AnalyseApplyType(state, "C"),
+            RuleApplyType::kApplyAndPruneOtherRules);
+  std::vector<cinn::auto_schedule::SearchState> states =
+      test_rule.ApplyOnBlock(state, "C");
+
+  auto test_func = [](IRSchedule* ir_sch) {
+    std::vector<Expr> loops = ir_sch->GetLoops("C");
+    // one or two outer loops are fused, the innermost one is kept
+    ASSERT_GE(loops.size(), 2UL);
+    ASSERT_LE(loops.size(), 3UL);
+    EXPECT_TRUE(loops.front().As<ir::For>()->is_parallel());
+    EXPECT_FALSE(loops.back().As<ir::For>()->is_parallel());
+    EXPECT_EQ(loops.back().As<ir::For>()->extent.as_int32(), 64);
+    VLOG(6) << "After auto-parallel:\n"
+            << ir_sch->GetModule().GetExprs().front();
+  };
+
+  test_func(&ir_schedule);
+  test_func(&states[0]->ir_schedule);
+  // the parallelized loops can not be parallelized again
+  EXPECT_EQ(test_rule.AnalyseApplyType(states[0], "C"),
+            RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
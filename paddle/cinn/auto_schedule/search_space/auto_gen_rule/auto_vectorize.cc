@@ -0,0 +1,137 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_bind.h"
+#include "paddle/cinn/ir/ir_printer.h"
+#include "paddle/cinn/ir/schedule/ir_schedule.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// The vector widths in elements, up to a 512 bits register of float32
+static std::vector<int> auto_vectorize_factors = {4, 8, 16};
+
+// check whether the expr uses the loop variable
+static bool UseLoopVar(const Expr& expr, const ir::Var& loop_var) {
+  auto used_exprs = ir::ir_utils::CollectIRNodesWithoutTensor(
+      expr, [&loop_var](const Expr* x) {
+        const ir::_Var_* var = x->As<ir::_Var_>();
+        return var && (x->same_as(loop_var) || var->name == loop_var->name);
+      });
+  return !used_exprs.empty();
+}
+
+// return the vector widths that the innermost loop of the block can be
+// vectorized with, empty if it can not be vectorized
+static std::vector<int> GetVectorizeFactors(
+    const ir::IRSchedule& ir_schedule, const Expr& block_expr) {
+  auto all_loops = ir_schedule.GetLoops(block_expr);
+  if (all_loops.empty()) return {};
+  const ir::For* inner_loop = all_loops.back().As<ir::For>();
+  if (!IsSpatialLoop(inner_loop) || !inner_loop->extent.is_constant()) {
+    return {};
+  }
+
+  // the innermost loop should only walk the last dimension of the block, so
+  // that the vectorized accesses to its output are contiguous
+  auto* block_realize = block_expr.As<ir::ScheduleBlockRealize>();
+  CHECK(block_realize) << "stmt is not a ScheduleBlockRealize:" << block_expr;
+  const auto& iter_values = block_realize->iter_values;
+  if (iter_values.empty() ||
+      !UseLoopVar(iter_values.back(), inner_loop->loop_var)) {
+    return {};
+  }
+  for (int i = 0; i + 1 < iter_values.size(); ++i) {
+    if (UseLoopVar(iter_values[i], inner_loop->loop_var)) return {};
+  }
+
+  int extent = static_cast<int>(inner_loop->extent.get_constant());
+  std::vector<int> factors;
+  for (int factor : auto_vectorize_factors) {
+    if (extent % factor == 0) factors.push_back(factor);
+  }
+  return factors;
+}
+
+static void VectorizeInnerLoop(ir::IRSchedule* ir_schedule,
+                               const std::string& block_name) {
+  Expr block_expr = ir_schedule->GetBlock(block_name);
+  std::vector<int> factors = GetVectorizeFactors(*ir_schedule, block_expr);
+  CHECK(!factors.empty()) << "The innermost loop of " << block_name
+                          << " can not be vectorized";
+  int factor = factors[std::rand() % factors.size()];
+
+  Expr inner_loop = ir_schedule->GetLoops(block_name).back();
+  int extent =
+      static_cast<int>(inner_loop.As<ir::For>()->extent.get_constant());
+  if (extent > factor) {
+    auto splits = ir_schedule->Split(inner_loop, {-1, factor});
+    CHECK_EQ(splits.size(), 2);
+    inner_loop = splits[1];
+  }
+  VLOG(6) << "Vectorize the innermost loop of " << block_name
+          << " with factor=" << factor;
+  ir_schedule->Vectorize(inner_loop, factor);
+}
+
+RuleApplyType AutoVectorize::Init(ir::IRSchedule* ir_schedule) {
+  ir_schedule_ = ir_schedule;
+  applicable_schedule_blocks_.clear();
+
+  for (auto&& block_realize : ir_schedule->GetAllBlocks()) {
+    if (!GetVectorizeFactors(*ir_schedule, block_realize).empty()) {
+      applicable_schedule_blocks_.emplace_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_schedule_blocks_.size();
+  VLOG(6) << "Collect applicable_schedule_blocks_:" << num_applicable_;
+  return num_applicable_ > 0 ? RuleApplyType::kApply
+                             : RuleApplyType::kCannotApply;
+}
+
+void AutoVectorize::Apply(int index) {
+  CHECK_LT(index, applicable_schedule_blocks_.size())
+      << "invalid apply index:" << index;
+  auto applied_block = applicable_schedule_blocks_.at(index);
+  VectorizeInnerLoop(ir_schedule_,
+                     applied_block.As<ir::ScheduleBlockRealize>()
+                         ->schedule_block.As<ir::ScheduleBlock>()
+                         ->name);
+  return;
+}
+
+RuleApplyType AutoVectorize::AnalyseApplyType(
+    SearchState state, const std::string& block_name) const {
+  Expr block_expr = state->ir_schedule.GetBlock(block_name);
+  return !GetVectorizeFactors(state->ir_schedule, block_expr).empty()
+             ? RuleApplyType::kApply
+             : RuleApplyType::kCannotApply;
+}
+
+std::vector<SearchState> AutoVectorize::ApplyOnBlock(
+    SearchState state, const std::string& block_name) {
+  SearchState new_state = state.Copy();
+  VectorizeInnerLoop(&new_state->ir_schedule, block_name);
+  return {new_state};
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
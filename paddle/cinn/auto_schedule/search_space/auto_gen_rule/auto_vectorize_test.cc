@@ -0,0 +1,103 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "paddle/cinn/cinn.h"
+#include "paddle/cinn/lang/lower.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoVectorize, Init) {
+  using namespace ir;  // NOLINT
+
+  Expr M(32);
+  Expr K(64);
+  Placeholder<float> A("A", {M, K});
+  Var k(K.as_int32(), "k0");
+  Tensor B = Compute(
+      {M}, [&](Var i) { return ReduceSum(A(i, k), {k}); }, "B");
+
+  Target target = common::DefaultHostTarget();
+  auto stages = CreateStages({B});
+  auto funcs = cinn::lang::LowerVec(
+      "test_init", stages, {A, B}, {}, {}, nullptr, target, true);
+
+  auto ast_expr = funcs[0]->body;
+  ir::IRSchedule init_schedule(ir::ModuleExpr({ast_expr}));
+  AutoVectorize test_rule(target);
+  // only the init block can be vectorized, the innermost loop of the reduce
+  // block is a reduce loop
+  ASSERT_EQ(test_rule.Init(&init_schedule), RuleApplyType::kApply);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  SearchState state(init_schedule, 0, {});
+  EXPECT_EQ(test_rule.AnalyseApplyType(state, "B__reduce_init"),
+            RuleApplyType::kApply);
+  EXPECT_EQ(test_rule.AnalyseApplyType(state, "B"),
+            RuleApplyType::kCannotApply);
+}
+
+TEST(AutoVectorize, VectorizeInnerLoop) {
+  using namespace ir;  // NOLINT
+
+  Expr M(32);
+  Expr N(64);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * B(i, j); }, "C");
+
+  Target target = common::DefaultHostTarget();
+  auto stages = CreateStages({C});
+  auto funcs = cinn::lang::LowerVec(
+      "test_vectorize", stages, {A, B, C}, {}, {}, nullptr, target, true);
+
+  auto ast_expr = funcs[0]->body;
+  VLOG(6) << "Before auto-vectorize:\n" << ast_expr;
+
+  AutoVectorize test_rule(target);
+  ir::IRSchedule ir_schedule(ir::ModuleExpr({ast_expr}));
+  SearchState state(ir_schedule, 0, {});
+  ASSERT_EQ(test_rule.Init(&ir_schedule), RuleApplyType::kApply);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  test_rule.ApplyRandomly();
+
+  // ApplyOnBlock
+  EXPECT_EQ(test_rule.AnalyseApplyType(state, "C"), RuleApplyType::kApply);
+  std::vector<cinn::auto_schedule::SearchState> states =
+      test_rule.ApplyOnBlock(state, "C");
+
+  auto test_func = [](IRSchedule* ir_sch) {
+    std::vector<Expr> loops = ir_sch->GetLoops("C");
+    ASSERT_EQ(loops.size(), 3UL);
+    const ir::For* inner_loop = loops.back().As<ir::For>();
+    ASSERT_TRUE(inner_loop->is_vectorized());
+    int factor = inner_loop->vectorize_info().factor;
+    EXPECT_TRUE(factor == 4 || factor == 8 || factor == 16);
+    EXPECT_EQ(inner_loop->extent.as_int32(), factor);
+    EXPECT_EQ(loops[1].As<ir::For>()->extent.as_int32(), 64 / factor);
+    VLOG(6) << "After auto-vectorize:\n"
+            << ir_sch->GetModule().GetExprs().front();
+  };
+
+  test_func(&ir_schedule);
+  test_func(&states[0]->ir_schedule);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -23,7 +23,9 @@
 #include "paddle/cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
 #include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_inline.h"
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
 #include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_unroll.h"
+#include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
 #include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/multi_level_tiling.h"
 #include "paddle/cinn/auto_schedule/search_space/auto_gen_rule/skip_rule.h"
 #include "paddle/cinn/auto_schedule/search_space/block_sampler.h"
@@ -50,6 +52,11 @@ SearchSpace::SearchSpace(const TuneTask& tune_task,
   // tune_task_.output_names));
   sketch_rules_.emplace_back(
       new MultiLevelTiling(target, MultiLevelTiling::kConfigs.at(target.arch)));
+  if (target.arch == common::Target::Arch::X86) {
+    // the CPU counterparts of the thread binding on GPU
+    sketch_rules_.emplace_back(new AutoParallel(target));
+    sketch_rules_.emplace_back(new AutoVectorize(target));
+  }
   sketch_rules_.emplace_back(new AutoUnroll(target));
   sketch_rules_.emplace_back(new SkipRule(target));
 }
@@ -22,6 +22,7 @@
 #include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Metadata.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -98,6 +99,21 @@ int NextPowerOfTwo(int x) {
   return 0;
 }
 
+//! Whether \p e is a multiple of \p n for all the values of its variables.
+bool IsMultipleOf(const Expr &e, int n) {
+  if (auto *imm = e.As<ir::IntImm>()) return imm->value % n == 0;
+  if (auto *mul = e.As<ir::Mul>()) {
+    return IsMultipleOf(mul->a(), n) || IsMultipleOf(mul->b(), n);
+  }
+  if (auto *add = e.As<ir::Add>()) {
+    return IsMultipleOf(add->a(), n) && IsMultipleOf(add->b(), n);
+  }
+  if (auto *sub = e.As<ir::Sub>()) {
+    return IsMultipleOf(sub->a(), n) && IsMultipleOf(sub->b(), n);
+  }
+  return false;
+}
+
 }  // namespace
 
 CodeGenLLVM::CodeGenLLVM(llvm::Module *m,
@@ -971,11 +987,16 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
         optim::VarModSimplify(&base);
         auto *ptr =
             CreateBufferPtr(op->type().ElementOf(), buffer, Visit(&base));
+        int alignment = VectorAccessAlignment(
+            op->tensor, base, op->type().with_lanes(lanes));
+        if (masked_vector_tail_ && NextPowerOfTwo(lanes) != lanes) {
+          return CreateMaskedVectorStore(
+              op, CreateVecSlice(value, offset, lanes), ptr, alignment);
+        }
         auto *vtype = llvm::VectorType::get(
                           CinnTypeToLLVMType(op->type().ElementOf(), m_, true),
                           llvm::ElementCount(lanes, false /*Scalable*/))
                           ->getPointerTo();
-        int alignment = std::max(op->type().ElementOf().bits() / 8, 1);
         llvm::StoreInst *inst =
             b_->CreateAlignedStore(CreateVecSlice(value, offset, lanes),
                                    b_->CreatePointerCast(ptr, vtype),
@@ -1296,11 +1317,18 @@ llvm::Value *CodeGenLLVM::DenseVectorLoad(const ir::Load *op) {
 
     llvm::Value *elt_ptr =
         CreateBufferPtr(op->type().ElementOf(), buffer, Visit(&slice_base));
+    int alignment = VectorAccessAlignment(
+        op->tensor, slice_base, op->type().with_lanes(slice_lanes));
+
+    if (masked_vector_tail_ && NextPowerOfTwo(slice_lanes) != slice_lanes) {
+      slices.push_back(CreateMaskedVectorLoad(
+          op, elt_ptr, op->type().with_lanes(slice_lanes), alignment));
+      continue;
+    }
+
     llvm::Value *vec_ptr = b_->CreatePointerCast(
         elt_ptr, slice_type->getPointerTo(), "get_vec_ptr");
 
-    int alignment = std::max(op->type().ElementOf().bits() / 8, 1);
-
     llvm::Instruction *load_inst =
         b_->CreateAlignedLoad(vec_ptr, llvm::Align(alignment), "load_vec");
     AddTbaaMetadata(load_inst, op->tensor.as_tensor()->name, op->index());
@@ -1359,6 +1387,129 @@ llvm::Value *CodeGenLLVM::CreateVecSlice(llvm::Value *vec,
       vec, undef, llvm::ConstantVector::get(indices));
 }
 
+int CodeGenLLVM::VectorAccessAlignment(const Expr &tensor,
+                                       const Expr &base,
+                                       Type type) {
+  int element_bytes = std::max(type.ElementOf().bits() / 8, 1);
+  int alignment = element_bytes;
+  auto *tensor_node = tensor.as_tensor();
+  if (!tensor_node || !tensor_node->buffer.defined()) return alignment;
+  // The alignment of the buffer allocated by the generated code, the ones
+  // passed in from outside are only aligned to their element.
+  int buffer_alignment = tensor_node->buffer->data_alignment;
+  for (int bytes = element_bytes * 2;
+       bytes <= std::min(buffer_alignment, element_bytes * type.lanes());
+       bytes *= 2) {
+    if (buffer_alignment % bytes != 0 ||
+        !IsMultipleOf(base, bytes / element_bytes)) {
+      break;
+    }
+    alignment = bytes;
+  }
+  return alignment;
+}
+
+llvm::Value *CodeGenLLVM::CreateTailMask(int lanes, int padded_lanes) {
+  std::vector<llvm::Constant *> mask;
+  for (int i = 0; i < padded_lanes; ++i) {
+    mask.push_back(i < lanes ? b_->getTrue() : b_->getFalse());
+  }
+  return llvm::ConstantVector::get(mask);
+}
+
+llvm::Value *CodeGenLLVM::CreateMaskedVectorLoad(const ir::Load *op,
+                                                 llvm::Value *elt_ptr,
+                                                 Type type,
+                                                 int alignment) {
+  int lanes = type.lanes();
+  int padded_lanes = NextPowerOfTwo(lanes);
+  auto *padded_type = llvm::FixedVectorType::get(
+      CinnTypeToLLVMType(type.ElementOf(), m_, true), padded_lanes);
+  llvm::Value *vec_ptr = b_->CreatePointerCast(
+      elt_ptr, padded_type->getPointerTo(), "get_vec_ptr");
+#if LLVM_VERSION_MAJOR >= 13
+  llvm::Instruction *load_inst =
+      b_->CreateMaskedLoad(padded_type,
+                           vec_ptr,
+                           llvm::Align(alignment),
+                           CreateTailMask(lanes, padded_lanes),
+                           nullptr,
+                           "load_vec");
+#else
+  llvm::Instruction *load_inst =
+      b_->CreateMaskedLoad(vec_ptr,
+                           llvm::Align(alignment),
+                           CreateTailMask(lanes, padded_lanes),
+                           nullptr,
+                           "load_vec");
+#endif
+  AddTbaaMetadata(load_inst, op->tensor.as_tensor()->name, op->index());
+  return CreateVecSlice(load_inst, 0, lanes);
+}
+
+llvm::Value *CodeGenLLVM::CreateMaskedVectorStore(const ir::Store *op,
+                                                  llvm::Value *value,
+                                                  llvm::Value *elt_ptr,
+                                                  int alignment) {
+  int lanes = llvm::cast<llvm::FixedVectorType>(value->getType())
+                  ->getNumElements();
+  int padded_lanes = NextPowerOfTwo(lanes);
+  // the padded lanes are undefined and never stored
+  std::vector<llvm::Constant *> indices;
+  for (int i = 0; i < padded_lanes; ++i) {
+    indices.push_back(ll_const_int32(std::min(i, lanes)));
+  }
+  llvm::Value *padded_value =
+      b_->CreateShuffleVector(value,
+                              llvm::UndefValue::get(value->getType()),
+                              llvm::ConstantVector::get(indices));
+  llvm::Value *vec_ptr = b_->CreatePointerCast(
+      elt_ptr, padded_value->getType()->getPointerTo(), "get_vec_ptr");
+  llvm::Instruction *store_inst =
+      b_->CreateMaskedStore(padded_value,
+                            vec_ptr,
+                            llvm::Align(alignment),
+                            CreateTailMask(lanes, padded_lanes));
+  AddTbaaMetadata(store_inst, op->tensor.as_tensor()->name, op->index());
+  return store_inst;
+}
+
+llvm::Value *CodeGenLLVM::CreateVectorReduce(const std::string &name,
+                                             llvm::Value *vec,
+                                             Type type) {
+  llvm::Value *ret = nullptr;
+  if (type.is_float()) {
+    auto *elem_type = CinnTypeToLLVMType(type.ElementOf(), m_, true);
+    if (name == "vector_reduce_add") {
+      ret = b_->CreateFAddReduce(llvm::ConstantFP::getNegativeZero(elem_type),
+                                 vec);
+    } else if (name == "vector_reduce_mul") {
+      ret = b_->CreateFMulReduce(llvm::ConstantFP::get(elem_type, 1.0), vec);
+    } else if (name == "vector_reduce_max") {
+      ret = b_->CreateFPMaxReduce(vec);
+    } else if (name == "vector_reduce_min") {
+      ret = b_->CreateFPMinReduce(vec);
+    }
+    // Reduce the lanes as a tree instead of in order.
+    if (auto *inst = llvm::dyn_cast_or_null<llvm::Instruction>(ret)) {
+      inst->setHasAllowReassoc(true);
+    }
+  } else {
+    bool is_signed = type.is_int();
+    if (name == "vector_reduce_add") {
+      ret = b_->CreateAddReduce(vec);
+    } else if (name == "vector_reduce_mul") {
+      ret = b_->CreateMulReduce(vec);
+    } else if (name == "vector_reduce_max") {
+      ret = b_->CreateIntMaxReduce(vec, is_signed);
+    } else if (name == "vector_reduce_min") {
+      ret = b_->CreateIntMinReduce(vec, is_signed);
+    }
+  }
+  CHECK(ret) << "Unsupported horizontal reduction " << name << " of " << type;
+  return ret;
+}
+
 void CodeGenLLVM::InitTarget(const Target &target) {
   llvm::InitializeAllTargetInfos();
   llvm::InitializeAllTargets();
@@ -1374,6 +1525,12 @@ void CodeGenLLVM::InitTarget(const Target &target) {
       } else {
         LOG(FATAL) << "get unknown bits";
       }
+      {
+        // The code is compiled for the host by ExecutionEngine.
+        llvm::StringMap<bool> host_features;
+        masked_vector_tail_ = llvm::sys::getHostCPUFeatures(host_features) &&
+                              host_features.lookup("avx512f");
+      }
       break;
     case Target::Arch::ARM:
       naive_vec_alignment_ = 128;
@@ -1606,6 +1763,10 @@ llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
       CHECK_GE(op->args.size(), 1U);
       llvm::Value *v = Visit(&op->args[0]);
       return b_->CreateFCmpUNO(v, v);
+    } else if (utils::Startswith(func_name, "vector_reduce_")) {
+      CHECK_EQ(op->args.size(), 1U);
+      return CreateVectorReduce(
+          func_name, Visit(&op->args[0]), op->args[0].type());
     }
   }
 
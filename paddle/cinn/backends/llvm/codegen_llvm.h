@@ -242,6 +242,27 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   llvm::Value *CreateVecSlice(llvm::Value *vec, int begin, int lanes);
 
   llvm::Value *DenseVectorLoad(const ir::Load *load);
+
+  //! The alignment in bytes of a vector of \p type accessing \p tensor from
+  //! \p base, which is aligned to the whole vector when the buffer and the
+  //! base allow.
+  int VectorAccessAlignment(const Expr &tensor, const Expr &base, Type type);
+  //! The mask enabling the first \p lanes lanes of \p padded_lanes lanes.
+  llvm::Value *CreateTailMask(int lanes, int padded_lanes);
+  //! Load or store a vector whose lanes are not a power of two, such as the
+  //! tail of a vectorized loop, with a masked access of the padded vector.
+  llvm::Value *CreateMaskedVectorLoad(const ir::Load *op,
+                                      llvm::Value *elt_ptr,
+                                      Type type,
+                                      int alignment);
+  llvm::Value *CreateMaskedVectorStore(const ir::Store *op,
+                                       llvm::Value *value,
+                                       llvm::Value *elt_ptr,
+                                       int alignment);
+  //! Reduce the lanes of \p vec by the vector_reduce_* intrinsic \p name.
+  llvm::Value *CreateVectorReduce(const std::string &name,
+                                  llvm::Value *vec,
+                                  Type type);
   llvm::Value *CreateSerialFor(const ir::For *op, int stride = 1);
 
   /**
@@ -273,6 +294,9 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   llvm::MDNode *md_tbaa_alias_set_{nullptr};
 
   int naive_vec_alignment_{0};
+  // Whether the vector tails are loaded and stored with masks, only when the
+  // host supports AVX-512, otherwise LLVM splits them into narrower vectors.
+  bool masked_vector_tail_{false};
   Target target_;
 };
 namespace detail {
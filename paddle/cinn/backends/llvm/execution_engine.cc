@@ -40,6 +40,7 @@
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Transforms/Scalar.h>
@@ -48,11 +49,15 @@
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Scalar/SimplifyCFG.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <sstream>
 #include <string>
+#include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "paddle/cinn/backends/codegen_cuda_host.h"
 #include "paddle/cinn/backends/llvm/cinn_runtime_llvm_ir.h"
@@ -86,6 +91,33 @@ void InitializeLLVMPasses() {
   // llvm::initializeTarget(registry);
   // llvm::initializeCodeGenPreparePass(registry);
 }
+
+// Everything of the target machine and of the compiler that the object files
+// emitted by ExecutionEngine::Link depend on, besides the module itself.
+std::string TargetFingerprint(const llvm::TargetMachine &machine,
+                              const ExecutionOptions &options) {
+  std::stringstream ss;
+  ss << "llvm: " << LLVM_VERSION_STRING << "\n";
+  ss << "triple: " << machine.getTargetTriple().str() << "\n";
+  ss << "cpu: " << machine.getTargetCPU().str() << "\n";
+  // The features of the host come in no particular order.
+  llvm::SmallVector<llvm::StringRef, 64> features;
+  machine.getTargetFeatureString().split(features, ',');
+  std::sort(features.begin(), features.end());
+  ss << "features:";
+  for (auto &feature : features) ss << " " << feature.str();
+  ss << "\n";
+  ss << "codegen_opt_level: " << static_cast<int>(machine.getOptLevel())
+     << "\n";
+  ss << "reloc_model: " << static_cast<int>(machine.getRelocationModel())
+     << "\n";
+  ss << "code_model: " << static_cast<int>(machine.getCodeModel()) << "\n";
+  ss << "opt_level: " << options.opt_level << "\n";
+  ss << "debug_info: " << options.enable_debug_info << "\n";
+  ss << "runtime: " << llvm::xxHash64(AsStringRef(backends::kRuntimeLlvmIr))
+     << "\n";
+  return ss.str();
+}
 }  // namespace
 void NaiveObjectCache::notifyObjectCompiled(const llvm::Module *m,
                                             llvm::MemoryBufferRef obj_buffer) {
@@ -125,17 +157,19 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(
 
   auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true,
                                                   std::move(module_symbols));
+  engine->options_ = config;
 
   auto compile_layer_creator =
       [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<
           std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
-    auto machine = llvm::cantFail(jtmb.createTargetMachine());
+    engine->target_machine_ = llvm::cantFail(jtmb.createTargetMachine());
+    auto *machine = engine->target_machine_.get();
     VLOG(1) << "create llvm compile layer";
     VLOG(1) << "Target Name: " << machine->getTarget().getName();
     VLOG(1) << "Target CPU: " << machine->getTargetCPU().str() << std::endl;
-    return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(
-        std::move(machine), engine->cache_.get());
+    return std::make_unique<llvm::orc::SimpleCompiler>(*machine,
+                                                       engine->cache_.get());
   };
 
   auto object_layer_creator = [&](llvm::orc::ExecutionSession &session,
@@ -172,6 +206,21 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(
 template <typename CodeGenT>
 void ExecutionEngine::Link(const ir::Module &module) {
   utils::RecordEvent("ExecutionEngine Link", utils::EventType::kOrdinary);
+  auto *object_cache = PersistentObjectCache::Global();
+  std::string fingerprint;
+  if (object_cache) {
+    std::stringstream ss;
+    ss << TargetFingerprint(*target_machine_, options_)
+       << "codegen: " << typeid(CodeGenT).name() << "\n"
+       << PersistentObjectCache::ModuleFingerprint(module);
+    fingerprint = ss.str();
+    if (auto object = object_cache->Load(fingerprint)) {
+      buffer_.append(object->getBufferStart(), object->getBufferEnd());
+      CHECK(AddObject(std::move(object)));
+      return;
+    }
+  }
+
   llvm::SMDiagnostic error;
   auto ctx = std::make_unique<llvm::LLVMContext>();
   auto m = llvm::parseAssemblyString(
@@ -183,10 +232,8 @@ void ExecutionEngine::Link(const ir::Module &module) {
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
 
-  auto machine = std::move(llvm::cantFail(
-      llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost())
-          .createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
+  LLVMModuleOptimizer optimize(
+      target_machine_.get(), options_.opt_level, {}, true);
   optimize(m.get());
   CHECK(!llvm::verifyModule(*m, &llvm::errs()))
       << "Invalid optimized module detected";
@@ -194,13 +241,21 @@ void ExecutionEngine::Link(const ir::Module &module) {
     VLOG(5) << "function: " << DumpToString(f);
   }
 
+  const size_t object_begin = buffer_.size();
   llvm::raw_svector_ostream rawstream(buffer_);
   llvm::legacy::PassManager pass_manager;
-  machine->addPassesToEmitFile(
+  target_machine_->addPassesToEmitFile(
       pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
   pass_manager.run(*m);
-
-  CHECK(AddModule(std::move(m), std::move(ctx)));
+  if (object_cache) {
+    // Add the object just stored instead of the module, so that the engine
+    // runs the same code as the engines that load it from the cache later.
+    llvm::StringRef object = llvm::StringRef(buffer_).drop_front(object_begin);
+    object_cache->Store(fingerprint, object);
+    CHECK(AddObject(llvm::MemoryBuffer::getMemBufferCopy(object)));
+  } else {
+    CHECK(AddModule(std::move(m), std::move(ctx)));
+  }
 
   if (VLOG_IS_ON(5)) {
     VLOG(5) << "======= dump jit execution session ======";
@@ -232,6 +287,12 @@ bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module,
   return true;
 }
 
+bool ExecutionEngine::AddObject(std::unique_ptr<llvm::MemoryBuffer> object) {
+  utils::RecordEvent("ExecutionEngine AddObject", utils::EventType::kOrdinary);
+  llvm::cantFail(jit_->addObjectFile(std::move(object)));
+  return true;
+}
+
 void ExecutionEngine::ExportObject(const std::string &path) {
   FILE *of = fopen(path.c_str(), "w");
   fwrite(buffer_.data(), 1, buffer_.size(), of);
@@ -35,6 +35,7 @@
 #include <llvm/Support/SmallVectorMemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
 
 #include <functional>
 #include <memory>
@@ -45,6 +46,7 @@
 
 #include "paddle/cinn/backends/llvm/codegen_x86.h"
 #include "paddle/cinn/backends/llvm/llvm_util.h"
+#include "paddle/cinn/backends/llvm/persistent_object_cache.h"
 #include "paddle/cinn/backends/llvm/runtime_symbol_registry.h"
 #include "paddle/cinn/ir/module.h"
 
@@ -86,6 +88,8 @@ class ExecutionEngine {
   bool AddModule(std::unique_ptr<llvm::Module> module,
                  std::unique_ptr<llvm::LLVMContext> context);
 
+  bool AddObject(std::unique_ptr<llvm::MemoryBuffer> object);
+
  protected:
   explicit ExecutionEngine(bool enable_object_cache,
                            RuntimeSymbols &&module_symbols)
@@ -103,6 +107,9 @@ class ExecutionEngine {
  private:
   mutable std::mutex mu_;
   llvm::SmallString<0> buffer_;
+  ExecutionOptions options_;
+  // The target machine of the jit, also used by Link to emit the objects.
+  std::unique_ptr<llvm::TargetMachine> target_machine_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
   RuntimeSymbols module_symbols_;
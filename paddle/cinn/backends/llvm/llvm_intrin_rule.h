@@ -83,6 +83,13 @@ void RegisterCpuIntrinRule() {
   ir::Registry::Register("lower_cpu_intrinsic_isnan", true)
       .SetBody(MakeFloatIntrinOp<-1, 1, false>);
 
+  // the horizontal reductions of the vectors emitted by VectorizeLoops
+  for (auto reduce : {"add", "mul", "max", "min"}) {
+    ir::Registry::Register(
+        std::string("lower_cpu_intrinsic_vector_reduce_") + reduce, true)
+        .SetBody(MakeFloatIntrinOp<-1, 1, false>);
+  }
+
   ir::Registry::Register("lower_cpu_intrinsic_isfinite", true)
       .SetBody([](lang::Args args, lang::RetValue *rv) {
         CHECK_GE(args.size(), 1U);
@@ -0,0 +1,216 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/backends/llvm/persistent_object_cache.h"
+
+#include <glog/logging.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <thread>  // NOLINT
+
+#include "paddle/cinn/ir/ir_printer.h"
+#include "paddle/cinn/runtime/flags.h"
+
+PD_DECLARE_string(cinn_compile_cache_dir);
+
+namespace cinn::backends {
+namespace {
+
+constexpr char kEntryMagic[8] = {'C', 'I', 'N', 'N', 'O', 'B', 'J', '1'};
+
+// The layout of the header in front of every cached object.
+struct EntryHeader {
+  char magic[8];
+  uint64_t fingerprint_hash;
+  uint64_t object_size;
+  uint64_t object_hash;
+};
+
+}  // namespace
+
+PersistentObjectCache::PersistentObjectCache(const std::string &cache_dir)
+    : cache_dir_(cache_dir) {
+  if (auto ec = llvm::sys::fs::create_directories(cache_dir_)) {
+    LOG(WARNING) << "Failed to create the CINN compile cache directory "
+                 << cache_dir_ << ": " << ec.message();
+  }
+}
+
+/*static*/ PersistentObjectCache *PersistentObjectCache::Global() {
+  if (FLAGS_cinn_compile_cache_dir.empty()) return nullptr;
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<PersistentObjectCache>> caches;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &cache = caches[FLAGS_cinn_compile_cache_dir];
+  if (!cache) {
+    cache =
+        std::make_unique<PersistentObjectCache>(FLAGS_cinn_compile_cache_dir);
+  }
+  return cache.get();
+}
+
+/*static*/ std::string PersistentObjectCache::ModuleFingerprint(
+    const ir::Module &module) {
+  // The module name is generated per process, so it is left out.
+  std::stringstream ss;
+  ss << "target: " << module->target << "\n";
+  for (auto &buffer : module->buffers) {
+    ss << "buffer: " << buffer << "\n";
+  }
+  for (auto &expr : module->functions) {
+    auto *func = expr.as_lowered_func();
+    CHECK(func);
+    ss << "function: " << func->name << "\n";
+    for (auto &arg : func->args) {
+      ss << "arg: " << arg.human_readable() << " " << arg.type();
+      if (arg.is_buffer()) {
+        ss << " " << arg.buffer_arg()->shape;
+      }
+      ss << "\n";
+    }
+    for (auto &buffer : func->temp_bufs) {
+      ss << "temp: " << buffer->name << " " << buffer->dtype << " "
+         << buffer->shape << "\n";
+    }
+    ss << "axis: " << func->cuda_axis_info << "\n";
+    ss << "prepare: " << func->argument_prepare_exprs << "\n";
+    ss << "alloc: " << func->alloc_output_buffer_exprs << "\n";
+    ss << "cast: " << func->buffer_data_cast_exprs << "\n";
+    ss << "dealloc: " << func->dealloc_output_buffer_exprs << "\n";
+    ss << "body: " << func->body << "\n";
+  }
+  return ss.str();
+}
+
+std::string PersistentObjectCache::PathOf(
+    const std::string &fingerprint) const {
+  llvm::SHA1 sha1;
+  sha1.update(fingerprint);
+  return cache_dir_ + "/" + llvm::toHex(sha1.final(), /*LowerCase=*/true) +
+         ".o";
+}
+
+std::unique_ptr<llvm::MemoryBuffer> PersistentObjectCache::Load(
+    const std::string &fingerprint) {
+  auto path = PathOf(fingerprint);
+  auto file = llvm::MemoryBuffer::getFile(
+      path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (!file) {
+    ++misses_;
+    return nullptr;
+  }
+
+  auto drop = [&](const char *reason) {
+    LOG(WARNING) << "Drop the invalid CINN compile cache entry " << path
+                 << ": " << reason;
+    llvm::sys::fs::remove(path);
+    ++invalid_;
+    ++misses_;
+    return nullptr;
+  };
+
+  llvm::StringRef content = (*file)->getBuffer();
+  EntryHeader header;
+  if (content.size() < sizeof(header)) return drop("truncated header");
+  std::memcpy(&header, content.data(), sizeof(header));
+  if (std::memcmp(header.magic, kEntryMagic, sizeof(kEntryMagic)) != 0) {
+    return drop("bad magic");
+  }
+  if (header.fingerprint_hash != llvm::xxHash64(fingerprint)) {
+    return drop("fingerprint mismatch");
+  }
+  llvm::StringRef object = content.drop_front(sizeof(header));
+  if (object.size() != header.object_size) return drop("truncated object");
+  if (header.object_hash != llvm::xxHash64(object)) {
+    return drop("checksum mismatch");
+  }
+
+  auto buffer = llvm::MemoryBuffer::getMemBufferCopy(object, path);
+  auto object_file =
+      llvm::object::ObjectFile::createObjectFile(buffer->getMemBufferRef());
+  if (!object_file) {
+    llvm::consumeError(object_file.takeError());
+    return drop("not an object file");
+  }
+
+  VLOG(3) << "Object loaded from CINN compile cache " << path;
+  ++hits_;
+  return buffer;
+}
+
+void PersistentObjectCache::Store(const std::string &fingerprint,
+                                  llvm::StringRef object) {
+  auto path = PathOf(fingerprint);
+  EntryHeader header;
+  std::memcpy(header.magic, kEntryMagic, sizeof(kEntryMagic));
+  header.fingerprint_hash = llvm::xxHash64(fingerprint);
+  header.object_size = object.size();
+  header.object_hash = llvm::xxHash64(object);
+
+  // Write a temporary file first and rename it, so that concurrent readers
+  // never see a partially written entry.
+  auto thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+  auto tmp_path = path + ".tmp." +
+                  std::to_string(llvm::sys::Process::getProcessId()) + "." +
+                  std::to_string(thread_id);
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(tmp_path, ec, llvm::sys::fs::OF_None);
+    if (ec) {
+      LOG(WARNING) << "Failed to write the CINN compile cache entry "
+                   << tmp_path << ": " << ec.message();
+      return;
+    }
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os << object;
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(tmp_path);
+      LOG(WARNING) << "Failed to write the CINN compile cache entry "
+                   << tmp_path;
+      return;
+    }
+  }
+  if (auto ec = llvm::sys::fs::rename(tmp_path, path)) {
+    llvm::sys::fs::remove(tmp_path);
+    LOG(WARNING) << "Failed to commit the CINN compile cache entry " << path
+                 << ": " << ec.message();
+    return;
+  }
+  VLOG(3) << "Object stored into CINN compile cache " << path;
+  ++stores_;
+}
+
+PersistentObjectCache::Stats PersistentObjectCache::GetStats() const {
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.stores = stores_;
+  stats.invalid = invalid_;
+  return stats;
+}
+
+}  // namespace cinn::backends
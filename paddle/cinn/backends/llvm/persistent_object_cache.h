@@ -0,0 +1,77 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "paddle/cinn/ir/module.h"
+
+namespace cinn::backends {
+
+/**
+ * A content addressed cache of the object files compiled by ExecutionEngine.
+ *
+ * The objects are stored in a local directory, named after the SHA1 of a
+ * fingerprint that covers the lowered module, the code generator, the target
+ * machine and the options of the engine. Every file carries the hash of its
+ * fingerprint and of its content, a file that does not match is ignored and
+ * removed, so a corrupted or truncated entry only costs a recompilation.
+ *
+ * Use FLAGS_cinn_compile_cache_dir to enable the cache of Global().
+ */
+class PersistentObjectCache {
+ public:
+  struct Stats {
+    size_t hits{0};
+    size_t misses{0};
+    size_t stores{0};
+    //! The entries found but dropped by the validation.
+    size_t invalid{0};
+  };
+
+  explicit PersistentObjectCache(const std::string &cache_dir);
+
+  //! The cache in FLAGS_cinn_compile_cache_dir, nullptr if the flag is empty.
+  static PersistentObjectCache *Global();
+
+  //! Serialize everything in \p module that the generated code depends on.
+  static std::string ModuleFingerprint(const ir::Module &module);
+
+  //! Load the object compiled for \p fingerprint, nullptr on a miss.
+  std::unique_ptr<llvm::MemoryBuffer> Load(const std::string &fingerprint);
+
+  //! Store the object compiled for \p fingerprint, errors are only logged.
+  void Store(const std::string &fingerprint, llvm::StringRef object);
+
+  Stats GetStats() const;
+
+  const std::string &cache_dir() const { return cache_dir_; }
+
+ private:
+  std::string PathOf(const std::string &fingerprint) const;
+
+  std::string cache_dir_;
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+  std::atomic<size_t> stores_{0};
+  std::atomic<size_t> invalid_{0};
+};
+
+}  // namespace cinn::backends
@@ -0,0 +1,132 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/backends/llvm/persistent_object_cache.h"
+
+#include <gtest/gtest.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Process.h>
+
+#include <fstream>
+#include <string>
+
+#include "paddle/cinn/backends/llvm/execution_engine.h"
+#include "paddle/cinn/cinn.h"
+#include "paddle/cinn/common/test_helper.h"
+#include "paddle/cinn/runtime/cinn_runtime.h"
+#include "paddle/cinn/runtime/flags.h"
+#include "paddle/cinn/utils/timer.h"
+
+PD_DECLARE_string(cinn_compile_cache_dir);
+
+namespace cinn {
+namespace backends {
+
+ir::Module CreateAddModule() {
+  Expr M(1024);
+  Placeholder<float> A("A", {M});
+  Placeholder<float> B("B", {M});
+  auto C = Compute(
+      {M}, [&](Expr i) { return A(i) + B(i); }, "C");
+  auto stages = CreateStages({C});
+  auto fn = Lower("fn_add", stages, {A, B, C});
+
+  Module::Builder builder("module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+  return builder.Build();
+}
+
+// Link the module into a new engine and check the result of the function.
+float LinkAndRun(const ir::Module& module,
+                 const ExecutionOptions& options = ExecutionOptions()) {
+  utils::Timer timer;
+  timer.Start();
+  auto engine = ExecutionEngine::Create(options);
+  engine->Link<CodeGenX86>(module);
+  auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(engine->Lookup("fn_add"));
+  float link_ms = timer.Stop();
+  CHECK(fn_ptr);
+
+  auto* A_buf = common::BufferBuilder(Float(32), {1024}).set_random().Build();
+  auto* B_buf = common::BufferBuilder(Float(32), {1024}).set_random().Build();
+  auto* C_buf = common::BufferBuilder(Float(32), {1024}).set_zero().Build();
+  auto args = common::ArgsBuilder().Add(A_buf).Add(B_buf).Add(C_buf).Build();
+  fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+
+  auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+  auto* B_data = reinterpret_cast<float*>(B_buf->memory);
+  auto* C_data = reinterpret_cast<float*>(C_buf->memory);
+  for (int i = 0; i < C_buf->num_elements(); i++) {
+    EXPECT_NEAR(A_data[i] + B_data[i], C_data[i], 1e-5);
+  }
+  return link_ms;
+}
+
+TEST(PersistentObjectCache, LinkFromCache) {
+  std::string cache_dir = "/tmp/cinn_compile_cache_test_" +
+                          std::to_string(llvm::sys::Process::getProcessId());
+  llvm::sys::fs::remove_directories(cache_dir);
+  FLAGS_cinn_compile_cache_dir = cache_dir;
+  auto* cache = PersistentObjectCache::Global();
+  ASSERT_NE(cache, nullptr);
+
+  auto module = CreateAddModule();
+  float cold_ms = LinkAndRun(module);
+  auto stats = cache->GetStats();
+  EXPECT_EQ(stats.hits, 0UL);
+  EXPECT_EQ(stats.misses, 1UL);
+  EXPECT_EQ(stats.stores, 1UL);
+
+  // A new engine, as in a restarted process, loads the object from the cache.
+  float warm_ms = LinkAndRun(module);
+  stats = cache->GetStats();
+  EXPECT_EQ(stats.hits, 1UL);
+  EXPECT_EQ(stats.misses, 1UL);
+  LOG(INFO) << "link cold: " << cold_ms << " ms, warm: " << warm_ms << " ms";
+
+  // Corrupt the entry, it is dropped and the module is compiled again.
+  std::error_code ec;
+  for (llvm::sys::fs::directory_iterator it(cache_dir, ec), end;
+       it != end && !ec;
+       it.increment(ec)) {
+    std::fstream file(it->path(),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(64);
+    file.write("corrupted", 9);
+  }
+  LinkAndRun(module);
+  stats = cache->GetStats();
+  EXPECT_EQ(stats.hits, 1UL);
+  EXPECT_EQ(stats.misses, 2UL);
+  EXPECT_EQ(stats.invalid, 1UL);
+  EXPECT_EQ(stats.stores, 2UL);
+
+  // The options of the engine are part of the key.
+  ExecutionOptions options;
+  options.opt_level = 2;
+  LinkAndRun(module, options);
+  stats = cache->GetStats();
+  EXPECT_EQ(stats.hits, 1UL);
+  EXPECT_EQ(stats.misses, 3UL);
+  EXPECT_EQ(stats.stores, 3UL);
+  LinkAndRun(module, options);
+  EXPECT_EQ(cache->GetStats().hits, 2UL);
+
+  FLAGS_cinn_compile_cache_dir = "";
+  EXPECT_EQ(PersistentObjectCache::Global(), nullptr);
+  llvm::sys::fs::remove_directories(cache_dir);
+}
+
+}  // namespace backends
+}  // namespace cinn
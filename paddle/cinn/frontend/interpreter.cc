@@ -26,6 +26,7 @@
 #include "paddle/cinn/runtime/flags.h"
 
 PD_DECLARE_bool(enable_auto_tuner);
+PD_DECLARE_bool(cinn_plan_buffer_reuse);
 
 namespace cinn::frontend {
 
@@ -123,6 +124,7 @@ void Interpreter::Impl::Build(const Target& target,
 
   hlir::framework::CompilationContext context(graph, scope_, target);
   context.with_instantiate_variables = true;
+  context.with_buffer_reuse_planned = FLAGS_cinn_plan_buffer_reuse;
   if (FLAGS_enable_auto_tuner) {
     VLOG(4) << "Compile with auto-tune";
     auto_schedule::AutoTuner auto_tuner(target, graph.get());
@@ -56,11 +56,25 @@ struct Buffer final {
 
   void SetTarget(const common::Target& target);
 
+  //! Use the \p size bytes at \p offset of \p arena instead of owning a
+  //! memory, the arena is kept alive until this buffer is resized or freed.
+  void ShareArena(const std::shared_ptr<Buffer>& arena,
+                  uint32_t offset,
+                  uint32_t size);
+
+  //! Number of bytes of the memory.
+  uint32_t size() const { return size_; }
+
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
   //! Free all the memory owned by this buffer.
   void Free() {
+    if (arena_) {
+      arena_.reset();
+      data_.memory = nullptr;
+      return;
+    }
     if (!data_.memory) return;
     memory_mng_cache_->free(data_.memory);
   }
@@ -88,6 +102,9 @@ struct Buffer final {
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! The arena holding the memory, if the memory is not owned.
+  std::shared_ptr<Buffer> arena_;
 };
 
 }  // namespace framework
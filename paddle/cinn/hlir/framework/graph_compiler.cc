@@ -16,6 +16,7 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
 #include <memory>
 #include <unordered_set>
 
@@ -56,7 +57,12 @@ CompilationResult GraphCompiler::Build(CompilationContext* context) {
   // write group's information into FLAGS_cinn_fusion_groups_graphviz_dir
   context->graph->VisualizeGroupedGraph(context->fetch_var_ids);
 
-  if (context->with_instantiate_variables) {
+  // The planned variables are instantiated after the instructions are built,
+  // since the plan depends on the arguments of the instructions.
+  bool plan_buffer_reuse = context->with_instantiate_variables &&
+                           context->with_buffer_reuse_planned &&
+                           !context->with_buffer_handle_instruction_inserted;
+  if (context->with_instantiate_variables && !plan_buffer_reuse) {
     InstantiateVariables(context);
   }
 
@@ -68,6 +74,9 @@ CompilationResult GraphCompiler::Build(CompilationContext* context) {
   CompilationResult result = (*parallel_compiler_.get())();
 
   if (context->stage != CompilationStage::DEFAULT || !result.IsSuccess()) {
+    if (plan_buffer_reuse) {
+      InstantiateVariables(context);
+    }
     return result;
   }
 
@@ -75,14 +84,22 @@ CompilationResult GraphCompiler::Build(CompilationContext* context) {
     RemoveInvalidVariables(context, result.RuntimeInstructions());
   }
 
+  std::shared_ptr<Buffer> buffer_arena;
+  if (plan_buffer_reuse) {
+    buffer_arena = PlanBufferReuse(context, result.RuntimeInstructions());
+    InstantiateVariables(context);
+  }
+
   if (context->with_buffer_handle_instruction_inserted) {
     VLOG(3) << "option.with_buffer_handle_instruction_inserted enable";
     InsertBufferHandlers(context, &result.instructions_);
   }
   VLOG(2) << "Compile With Parallel Compiler Done!";
 
-  result.SetRuntimeProgram(std::make_unique<Program>(
-      context->scope, std::move(result.instructions_)));
+  auto program = std::make_unique<Program>(context->scope,
+                                           std::move(result.instructions_));
+  program->SetBufferArena(buffer_arena);
+  result.SetRuntimeProgram(std::move(program));
   return result;
 }
 
@@ -258,6 +275,131 @@ void GraphCompiler::AnalyzeVariableLifeTime(
   }
 }
 
+std::shared_ptr<Buffer> GraphCompiler::PlanBufferReuse(
+    CompilationContext* context,
+    const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  utils::RecordEvent("GraphCompiler PlanBufferReuse",
+                     utils::EventType::kOrdinary);
+  // The offsets are aligned to the cache line, which also meets the alignment
+  // of the vector instructions.
+  constexpr uint32_t kOffsetAlignment = 64;
+
+  // The variables that must keep their values after the program finishes, or
+  // are filled before it starts, are never placed in the arena.
+  std::unordered_set<std::string> excluded(context->fetch_var_ids.begin(),
+                                           context->fetch_var_ids.end());
+  for (auto* output : context->graph->outputs) {
+    excluded.insert(output->id());
+  }
+  for (const auto& reuse : context->reuse_vars_map) {
+    excluded.insert(reuse.first);
+    excluded.insert(reuse.second);
+  }
+
+  struct LiveRange {
+    int first_step;
+    int last_step;
+    bool written_first;
+    bool read;
+  };
+  absl::flat_hash_map<std::string, LiveRange> ranges;
+  for (int step = 0; step < instructions.size(); ++step) {
+    const auto& instr = instructions.at(step);
+    auto visit = [&](const std::vector<std::vector<std::string>>& args_list,
+                     bool is_output) {
+      for (const auto& args : args_list) {
+        for (const auto& var_name : args) {
+          // the results of the pre-run functions are computed only once
+          if (instr->pre_run || utils::Startswith(var_name, "kernel_pack")) {
+            excluded.insert(var_name);
+          }
+          auto it = ranges.try_emplace(
+              var_name, LiveRange{step, step, is_output, false});
+          if (!it.second && it.first->second.first_step == step) {
+            it.first->second.written_first &= is_output;
+          }
+          it.first->second.last_step = step;
+          it.first->second.read |= !is_output;
+        }
+      }
+    };
+    visit(instr->GetInArgs(), false);
+    visit(instr->GetOutArgs(), true);
+  }
+
+  struct ArenaBlock {
+    std::string var_name;
+    LiveRange range;
+    uint32_t size;
+    uint32_t offset;
+  };
+  std::vector<ArenaBlock> blocks;
+  size_t unplanned_size = 0;
+  for (const auto& item : ranges) {
+    const auto& range = item.second;
+    // a variable never read after it is written is an output of the program
+    if (excluded.count(item.first) || !range.written_first || !range.read) {
+      continue;
+    }
+    auto* var = context->scope->FindVar(item.first);
+    if (!var) continue;
+    auto& tensor = absl::get<Tensor>(*var);
+    uint32_t size = tensor->shape().numel() * tensor->type().bytes();
+    if (size == 0) continue;
+    unplanned_size += size;
+    size = (size + kOffsetAlignment - 1) / kOffsetAlignment * kOffsetAlignment;
+    blocks.push_back(ArenaBlock{item.first, range, size, 0});
+  }
+  if (blocks.empty()) return nullptr;
+
+  // Place the larger blocks first, each at the lowest offset that does not
+  // overlap with a placed block alive at the same time.
+  std::sort(blocks.begin(),
+            blocks.end(),
+            [](const ArenaBlock& a, const ArenaBlock& b) {
+              if (a.size != b.size) return a.size > b.size;
+              return a.range.first_step < b.range.first_step;
+            });
+  uint32_t arena_size = 0;
+  std::vector<const ArenaBlock*> placed;
+  for (auto& block : blocks) {
+    std::vector<const ArenaBlock*> alive;
+    for (const auto* other : placed) {
+      if (other->range.first_step <= block.range.last_step &&
+          block.range.first_step <= other->range.last_step) {
+        alive.push_back(other);
+      }
+    }
+    std::sort(alive.begin(),
+              alive.end(),
+              [](const ArenaBlock* a, const ArenaBlock* b) {
+                return a->offset < b->offset;
+              });
+    uint32_t offset = 0;
+    for (const auto* other : alive) {
+      if (offset + block.size <= other->offset) break;
+      offset = std::max(offset, other->offset + other->size);
+    }
+    block.offset = offset;
+    arena_size = std::max(arena_size, offset + block.size);
+    placed.push_back(&block);
+  }
+
+  auto arena = std::make_shared<Buffer>(context->target);
+  arena->Resize(1024, arena_size);
+  for (const auto& block : blocks) {
+    auto& tensor = absl::get<Tensor>(*context->scope->FindVar(block.var_name));
+    auto buffer = std::make_shared<Buffer>();
+    buffer->ShareArena(arena, block.offset, block.size);
+    tensor->set_buffer(buffer);
+    tensor->Resize(tensor->shape());
+  }
+  VLOG(2) << "Plan " << blocks.size() << " temporary variables into an arena"
+          << " of " << arena_size << " bytes, " << unplanned_size
+          << " bytes without reuse";
+  return arena;
+}
+
 void GraphCompiler::InsertBufferHandlers(
     CompilationContext* context,
     std::vector<std::unique_ptr<Instruction>>* instructions) {
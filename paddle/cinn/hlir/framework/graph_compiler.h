@@ -92,6 +92,14 @@ class GraphCompiler final {
       std::unordered_map<int, std::vector<std::string>>* step2malloc,
       std::unordered_map<int, std::vector<std::string>>* step2free);
 
+  // place the temporary variables, which are written before read and are not
+  // the outputs of the graph, at the offsets of a single arena, the variables
+  // whose lifetimes do not overlap may share the memory. Return the arena, or
+  // nullptr if there is no temporary variable.
+  std::shared_ptr<Buffer> PlanBufferReuse(
+      CompilationContext* context,
+      const std::vector<std::unique_ptr<Instruction>>& instructions);
+
   // insert a buffer malloc instruction applying on variables before they are
   // firstly used in the next instruction, and insert a buffer free instruction
   // applying on variables after no instruction will use them anymore
@@ -25,6 +25,7 @@
 #include "paddle/cinn/hlir/op/use_ops.h"
 #include "paddle/cinn/hlir/pass/use_pass.h"
 #include "paddle/cinn/utils/data_util.h"
+#include "paddle/cinn/utils/timer.h"
 
 namespace cinn {
 namespace hlir {
@@ -132,6 +133,116 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+// The bytes of the memory held by the variables in scope, where the variables
+// in the arena of the program are counted as the size of the arena.
+size_t HeldBytes(Scope* scope, Program* program) {
+  const auto& arena = program->GetBufferArena();
+  size_t bytes = arena ? arena->size() : 0;
+  std::unordered_set<Buffer*> counted;
+  for (auto& name : scope->var_names()) {
+    auto buffer = scope->GetTensor(std::string(name))->get_buffer();
+    auto* memory = buffer->data()->memory;
+    if (arena && memory >= arena->data()->memory &&
+        memory < arena->data()->memory + arena->size()) {
+      continue;
+    }
+    if (counted.insert(buffer.get()).second) bytes += buffer->size();
+  }
+  return bytes;
+}
+
+struct BufferPlanResult {
+  std::vector<float> output;
+  size_t held_bytes;
+};
+
+// Runs the program built from the non-fused graph of \p program, with or
+// without the buffer reuse planned.
+BufferPlanResult RunWithBufferPlan(
+    frontend::Program* program,
+    const std::vector<std::string>& inputs,
+    const std::string& output,
+    bool plan) {
+  auto target = common::DefaultHostTarget();
+  auto graph = std::make_shared<Graph>(*program, target);
+  auto scope = BuildScope(target, graph);
+
+  CompilationContext context(graph, scope, target);
+  context.with_instantiate_variables = true;
+  context.with_buffer_reuse_planned = plan;
+  context.fetch_var_ids = {output};
+  GraphCompiler gc(context);
+  auto runtime_program = gc.Build(&context).RuntimeProgram();
+  EXPECT_EQ(runtime_program->GetBufferArena() != nullptr, plan);
+
+  for (int i = 0; i < inputs.size(); ++i) {
+    SetRandData<float>(scope->GetTensor(inputs[i]), target, i + 1);
+  }
+  runtime_program->Execute();
+  constexpr int kRepeat = 10;
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < kRepeat; ++i) {
+    runtime_program->Execute();
+  }
+  float run_ms = timer.Stop() / kRepeat;
+
+  size_t held_bytes = HeldBytes(scope.get(), runtime_program.get());
+  LOG(INFO) << program->size() << " ops, buffer reuse "
+            << (plan ? "planned" : "not planned") << ", memory: " << held_bytes
+            << " bytes, run: " << run_ms << " ms";
+  return {GetTensorData<float>(scope->GetTensor(output), target), held_bytes};
+}
+
+void CheckBufferPlan(frontend::Program* program,
+                     const std::vector<std::string>& inputs,
+                     const std::string& output) {
+  auto unplanned = RunWithBufferPlan(program, inputs, output, false);
+  auto planned = RunWithBufferPlan(program, inputs, output, true);
+  // The temporaries of the blocks share the arena.
+  EXPECT_LT(planned.held_bytes, unplanned.held_bytes);
+  const auto& expect = unplanned.output;
+  const auto& actual = planned.output;
+  ASSERT_EQ(expect.size(), actual.size());
+  for (int i = 0; i < expect.size(); ++i) {
+    ASSERT_FLOAT_EQ(expect[i], actual[i]) << "at " << i;
+  }
+}
+
+TEST(GraphCompilerTest, TestBufferReuseResNetBlocks) {
+  // The residual blocks of scale, bias and relu on the feature maps.
+  frontend::NetBuilder builder("test_buffer_reuse_resnet");
+  auto x = builder.CreateInput(Float(32), {1, 64, 56, 56}, "X");
+  auto scale = builder.CreateInput(Float(32), {64}, "Scale");
+  auto bias = builder.CreateInput(Float(32), {64}, "Bias");
+  frontend::Variable out = x;
+  for (int i = 0; i < 4; ++i) {
+    auto y = builder.Relu(
+        builder.Add(builder.Multiply(out, scale, 1), bias, 1));
+    auto z = builder.Add(builder.Multiply(y, scale, 1), bias, 1);
+    out = builder.Relu(builder.Add(z, out));
+  }
+  auto program = builder.Build();
+  CheckBufferPlan(&program, {"X", "Scale", "Bias"}, out->id);
+}
+
+TEST(GraphCompilerTest, TestBufferReuseBertLayers) {
+  // The feed forward layers with residual connections and a softmax.
+  frontend::NetBuilder builder("test_buffer_reuse_bert");
+  auto x = builder.CreateInput(Float(32), {64, 256}, "X");
+  auto w1 = builder.CreateInput(Float(32), {256, 512}, "W1");
+  auto b1 = builder.CreateInput(Float(32), {512}, "B1");
+  auto w2 = builder.CreateInput(Float(32), {512, 256}, "W2");
+  frontend::Variable out = x;
+  for (int i = 0; i < 2; ++i) {
+    auto h = builder.Relu(builder.Add(builder.Matmul(out, w1), b1, 1));
+    out = builder.Add(builder.Matmul(h, w2), out);
+  }
+  out = builder.Softmax(out, {1});
+  auto program = builder.Build();
+  CheckBufferPlan(&program, {"X", "W1", "B1", "W2"}, out->id);
+}
+
 #ifdef CINN_WITH_CUDA
 std::vector<float> test_mul(const std::vector<float>& A,
                             const std::vector<float>& B,
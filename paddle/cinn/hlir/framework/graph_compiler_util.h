@@ -68,6 +68,10 @@ struct CompilationContext {
   bool with_instantiate_variables = false;
   bool with_buffer_handle_instruction_inserted = false;
   bool remove_unused_variables = true;
+  // Place the temporary variables into a single arena allocated once, where
+  // the variables whose lifetimes do not overlap share the memory. It only
+  // takes effect with with_instantiate_variables.
+  bool with_buffer_reuse_planned = false;
   // Compile stage, full compile by default.
   CompilationStage stage = CompilationStage::DEFAULT;
   // Compile target.
@@ -23,6 +23,7 @@
 #include "paddle/cinn/backends/codegen_cuda_util.h"
 #include "paddle/cinn/backends/compiler.h"
 #include "paddle/cinn/backends/llvm/codegen_x86.h"
+#include "paddle/cinn/backends/llvm/persistent_object_cache.h"
 #include "paddle/cinn/backends/llvm/runtime_symbol_registry.h"
 #include "paddle/cinn/backends/nvrtc/nvrtc_util.h"
 #include "paddle/cinn/common/context.h"
@@ -32,6 +33,7 @@
 #include "paddle/cinn/hlir/framework/pass.h"
 #include "paddle/cinn/ir/module.h"
 #include "paddle/cinn/runtime/flags.h"
+#include "paddle/cinn/utils/timer.h"
 
 PD_DECLARE_int32(cinn_parallel_compile_thread);
 
@@ -70,7 +72,23 @@ CompilationResult ParallelCompiler::operator()() {
   // task spilt
   SplitTask();
   // launch task
+  auto* object_cache = backends::PersistentObjectCache::Global();
+  backends::PersistentObjectCache::Stats stats_before;
+  if (object_cache) {
+    stats_before = object_cache->GetStats();
+  }
+  utils::Timer timer;
+  timer.Start();
   LaunchTask();
+  float compile_ms = timer.Stop();
+  if (object_cache) {
+    auto stats = object_cache->GetStats();
+    LOG(INFO) << "Compile " << tasks_.size() << " groups in " << compile_ms
+              << " ms, compile cache " << object_cache->cache_dir()
+              << ": hits = " << stats.hits - stats_before.hits
+              << ", misses = " << stats.misses - stats_before.misses
+              << ", invalid = " << stats.invalid - stats_before.invalid;
+  }
   // return compilation result
   return std::move(result_);
 }
@@ -64,6 +64,18 @@ class Program {
     return instrs_;
   }
 
+  /**
+   * Set the arena holding the temporary variables planned by GraphCompiler,
+   * so that no instruction allocates them during the execution.
+   */
+  void SetBufferArena(const std::shared_ptr<Buffer>& arena) {
+    buffer_arena_ = arena;
+  }
+  //! The arena of the temporary variables, nullptr if not planned.
+  const std::shared_ptr<Buffer>& GetBufferArena() const {
+    return buffer_arena_;
+  }
+
  private:
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
@@ -71,6 +83,8 @@ class Program {
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+  // the memory shared by the planned temporary variables
+  std::shared_ptr<Buffer> buffer_arena_;
 };
 
 }  // namespace framework
@@ -28,7 +28,10 @@ static const std::set<std::string> kIntrinsicCalls{
      "cos",         "cosh",        "tan",        "tanh",        "sin",
      "sinh",        "fabs",        "isnan",      "isfinite",    "isinf",
      "left_shift",  "right_shift", "bitwise_or", "bitwise_and", "bitwise_xor",
-     "bitwise_not", "fma",         "rsqrt"}};
+     "bitwise_not", "fma",         "rsqrt",
+     // the horizontal reductions of the vectors emitted by VectorizeLoops
+     "vector_reduce_add", "vector_reduce_mul", "vector_reduce_max",
+     "vector_reduce_min"}};
 
 /**
  * Map the Call nodes to llvm intrinsic.
@@ -21,16 +21,19 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "paddle/cinn/common/cas.h"
 #include "paddle/cinn/common/ir_util.h"
 #include "paddle/cinn/ir/ir_printer.h"
 #include "paddle/cinn/ir/op/ir_operators.h"
+#include "paddle/cinn/ir/utils/ir_compare.h"
 #include "paddle/cinn/ir/utils/ir_copy.h"
 #include "paddle/cinn/ir/utils/ir_nodes_collector.h"
 #include "paddle/cinn/ir/utils/ir_replace.h"
 #include "paddle/cinn/optim/ir_simplify.h"
+#include "paddle/cinn/optim/replace_var_with_expr.h"
 #include "paddle/cinn/optim/unroll_loops.h"
 #include "paddle/cinn/utils/functional.h"
 
@@ -364,12 +367,20 @@ class Vectorizer : public IRMutator<Expr *> {
   //! A suffix to attach to widened variables.
   std::string widen_suffix;
 
+  //! Whether to lower the reductions over the vectorized variable to the
+  //! horizontal reductions of the vectors, which needs the x86 intrinsics.
+  bool lower_reduction_{false};
+
  public:
   Vectorizer(const Var &var,
              int lanes,
              const absl::flat_hash_map<std::string, common::CasInterval>
-                 &var_intervals = {})
-      : var(var), lanes_(lanes), var_intervals_(var_intervals) {
+                 &var_intervals = {},
+             bool lower_reduction = false)
+      : var(var),
+        lanes_(lanes),
+        var_intervals_(var_intervals),
+        lower_reduction_(lower_reduction) {
     // the identity ramp.
     ramp_ = Ramp::Make(make_zero(), make_one(), lanes_);
   }
@@ -479,8 +490,34 @@ class Vectorizer : public IRMutator<Expr *> {
     *expr = Load::Make(node->tensor, new_indices);
   }
 
+  void Visit(const ScheduleBlockRealize *op, Expr *expr) override {
+    auto *node = expr->As<ScheduleBlockRealize>();
+    auto *block = node->schedule_block.As<ScheduleBlock>();
+    if (lower_reduction_ && block) {
+      // The loads and stores of a block only see the vectorized variable
+      // through its iter values, so inline them into a reduce block to lower
+      // the reduction in place.
+      Expr body = ir::ir_utils::IRCopy(block->body);
+      for (int i = 0; i < node->iter_values.size(); ++i) {
+        if (UseVar(node->iter_values[i])) {
+          ReplaceVarWithExpr(&body, block->iter_vars[i], node->iter_values[i]);
+        }
+      }
+      auto *stmts = body.As<Block>();
+      Expr store = stmts && stmts->stmts.size() == 1U ? stmts->stmts[0] : body;
+      if (store.As<Store>() && IsReduction(store.As<Store>())) {
+        block->body = body;
+      }
+    }
+    IRMutator::Visit(op, expr);
+  }
+
   void Visit(const Store *op, Expr *expr) override {
     auto *node = expr->As<Store>();
+    if (lower_reduction_ && IsReduction(node)) {
+      LowerReduction(node);
+      return;
+    }
     auto value0 = node->value;
     Visit(&node->value);
 
@@ -570,6 +607,74 @@ class Vectorizer : public IRMutator<Expr *> {
     ir::IRMutator<>::Visit(op, expr);
   }
 
+  bool UseVar(const Expr &e) const {
+    return !ir::ir_utils::CollectIRNodes(e, [&](const Expr *x) {
+              return x->as_var() && x->as_var()->name == var->name;
+            }).empty();
+  }
+
+  //! Whether \p e loads the element that \p store writes.
+  bool IsSelfLoad(const Store *store, const Expr &e) const {
+    auto *load = e.As<Load>();
+    if (!load || !load->tensor.as_tensor() || !store->tensor.as_tensor() ||
+        load->tensor.as_tensor()->name != store->tensor.as_tensor()->name ||
+        load->indices.size() != store->indices.size()) {
+      return false;
+    }
+    for (int i = 0; i < load->indices.size(); ++i) {
+      if (!ir::ir_utils::IRCompare(load->indices[i], store->indices[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //! Get the operand reduced into the store target by the binary op \p T,
+  //! nullptr if \p store is not such a reduction.
+  template <typename T>
+  Expr *ReducedOperand(Store *store) {
+    auto *node = store->value.As<T>();
+    if (!node) return nullptr;
+    if (IsSelfLoad(store, node->a())) return &node->b();
+    if (IsSelfLoad(store, node->b())) return &node->a();
+    return nullptr;
+  }
+
+  //! Whether \p store is a reduction such as `A[i] = A[i] + B[i, var]`, whose
+  //! indices do not depend on the vectorized variable.
+  bool IsReduction(const Store *store) {
+    for (auto &idx : store->indices) {
+      if (UseVar(idx)) return false;
+    }
+    if (!UseVar(store->value)) return false;
+    auto *node = const_cast<Store *>(store);
+    return ReducedOperand<Add>(node) || ReducedOperand<Mul>(node) ||
+           ReducedOperand<Max>(node) || ReducedOperand<Min>(node);
+  }
+
+  //! Vectorize the reduced operand of \p store and reduce its lanes
+  //! horizontally, e.g. `A[i] = A[i] + vector_reduce_add(B[i, Ramp])`.
+  void LowerReduction(Store *store) {
+    std::pair<Expr *, std::string> operands[] = {
+        {ReducedOperand<Add>(store), "vector_reduce_add"},
+        {ReducedOperand<Mul>(store), "vector_reduce_mul"},
+        {ReducedOperand<Max>(store), "vector_reduce_max"},
+        {ReducedOperand<Min>(store), "vector_reduce_min"}};
+    for (auto &operand : operands) {
+      if (!operand.first) continue;
+      Visit(operand.first);
+      Type type = operand.first->type();
+      if (type.lanes() > 1) {
+        *operand.first = Call::Make(type.ElementOf(),
+                                    operand.second,
+                                    {*operand.first},
+                                    {},
+                                    CallType::Intrinsic);
+      }
+      return;
+    }
+  }
+
   void Scalarize(Expr *expr) {
     Var idx(var->name + "_s", Int(32));
     std::map<const ir::_Var_ *, Expr> var_map;
@@ -762,6 +867,13 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       }
 
       const int factor = forloop->vectorize_info().factor;
+      if (target.arch == Target::Arch::X86 && node->extent.As<IntImm>() &&
+          node->extent.as_int32() % factor != 0) {
+        var_intervals.erase(loopvar_name);
+        SplitTailLoop(node, factor, expr);
+        IRMutator::Visit(expr, expr);
+        return;
+      }
       auto _new_forloop = SplitForLoop(node, factor);
       if (!_new_forloop.defined()) {
         IRMutator<>::Visit(&node->body, &node->body);
@@ -816,7 +928,10 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
         body_stmts.insert(
             body_stmts.end(), store_exprs.begin(), store_exprs.end());
       } else {
-        Vectorizer(new_forloop->loop_var, extent, var_intervals)
+        Vectorizer(new_forloop->loop_var,
+                   extent,
+                   var_intervals,
+                   target.arch == Target::Arch::X86)
             .Visit(&new_forloop->body);
       }
 
@@ -912,6 +1027,37 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     return false;
   }
 
+  //! Split the constant extent forloop that is not a multiple of \p factor
+  //! into a main loop vectorized by \p factor and a tail loop vectorized by
+  //! the remaining lanes, instead of running past the extent. The code
+  //! generator loads and stores the tail with masks on AVX-512, and falls
+  //! back to the narrower vector instructions otherwise.
+  void SplitTailLoop(For *forloop, int factor, Expr *expr) {
+    int extent = forloop->extent.as_int32();
+    int tail = extent % factor;
+    int main_extent = extent - tail;
+
+    Var tail_var(common::UniqName(forloop->loop_var->name + "_tail"));
+    Expr tail_body = ir::ir_utils::IRCopy(forloop->body);
+    cinn::ir::ir_utils::IrReplace(
+        &tail_body, forloop->loop_var, Expr(main_extent) + Expr(tail_var));
+    Expr tail_loop = For::Make(
+        tail_var,
+        make_zero(),
+        make_const(tail),
+        tail > 1 ? ForType::Vectorized : ForType::Serial,
+        forloop->device_api,
+        tail_body,
+        tail > 1 ? VectorizeInfo(forloop->vectorize_info().level, tail)
+                 : VectorizeInfo());
+    if (main_extent == 0) {
+      *expr = Block::Make({tail_loop});
+      return;
+    }
+    forloop->extent = make_const(main_extent);
+    *expr = Block::Make({*expr, tail_loop});
+  }
+
   //! Split the forloop with size \p factor.
   //! @return The new forloop.
   Expr SplitForLoop(For *forloop, int factor) {
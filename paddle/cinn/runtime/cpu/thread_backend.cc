@@ -15,6 +15,10 @@
 #include "paddle/cinn/runtime/cpu/thread_backend.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <vector>
 
 #ifdef CINN_USE_OPENMP
@@ -24,8 +28,11 @@
 #include "paddle/cinn/backends/extern_func_jit_register.h"
 #include "paddle/cinn/backends/llvm/runtime_symbol_registry.h"
 #include "paddle/cinn/common/cas.h"
+#include "paddle/cinn/runtime/flags.h"
 #include "paddle/cinn/runtime/intrinsic.h"
 
+PD_DECLARE_string(cinn_thread_backend);
+
 int max_concurrency() {
   int max_concurrency = 1;
   const char* val = getenv("CINN_NUM_THREADS");
@@ -43,13 +50,221 @@ int max_concurrency() {
   return std::max(max_concurrency, 1);
 }
 
-int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
-                                 void* datas,
-                                 int num_task) {
+namespace {
+
+/**
+ * A persistent pool running the tasks of one parallel launch at a time.
+ *
+ * The tasks of a launch are split into one contiguous range per worker, a
+ * worker runs the tasks of its own range from the front and, once it is
+ * empty, steals the back half of the range of another worker. The calling
+ * thread takes part as the worker 0, so the pool creates one thread less than
+ * the number of workers, and idle workers sleep instead of spinning so that
+ * they leave the cores to the intra-op threads of Paddle.
+ */
+class ParallelThreadPool {
+ public:
+  explicit ParallelThreadPool(int num_workers)
+      : num_workers_(num_workers), ranges_(new TaskRange[num_workers]) {
+    for (int i = 1; i < num_workers_; ++i) {
+      threads_.emplace_back(&ParallelThreadPool::WorkerLoop, this, i);
+    }
+  }
+
+  ~ParallelThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) thread.join();
+  }
+
+  static ParallelThreadPool* Global() {
+    static ParallelThreadPool pool(max_concurrency());
+    return &pool;
+  }
+
+  int num_workers() const { return num_workers_; }
+
+  // Returns false without running anything if the pool is busy with the
+  // launch of another thread.
+  bool Launch(FCINNParallelLambda flambda,
+              void* datas,
+              int num_task,
+              int* status) {
+    bool expected = false;
+    if (!busy_.compare_exchange_strong(expected, true)) return false;
+    {
+      // The workers still leaving the previous launch must not see this one
+      // half initialized.
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (active_workers_.load(std::memory_order_acquire) > 0) {
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+      }
+      flambda_ = flambda;
+      datas_ = datas;
+      num_task_ = num_task;
+      status_.store(0, std::memory_order_relaxed);
+      remaining_.store(num_task, std::memory_order_relaxed);
+      for (int i = 0; i < num_workers_; ++i) {
+        int64_t begin = static_cast<int64_t>(num_task) * i / num_workers_;
+        int64_t end = static_cast<int64_t>(num_task) * (i + 1) / num_workers_;
+        ranges_[i].range.store(Pack(begin, end), std::memory_order_release);
+      }
+      ++generation_;
+    }
+    cv_.notify_all();
+
+    RunTasks(0);
+    while (remaining_.load(std::memory_order_acquire) > 0) {
+      std::this_thread::yield();
+    }
+    *status = status_.load(std::memory_order_relaxed);
+    busy_.store(false, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // [begin, end) of the tasks left to a worker, packed in 64 bits.
+  struct alignas(64) TaskRange {
+    std::atomic<uint64_t> range{0};
+  };
+
+  static uint64_t Pack(uint64_t begin, uint64_t end) {
+    return (begin << 32) | end;
+  }
+  static uint32_t Begin(uint64_t range) { return range >> 32; }
+  static uint32_t End(uint64_t range) { return range & 0xffffffffu; }
+
+  bool PopFront(int worker, int* task) {
+    auto& range = ranges_[worker].range;
+    uint64_t old = range.load(std::memory_order_acquire);
+    while (Begin(old) < End(old)) {
+      if (range.compare_exchange_weak(old,
+                                      Pack(Begin(old) + 1, End(old)),
+                                      std::memory_order_acq_rel)) {
+        *task = Begin(old);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Steal(int thief, int* task) {
+    for (int i = 1; i < num_workers_; ++i) {
+      auto& range = ranges_[(thief + i) % num_workers_].range;
+      uint64_t old = range.load(std::memory_order_acquire);
+      while (Begin(old) < End(old)) {
+        uint32_t size = End(old) - Begin(old);
+        uint32_t mid = End(old) - std::max(size / 2, 1u);
+        if (range.compare_exchange_weak(
+                old, Pack(Begin(old), mid), std::memory_order_acq_rel)) {
+          // Nobody steals from an empty range, so the thief owns its range.
+          ranges_[thief].range.store(Pack(mid + 1, End(old)),
+                                     std::memory_order_release);
+          *task = mid;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void RunTasks(int worker) {
+    bool in_parallel = tls_in_parallel;
+    tls_in_parallel = true;
+    int task;
+    while (PopFront(worker, &task) || Steal(worker, &task)) {
+      if ((*flambda_)(task, num_task_, datas_) != 0) {
+        status_.store(-1, std::memory_order_relaxed);
+      }
+      remaining_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    tls_in_parallel = in_parallel;
+  }
+
+  void WorkerLoop(int worker) {
+    uint64_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+        active_workers_.fetch_add(1, std::memory_order_relaxed);
+      }
+      RunTasks(worker);
+      active_workers_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+ public:
+  // Whether the current thread runs a task of a parallel launch.
+  static thread_local bool tls_in_parallel;
+
+ private:
+  const int num_workers_;
+  std::unique_ptr<TaskRange[]> ranges_;
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t generation_{0};
+  bool stop_{false};
+  // The number of workers in RunTasks, only increased under mutex_.
+  std::atomic<int> active_workers_{0};
+
+  std::atomic<bool> busy_{false};
+  FCINNParallelLambda flambda_{nullptr};
+  void* datas_{nullptr};
+  int num_task_{0};
+  std::atomic<int> remaining_{0};
+  std::atomic<int> status_{0};
+};
+
+thread_local bool ParallelThreadPool::tls_in_parallel = false;
+
+// The number of tasks per worker when the number of tasks is left to the
+// backend, more tasks than workers balance the load between them.
+constexpr int kTasksPerWorker = 4;
+
+int RunSerially(FCINNParallelLambda flambda, void* datas, int num_task) {
+  int status = 0;
+  for (int i = 0; i < num_task; ++i) {
+    if ((*flambda)(i, num_task, datas) != 0) status = -1;
+  }
+  return status;
+}
+
+int NativeParallelLaunch(FCINNParallelLambda flambda,
+                         void* datas,
+                         int num_task) {
+  // A launch nested in a parallel task, or racing with the launch of another
+  // thread, runs in the calling thread instead of oversubscribing the cores.
+  if (ParallelThreadPool::tls_in_parallel) {
+    return RunSerially(flambda, datas, num_task == 0 ? 1 : num_task);
+  }
+  auto* pool = ParallelThreadPool::Global();
+  if (pool->num_workers() == 1) {
+    return RunSerially(flambda, datas, num_task == 0 ? 1 : num_task);
+  }
+  if (num_task == 0) num_task = pool->num_workers() * kTasksPerWorker;
+  int status = 0;
+  if (!pool->Launch(flambda, datas, num_task, &status)) {
+    return RunSerially(flambda, datas, num_task);
+  }
+  return status;
+}
+
+int OpenMPParallelLaunch(FCINNParallelLambda flambda,
+                         void* datas,
+                         int num_task) {
   int num_workers = max_concurrency();
   if (num_task == 0) num_task = num_workers;
 #ifdef CINN_USE_OPENMP
-  omp_set_num_threads(num_task);
 #pragma omp parallel num_threads(num_task)
   {
     int thread_num = omp_get_thread_num();
@@ -61,6 +276,17 @@ int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
   return 0;
 }
 
+}  // namespace
+
+int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
+                                 void* datas,
+                                 int num_task) {
+  if (FLAGS_cinn_thread_backend == "openmp") {
+    return OpenMPParallelLaunch(flambda, datas, num_task);
+  }
+  return NativeParallelLaunch(flambda, datas, num_task);
+}
+
 CINN_REGISTER_HELPER(cinn_backend_parallel) {
   using namespace cinn;  // NOLINT
   using backends::FunctionProto;
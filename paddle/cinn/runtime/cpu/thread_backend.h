@@ -34,6 +34,11 @@ typedef int (*FCINNParallelLambda)(int task_id, int num_task, void* datas);
 /**
  * @brief Backend function for running parallel jobs.
  *
+ * The tasks run on the work stealing thread pool of the runtime, or on OpenMP
+ * if FLAGS_cinn_thread_backend is "openmp". A launch from inside a parallel
+ * task, or while the pool is serving another launch, runs in the calling
+ * thread.
+ *
  * @param flambda The parallel function to be launched.
  * @param datas The closure datas.
  * @param num_task The Number of tasks to launch. If 0, it means to launch
@@ -0,0 +1,180 @@
+// Copyright (c) 2023 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/runtime/cpu/thread_backend.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/cinn/runtime/flags.h"
+
+PD_DECLARE_string(cinn_thread_backend);
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+struct CountArgs {
+  std::vector<std::atomic<int>>* counts;
+  std::atomic<int>* num_task;
+  bool nested;
+};
+
+int CountLambda(int task_id, int num_task, void* datas) {
+  auto* args = reinterpret_cast<CountArgs*>(datas);
+  (*args->counts)[task_id]++;
+  args->num_task->store(num_task);
+  if (args->nested) {
+    std::vector<std::atomic<int>> counts(64);
+    std::atomic<int> nested_num_task{0};
+    CountArgs nested_args{&counts, &nested_num_task, false};
+    cinn_backend_parallel_launch(&CountLambda, &nested_args, 0);
+    // A nested launch runs in the calling thread as a single task.
+    if (nested_num_task != 1 || counts[0] != 1) return -1;
+  }
+  return 0;
+}
+
+// Launches num_task tasks and checks that every task runs exactly once.
+void CheckLaunch(int num_task, bool nested) {
+  std::vector<std::atomic<int>> counts(4096);
+  std::atomic<int> actual_num_task{0};
+  CountArgs args{&counts, &actual_num_task, nested};
+  ASSERT_EQ(cinn_backend_parallel_launch(&CountLambda, &args, num_task), 0);
+  ASSERT_GT(actual_num_task, 0);
+  ASSERT_LE(actual_num_task, 4096);
+  for (int i = 0; i < actual_num_task; ++i) {
+    ASSERT_EQ(counts[i], 1) << "task " << i;
+  }
+}
+
+TEST(ThreadBackend, run_every_task_once) {
+  FLAGS_cinn_thread_backend = "native";
+  CheckLaunch(0, false);
+  CheckLaunch(1, false);
+  CheckLaunch(37, false);
+  CheckLaunch(4096, false);
+  CheckLaunch(0, true);
+}
+
+TEST(ThreadBackend, concurrent_launch) {
+  FLAGS_cinn_thread_backend = "native";
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([] {
+      for (int j = 0; j < 100; ++j) CheckLaunch(64, false);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+// out = max(x * y + x, 0), which is a typical fused elementwise group.
+struct ElementwiseArgs {
+  const float* x;
+  const float* y;
+  float* out;
+  int64_t numel;
+};
+
+int ElementwiseLambda(int task_id, int num_task, void* datas) {
+  auto* args = reinterpret_cast<ElementwiseArgs*>(datas);
+  int64_t step = (args->numel + num_task - 1) / num_task;
+  int64_t begin = std::min(task_id * step, args->numel);
+  int64_t end = std::min(begin + step, args->numel);
+  for (int64_t i = begin; i < end; ++i) {
+    args->out[i] = std::max(args->x[i] * args->y[i] + args->x[i], 0.f);
+  }
+  return 0;
+}
+
+// out[i] = sum(x[i, :]), the reduce group is parallelized over the rows.
+struct ReduceArgs {
+  const float* x;
+  float* out;
+  int64_t rows;
+  int64_t cols;
+};
+
+int ReduceLambda(int task_id, int num_task, void* datas) {
+  auto* args = reinterpret_cast<ReduceArgs*>(datas);
+  int64_t step = (args->rows + num_task - 1) / num_task;
+  int64_t begin = std::min(task_id * step, args->rows);
+  int64_t end = std::min(begin + step, args->rows);
+  for (int64_t i = begin; i < end; ++i) {
+    float sum = 0.f;
+    const float* row = args->x + i * args->cols;
+    for (int64_t j = 0; j < args->cols; ++j) sum += row[j];
+    args->out[i] = sum;
+  }
+  return 0;
+}
+
+double TimeLaunch(FCINNParallelLambda flambda, void* datas, int repeat) {
+  cinn_backend_parallel_launch(flambda, datas, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    cinn_backend_parallel_launch(flambda, datas, 0);
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         repeat;
+}
+
+TEST(ThreadBackend, benchmark) {
+  std::vector<std::string> backends = {"native"};
+#ifdef CINN_USE_OPENMP
+  backends.push_back("openmp");
+#endif
+
+  constexpr int64_t kNumel = 1 << 22;
+  std::vector<float> x(kNumel), y(kNumel), out(kNumel);
+  for (int64_t i = 0; i < kNumel; ++i) {
+    x[i] = static_cast<float>(i % 17) - 8.f;
+    y[i] = static_cast<float>(i % 5) - 2.f;
+  }
+  ElementwiseArgs elementwise_args{x.data(), y.data(), out.data(), kNumel};
+  constexpr int64_t kRows = 4096;
+  std::vector<float> reduce_out(kRows);
+  ReduceArgs reduce_args{x.data(), reduce_out.data(), kRows, kNumel / kRows};
+  // Small groups, where the launch overhead dominates.
+  ElementwiseArgs small_args{x.data(), y.data(), out.data(), 4096};
+
+  for (auto& backend : backends) {
+    FLAGS_cinn_thread_backend = backend;
+    double elementwise_ms =
+        TimeLaunch(&ElementwiseLambda, &elementwise_args, 20);
+    for (int64_t i = 0; i < kNumel; i += 4099) {
+      ASSERT_EQ(out[i], std::max(x[i] * y[i] + x[i], 0.f));
+    }
+    double reduce_ms = TimeLaunch(&ReduceLambda, &reduce_args, 20);
+    ASSERT_EQ(reduce_out[1], reduce_out[1 + 17]);
+    double small_ms = TimeLaunch(&ElementwiseLambda, &small_args, 2000);
+    LOG(INFO) << backend << " backend with " << max_concurrency()
+              << " threads, elementwise: " << elementwise_ms
+              << " ms, reduce: " << reduce_ms
+              << " ms, small elementwise: " << small_ms * 1000 << " us";
+  }
+  FLAGS_cinn_thread_backend = "native";
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
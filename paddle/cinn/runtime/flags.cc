@@ -98,6 +98,12 @@ PD_DEFINE_bool(cinn_use_dense_merge_pass,
                BoolFromEnv("FLAGS_cinn_use_dense_merge_pass", false),
                "Whether use dense merge pass.");
 
+PD_DEFINE_bool(cinn_plan_buffer_reuse,
+               BoolFromEnv("FLAGS_cinn_plan_buffer_reuse", false),
+               "Whether place the temporary variables of the programs run "
+               "by the interpreter into an arena shared by the variables "
+               "whose lifetimes do not overlap.");
+
 PD_DEFINE_bool(
     nvrtc_compile_to_cubin,
     BoolFromEnv("FLAGS_nvrtc_compile_to_cubin", false),
@@ -158,6 +164,18 @@ PD_DEFINE_string(
     StringFromEnv("FLAGS_cinn_dump_group_instruction", ""),
     "Specify the path for dump instruction by group, which is used for debug.");
 
+PD_DEFINE_string(
+    cinn_compile_cache_dir,
+    StringFromEnv("FLAGS_cinn_compile_cache_dir", ""),
+    "Specify the directory of the persistent cache of the objects compiled "
+    "by the LLVM execution engine, which is reused across processes.");
+
+PD_DEFINE_string(cinn_thread_backend,
+                 StringFromEnv("FLAGS_cinn_thread_backend", "native"),
+                 "The thread backend of the parallel loops on x86, \"native\" "
+                 "for the work stealing thread pool of the CINN runtime, "
+                 "\"openmp\" for the OpenMP runtime.");
+
 PD_DEFINE_string(cinn_pass_visualize_dir,
                  StringFromEnv("FLAGS_cinn_pass_visualize_dir", ""),
                  "Specify the directory path of pass visualize file of graph, "
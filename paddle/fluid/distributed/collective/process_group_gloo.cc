@@ -28,6 +28,7 @@
 
 #include "paddle/fluid/distributed/collective/common.h"
 #include "paddle/fluid/distributed/collective/process_group_gloo.h"
+#include "paddle/fluid/distributed/collective/utils.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 
@@ -152,6 +153,42 @@ ProcessGroupGloo::GlooTask::GlooTask(
     int rank, const std::vector<phi::DenseTensor>& inputs, CommType comm_type)
     : ProcessGroup::Task(rank, inputs, comm_type) {}
 
+bool ProcessGroupGloo::GlooTask::IsCompleted() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_completed_;
+}
+
+bool ProcessGroupGloo::GlooTask::Wait(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (timeout == kWaitTimeout) {
+    // This waits without a timeout.
+    cv_.wait(lock, [&] { return is_completed_; });
+  } else {
+    cv_.wait_for(lock, timeout, [&] { return is_completed_; });
+    PADDLE_ENFORCE_EQ(
+        is_completed_,
+        true,
+        platform::errors::ExecutionTimeout("Gloo operation timeout."));
+  }
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+  return true;
+}
+
+void ProcessGroupGloo::GlooTask::RunAndComplete() {
+  std::exception_ptr exception;
+  try {
+    Run();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  is_completed_ = true;
+  exception_ = exception;
+  cv_.notify_all();
+}
+
 ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<phi::distributed::Store>& store,
     int rank,
@@ -165,6 +202,61 @@ ProcessGroupGloo::ProcessGroupGloo(
   _context->connectFullMesh(*_store, options->device);
 }
 
+ProcessGroupGloo::~ProcessGroupGloo() {
+  {
+    std::lock_guard<std::mutex> lock(_async_mutex);
+    _async_stop = true;
+  }
+  _async_cv.notify_all();
+  if (_async_worker.joinable()) {
+    _async_worker.join();
+  }
+}
+
+std::shared_ptr<ProcessGroupGloo::GlooTask> ProcessGroupGloo::RunTask(
+    std::shared_ptr<GlooTask> task, bool sync_op) {
+  bool run_inline = false;
+  {
+    std::lock_guard<std::mutex> lock(_async_mutex);
+    run_inline = sync_op && _async_pending == 0;
+    if (!run_inline) {
+      if (!_async_worker.joinable()) {
+        _async_worker = std::thread(&ProcessGroupGloo::AsyncLoop, this);
+      }
+      ++_async_pending;
+      _async_queue.push_back(task);
+    }
+  }
+  if (run_inline) {
+    task->RunAndComplete();
+  } else {
+    _async_cv.notify_one();
+  }
+  if (sync_op) {
+    task->Wait();
+  }
+  return task;
+}
+
+void ProcessGroupGloo::AsyncLoop() {
+  while (true) {
+    std::shared_ptr<GlooTask> task;
+    {
+      std::unique_lock<std::mutex> lock(_async_mutex);
+      _async_cv.wait(lock,
+                     [&] { return _async_stop || !_async_queue.empty(); });
+      if (_async_queue.empty()) return;
+      task = _async_queue.front();
+    }
+    task->RunAndComplete();
+    {
+      std::lock_guard<std::mutex> lock(_async_mutex);
+      _async_queue.pop_front();
+      --_async_pending;
+    }
+  }
+}
+
 class BroadcastGlooTask : public ProcessGroupGloo::GlooTask {
  public:
   BroadcastGlooTask(phi::distributed::GlooCommContext* comm_context,
@@ -223,8 +315,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Broadcast(
   auto comm_context = this->GetCommContext();
   task = std::make_unique<BroadcastGlooTask>(
       comm_context, inputs, outputs, rank_, root, tag);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 class SendGlooTask : public ProcessGroupGloo::GlooTask {
@@ -266,9 +357,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Send(
   auto comm_context = this->GetCommContext();
   task = std::make_unique<SendGlooTask>(
       comm_context, &inputs, rank_, dst_rank, tag);
-  task->Run();
-
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 class RecvGlooTask : public ProcessGroupGloo::GlooTask {
@@ -311,8 +400,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Recv(
 
   task = std::make_unique<RecvGlooTask>(
       comm_context, &outputs, rank_, src_rank, tag);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
@@ -353,7 +441,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
     bool sync_op) {
   std::vector<phi::DenseTensor> in_wrapper{in_tensor};
   std::vector<phi::DenseTensor> out_wrapper{*out_tensor};
-  return AllReduce(in_wrapper, out_wrapper, opts, true);
+  return AllReduce(in_wrapper, out_wrapper, opts, sync_op);
 }
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
@@ -373,8 +461,111 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
   auto comm_context = this->GetCommContext();
   task = std::make_shared<AllreduceGlooTask>(
       rank_, comm_context, inputs, outputs, opts.reduce_op, tag);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), sync_op);
+}
+
+class AllToAllGlooTask : public ProcessGroupGloo::GlooTask {
+ public:
+  AllToAllGlooTask(int rank,
+                   phi::distributed::GlooCommContext* comm_context,
+                   const phi::DenseTensor& input,
+                   phi::DenseTensor* output,
+                   std::vector<int64_t> out_numel_each_rank,
+                   std::vector<int64_t> in_numel_each_rank,
+                   uint32_t tag)
+      : ProcessGroupGloo::GlooTask(rank, {input}, CommType::ALLTOALL),
+        _comm_context(comm_context),
+        _input(input),
+        _output(*output),
+        _out_numel_each_rank(std::move(out_numel_each_rank)),
+        _in_numel_each_rank(std::move(in_numel_each_rank)),
+        _tag(tag) {}
+
+  void Run() override {
+    _comm_context->AllToAll(
+        &_output, _input, _out_numel_each_rank, _in_numel_each_rank, _tag);
+  }
+
+ private:
+  phi::distributed::GlooCommContext* _comm_context;
+  phi::DenseTensor _input;
+  phi::DenseTensor _output;
+  std::vector<int64_t> _out_numel_each_rank;
+  std::vector<int64_t> _in_numel_each_rank;
+  uint32_t _tag;
+};
+
+static std::vector<int64_t> RowsToNumel(const phi::DDim& dims,
+                                        const std::vector<int64_t>& rows) {
+  int64_t row_numel = dims[0] == 0 ? 0 : phi::product(dims) / dims[0];
+  std::vector<int64_t> numel(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    numel[i] = rows[i] * row_numel;
+  }
+  return numel;
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllToAll(
+    phi::DenseTensor* out_tensor,
+    const phi::DenseTensor& in_tensor,
+    const std::vector<int64_t>& out_size_each_rank,
+    const std::vector<int64_t>& in_size_each_rank,
+    bool sync_op) {
+  CheckSizeOnEachRank(out_tensor->dims(), out_size_each_rank, size_);
+  CheckSizeOnEachRank(in_tensor.dims(), in_size_each_rank, size_);
+  auto tag = next_tag();
+  auto comm_context = this->GetCommContext();
+  auto task = std::make_shared<AllToAllGlooTask>(
+      rank_,
+      comm_context,
+      in_tensor,
+      out_tensor,
+      RowsToNumel(out_tensor->dims(), out_size_each_rank),
+      RowsToNumel(in_tensor.dims(), in_size_each_rank),
+      tag);
+  // The caller splits the output right after the call, so the task always
+  // completes before returning.
+  return RunTask(std::move(task), /*sync_op*/ true);
+}
+
+class ReduceScatterGlooTask : public ProcessGroupGloo::GlooTask {
+ public:
+  ReduceScatterGlooTask(int rank,
+                        phi::distributed::GlooCommContext* comm_context,
+                        const phi::DenseTensor& input,
+                        phi::DenseTensor* output,
+                        ReduceOp reduce_op,
+                        uint32_t tag)
+      : ProcessGroupGloo::GlooTask(rank, {input}, CommType::REDUCE_SCATTER),
+        _comm_context(comm_context),
+        _input(input),
+        _output(*output),
+        _reduce_op(reduce_op),
+        _tag(tag) {}
+
+  void Run() override {
+    _comm_context->ReduceScatter(
+        &_output, _input, static_cast<int>(_reduce_op), _tag);
+  }
+
+ private:
+  phi::distributed::GlooCommContext* _comm_context;
+  phi::DenseTensor _input;
+  phi::DenseTensor _output;
+  const ReduceOp _reduce_op;
+  uint32_t _tag;
+};
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::ReduceScatter(
+    phi::DenseTensor* out_tensor,
+    const phi::DenseTensor& in_tensor,
+    const ReduceScatterOptions& opts,
+    bool sync_op) {
+  auto tag = next_tag();
+  auto comm_context = this->GetCommContext();
+  auto task = std::make_shared<ReduceScatterGlooTask>(
+      rank_, comm_context, in_tensor, out_tensor, opts.reduce_op, tag);
+  return RunTask(std::move(task), sync_op);
 }
 
 class BarrierGlooTask : public ProcessGroupGloo::GlooTask {
@@ -397,8 +588,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Barrier(
   std::shared_ptr<BarrierGlooTask> task;
   auto comm_context = this->GetCommContext();
   task = std::make_shared<BarrierGlooTask>(rank_, comm_context);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 class AllgatherGlooTask : public ProcessGroupGloo::GlooTask {
@@ -454,8 +644,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllGather(
   auto comm_context = this->GetCommContext();
   task = std::make_shared<AllgatherGlooTask>(
       rank_, comm_context, in_tensors, out_tensors, tag);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 class ReduceGlooTask : public ProcessGroupGloo::GlooTask {
@@ -511,8 +700,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Reduce(
                                           opts.reduce_op,
                                           opts.root_rank,
                                           tag);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Reduce(
@@ -568,8 +756,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Scatter(
   std::vector<phi::DenseTensor> out_wrapper{*out_tensor};
   task = std::make_shared<ScatterGlooTask>(
       rank_, comm_context, in_wrapper, out_wrapper, opts.root_rank, size_, tag);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Scatter(
@@ -625,8 +812,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::Gather(
   auto comm_context = this->GetCommContext();
   task = std::make_shared<GatherGlooTask>(
       rank_, comm_context, in_tensor, out_tensor, opts.root_rank, tag);
-  task->Run();
-  return task;
+  return RunTask(std::move(task), /*sync_op*/ true);
 }
 
 std::shared_ptr<::gloo::transport::Device>
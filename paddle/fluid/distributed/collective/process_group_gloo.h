@@ -14,9 +14,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/distributed/collective/process_group_without_stream.h"
@@ -43,12 +47,20 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
     ~GlooTask() = default;
 
     virtual void Run() = 0;
-    bool Wait(std::chrono::milliseconds timeout) override { return true; }
-    bool IsCompleted() override { return true; }
-    void Synchronize() override {}
+    bool Wait(std::chrono::milliseconds timeout = kWaitTimeout) override;
+    bool IsCompleted() override;
+    void Synchronize() override { Wait(kWaitTimeout); }
 
    protected:
     friend class ProcessGroupGloo;
+
+    // Runs the task and records its completion, the exception thrown by Run
+    // is rethrown by Wait.
+    void RunAndComplete();
+
+   private:
+    std::condition_variable cv_;
+    std::exception_ptr exception_;
   };
 
   class GlooStore : public ::gloo::rendezvous::Store {
@@ -112,7 +124,7 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
       int world_size,
       int gid);
 
-  ~ProcessGroupGloo() = default;
+  ~ProcessGroupGloo();
 
   std::shared_ptr<ProcessGroup::Task> AllGather(
       phi::DenseTensor* out_tensor,
@@ -127,12 +139,25 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
       const AllreduceOptions& opts,
       bool sync_op) override;
 
+  std::shared_ptr<ProcessGroup::Task> AllToAll(
+      phi::DenseTensor* out_tensor,
+      const phi::DenseTensor& in_tensor,
+      const std::vector<int64_t>& out_size_each_rank,
+      const std::vector<int64_t>& in_size_each_rank,
+      bool sync_op) override;
+
   std::shared_ptr<ProcessGroup::Task> Broadcast(
       phi::DenseTensor* out_tensor,
       const phi::DenseTensor& in_tensor,
       const BroadcastOptions& opts,
       bool sync_op) override;
 
+  std::shared_ptr<ProcessGroup::Task> ReduceScatter(
+      phi::DenseTensor* out_tensor,
+      const phi::DenseTensor& in_tensor,
+      const ReduceScatterOptions& opts,
+      bool sync_op) override;
+
   std::shared_ptr<ProcessGroup::Task> Send(const phi::DenseTensor& tensor,
                                            int dst_rank,
                                            bool sync_op) override;
@@ -236,9 +261,25 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
   static std::shared_ptr<::gloo::transport::Device> createDefaultDevice();
 
  private:
+  // Collectives must be issued in the same order on every rank, so the async
+  // tasks are run one by one by a single worker thread. A sync task runs in
+  // the calling thread unless async tasks are still pending, in which case it
+  // is queued behind them and waited.
+  std::shared_ptr<GlooTask> RunTask(std::shared_ptr<GlooTask> task,
+                                    bool sync_op);
+  void AsyncLoop();
+
   uint32_t _tag;
   std::shared_ptr<gloo::rendezvous::Context> _context;
   std::shared_ptr<::gloo::rendezvous::Store> _store;
+
+  std::thread _async_worker;
+  std::mutex _async_mutex;
+  std::condition_variable _async_cv;
+  std::deque<std::shared_ptr<GlooTask>> _async_queue;
+  // The number of queued and running async tasks.
+  size_t _async_pending{0};
+  bool _async_stop{false};
 };
 
 }  // namespace distributed
@@ -1046,7 +1046,7 @@ void EagerReducer::FinalizeBackward() {
   for (auto &group : groups_) {
     if (!group.is_sparse_) {
       group.task->Synchronize();
-      if (!IsStreamSafeAllocator()) {
+      if (!IsStreamSafeAllocator() || IsAsyncCpuAllReduce()) {
         auto *default_ctx =
             platform::DeviceContextPool::Instance().Get(inner_place_);
         group.SplitTensors(*default_ctx);
@@ -1064,6 +1064,11 @@ void EagerReducer::FinalizeBackward() {
   VLOG(3) << "In the batch, Reducer is finished.";
 }
 
+bool EagerReducer::IsAsyncCpuAllReduce() const {
+  return platform::is_cpu_place(inner_place_) &&
+         process_group_->GetBackendName() == "GLOO";
+}
+
 void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
                                           const int curr_group_index) {
   // The overall timeline: concat > div_nranks > allreduce > split
@@ -1086,6 +1091,14 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
   for (auto &t : reduce_tensors) {
     in_out.push_back(*std::dynamic_pointer_cast<phi::DenseTensor>(t.impl()));
   }
+  if (IsAsyncCpuAllReduce()) {
+    // On CPU the allreduce of this group runs in the background while the
+    // backward of the next groups goes on, the split is done once it is
+    // finished in FinalizeBackward.
+    group->task = process_group_->AllReduce(
+        &in_out[0], in_out[0], opts, /*sync_op*/ false);
+    return;
+  }
   group->task = process_group_->AllReduce(in_out, in_out, opts);
 
   auto *context = process_group_->GetDeviceContext(inner_place_);
@@ -112,6 +112,8 @@ class EagerReducer {
   void TraverseBackwardGraph(const std::vector<Tensor> &outputs);
   void ProcessUnusedDenseVars();
   bool HasGrad(size_t var_index);
+  // whether the dense groups are allreduced asynchronously on CPU
+  bool IsAsyncCpuAllReduce() const;
 
  private:
   std::vector<Tensor> tensors_;
@@ -35,6 +35,11 @@ PADDLE_DEFINE_EXPORTED_bool(
     "Use standalone executor to run ops. Temporary FLAGS, will be removed "
     "after all fleet executor cases are modified to run ops with standalone "
     "executor.");
+PADDLE_DEFINE_EXPORTED_bool(
+    fleet_executor_share_local_vars,
+    false,
+    "Share the tensors of the vars sent between the interceptors in the same "
+    "rank instead of serializing them into the messages.");
 PHI_DECLARE_bool(cache_inference_while_scope);
 
 namespace paddle {
@@ -112,6 +117,8 @@ void Carrier::Release() {
   if (root_scope_) {
     root_scope_->DropKids();
   }
+  std::lock_guard<std::mutex> lock(shared_tensors_mutex_);
+  shared_tensors_.clear();
 }
 
 Carrier::~Carrier() { VLOG(3) << "Carrier's destructor."; }
@@ -248,6 +255,51 @@ bool Carrier::Send(const InterceptorMessage& msg) {
   return GlobalVal<MessageBus>::Get()->Send(dst_rank, msg);
 }
 
+bool Carrier::ShareVarsWith(int64_t dst_id) const {
+  if (!FLAGS_fleet_executor_share_local_vars || GetRank(dst_id) != rank_) {
+    return false;
+  }
+  // a receiver which does not decode the vars would never take its share
+  auto iter = interceptor_idx_to_interceptor_.find(dst_id);
+  return iter != interceptor_idx_to_interceptor_.end() &&
+         iter->second->DecodesMsgVars();
+}
+
+void Carrier::PutSharedTensor(int64_t src_id,
+                              int64_t scope_idx,
+                              const std::string& name,
+                              const phi::DenseTensor& tensor,
+                              int num_receivers) {
+  std::lock_guard<std::mutex> lock(shared_tensors_mutex_);
+  shared_tensors_[std::make_tuple(src_id, scope_idx, name)] =
+      std::make_pair(tensor, num_receivers);
+}
+
+phi::DenseTensor Carrier::TakeSharedTensor(int64_t src_id,
+                                           int64_t scope_idx,
+                                           const std::string& name) {
+  std::lock_guard<std::mutex> lock(shared_tensors_mutex_);
+  auto iter = shared_tensors_.find(std::make_tuple(src_id, scope_idx, name));
+  PADDLE_ENFORCE_NE(
+      iter,
+      shared_tensors_.end(),
+      platform::errors::NotFound("Interceptor %lld has not shared var %s in "
+                                 "scope %lld.",
+                                 src_id,
+                                 name,
+                                 scope_idx));
+  phi::DenseTensor tensor = iter->second.first;
+  if (--iter->second.second <= 0) {
+    shared_tensors_.erase(iter);
+  }
+  return tensor;
+}
+
+size_t Carrier::NumSharedTensors() {
+  std::lock_guard<std::mutex> lock(shared_tensors_mutex_);
+  return shared_tensors_.size();
+}
+
 Interceptor* Carrier::SetInterceptor(int64_t interceptor_id,
                                      std::unique_ptr<Interceptor> interceptor) {
   auto iter = interceptor_idx_to_interceptor_.find(interceptor_id);
@@ -15,10 +15,12 @@
 #pragma once
 
 #include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -31,6 +33,7 @@
 #include "paddle/fluid/platform/errors.h"
 #include "paddle/fluid/platform/macros.h"
 #include "paddle/fluid/platform/place.h"
+#include "paddle/phi/core/dense_tensor.h"
 
 namespace paddle {
 namespace framework {
@@ -89,6 +92,27 @@ class Carrier final {
 
   bool Send(const InterceptorMessage& msg);
 
+  // Whether the vars sent to the interceptor are shared through this carrier
+  // rather than serialized into the message, which is the case if it runs in
+  // the same rank and takes the vars it receives.
+  bool ShareVarsWith(int64_t dst_id) const;
+
+  // The tensors sent by the interceptors to the others in the same rank,
+  // keyed by the source interceptor, the scope and the var name. They share
+  // the allocations of the source tensors, and are released once taken by
+  // the num_receivers downstreams, or replaced by the next tensors sent with
+  // the same key.
+  void PutSharedTensor(int64_t src_id,
+                       int64_t scope_idx,
+                       const std::string& name,
+                       const phi::DenseTensor& tensor,
+                       int num_receivers);
+  phi::DenseTensor TakeSharedTensor(int64_t src_id,
+                                    int64_t scope_idx,
+                                    const std::string& name);
+  // The number of the shared tensors not taken by all of their receivers.
+  size_t NumSharedTensors();
+
  private:
   DISABLE_COPY_AND_ASSIGN(Carrier);
   Carrier() = delete;
@@ -119,6 +143,12 @@ class Carrier final {
   int thread_num_;
   TaskLoopThreadPool thread_pool_;
   std::unordered_set<int64_t> interceptor_ids_;
+
+  std::mutex shared_tensors_mutex_;
+  // (src_id, scope_idx, name) -> (tensor, receivers not taking it yet)
+  std::map<std::tuple<int64_t, int64_t, std::string>,
+           std::pair<phi::DenseTensor, int>>
+      shared_tensors_;
 };
 
 }  // namespace distributed
@@ -59,11 +59,15 @@ void ComputeInterceptor::DecodeMsgVars(const InterceptorMessage& msg) {
   platform::DeviceContextPool& pool = platform::DeviceContextPool::Instance();
   for (const auto& var_iter : msg.vars_list()) {
     const std::string& name = var_iter.name();
-    auto& dev_ctx = *pool.Get(place_);
-    std::istringstream ss(var_iter.stensor());
     auto* var = scope->Var(name);
     auto* tensor = var->GetMutable<phi::DenseTensor>();
-    framework::DeserializeFromStream(ss, tensor, dev_ctx);
+    if (msg.shared_vars()) {
+      *tensor = carrier_->TakeSharedTensor(msg.src_id(), scope_id, name);
+    } else {
+      auto& dev_ctx = *pool.Get(place_);
+      std::istringstream ss(var_iter.stensor());
+      framework::DeserializeFromStream(ss, tensor, dev_ctx);
+    }
 
     VLOG(3) << "Set vars " << name << " with value in scope " << scope_id
             << " with dims " << tensor->dims() << " with dtype "
@@ -71,7 +75,8 @@ void ComputeInterceptor::DecodeMsgVars(const InterceptorMessage& msg) {
   }
 }
 
-InterceptorMessage ComputeInterceptor::PrepareVarsMsg() {
+InterceptorMessage ComputeInterceptor::PrepareVarsMsg(
+    int num_shared_receivers) {
   PADDLE_ENFORCE_LT(cur_scope_id_,
                     microbatch_scopes_.size(),
                     platform::errors::InvalidArgument(
@@ -84,21 +89,32 @@ InterceptorMessage ComputeInterceptor::PrepareVarsMsg() {
   InterceptorMessage ready_msg;
   ready_msg.set_message_type(DATA_WITH_VARS);
   ready_msg.set_scope_idx(cur_scope_id_);
+  ready_msg.set_shared_vars(num_shared_receivers > 0);
   platform::DeviceContextPool& pool = platform::DeviceContextPool::Instance();
   for (auto const& iter : node_->vars_to_dtype()) {
     VarList* vars = ready_msg.add_vars_list();
     const auto& var_name = iter.first;
     vars->set_name(var_name);
-    std::ostringstream ss;
-    auto& dev_ctx = *pool.Get(place_);
     auto* var = scope->FindVar(var_name);
     PADDLE_ENFORCE(
         var,
         platform::errors::NotFound(
             "Variable %s not exists in scope %ld", var_name, cur_scope_id_));
     const auto& tensor = var->Get<phi::DenseTensor>();
-    framework::SerializeToStream(ss, tensor, dev_ctx);
-    vars->set_stensor(ss.str());
+    if (num_shared_receivers > 0) {
+      // The downstreams share the allocation, which the upstream does not
+      // write again until they have used the data and replied.
+      carrier_->PutSharedTensor(interceptor_id_,
+                                cur_scope_id_,
+                                var_name,
+                                tensor,
+                                num_shared_receivers);
+    } else {
+      std::ostringstream ss;
+      auto& dev_ctx = *pool.Get(place_);
+      framework::SerializeToStream(ss, tensor, dev_ctx);
+      vars->set_stensor(ss.str());
+    }
     VLOG(3) << "Prepare vars msg " << var_name << " with dimension "
             << tensor.dims() << " dtype " << tensor.dtype();
   }
@@ -229,8 +245,19 @@ void ComputeInterceptor::SendDataReadyToDownStream() {
   InterceptorMessage ready_msg;
   ready_msg.set_start_micro_step(start_micro_step_);
   ready_msg.set_num_micro_step(num_micro_step_);
+  // The vars are serialized only for the downstreams in other ranks.
+  InterceptorMessage shared_vars_msg;
   if (need_send_vars) {
-    ready_msg = PrepareVarsMsg();
+    int num_shared_receivers = 0;
+    for (auto& outs : out_buffs_) {
+      num_shared_receivers += carrier_->ShareVarsWith(outs.first);
+    }
+    if (num_shared_receivers > 0) {
+      shared_vars_msg = PrepareVarsMsg(num_shared_receivers);
+    }
+    if (num_shared_receivers < static_cast<int>(out_buffs_.size())) {
+      ready_msg = PrepareVarsMsg(0);
+    }
   } else {
     ready_msg.set_message_type(DATA_IS_READY);
     ready_msg.set_scope_idx(cur_scope_id_);
@@ -257,7 +284,8 @@ void ComputeInterceptor::SendDataReadyToDownStream() {
       VLOG(3) << "ComputeInterceptor " << interceptor_id_
               << " Send data_with_vars msg to " << down_id
               << " in scope: " << cur_scope_id_;
-      Send(down_id, ready_msg);
+      Send(down_id,
+           carrier_->ShareVarsWith(down_id) ? shared_vars_msg : ready_msg);
     } else {
       VLOG(3) << "ComputeInterceptor " << interceptor_id_
               << " Send data_is_ready msg to " << down_id
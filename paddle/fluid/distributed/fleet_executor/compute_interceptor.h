@@ -28,6 +28,8 @@ class ComputeInterceptor : public Interceptor {
  public:
   ComputeInterceptor(int64_t interceptor_id, TaskNode* node);
 
+  bool DecodesMsgVars() const override { return true; }
+
  protected:
   virtual void RunOps();
   virtual void SendDataReadyToDownStream();
@@ -47,7 +49,9 @@ class ComputeInterceptor : public Interceptor {
 
  private:
   void PrepareDeps();
-  InterceptorMessage PrepareVarsMsg();
+  // Shares the vars with num_shared_receivers downstreams in the same rank
+  // through the carrier, or serializes them into the message if it is 0.
+  InterceptorMessage PrepareVarsMsg(int num_shared_receivers);
   void DecodeMsgVars(const InterceptorMessage& msg);
 
   bool IsInputReady();
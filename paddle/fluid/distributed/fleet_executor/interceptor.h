@@ -92,6 +92,10 @@ class Interceptor {
 
   TaskNode* GetTaskNode() const { return node_; }
 
+  // Whether the interceptor decodes the vars of the DATA_WITH_VARS messages,
+  // and so takes the vars shared with it through the carrier.
+  virtual bool DecodesMsgVars() const { return false; }
+
   DISABLE_COPY_AND_ASSIGN(Interceptor);
 
  protected:
@@ -26,6 +26,8 @@ class StartInterceptor final : public ComputeInterceptor {
  public:
   StartInterceptor(int64_t interceptor_id, TaskNode* node);
 
+  bool DecodesMsgVars() const override { return false; }
+
  private:
   void SendDataReadyToDownStream() override;
   void RunOps() override;
@@ -31,6 +31,8 @@ limitations under the License. */
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 PHI_DECLARE_bool(enable_ins_parser_file);
+PHI_DECLARE_bool(enable_local_block_reader);
+PHI_DECLARE_int32(local_block_reader_decode_threads);
 namespace paddle {
 namespace framework {
 
@@ -533,6 +535,9 @@ void InMemoryDataFeed<T>::LoadIntoMemory() {
   while (this->PickOneFile(&filename)) {
     VLOG(3) << "PickOneFile, filename=" << filename
             << ", thread_id=" << thread_id_;
+    if (LoadLocalFileInBlocks(filename)) {
+      continue;
+    }
 #ifdef PADDLE_WITH_BOX_PS
     if (BoxWrapper::GetInstance()->UseAfsApi()) {
       this->fp_ = BoxWrapper::GetInstance()->afs_manager->GetFile(
@@ -570,6 +575,106 @@ void InMemoryDataFeed<T>::LoadIntoMemory() {
 #endif
 }
 
+template <typename T>
+bool InMemoryDataFeed<T>::LoadLocalFileInBlocks(const std::string& filename) {
+#ifdef _LINUX
+  if (!FLAGS_enable_local_block_reader ||
+      !localfs_can_read_blocks(filename, this->pipe_command_)) {
+    return false;
+  }
+  int num_decoders = std::max(FLAGS_local_block_reader_decode_threads, 1);
+  std::vector<std::unique_ptr<DataFeedBlockDecoder<T>>> decoders;
+  for (int i = 0; i < num_decoders; ++i) {
+    decoders.push_back(CreateBlockDecoder());
+    if (decoders.back() == nullptr) {
+      return false;
+    }
+  }
+  platform::Timer timeline;
+  timeline.Start();
+  // The reads wait for the decoders when a few blocks per decoder are in
+  // flight, and the decoders wait for the consumers of the input channel
+  // when it is full. The blocks are decoded in parallel, but each decoder
+  // waits for the records of the previous blocks to be written before it
+  // writes its own, so that the records keep the order of the file.
+  auto blocks =
+      MakeChannel<std::pair<uint64_t, std::vector<char>>>(2 * num_decoders);
+  std::atomic<uint64_t> fea_num{0};
+  std::mutex write_mutex;
+  std::condition_variable write_cond;
+  uint64_t next_block = 0;
+  bool aborted = false;
+  std::exception_ptr decode_error;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_decoders; ++i) {
+    threads.emplace_back([&, i] {
+      std::vector<T> records;
+      std::pair<uint64_t, std::vector<char>> block;
+      try {
+        while (blocks->Get(block)) {
+          char* begin = block.second.data();
+          fea_num += decoders[i]->Decode(
+              begin, begin + block.second.size(), &records);
+          std::unique_lock<std::mutex> lock(write_mutex);
+          write_cond.wait(
+              lock, [&] { return aborted || next_block == block.first; });
+          if (aborted) break;
+          input_channel_->WriteMove(records.size(), records.data());
+          records.clear();
+          ++next_block;
+          write_cond.notify_all();
+        }
+      } catch (...) {
+        {
+          std::lock_guard<std::mutex> lock(write_mutex);
+          if (!decode_error) decode_error = std::current_exception();
+          aborted = true;
+        }
+        write_cond.notify_all();
+        blocks->Close();
+      }
+    });
+  }
+  std::exception_ptr read_error;
+  try {
+    LocalFileBlockReader reader(filename);
+    std::pair<uint64_t, std::vector<char>> block;
+    for (uint64_t index = 0; reader.Next(&block.second); ++index) {
+      if (block.second.back() != '\n') {
+        block.second.push_back('\n');
+      }
+      block.first = index;
+      if (!blocks->Put(std::move(block))) {
+        break;
+      }
+    }
+  } catch (...) {
+    read_error = std::current_exception();
+  }
+  blocks->Close();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (read_error) std::rethrow_exception(read_error);
+  if (decode_error) std::rethrow_exception(decode_error);
+
+  fea_num_ += fea_num;
+  STAT_ADD(STAT_total_feasign_num_in_mem, fea_num_);
+  {
+    std::lock_guard<std::mutex> flock(*mutex_for_fea_num_);
+    *total_fea_num_ += fea_num_;
+    fea_num_ = 0;
+  }
+  timeline.Pause();
+  VLOG(3) << "LoadLocalFileInBlocks() read all lines, file=" << filename
+          << ", cost time=" << timeline.ElapsedSec()
+          << " seconds, thread_id=" << thread_id_;
+  return true;
+#else
+  return false;
+#endif
+}
+
 template <typename T>
 void InMemoryDataFeed<T>::LoadIntoMemoryFromSo() {
 #if (defined _LINUX) && (defined PADDLE_WITH_HETERPS) && \
@@ -1135,132 +1240,166 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
   if (!reader.getline(&*(fp_.get()))) {
     return false;
   } else {
-    const char* str = reader.get();
-    std::string line = std::string(str);
-    // VLOG(3) << line;
-    char* endptr = const_cast<char*>(str);
-    int pos = 0;
-    if (parse_ins_id_) {
-      int num = strtol(&str[pos], &endptr, 10);
-      CHECK(num == 1);  // NOLINT
-      pos = endptr - str + 1;
-      size_t len = 0;
-      while (str[pos + len] != ' ') {
-        ++len;
-      }
-      instance->ins_id_ = std::string(str + pos, len);
-      pos += len + 1;
-      VLOG(3) << "ins_id " << instance->ins_id_;
+    ParseOneInstanceFromLine(reader.get(), instance);
+    fea_num_ += instance->uint64_feasigns_.size();
+    return true;
+  }
+#else
+  return false;
+#endif
+}
+
+void MultiSlotInMemoryDataFeed::ParseOneInstanceFromLine(const char* str,
+                                                         Record* instance) {
+  char* endptr = const_cast<char*>(str);
+  int pos = 0;
+  if (parse_ins_id_) {
+    int num = strtol(&str[pos], &endptr, 10);
+    CHECK(num == 1);  // NOLINT
+    pos = endptr - str + 1;
+    size_t len = 0;
+    while (str[pos + len] != ' ') {
+      ++len;
     }
-    if (parse_content_) {
-      int num = strtol(&str[pos], &endptr, 10);
-      CHECK(num == 1);  // NOLINT
-      pos = endptr - str + 1;
-      size_t len = 0;
-      while (str[pos + len] != ' ') {
-        ++len;
-      }
-      instance->content_ = std::string(str + pos, len);
-      pos += len + 1;
-      VLOG(3) << "content " << instance->content_;
+    instance->ins_id_ = std::string(str + pos, len);
+    pos += len + 1;
+    VLOG(3) << "ins_id " << instance->ins_id_;
+  }
+  if (parse_content_) {
+    int num = strtol(&str[pos], &endptr, 10);
+    CHECK(num == 1);  // NOLINT
+    pos = endptr - str + 1;
+    size_t len = 0;
+    while (str[pos + len] != ' ') {
+      ++len;
     }
-    if (parse_logkey_) {
-      int num = strtol(&str[pos], &endptr, 10);
-      CHECK(num == 1);  // NOLINT
-      pos = endptr - str + 1;
-      size_t len = 0;
-      while (str[pos + len] != ' ') {
-        ++len;
-      }
-      // parse_logkey
-      std::string log_key = std::string(str + pos, len);
-      uint64_t search_id;
-      uint32_t cmatch;
-      uint32_t rank;
-      GetMsgFromLogKey(log_key, &search_id, &cmatch, &rank);
-
-      instance->ins_id_ = log_key;
-      instance->search_id = search_id;
-      instance->cmatch = cmatch;
-      instance->rank = rank;
-      pos += len + 1;
+    instance->content_ = std::string(str + pos, len);
+    pos += len + 1;
+    VLOG(3) << "content " << instance->content_;
+  }
+  if (parse_logkey_) {
+    int num = strtol(&str[pos], &endptr, 10);
+    CHECK(num == 1);  // NOLINT
+    pos = endptr - str + 1;
+    size_t len = 0;
+    while (str[pos + len] != ' ') {
+      ++len;
     }
-    for (size_t i = 0; i < use_slots_index_.size(); ++i) {
-      int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
-      PADDLE_ENFORCE_NE(
-          num,
-          0,
-          platform::errors::InvalidArgument(
-              "The number of ids can not be zero, you need padding "
-              "it in data generator; or if there is something wrong with "
-              "the data, please check if the data contains unresolvable "
-              "characters.\nplease check this error line: %s, \n Specifically, "
-              "something wrong happened(the length of this slot's feasign is 0)"
-              "when we parse the %d th slots."
-              "Maybe something wrong around this slot"
-              "\nWe detect the feasign number of this slot is %d, "
-              "which is illegal.",
-              str,
-              i,
-              num));
+    // parse_logkey
+    std::string log_key = std::string(str + pos, len);
+    uint64_t search_id;
+    uint32_t cmatch;
+    uint32_t rank;
+    GetMsgFromLogKey(log_key, &search_id, &cmatch, &rank);
+
+    instance->ins_id_ = log_key;
+    instance->search_id = search_id;
+    instance->cmatch = cmatch;
+    instance->rank = rank;
+    pos += len + 1;
+  }
+  for (size_t i = 0; i < use_slots_index_.size(); ++i) {
+    int idx = use_slots_index_[i];
+    int num = strtol(&str[pos], &endptr, 10);
+    PADDLE_ENFORCE_NE(
+        num,
+        0,
+        platform::errors::InvalidArgument(
+            "The number of ids can not be zero, you need padding "
+            "it in data generator; or if there is something wrong with "
+            "the data, please check if the data contains unresolvable "
+            "characters.\nplease check this error line: %s, \n Specifically, "
+            "something wrong happened(the length of this slot's feasign is 0)"
+            "when we parse the %d th slots."
+            "Maybe something wrong around this slot"
+            "\nWe detect the feasign number of this slot is %d, "
+            "which is illegal.",
+            str,
+            i,
+            num));
 #ifdef PADDLE_WITH_PSLIB
-      if (parse_uid_ && all_slots_[i] == uid_slot_) {
-        PADDLE_ENFORCE(num == 1 && all_slots_type_[i][0] == 'u',
-                       platform::errors::PreconditionNotMet(
-                           "The uid has to be uint64 and single.\n"
-                           "please check this error line: %s",
-                           str));
+    if (parse_uid_ && all_slots_[i] == uid_slot_) {
+      PADDLE_ENFORCE(num == 1 && all_slots_type_[i][0] == 'u',
+                     platform::errors::PreconditionNotMet(
+                         "The uid has to be uint64 and single.\n"
+                         "please check this error line: %s",
+                         str));
 
-        char* uidptr = endptr;
-        uint64_t feasign = (uint64_t)strtoull(uidptr, &uidptr, 10);
-        instance->uid_ = feasign;
-      }
+      char* uidptr = endptr;
+      uint64_t feasign = (uint64_t)strtoull(uidptr, &uidptr, 10);
+      instance->uid_ = feasign;
+    }
 #endif
-      if (idx != -1) {
-        if (all_slots_type_[i][0] == 'f') {  // float
-          for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
-            // if float feasign is equal to zero, ignore it
-            // except when slot is dense
-            if (fabs(feasign) < 1e-6 && !use_slots_is_dense_[i]) {
-              continue;
-            }
-            FeatureFeasign f;
-            f.float_feasign_ = feasign;
-            instance->float_feasigns_.emplace_back(f, idx);
-          }
-        } else if (all_slots_type_[i][0] == 'u') {  // uint64
-          for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
-            // if uint64 feasign is equal to zero, ignore it
-            // except when slot is dense
-            if (feasign == 0 && !use_slots_is_dense_[i]) {
-              continue;
-            }
-            FeatureFeasign f;
-            f.uint64_feasign_ = feasign;
-            instance->uint64_feasigns_.emplace_back(f, idx);
+    if (idx != -1) {
+      if (all_slots_type_[i][0] == 'f') {  // float
+        for (int j = 0; j < num; ++j) {
+          float feasign = strtof(endptr, &endptr);
+          // if float feasign is equal to zero, ignore it
+          // except when slot is dense
+          if (fabs(feasign) < 1e-6 && !use_slots_is_dense_[i]) {
+            continue;
           }
+          FeatureFeasign f;
+          f.float_feasign_ = feasign;
+          instance->float_feasigns_.emplace_back(f, idx);
         }
-        pos = endptr - str;
-      } else {
-        for (int j = 0; j <= num; ++j) {
-          // pos = line.find_first_of(' ', pos + 1);
-          while (line[pos + 1] != ' ') {
-            pos++;
+      } else if (all_slots_type_[i][0] == 'u') {  // uint64
+        for (int j = 0; j < num; ++j) {
+          uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+          // if uint64 feasign is equal to zero, ignore it
+          // except when slot is dense
+          if (feasign == 0 && !use_slots_is_dense_[i]) {
+            continue;
           }
+          FeatureFeasign f;
+          f.uint64_feasign_ = feasign;
+          instance->uint64_feasigns_.emplace_back(f, idx);
+        }
+      }
+      pos = endptr - str;
+    } else {
+      for (int j = 0; j <= num; ++j) {
+        // pos = line.find_first_of(' ', pos + 1);
+        while (str[pos + 1] != ' ') {
+          pos++;
         }
       }
     }
-    instance->float_feasigns_.shrink_to_fit();
-    instance->uint64_feasigns_.shrink_to_fit();
-    fea_num_ += instance->uint64_feasigns_.size();
-    return true;
   }
-#else
-  return false;
-#endif
+  instance->float_feasigns_.shrink_to_fit();
+  instance->uint64_feasigns_.shrink_to_fit();
+}
+
+class MultiSlotInMemoryDataFeed::LineDecoder
+    : public DataFeedBlockDecoder<Record> {
+ public:
+  explicit LineDecoder(MultiSlotInMemoryDataFeed* feed) : feed_(feed) {}
+
+  uint64_t Decode(char* begin,
+                  char* end,
+                  std::vector<Record>* records) override {
+    uint64_t fea_num = 0;
+    while (begin < end) {
+      char* line_end = std::find(begin, end, '\n');
+      *line_end = '\0';
+      if (line_end != begin) {
+        Record instance;
+        feed_->ParseOneInstanceFromLine(begin, &instance);
+        fea_num += instance.uint64_feasigns_.size();
+        records->push_back(std::move(instance));
+      }
+      begin = line_end + 1;
+    }
+    return fea_num;
+  }
+
+ private:
+  MultiSlotInMemoryDataFeed* feed_;
+};
+
+std::unique_ptr<DataFeedBlockDecoder<Record>>
+MultiSlotInMemoryDataFeed::CreateBlockDecoder() {
+  return std::make_unique<LineDecoder>(this);
 }
 
 bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
@@ -1383,6 +1383,20 @@ class PrivateQueueDataFeed : public DataFeed {
   std::shared_ptr<paddle::framework::ChannelObject<T>> queue_;
 };
 
+// Decodes the records of a block of whole lines, see
+// InMemoryDataFeed::CreateBlockDecoder.
+template <typename T>
+class DataFeedBlockDecoder {
+ public:
+  virtual ~DataFeedBlockDecoder() {}
+  // Appends the records of the lines in [begin, end) to *records and returns
+  // the number of feasigns decoded. Every line ends with a '\n', and the
+  // lines may be modified in place.
+  virtual uint64_t Decode(char* begin,
+                          char* end,
+                          std::vector<T>* records) = 0;
+};
+
 template <typename T>
 class InMemoryDataFeed : public DataFeed {
  public:
@@ -1428,6 +1442,15 @@ class InMemoryDataFeed : public DataFeed {
   }
   virtual void PutToFeedVec(const std::vector<T>& ins_vec) = 0;
   virtual void PutToFeedVec(const T* ins_vec, int num) = 0;
+  // Returns a decoder to read the local files in blocks and decode them in
+  // parallel instead of parsing the lines from the pipe, or nullptr if the
+  // feed does not support it. Each decoder is used by a single thread.
+  virtual std::unique_ptr<DataFeedBlockDecoder<T>> CreateBlockDecoder() {
+    return nullptr;
+  }
+  // Loads a local file with LocalFileBlockReader if the feed and the pipe
+  // command allow it, returns false otherwise.
+  bool LoadLocalFileInBlocks(const std::string& filename);
 
   std::vector<std::vector<float>> batch_float_feasigns_;
   std::vector<std::vector<uint64_t>> batch_uint64_feasigns_;
@@ -1804,6 +1827,8 @@ class MultiSlotInMemoryDataFeed : public InMemoryDataFeed<Record> {
  protected:
   virtual bool ParseOneInstance(Record* instance);
   virtual bool ParseOneInstanceFromPipe(Record* instance);
+  // Parses a line without the '\n', which may be called concurrently.
+  void ParseOneInstanceFromLine(const char* str, Record* instance);
   virtual void ParseOneInstanceFromSo(const char* str UNUSED,
                                       Record* instance UNUSED,
                                       CustomParser* parser UNUSED) {}
@@ -1811,12 +1836,16 @@ class MultiSlotInMemoryDataFeed : public InMemoryDataFeed<Record> {
                                   const char* str,
                                   std::vector<Record>* instances,
                                   CustomParser* parser);
+  std::unique_ptr<DataFeedBlockDecoder<Record>> CreateBlockDecoder() override;
   virtual void PutToFeedVec(const std::vector<Record>& ins_vec);
   virtual void GetMsgFromLogKey(const std::string& log_key,
                                 uint64_t* search_id,
                                 uint32_t* cmatch,
                                 uint32_t* rank);
   virtual void PutToFeedVec(const Record* ins_vec, int num);
+
+ private:
+  class LineDecoder;
 };
 
 class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
@@ -0,0 +1,111 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/channel.h"
+#include "paddle/fluid/framework/data_feed.h"
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(local_block_reader_decode_threads);
+
+namespace paddle {
+namespace framework {
+
+class LocalBlockTestDataFeed : public MultiSlotInMemoryDataFeed {
+ public:
+  using MultiSlotInMemoryDataFeed::LoadLocalFileInBlocks;
+};
+
+// The feasigns of the i-th record: more of them every few lines, so that the
+// lines are shorter and longer than a block.
+std::vector<uint64_t> RecordFeasigns(int i) {
+  std::vector<uint64_t> feasigns(1 + i * 37 % 700);
+  for (size_t j = 0; j < feasigns.size(); ++j) {
+    feasigns[j] = static_cast<uint64_t>(i) * 1000 + j + 1;
+  }
+  return feasigns;
+}
+
+TEST(DataFeed, LoadLocalFileInBlocks) {
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(PADDLE_ARM)
+  constexpr int kNumRecords = 3000;
+  const std::string filename = "local_block_records.txt";
+  {
+    std::ofstream out(filename);
+    for (int i = 0; i < kNumRecords; ++i) {
+      auto feasigns = RecordFeasigns(i);
+      out << feasigns.size();
+      for (uint64_t feasign : feasigns) {
+        out << " " << feasign;
+      }
+      // the last record has no '\n'
+      if (i + 1 < kNumRecords) out << "\n";
+    }
+  }
+
+  DataFeedDesc desc;
+  desc.set_name("MultiSlotInMemoryDataFeed");
+  desc.set_batch_size(2);
+  desc.set_pipe_command("cat");
+  Slot* slot = desc.mutable_multi_slot_desc()->add_slots();
+  slot->set_name("ids");
+  slot->set_type("uint64");
+  slot->set_is_dense(false);
+  slot->set_is_used(true);
+
+  size_t block_size = localfs_block_size();
+  int decode_threads = FLAGS_local_block_reader_decode_threads;
+  localfs_set_block_size(4096);
+  FLAGS_local_block_reader_decode_threads = 4;
+
+  LocalBlockTestDataFeed feed;
+  feed.Init(desc);
+  auto channel = MakeChannel<Record>();
+  std::mutex fea_num_mutex;
+  uint64_t fea_num = 0;
+  feed.SetInputChannel(channel.get());
+  feed.SetFeaNumMutex(&fea_num_mutex);
+  feed.SetFeaNum(&fea_num);
+  EXPECT_TRUE(feed.LoadLocalFileInBlocks(filename));
+
+  localfs_set_block_size(block_size);
+  FLAGS_local_block_reader_decode_threads = decode_threads;
+
+  channel->Close();
+  std::vector<Record> records;
+  channel->ReadAll(records);
+  ASSERT_EQ(records.size(), static_cast<size_t>(kNumRecords));
+  uint64_t expected_fea_num = 0;
+  for (int i = 0; i < kNumRecords; ++i) {
+    auto feasigns = RecordFeasigns(i);
+    expected_fea_num += feasigns.size();
+    ASSERT_EQ(records[i].uint64_feasigns_.size(), feasigns.size())
+        << "record " << i;
+    for (size_t j = 0; j < feasigns.size(); ++j) {
+      EXPECT_EQ(records[i].uint64_feasigns_[j].sign().uint64_feasign_,
+                feasigns[j]);
+      EXPECT_EQ(records[i].uint64_feasigns_[j].slot(), 0);
+    }
+  }
+  EXPECT_EQ(fea_num, expected_fea_num);
+#endif
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -21,6 +21,7 @@
 #include "paddle/fluid/framework/data_feed_factory.h"
 #include "paddle/fluid/framework/fleet/fleet_wrapper.h"
 #include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/framework/parallel_shuffle.h"
 #include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/timer.h"
 #include "paddle/phi/core/flags.h"
@@ -645,7 +646,7 @@ void DatasetImpl<T>::LocalShuffle() {
   input_channel_->Close();
   std::vector<T> data;
   input_channel_->ReadAll(data);
-  std::shuffle(data.begin(), data.end(), fleet_ptr->LocalRandomEngine());
+  ParallelShuffle(&data, thread_num_, &fleet_ptr->LocalRandomEngine());
   input_channel_->Open();
   input_channel_->Write(std::move(data));
   data.clear();
@@ -770,21 +771,18 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
     return;
   }
 
+  if (thread_num == -1) {
+    thread_num = thread_num_;
+  }
   // local shuffle
   input_channel_->Close();
   std::vector<Record> data;
   input_channel_->ReadAll(data);
-  std::shuffle(data.begin(), data.end(), fleet_ptr->LocalRandomEngine());
-  input_channel_->Open();
-  input_channel_->Write(std::move(data));
-  data.clear();
-  data.shrink_to_fit();
-
-  input_channel_->Close();
+  ParallelShuffle(&data, thread_num, &fleet_ptr->LocalRandomEngine());
   input_channel_->SetBlockSize(fleet_send_batch_size_);
-  VLOG(3) << "MultiSlotDataset::GlobalShuffle() input_channel_ size "
-          << input_channel_->Size();
+  VLOG(3) << "MultiSlotDataset::GlobalShuffle() data size " << data.size();
 
+  // called by the exchange threads, whose random engines are thread local
   auto get_client_id = [this, fleet_ptr](const Record& data) -> size_t {
     if (this->merge_by_insid_) {
       return XXH64(data.ins_id_.data(), data.ins_id_.length(), 0) %
@@ -796,66 +794,25 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
       return fleet_ptr->LocalRandomEngine()() % this->trainer_num_;
     }
   };
-
-  auto global_shuffle_func = [this, get_client_id]() {
-#ifdef PADDLE_WITH_PSCORE
-    auto fleet_ptr = distributed::FleetWrapper::GetInstance();
-#else
-    auto fleet_ptr = framework::FleetWrapper::GetInstance();
-#endif
-    // auto fleet_ptr = framework::FleetWrapper::GetInstance();
-    std::vector<Record> data;
-    while (this->input_channel_->Read(data)) {
-      std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
-      for (auto& t : data) {
-        auto client_id = get_client_id(t);
-        ars[client_id] << t;
-      }
-      std::vector<std::future<int32_t>> total_status;
-      std::vector<int> send_index(this->trainer_num_);
-      for (int i = 0; i < this->trainer_num_; ++i) {
-        send_index[i] = i;
-      }
-      std::shuffle(
-          send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
-      for (int index = 0; index < this->trainer_num_; ++index) {
-        int i = send_index[index];
-        if (ars[i].Length() == 0) {
-          continue;
-        }
-        std::string msg(ars[i].Buffer(), ars[i].Length());
-        auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
-        total_status.push_back(std::move(ret));
-      }
-      for (auto& t : total_status) {
-        t.wait();
-      }
-      ars.clear();
-      ars.shrink_to_fit();
-      data.clear();
-      data.shrink_to_fit();
-      // currently we find bottleneck is server not able to handle large data
-      // in time, so we can remove this sleep and set fleet_send_batch_size to
-      // 1024, and set server thread to 24.
-      if (fleet_send_sleep_seconds_ != 0) {
-        sleep(this->fleet_send_sleep_seconds_);
-      }
-    }
+  auto send = [fleet_ptr](int client_id, const std::string& msg) {
+    return fleet_ptr->SendClientToClientMsg(0, client_id, msg);
   };
-
-  std::vector<std::thread> global_shuffle_threads;
-  if (thread_num == -1) {
-    thread_num = thread_num_;
+  // currently we find bottleneck is server not able to handle large data
+  // in time, so we can remove this sleep and set fleet_send_batch_size to
+  // 1024, and set server thread to 24.
+  std::function<void()> after_round = nullptr;
+  if (fleet_send_sleep_seconds_ != 0) {
+    after_round = [this]() { sleep(this->fleet_send_sleep_seconds_); };
   }
+
   VLOG(3) << "start global shuffle threads, num = " << thread_num;
-  for (int i = 0; i < thread_num; ++i) {
-    global_shuffle_threads.emplace_back(global_shuffle_func);
-  }
-  for (std::thread& t : global_shuffle_threads) {
-    t.join();
-  }
-  global_shuffle_threads.clear();
-  global_shuffle_threads.shrink_to_fit();
+  PartitionedExchange<Record>(&data,
+                              trainer_num_,
+                              thread_num,
+                              fleet_send_batch_size_,
+                              get_client_id,
+                              send,
+                              after_round);
   input_channel_->Clear();
   timeline.Pause();
   VLOG(3) << "DatasetImpl<T>::GlobalShuffle() end, cost time="
@@ -15,7 +15,13 @@ limitations under the License. */
 #include "paddle/fluid/framework/io/fs.h"
 
 #include <sys/stat.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <memory>
 
 #include "glog/logging.h"
@@ -227,6 +233,85 @@ void localfs_mv(const std::string& src, const std::string& dest) {
   shell_execute(string::format_string("mv %s %s", src.c_str(), dest.c_str()));
 }
 
+static size_t& localfs_block_size_internal() {
+  static size_t x = 4 << 20;
+  return x;
+}
+
+size_t localfs_block_size() { return localfs_block_size_internal(); }
+
+void localfs_set_block_size(size_t x) { localfs_block_size_internal() = x; }
+
+bool localfs_can_read_blocks(const std::string& path,
+                             const std::string& converter) {
+#if defined(_WIN32) || defined(__APPLE__) || defined(PADDLE_ARM)
+  return false;
+#else
+  std::string command = string::trim_spaces(converter);
+  return fs_select_internal(path) == 0 && !fs_end_with_internal(path, ".gz") &&
+         (command.empty() || command == "cat");
+#endif
+}
+
+LocalFileBlockReader::LocalFileBlockReader(const std::string& path,
+                                           size_t block_size) {
+#if defined(_WIN32) || defined(__APPLE__) || defined(PADDLE_ARM)
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "LocalFileBlockReader is not implemented on this platform."));
+#else
+  // Keep the reads aligned to the pages of the page cache.
+  constexpr size_t kPageSize = 4096;
+  block_size_ =
+      std::max(kPageSize, (block_size + kPageSize - 1) / kPageSize * kPageSize);
+  fd_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  PADDLE_ENFORCE_GE(fd_,
+                    0,
+                    platform::errors::Unavailable(
+                        "Failed to open file %s: %s", path, strerror(errno)));
+  posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+LocalFileBlockReader::~LocalFileBlockReader() {
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(PADDLE_ARM)
+  if (fd_ >= 0) close(fd_);
+#endif
+}
+
+bool LocalFileBlockReader::Next(std::vector<char>* block) {
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(PADDLE_ARM)
+  block->swap(carry_);
+  carry_.clear();
+  while (!eof_) {
+    size_t size = block->size();
+    block->resize(size + block_size_);
+    ssize_t n = pread(fd_, block->data() + size, block_size_, offset_);
+    if (n < 0 && errno == EINTR) {
+      block->resize(size);
+      continue;
+    }
+    PADDLE_ENFORCE_GE(
+        n,
+        0,
+        platform::errors::External("Failed to read file: %s", strerror(errno)));
+    block->resize(size + n);
+    offset_ += n;
+    eof_ = n == 0;
+    auto last_line_end = std::find(block->rbegin(),
+                                   block->rbegin() + static_cast<int64_t>(n),
+                                   '\n');
+    if (last_line_end != block->rbegin() + static_cast<int64_t>(n)) {
+      carry_.assign(last_line_end.base(), block->end());
+      block->erase(last_line_end.base(), block->end());
+      return true;
+    }
+  }
+  return !block->empty();
+#else
+  return false;
+#endif
+}
+
 static size_t& hdfs_buffer_size_internal() {
   static size_t x = 0;
   return x;
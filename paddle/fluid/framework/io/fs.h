@@ -55,6 +55,38 @@ extern void localfs_mkdir(const std::string& path);
 
 extern void localfs_mv(const std::string& src, const std::string& dest);
 
+extern size_t localfs_block_size();
+
+extern void localfs_set_block_size(size_t x);
+
+// Whether the file is a local file which LocalFileBlockReader can read
+// directly, i.e. it is not compressed and the converter does nothing.
+extern bool localfs_can_read_blocks(const std::string& path,
+                                    const std::string& converter);
+
+// Reads a local file in large blocks of whole lines with pread, without the
+// stdio buffers and the converter pipes. The reads are issued at offsets
+// aligned to the block size, which is a multiple of the page size, and the
+// partial line at the end of a block is carried over to the next block.
+class LocalFileBlockReader {
+ public:
+  explicit LocalFileBlockReader(const std::string& path,
+                                size_t block_size = localfs_block_size());
+  ~LocalFileBlockReader();
+
+  // Replaces *block with the next lines of the file, each ending with a
+  // '\n' except the last line of the file. Returns false at the end of the
+  // file.
+  bool Next(std::vector<char>* block);
+
+ private:
+  int fd_ = -1;
+  size_t block_size_;
+  uint64_t offset_ = 0;
+  bool eof_ = false;
+  std::vector<char> carry_;
+};
+
 // hdfs
 extern size_t hdfs_buffer_size();
 
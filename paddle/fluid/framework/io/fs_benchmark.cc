@@ -0,0 +1,83 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The throughput of LocalFileBlockReader against the lines read through a
+// pipe. This target is built with the tests but not run by ctest, run it by
+// hand.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/io/fs.h"
+
+#if defined _WIN32 || defined __APPLE__
+#else
+#define _LINUX
+#endif
+
+TEST(FS, LocalFileBlockReaderBenchmark) {
+#ifdef _LINUX
+  const std::string path = "block_reader_benchmark.txt";
+  size_t bytes = 0;
+  {
+    std::ofstream out(path);
+    std::string line;
+    for (int i = 0; i < 64; ++i) {
+      line += " " + std::to_string(i * 2654435761u);
+    }
+    for (int i = 0; i < 200000; ++i) {
+      out << "64" << line << "\n";
+      bytes += line.size() + 3;
+    }
+  }
+
+  // The lines are read through a pipe by the data feeds if they are not read
+  // in blocks, the file is cached by the first pass.
+  auto start = std::chrono::steady_clock::now();
+  size_t pipe_lines = 0;
+  int err_no = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    if (pass == 1) start = std::chrono::steady_clock::now();
+    auto fp = paddle::framework::fs_open_read(path, &err_no, "cat", true);
+    paddle::string::LineFileReader reader;
+    pipe_lines = 0;
+    while (reader.getline(&*fp)) ++pipe_lines;
+  }
+  double pipe_sec = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+  start = std::chrono::steady_clock::now();
+  paddle::framework::LocalFileBlockReader reader(path);
+  std::vector<char> block;
+  size_t block_lines = 0;
+  while (reader.Next(&block)) {
+    block_lines += std::count(block.begin(), block.end(), '\n');
+  }
+  double block_sec = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+  EXPECT_EQ(pipe_lines, 200000u);
+  EXPECT_EQ(block_lines, 200000u);
+  LOG(INFO) << "read " << bytes / 1e9 << " GB, pipe: " << bytes / 1e9 / pipe_sec
+            << " GB/s, blocks: " << bytes / 1e9 / block_sec << " GB/s";
+  paddle::framework::localfs_remove(path);
+#endif
+}
@@ -15,6 +15,8 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "paddle/fluid/framework/io/fs.h"
 
@@ -60,3 +62,51 @@ TEST(FS, mv) {
 
 #endif
 }
+
+#ifdef _LINUX
+static std::string read_blocks(const std::string& path, size_t block_size) {
+  paddle::framework::LocalFileBlockReader reader(path, block_size);
+  std::vector<char> block;
+  std::string content;
+  while (reader.Next(&block)) {
+    EXPECT_FALSE(block.empty());
+    content.append(block.begin(), block.end());
+    // Only the last block may end in the middle of a line.
+    if (block.back() != '\n') {
+      EXPECT_FALSE(reader.Next(&block));
+      break;
+    }
+  }
+  return content;
+}
+#endif
+
+TEST(FS, LocalFileBlockReader) {
+#ifdef _LINUX
+  EXPECT_TRUE(paddle::framework::localfs_can_read_blocks("a.txt", ""));
+  EXPECT_TRUE(paddle::framework::localfs_can_read_blocks("a.txt", " cat "));
+  EXPECT_FALSE(paddle::framework::localfs_can_read_blocks("a.txt.gz", ""));
+  EXPECT_FALSE(paddle::framework::localfs_can_read_blocks("afs:/a.txt", ""));
+  EXPECT_FALSE(paddle::framework::localfs_can_read_blocks("a.txt", "sort"));
+
+  // Lines shorter and longer than a block, without the last '\n'.
+  std::string content;
+  for (int i = 0; i < 2000; ++i) {
+    content += std::string(i * 7 % 10000, 'a' + i % 26) + "\n";
+  }
+  content += "last line";
+  {
+    std::ofstream out("block_reader.txt");
+    out << content;
+  }
+  EXPECT_EQ(read_blocks("block_reader.txt", 4096), content);
+  EXPECT_EQ(read_blocks("block_reader.txt", 1 << 20), content);
+
+  {
+    std::ofstream out("block_reader_empty.txt");
+  }
+  EXPECT_EQ(read_blocks("block_reader_empty.txt", 4096), "");
+  paddle::framework::localfs_remove("block_reader.txt");
+  paddle::framework::localfs_remove("block_reader_empty.txt");
+#endif
+}
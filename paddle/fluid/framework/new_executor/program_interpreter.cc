@@ -922,6 +922,8 @@ void ProgramInterpreter::RunOperator(const Instruction& instr_node) {
     }
   }
 
+  RecordOutputVarsMemory(op->Outputs(), *local_scope);
+
   VLOG(4) << "End run " << place << " "
           << op->DebugStringEx(local_scope);  // NOLINT
 
@@ -792,6 +792,7 @@ void OperatorBase::Run(const Scope& scope, const platform::Place& place) {
           FLAGS_enable_host_event_recorder_hook ? 20 : 1,
           platform::EventRole::kUniqueOp);
       RunImpl(scope, place);
+      RecordOutputVarsMemory(outputs_, scope);
     }
 
     VLOG(3) << GetExecutionPlace(place) << " " << DebugStringEx(&scope);
@@ -1081,6 +1082,27 @@ phi::DenseTensor* GetMutableLoDTensorOrSelectedRowsValueFromVar(Variable* var) {
   }
 }
 
+void RecordOutputVarsMemory(const VariableNameMap& outputs,
+                            const Scope& scope) {
+  if (platform::RecordMemEvent::IsEnabled() == false) {
+    return;
+  }
+  for (auto& output : outputs) {
+    for (auto& var_name : output.second) {
+      auto* var = scope.FindVar(var_name);
+      if (var == nullptr || !VarIsTensor(*var)) {
+        continue;
+      }
+      auto* tensor = GetLoDTensorOrSelectedRowsValueFromVar(*var);
+      if (!tensor->IsInitialized() || tensor->Holder()->ptr() == nullptr) {
+        continue;
+      }
+      platform::RecordMemVarEvent(
+          tensor->Holder()->ptr(), tensor->place(), var_name);
+    }
+  }
+}
+
 OperatorWithKernel::OperatorWithKernel(const std::string& type,
                                        const VariableNameMap& inputs,
                                        const VariableNameMap& outputs,
@@ -134,6 +134,11 @@ const phi::DenseTensor* GetLoDTensorOrSelectedRowsValueFromVar(
     const Variable& var);
 phi::DenseTensor* GetMutableLoDTensorOrSelectedRowsValueFromVar(Variable* var);
 
+// Record the variables holding the memory written by an operator, so that the
+// profiler can attribute the memory to them. It does nothing unless the
+// memory events are recorded.
+void RecordOutputVarsMemory(const VariableNameMap& outputs, const Scope& scope);
+
 class ExecutionContext;
 class OperatorBase;
 
@@ -0,0 +1,173 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <future>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/framework/archive.h"
+
+namespace paddle {
+namespace framework {
+
+namespace detail {
+
+// Below this many records per thread, the threads cost more than they save.
+constexpr size_t kMinShuffleRecordsPerThread = 1 << 14;
+
+template <typename Func>
+void RunInThreads(int thread_num, Func&& func) {
+  std::vector<std::thread> threads;
+  for (int i = 1; i < thread_num; ++i) {
+    threads.emplace_back(func, i);
+  }
+  func(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace detail
+
+// Shuffles the records with thread_num threads. Every thread scatters a part
+// of the records into thread_num buckets at random, then every thread gathers
+// a bucket from all the parts and shuffles it with Fisher-Yates. The result is
+// a uniform permutation since every record falls in a bucket independently.
+template <typename T>
+void ParallelShuffle(std::vector<T>* data,
+                     int thread_num,
+                     std::default_random_engine* engine) {
+  size_t size = data->size();
+  thread_num = static_cast<int>(std::min<size_t>(
+      std::max(thread_num, 1), size / detail::kMinShuffleRecordsPerThread + 1));
+  if (thread_num == 1) {
+    std::shuffle(data->begin(), data->end(), *engine);
+    return;
+  }
+  std::vector<uint64_t> seeds(2 * thread_num);
+  for (auto& seed : seeds) {
+    seed = (*engine)();
+  }
+
+  // buckets[i][j] holds the records of part i scattered to bucket j.
+  std::vector<std::vector<std::vector<T>>> buckets(
+      thread_num, std::vector<std::vector<T>>(thread_num));
+  detail::RunInThreads(thread_num, [&](int i) {
+    std::mt19937_64 rng(seeds[i]);
+    size_t begin = size * i / thread_num;
+    size_t end = size * (i + 1) / thread_num;
+    for (auto& bucket : buckets[i]) {
+      bucket.reserve((end - begin) / thread_num * 9 / 8);
+    }
+    for (size_t k = begin; k < end; ++k) {
+      buckets[i][rng() % thread_num].push_back(std::move((*data)[k]));
+    }
+  });
+
+  std::vector<size_t> offsets(thread_num + 1, 0);
+  for (int j = 0; j < thread_num; ++j) {
+    offsets[j + 1] = offsets[j];
+    for (int i = 0; i < thread_num; ++i) {
+      offsets[j + 1] += buckets[i][j].size();
+    }
+  }
+  detail::RunInThreads(thread_num, [&](int j) {
+    auto out = data->begin() + offsets[j];
+    for (int i = 0; i < thread_num; ++i) {
+      out = std::move(buckets[i][j].begin(), buckets[i][j].end(), out);
+      std::vector<T>().swap(buckets[i][j]);
+    }
+    std::mt19937_64 rng(seeds[thread_num + j]);
+    std::shuffle(
+        data->begin() + offsets[j], data->begin() + offsets[j + 1], rng);
+  });
+}
+
+// Sends the records to the trainers chosen by get_client_id with thread_num
+// threads, and clears *data. Every thread partitions a part of the records
+// into a buffer per trainer, and sends a buffer once it holds batch_size
+// records, so that the messages carry batch_size records rather than about
+// batch_size / trainer_num as when a batch is partitioned at once. A thread
+// waits for its messages in flight after trainer_num messages, which bounds
+// the memory of the buffers being sent, then calls after_round if it is set.
+// get_client_id and after_round are called concurrently.
+template <typename T>
+void PartitionedExchange(
+    std::vector<T>* data,
+    int trainer_num,
+    int thread_num,
+    int64_t batch_size,
+    const std::function<size_t(const T&)>& get_client_id,
+    const std::function<std::future<int32_t>(int, const std::string&)>& send,
+    const std::function<void()>& after_round = nullptr) {
+  size_t size = data->size();
+  thread_num = static_cast<int>(
+      std::min<size_t>(std::max(thread_num, 1), std::max<size_t>(size, 1)));
+  batch_size = std::max<int64_t>(batch_size, 1);
+  detail::RunInThreads(thread_num, [&](int t) {
+    std::vector<BinaryArchive> ars(trainer_num);
+    std::vector<int64_t> counts(trainer_num, 0);
+    std::vector<std::future<int32_t>> in_flight;
+    auto wait_round = [&]() {
+      if (in_flight.empty()) {
+        return;
+      }
+      for (auto& status : in_flight) {
+        status.wait();
+      }
+      in_flight.clear();
+      if (after_round) {
+        after_round();
+      }
+    };
+    auto flush = [&](int client_id) {
+      if (counts[client_id] == 0) {
+        return;
+      }
+      std::string msg(ars[client_id].Buffer(), ars[client_id].Length());
+      in_flight.push_back(send(client_id, msg));
+      ars[client_id].Clear();
+      counts[client_id] = 0;
+      if (static_cast<int>(in_flight.size()) >= trainer_num) {
+        wait_round();
+      }
+    };
+    size_t begin = size * t / thread_num;
+    size_t end = size * (t + 1) / thread_num;
+    for (size_t k = begin; k < end; ++k) {
+      size_t client_id = get_client_id((*data)[k]);
+      ars[client_id] << (*data)[k];
+      if (++counts[client_id] >= batch_size) {
+        flush(static_cast<int>(client_id));
+      }
+    }
+    // The threads start from different trainers to spread the last messages.
+    for (int i = 0; i < trainer_num; ++i) {
+      flush((t + i) % trainer_num);
+    }
+    wait_round();
+  });
+  data->clear();
+  data->shrink_to_fit();
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,32 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The timings of the global shuffle of the trainer processes exchanging
+// their records over unix sockets. This target is built with the tests but
+// not run by ctest, run it by hand.
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/parallel_shuffle_test.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(PartitionedExchange, MultiProcessBenchmark) {
+  for (size_t records_per_trainer : {3000, 300000, 3000000}) {
+    RunTrainers(3, records_per_trainer);
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,112 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/parallel_shuffle.h"
+
+#include <mutex>  // NOLINT
+#include <numeric>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/parallel_shuffle_test.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(ParallelShuffle, Permutation) {
+  std::default_random_engine engine(0);
+  for (size_t size : {0, 1, 1000, 100000}) {
+    std::vector<uint64_t> data(size);
+    std::iota(data.begin(), data.end(), 0);
+    ParallelShuffle(&data, 4, &engine);
+    ASSERT_EQ(data.size(), size);
+    size_t moved = 0;
+    for (size_t i = 0; i < size; ++i) {
+      moved += data[i] != i;
+    }
+    std::sort(data.begin(), data.end());
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(data[i], i);
+    }
+    if (size >= 1000) {
+      EXPECT_GT(moved, size * 9 / 10);
+    }
+  }
+}
+
+TEST(ParallelShuffle, Uniform) {
+  // Every record lands at the first position about as often as the others,
+  // across the buckets of the threads.
+  constexpr size_t kSize = 1 << 16;
+  constexpr int kRuns = 400;
+  constexpr size_t kGroups = 4;
+  std::default_random_engine engine(0);
+  std::vector<int> counts(kGroups, 0);
+  for (int run = 0; run < kRuns; ++run) {
+    std::vector<uint32_t> data(kSize);
+    std::iota(data.begin(), data.end(), 0);
+    ParallelShuffle(&data, 4, &engine);
+    ++counts[data[0] / (kSize / kGroups)];
+  }
+  for (int count : counts) {
+    EXPECT_GT(count, kRuns / kGroups / 2);
+    EXPECT_LT(count, kRuns / kGroups * 3 / 2);
+  }
+}
+
+TEST(PartitionedExchange, Rounds) {
+  // after_round is called once a round of trainer_num messages is sent, and
+  // once after the last messages, rather than once per message.
+  constexpr int kTrainerNum = 3;
+  std::vector<uint64_t> data(3000);
+  std::iota(data.begin(), data.end(), 0);
+  std::mutex mutex;
+  std::vector<uint64_t> sent;
+  int messages = 0;
+  int rounds = 0;
+  auto send = [&](int client_id, const std::string& msg) {
+    std::vector<uint64_t> records;
+    Decode(msg, &records);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto record : records) {
+      EXPECT_EQ(static_cast<int>(record % kTrainerNum), client_id);
+    }
+    sent.insert(sent.end(), records.begin(), records.end());
+    ++messages;
+    std::promise<int32_t> status;
+    status.set_value(0);
+    return status.get_future();
+  };
+  auto get_client_id = [](const uint64_t& record) -> size_t {
+    return record % kTrainerNum;
+  };
+  auto after_round = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++rounds;
+  };
+  PartitionedExchange<uint64_t>(
+      &data, kTrainerNum, 1, 100, get_client_id, send, after_round);
+  EXPECT_TRUE(data.empty());
+  ASSERT_EQ(sent.size(), 3000UL);
+  std::sort(sent.begin(), sent.end());
+  for (size_t i = 0; i < sent.size(); ++i) {
+    ASSERT_EQ(sent[i], i);
+  }
+  EXPECT_EQ(messages, 30);
+  EXPECT_EQ(rounds, 10);
+}
+
+TEST(PartitionedExchange, MultiProcess) { RunTrainers(3, 3000); }
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,185 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <mutex>   // NOLINT
+#include <numeric>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/parallel_shuffle.h"
+
+// The trainer processes exchanging their records shared by
+// parallel_shuffle_test and parallel_shuffle_benchmark.
+
+namespace paddle {
+namespace framework {
+
+inline bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = write(fd, data, size);
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+inline bool ReadAll(int fd, char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = read(fd, data, size);
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+inline void Decode(const std::string& msg, std::vector<uint64_t>* records) {
+  BinaryArchive ar;
+  ar.SetReadBuffer(const_cast<char*>(msg.data()), msg.size(), nullptr);
+  while (ar.Cursor() < ar.Finish()) {
+    records->push_back(ar.Get<uint64_t>());
+  }
+}
+
+// A trainer process exchanging the messages with the others through unix
+// sockets, as the fleet wrapper does through the RPC between the trainers.
+inline int RunTrainer(int rank,
+               int trainer_num,
+               size_t records_per_trainer,
+               const std::vector<std::vector<int>>& fds) {
+  std::mutex mutex;
+  std::vector<uint64_t> received;
+  std::vector<std::thread> receivers;
+  for (int peer = 0; peer < trainer_num; ++peer) {
+    if (peer == rank) continue;
+    receivers.emplace_back([&, peer] {
+      uint64_t size = 0;
+      while (ReadAll(fds[rank][peer], reinterpret_cast<char*>(&size), 8)) {
+        std::string msg(size, '\0');
+        CHECK(ReadAll(fds[rank][peer], &msg[0], size));
+        std::vector<uint64_t> records;
+        Decode(msg, &records);
+        std::lock_guard<std::mutex> lock(mutex);
+        received.insert(received.end(), records.begin(), records.end());
+      }
+    });
+  }
+  std::vector<std::mutex> send_mutexes(trainer_num);
+  auto send = [&](int client_id, const std::string& msg) {
+    if (client_id == rank) {
+      std::vector<uint64_t> records;
+      Decode(msg, &records);
+      std::lock_guard<std::mutex> lock(mutex);
+      received.insert(received.end(), records.begin(), records.end());
+    } else {
+      std::lock_guard<std::mutex> lock(send_mutexes[client_id]);
+      uint64_t size = msg.size();
+      int fd = fds[rank][client_id];
+      CHECK(WriteAll(fd, reinterpret_cast<char*>(&size), 8));
+      CHECK(WriteAll(fd, msg.data(), msg.size()));
+    }
+    std::promise<int32_t> status;
+    status.set_value(0);
+    return status.get_future();
+  };
+  auto get_client_id = [trainer_num](const uint64_t& record) -> size_t {
+    return record % trainer_num;
+  };
+
+  std::vector<uint64_t> data(records_per_trainer);
+  std::iota(data.begin(), data.end(), rank * records_per_trainer);
+  std::default_random_engine engine(rank);
+  auto start = std::chrono::steady_clock::now();
+  ParallelShuffle(&data, 4, &engine);
+  PartitionedExchange<uint64_t>(
+      &data, trainer_num, 4, 1024, get_client_id, send);
+  for (int peer = 0; peer < trainer_num; ++peer) {
+    if (peer != rank) shutdown(fds[rank][peer], SHUT_WR);
+  }
+  for (auto& receiver : receivers) {
+    receiver.join();
+  }
+  ParallelShuffle(&received, 4, &engine);
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  if (rank == 0) {
+    LOG(INFO) << "global shuffle of " << records_per_trainer * trainer_num
+              << " records on " << trainer_num << " trainers: " << ms << " ms";
+  }
+
+  // The trainer gets the records of its partition from every trainer.
+  std::sort(received.begin(), received.end());
+  if (received.size() != records_per_trainer) return 1;
+  for (size_t i = 0; i < received.size(); ++i) {
+    if (received[i] != rank + i * trainer_num) return 2;
+  }
+  return 0;
+}
+
+// Runs trainer_num trainer processes that shuffle records_per_trainer records
+// each, and checks that every trainer gets its partition.
+inline void RunTrainers(int trainer_num, size_t records_per_trainer) {
+  // fds[i][j] is the socket of trainer i connected to trainer j.
+  std::vector<std::vector<int>> fds(trainer_num,
+                                    std::vector<int>(trainer_num, -1));
+  for (int i = 0; i < trainer_num; ++i) {
+    for (int j = i + 1; j < trainer_num; ++j) {
+      int pair[2];
+      ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+      fds[i][j] = pair[0];
+      fds[j][i] = pair[1];
+    }
+  }
+  std::vector<pid_t> pids;
+  for (int rank = 0; rank < trainer_num; ++rank) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      for (int i = 0; i < trainer_num; ++i) {
+        for (int j = 0; j < trainer_num; ++j) {
+          if (i != rank && fds[i][j] >= 0) close(fds[i][j]);
+        }
+      }
+      _exit(RunTrainer(rank, trainer_num, records_per_trainer, fds));
+    }
+    pids.push_back(pid);
+  }
+  for (auto& row : fds) {
+    for (int fd : row) {
+      if (fd >= 0) close(fd);
+    }
+  }
+  for (int rank = 0; rank < trainer_num; ++rank) {
+    int status = 0;
+    ASSERT_EQ(waitpid(pids[rank], &status, 0), pids[rank]);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0)
+        << "trainer " << rank << ", " << records_per_trainer << " records";
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
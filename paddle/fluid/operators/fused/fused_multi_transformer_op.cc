@@ -12,11 +12,21 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/op_version_registry.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
 
 namespace paddle {
 namespace operators {
@@ -294,6 +304,596 @@ class FusedMultiTransformerOpOpMaker
   }
 };
 
+namespace {
+
+#ifdef PADDLE_WITH_MKLML
+// The weights packed for the MKL GEMM. The weights of an inference program do
+// not change between the runs, so every weight is packed once and kept until
+// its allocation is freed.
+template <typename T>
+class PackedWeightCache {
+ public:
+  static PackedWeightCache &Instance() {
+    // Never destroyed, since MKL may be unloaded before the static objects.
+    static auto *cache = new PackedWeightCache();
+    return *cache;
+  }
+
+  // weight is [k, n], or [n, k] if trans.
+  const T *Get(const phi::CPUContext &dev_ctx,
+               const phi::DenseTensor &weight,
+               bool trans,
+               int n,
+               int k) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(weight.data());
+    if (iter != entries_.end()) {
+      const auto &entry = iter->second;
+      if (entry.holder.lock() == weight.Holder() && entry.trans == trans &&
+          entry.n == n && entry.k == k) {
+        return entry.packed;
+      }
+    }
+    auto blas = phi::funcs::GetBlas<phi::CPUContext, T>(dev_ctx);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it == iter || it->second.holder.expired()) {
+        blas.GEMM_FREE(it->second.packed);
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    // The packed weight does not depend on the rows of the input.
+    T *packed = blas.GEMM_ALLOC(CblasBMatrix, 1, n, k);
+    PADDLE_ENFORCE_NOT_NULL(
+        packed,
+        platform::errors::ResourceExhausted(
+            "Failed to allocate the packed weight of [%d, %d].", k, n));
+    blas.GEMM_PACK(CblasBMatrix,
+                   trans ? CblasTrans : CblasNoTrans,
+                   1,
+                   n,
+                   k,
+                   static_cast<T>(1),
+                   weight.data<T>(),
+                   trans ? k : n,
+                   packed);
+    entries_[weight.data()] = {weight.Holder(), trans, n, k, packed};
+    return packed;
+  }
+
+ private:
+  struct Entry {
+    std::weak_ptr<phi::Allocation> holder;
+    bool trans;
+    int n;
+    int k;
+    T *packed;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<const void *, Entry> entries_;
+};
+#endif
+
+// out [m, n] = x [m, k] * weight, where weight is [k, n], or [n, k] if trans.
+template <typename T>
+void Linear(const phi::CPUContext &dev_ctx,
+            const T *x,
+            const phi::DenseTensor &weight,
+            bool trans,
+            int m,
+            int n,
+            int k,
+            T *out) {
+  auto blas = phi::funcs::GetBlas<phi::CPUContext, T>(dev_ctx);
+#ifdef PADDLE_WITH_MKLML
+  const T *packed =
+      PackedWeightCache<T>::Instance().Get(dev_ctx, weight, trans, n, k);
+  blas.GEMM_COMPUTE(CblasNoTrans,
+                    CblasPacked,
+                    m,
+                    n,
+                    k,
+                    x,
+                    k,
+                    packed,
+                    trans ? k : n,
+                    static_cast<T>(0),
+                    out,
+                    n);
+#else
+  blas.GEMM(CblasNoTrans,
+            trans ? CblasTrans : CblasNoTrans,
+            m,
+            n,
+            k,
+            static_cast<T>(1),
+            x,
+            weight.data<T>(),
+            static_cast<T>(0),
+            out);
+#endif
+}
+
+template <typename T>
+void LayerNormRow(const T *x,
+                  const T *scale,
+                  const T *bias,
+                  int cols,
+                  float epsilon,
+                  T *out) {
+  T mean = 0;
+  for (int j = 0; j < cols; ++j) {
+    mean += x[j];
+  }
+  mean /= cols;
+  T var = 0;
+  for (int j = 0; j < cols; ++j) {
+    var += (x[j] - mean) * (x[j] - mean);
+  }
+  var /= cols;
+  const T inv_std = 1 / std::sqrt(var + static_cast<T>(epsilon));
+  for (int j = 0; j < cols; ++j) {
+    out[j] = (x[j] - mean) * inv_std * scale[j] + bias[j];
+  }
+}
+
+template <typename T>
+void LayerNorm(const T *x,
+               const T *scale,
+               const T *bias,
+               int rows,
+               int cols,
+               float epsilon,
+               T *out) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < rows; ++i) {
+    LayerNormRow(x + i * cols, scale, bias, cols, epsilon, out + i * cols);
+  }
+}
+
+// x += y + bias, then out = layer_norm(x) if scale is given, out may be x.
+template <typename T>
+void AddResidualLayerNorm(T *x,
+                          const T *y,
+                          const T *bias,
+                          const T *scale,
+                          const T *ln_bias,
+                          int rows,
+                          int cols,
+                          float epsilon,
+                          T *out) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < rows; ++i) {
+    T *x_row = x + i * cols;
+    const T *y_row = y + i * cols;
+    if (bias) {
+      for (int j = 0; j < cols; ++j) {
+        x_row[j] += y_row[j] + bias[j];
+      }
+    } else {
+      for (int j = 0; j < cols; ++j) {
+        x_row[j] += y_row[j];
+      }
+    }
+    if (scale) {
+      LayerNormRow(x_row, scale, ln_bias, cols, epsilon, out + i * cols);
+    }
+  }
+}
+
+// x = act(x + bias), bias may be null.
+template <typename T>
+void BiasAct(
+    T *x, const T *bias, const std::string &act_method, int rows, int cols) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < rows; ++i) {
+    T *row = x + i * cols;
+    if (bias) {
+      for (int j = 0; j < cols; ++j) {
+        row[j] += bias[j];
+      }
+    }
+    if (act_method == "gelu") {
+      for (int j = 0; j < cols; ++j) {
+        row[j] = row[j] * static_cast<T>(0.5) *
+                 (1 + std::erf(row[j] * static_cast<T>(M_SQRT1_2)));
+      }
+    } else if (act_method == "relu") {
+      for (int j = 0; j < cols; ++j) {
+        row[j] = row[j] > 0 ? row[j] : 0;
+      }
+    }
+  }
+}
+
+// The attention of the queries in qkv [token_num, 3, num_head, dim_head] to
+// the first kv_len keys and values, out is [token_num, num_head, dim_head].
+// With cache_kv [2, bsz, num_head, max_seq_len, dim_head], the keys and values
+// in qkv are written to the cache at cache_offset first, and those of the
+// previous steps are read from it, otherwise they are read from qkv directly.
+template <typename T>
+void Attention(const phi::CPUContext &dev_ctx,
+               const T *qkv,
+               const phi::DenseTensor *src_mask,
+               T *cache_kv,
+               int max_seq_len,
+               int cache_offset,
+               int bsz,
+               int seq_len,
+               int num_head,
+               int dim_head,
+               T *out) {
+  const int hidden_size = num_head * dim_head;
+  const int qkv_stride = 3 * hidden_size;
+  const int kv_len = cache_kv ? cache_offset + seq_len : seq_len;
+  const int64_t cache_v_offset =
+      static_cast<int64_t>(bsz) * num_head * max_seq_len * dim_head;
+
+  int64_t mask_batch_stride = 0, mask_head_stride = 0, mask_row_stride = 0;
+  const T *mask_data = nullptr;
+  if (src_mask) {
+    const auto &dims = src_mask->dims();
+    PADDLE_ENFORCE_EQ(
+        dims.size() == 4 && dims[3] >= kv_len,
+        true,
+        platform::errors::InvalidArgument(
+            "The SrcMask should be [batch_size, 1 or num_head, 1 or seq_len, "
+            "at least %d], but got [%s].",
+            kv_len,
+            dims));
+    mask_data = src_mask->data<T>();
+    mask_row_stride = dims[2] == 1 ? 0 : dims[3];
+    mask_head_stride = dims[1] == 1 ? 0 : dims[2] * dims[3];
+    mask_batch_stride = dims[0] == 1 ? 0 : dims[1] * dims[2] * dims[3];
+  }
+
+  phi::DenseTensor scores;
+  scores.Resize({bsz, num_head, seq_len, kv_len});
+  T *scores_data = dev_ctx.template Alloc<T>(&scores);
+  const T scale = static_cast<T>(1.0 / std::sqrt(dim_head));
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int bh = 0; bh < bsz * num_head; ++bh) {
+    const int b = bh / num_head;
+    const int h = bh % num_head;
+    const T *q = qkv + static_cast<int64_t>(b) * seq_len * qkv_stride +
+                 h * dim_head;
+    const T *k = q + hidden_size;
+    const T *v = q + 2 * hidden_size;
+    int kv_stride = qkv_stride;
+    if (cache_kv) {
+      T *cache_k = cache_kv + static_cast<int64_t>(bh) * max_seq_len * dim_head;
+      T *cache_v = cache_k + cache_v_offset;
+      for (int s = 0; s < seq_len; ++s) {
+        const int64_t pos = static_cast<int64_t>(cache_offset + s) * dim_head;
+        std::memcpy(
+            cache_k + pos, k + s * qkv_stride, dim_head * sizeof(T));
+        std::memcpy(
+            cache_v + pos, v + s * qkv_stride, dim_head * sizeof(T));
+      }
+      k = cache_k;
+      v = cache_v;
+      kv_stride = dim_head;
+    }
+
+    // Runs single threaded in the parallel loop.
+    auto blas = phi::funcs::GetBlas<phi::CPUContext, T>(dev_ctx);
+    T *qk = scores_data + static_cast<int64_t>(bh) * seq_len * kv_len;
+    blas.GEMM(false,
+              true,
+              seq_len,
+              kv_len,
+              dim_head,
+              scale,
+              q,
+              qkv_stride,
+              k,
+              kv_stride,
+              static_cast<T>(0),
+              qk,
+              kv_len);
+    for (int s = 0; s < seq_len; ++s) {
+      T *row = qk + s * kv_len;
+      if (mask_data) {
+        const T *mask_row = mask_data + b * mask_batch_stride +
+                            h * mask_head_stride + s * mask_row_stride;
+        for (int t = 0; t < kv_len; ++t) {
+          row[t] += mask_row[t];
+        }
+      }
+      T max_value = std::numeric_limits<T>::lowest();
+      for (int t = 0; t < kv_len; ++t) {
+        max_value = std::max(max_value, row[t]);
+      }
+      T sum = 0;
+      for (int t = 0; t < kv_len; ++t) {
+        row[t] = std::exp(row[t] - max_value);
+        sum += row[t];
+      }
+      for (int t = 0; t < kv_len; ++t) {
+        row[t] /= sum;
+      }
+    }
+    blas.GEMM(false,
+              false,
+              seq_len,
+              dim_head,
+              kv_len,
+              static_cast<T>(1),
+              qk,
+              kv_len,
+              v,
+              kv_stride,
+              static_cast<T>(0),
+              out + static_cast<int64_t>(b) * seq_len * hidden_size +
+                  h * dim_head,
+              hidden_size);
+  }
+}
+
+}  // namespace
+
+// The layers run on the tokens of all the sequences at once with the weights
+// pre-packed for MKL. With CacheKV, the keys and values of the context stage
+// are written to the cache, and every decoding step with TimeStep appends its
+// own and attends to all those cached before it, as the CUDA kernel.
+template <typename T, typename DeviceContext>
+class FusedMultiTransformerCPUKernel : public framework::OpKernel<T> {
+ public:
+  void Compute(const framework::ExecutionContext &ctx) const override {
+    auto &dev_ctx = ctx.template device_context<phi::CPUContext>();
+    PADDLE_ENFORCE_EQ(ctx.Attr<int>("ring_id"),
+                      -1,
+                      platform::errors::Unimplemented(
+                          "The tensor model parallel of "
+                          "fused_multi_transformer is not supported on CPU."));
+    PADDLE_ENFORCE_EQ(ctx.Attr<int>("rotary_emb_dims"),
+                      0,
+                      platform::errors::Unimplemented(
+                          "The RotaryPosEmb of fused_multi_transformer is not "
+                          "supported on CPU."));
+    PADDLE_ENFORCE_EQ(ctx.MultiInput<phi::DenseTensor>("PreCaches").empty() &&
+                          !ctx.HasInput("SeqLengths"),
+                      true,
+                      platform::errors::Unimplemented(
+                          "The PreCaches and SeqLengths of "
+                          "fused_multi_transformer are not supported on CPU."));
+
+    auto *input_x = ctx.Input<phi::DenseTensor>("X");
+    const auto x_dims = input_x->dims();
+    const int bsz = static_cast<int>(x_dims[0]);
+    const int seq_len = static_cast<int>(x_dims[1]);
+    const int dim_embed = static_cast<int>(x_dims[2]);
+    const int token_num = bsz * seq_len;
+    const bool pre_layer_norm = ctx.Attr<bool>("pre_layer_norm");
+    const float epsilon = ctx.Attr<float>("epsilon");
+    const std::string act_method = ctx.Attr<std::string>("act_method");
+
+    auto ln_scales = ctx.MultiInput<phi::DenseTensor>("LnScale");
+    auto ln_biases = ctx.MultiInput<phi::DenseTensor>("LnBias");
+    auto qkv_weights = ctx.MultiInput<phi::DenseTensor>("QKVW");
+    auto qkv_biases = ctx.MultiInput<phi::DenseTensor>("QKVBias");
+    auto out_linear_weights = ctx.MultiInput<phi::DenseTensor>("OutLinearW");
+    auto out_linear_biases = ctx.MultiInput<phi::DenseTensor>("OutLinearBias");
+    auto ffn_ln_scales = ctx.MultiInput<phi::DenseTensor>("FFNLnScale");
+    auto ffn_ln_biases = ctx.MultiInput<phi::DenseTensor>("FFNLnBias");
+    auto ffn1_weights = ctx.MultiInput<phi::DenseTensor>("FFN1Weight");
+    auto ffn1_biases = ctx.MultiInput<phi::DenseTensor>("FFN1Bias");
+    auto ffn2_weights = ctx.MultiInput<phi::DenseTensor>("FFN2Weight");
+    auto ffn2_biases = ctx.MultiInput<phi::DenseTensor>("FFN2Bias");
+    auto cache_kvs = ctx.MultiInput<phi::DenseTensor>("CacheKV");
+    auto cache_kv_outs = ctx.MultiOutput<phi::DenseTensor>("CacheKVOut");
+    auto *time_step = ctx.Input<phi::DenseTensor>("TimeStep");
+    auto *src_mask = ctx.Input<phi::DenseTensor>("SrcMask");
+
+    const bool trans_qkvw = ctx.Attr<bool>("trans_qkvw");
+    const auto qkv_w_dims = qkv_weights[0]->dims();
+    const int num_head =
+        static_cast<int>(trans_qkvw ? qkv_w_dims[1] : qkv_w_dims[2]);
+    const int dim_head =
+        static_cast<int>(trans_qkvw ? qkv_w_dims[2] : qkv_w_dims[3]);
+    const int hidden_size = num_head * dim_head;
+    const int dim_ffn = static_cast<int>(ffn1_weights[0]->dims()[1]);
+    const int layers = static_cast<int>(qkv_weights.size());
+
+    int cache_offset = 0;
+    if (time_step) {
+      PADDLE_ENFORCE_EQ(time_step->place(),
+                        platform::CPUPlace(),
+                        platform::errors::PreconditionNotMet(
+                            "The place of input(TimeStep) must be CPUPlace."));
+      cache_offset = time_step->data<int>()[0];
+      PADDLE_ENFORCE_GT(cache_offset,
+                        0,
+                        platform::errors::PreconditionNotMet(
+                            "The value of time_step must > 0, but now is %d",
+                            cache_offset));
+      PADDLE_ENFORCE_EQ(
+          seq_len,
+          1,
+          platform::errors::PreconditionNotMet(
+              "In decode stage, the seq_len of input must be 1, but now is %d",
+              seq_len));
+    }
+
+    // The hidden states are updated in place in Out through the layers.
+    auto *out = ctx.Output<phi::DenseTensor>("Out");
+    T *x_data = dev_ctx.template Alloc<T>(out);
+    std::memcpy(x_data, input_x->data<T>(), out->numel() * sizeof(T));
+
+    phi::DenseTensor ln_out, qkv_out, fmha_out, linear_out, ffn1_out;
+    ln_out.Resize({token_num, dim_embed});
+    qkv_out.Resize({token_num, 3 * hidden_size});
+    fmha_out.Resize({token_num, hidden_size});
+    linear_out.Resize({token_num, dim_embed});
+    ffn1_out.Resize({token_num, dim_ffn});
+    T *ln_out_data = dev_ctx.template Alloc<T>(&ln_out);
+    T *qkv_out_data = dev_ctx.template Alloc<T>(&qkv_out);
+    T *fmha_out_data = dev_ctx.template Alloc<T>(&fmha_out);
+    T *linear_out_data = dev_ctx.template Alloc<T>(&linear_out);
+    T *ffn1_out_data = dev_ctx.template Alloc<T>(&ffn1_out);
+
+    auto data_or_null = [](const std::vector<const phi::DenseTensor *> &ts,
+                           int i) -> const T * {
+      return ts.empty() ? nullptr : ts[i]->data<T>();
+    };
+
+    for (int i = 0; i < layers; ++i) {
+      // step1. layer_norm, fused into the residual of the previous layer
+      // after the first one.
+      if (pre_layer_norm && i == 0) {
+        LayerNorm(x_data,
+                  ln_scales[0]->data<T>(),
+                  ln_biases[0]->data<T>(),
+                  token_num,
+                  dim_embed,
+                  epsilon,
+                  ln_out_data);
+      }
+
+      // step2. qkv
+      Linear(dev_ctx,
+             pre_layer_norm ? ln_out_data : x_data,
+             *qkv_weights[i],
+             trans_qkvw,
+             token_num,
+             3 * hidden_size,
+             dim_embed,
+             qkv_out_data);
+      if (!qkv_biases.empty()) {
+        BiasAct(qkv_out_data,
+                qkv_biases[i]->data<T>(),
+                "none",
+                token_num,
+                3 * hidden_size);
+      }
+
+      // step3. fmha
+      T *cache_kv_data = nullptr;
+      int max_seq_len = 0;
+      if (!cache_kvs.empty()) {
+        auto *cache_kv_out = cache_kv_outs[i];
+        if (!cache_kv_out->IsSharedBufferWith(*cache_kvs[i])) {
+          framework::TensorCopySync(
+              *cache_kvs[i], ctx.GetPlace(), cache_kv_out);
+        }
+        // [2, batch_size, num_head, max_seq_len, head_size]
+        max_seq_len = static_cast<int>(cache_kv_out->dims()[3]);
+        PADDLE_ENFORCE_LE(
+            cache_offset + seq_len,
+            max_seq_len,
+            platform::errors::InvalidArgument(
+                "The CacheKV of %d positions can not hold the step %d.",
+                max_seq_len,
+                cache_offset + seq_len - 1));
+        cache_kv_data = dev_ctx.template Alloc<T>(cache_kv_out);
+      }
+      Attention(dev_ctx,
+                qkv_out_data,
+                src_mask,
+                cache_kv_data,
+                max_seq_len,
+                cache_offset,
+                bsz,
+                seq_len,
+                num_head,
+                dim_head,
+                fmha_out_data);
+
+      // step4. out_linear
+      Linear(dev_ctx,
+             fmha_out_data,
+             *out_linear_weights[i],
+             false,
+             token_num,
+             dim_embed,
+             hidden_size,
+             linear_out_data);
+
+      // step5. ln(residual + bias)
+      if (pre_layer_norm) {
+        AddResidualLayerNorm(x_data,
+                             linear_out_data,
+                             data_or_null(out_linear_biases, i),
+                             ffn_ln_scales[i]->data<T>(),
+                             ffn_ln_biases[i]->data<T>(),
+                             token_num,
+                             dim_embed,
+                             epsilon,
+                             ln_out_data);
+      } else {
+        AddResidualLayerNorm(x_data,
+                             linear_out_data,
+                             data_or_null(out_linear_biases, i),
+                             ln_scales[i]->data<T>(),
+                             ln_biases[i]->data<T>(),
+                             token_num,
+                             dim_embed,
+                             epsilon,
+                             x_data);
+      }
+
+      // step6. ffn
+      Linear(dev_ctx,
+             pre_layer_norm ? ln_out_data : x_data,
+             *ffn1_weights[i],
+             false,
+             token_num,
+             dim_ffn,
+             dim_embed,
+             ffn1_out_data);
+      BiasAct(ffn1_out_data,
+              data_or_null(ffn1_biases, i),
+              act_method,
+              token_num,
+              dim_ffn);
+      Linear(dev_ctx,
+             ffn1_out_data,
+             *ffn2_weights[i],
+             false,
+             token_num,
+             dim_embed,
+             dim_ffn,
+             linear_out_data);
+
+      // step7. residual bias, with the layer_norm of the next layer
+      if (pre_layer_norm) {
+        const bool has_next = i < layers - 1;
+        AddResidualLayerNorm(
+            x_data,
+            linear_out_data,
+            data_or_null(ffn2_biases, i),
+            has_next ? ln_scales[i + 1]->data<T>() : nullptr,
+            has_next ? ln_biases[i + 1]->data<T>() : nullptr,
+            token_num,
+            dim_embed,
+            epsilon,
+            ln_out_data);
+      } else {
+        AddResidualLayerNorm(x_data,
+                             linear_out_data,
+                             data_or_null(ffn2_biases, i),
+                             ffn_ln_scales[i]->data<T>(),
+                             ffn_ln_biases[i]->data<T>(),
+                             token_num,
+                             dim_embed,
+                             epsilon,
+                             x_data);
+      }
+    }
+  }
+};
+
 }  // namespace operators
 }  // namespace paddle
 
@@ -305,6 +905,12 @@ REGISTER_OPERATOR(
     paddle::framework::EmptyGradOpMaker<paddle::framework::OpDesc>,
     paddle::framework::EmptyGradOpMaker<paddle::imperative::OpBase>);
 
+PD_REGISTER_STRUCT_KERNEL(fused_multi_transformer,
+                          CPU,
+                          ALL_LAYOUT,
+                          ops::FusedMultiTransformerCPUKernel,
+                          float) {}
+
 REGISTER_OP_VERSION(fused_multi_transformer)
     .AddCheckpoint(
         R"ROC(
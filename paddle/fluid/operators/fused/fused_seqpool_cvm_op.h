@@ -13,33 +13,223 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <memory>
 #include <vector>
 
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/tensor.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace paddle {
 namespace operators {
 
+// The offsets of the instances of every slot, the rows of a slot without LoD
+// are the instances. *storage keeps the offsets built for them.
+inline std::vector<const size_t*> GetSeqpoolLods(
+    const std::vector<const phi::DenseTensor*>& tensors,
+    int64_t* batch_size,
+    std::vector<std::vector<size_t>>* storage) {
+  std::vector<const size_t*> lods(tensors.size());
+  storage->resize(tensors.size());
+  *batch_size = -1;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto* tensor = tensors[i];
+    int64_t cur_batch_size = 0;
+    if (!tensor->lod().empty()) {
+      lods[i] = tensor->lod()[0].data();
+      cur_batch_size = static_cast<int64_t>(tensor->lod()[0].size()) - 1;
+    } else {
+      cur_batch_size = tensor->dims()[0];
+      auto& offsets = (*storage)[i];
+      offsets.resize(cur_batch_size + 1);
+      for (int64_t j = 0; j <= cur_batch_size; ++j) {
+        offsets[j] = j;
+      }
+      lods[i] = offsets.data();
+    }
+    if (*batch_size == -1) {
+      *batch_size = cur_batch_size;
+    } else {
+      PADDLE_ENFORCE_EQ(*batch_size,
+                        cur_batch_size,
+                        platform::errors::PreconditionNotMet(
+                            "The batch size of all input should be same, "
+                            "please check, last batch_size is %d, current "
+                            "batch_size is %d",
+                            *batch_size,
+                            cur_batch_size));
+    }
+  }
+  return lods;
+}
+
+inline void CheckSeqpoolWidth(
+    const std::vector<const phi::DenseTensor*>& tensors,
+    int64_t embedding_size) {
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        tensors[i]->dims()[tensors[i]->dims().size() - 1],
+        embedding_size,
+        platform::errors::InvalidArgument(
+            "The embedding size of all inputs should be same, but the "
+            "embedding size of input %d is %d, not %d.",
+            i,
+            tensors[i]->dims()[tensors[i]->dims().size() - 1],
+            embedding_size));
+  }
+}
+
+// Pools the instances of all the slots in one parallel loop over the (slot,
+// instance) pairs, and applies CVM to the pooled rows in the outputs, without
+// the intermediate tensors of sequence_pool. As the GPU kernel, pad_value is
+// added to every pooled row.
 template <typename T, typename DeviceContext>
 class FusedSeqpoolCVMOpCPUKernel : public framework::OpKernel<T> {
  public:
   void Compute(const framework::ExecutionContext& ctx) const override {
-    PADDLE_THROW(platform::errors::Unimplemented(
-        "Unimplemented CPU kernel for FusedSeqpoolCVMOp, only support GPU "
-        "now."));
+    auto inputs = ctx.MultiInput<phi::DenseTensor>("X");
+    auto outputs = ctx.MultiOutput<phi::DenseTensor>("Out");
+    const T pad_value = static_cast<T>(ctx.Attr<float>("pad_value"));
+    const bool use_cvm = ctx.Attr<bool>("use_cvm");
+    const int cvm_offset = ctx.Attr<int>("cvm_offset");
+
+    const int64_t slot_size = static_cast<int64_t>(inputs.size());
+    const int64_t embedding_size =
+        inputs[0]->dims()[inputs[0]->dims().size() - 1];
+    CheckSeqpoolWidth(inputs, embedding_size);
+    const int64_t out_width =
+        use_cvm ? embedding_size : embedding_size - cvm_offset;
+    int64_t batch_size = -1;
+    std::vector<std::vector<size_t>> lods_storage;
+    auto lods = GetSeqpoolLods(inputs, &batch_size, &lods_storage);
+
+    std::vector<const T*> input_data(slot_size);
+    std::vector<T*> output_data(slot_size);
+    for (int64_t i = 0; i < slot_size; ++i) {
+      input_data[i] = inputs[i]->data<T>();
+      outputs[i]->Resize({batch_size, out_width});
+      output_data[i] = outputs[i]->mutable_data<T>(ctx.GetPlace());
+    }
+
+    phi::jit::seq_pool_attr_t pool_attr(static_cast<int>(embedding_size),
+                                        phi::jit::SeqPoolType::kSum);
+    auto seqpool = phi::jit::KernelFuncs<phi::jit::SeqPoolTuple<T>,
+                                         platform::CPUPlace>::Cache()
+                       .At(pool_attr);
+    const int64_t num_rows = slot_size * batch_size;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel
+#endif
+    {
+      // Without CVM, the show and click are pooled here and dropped.
+      std::vector<T> pooled(use_cvm ? 0 : embedding_size);
+      phi::jit::seq_pool_attr_t attr = pool_attr;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for schedule(static)
+#endif
+      for (int64_t row = 0; row < num_rows; ++row) {
+        const int64_t slot = row / batch_size;
+        const int64_t ins = row % batch_size;
+        const size_t start = lods[slot][ins];
+        const size_t end = lods[slot][ins + 1];
+        T* out = output_data[slot] + ins * out_width;
+        T* dst = use_cvm ? out : pooled.data();
+        if (end > start) {
+          attr.h = static_cast<int>(end - start);
+          seqpool(input_data[slot] + start * embedding_size, dst, &attr);
+          if (pad_value != static_cast<T>(0)) {
+            for (int64_t j = 0; j < embedding_size; ++j) {
+              dst[j] += pad_value;
+            }
+          }
+        } else {
+          std::fill(dst, dst + embedding_size, pad_value);
+        }
+        if (use_cvm) {
+          out[0] = std::log(out[0] + 1);
+          out[1] = std::log(out[1] + 1) - out[0];
+        } else {
+          std::memcpy(out, dst + cvm_offset, out_width * sizeof(T));
+        }
+      }
+    }
   }
 };
 
+// Broadcasts the gradient of every pooled row to the rows of its instance,
+// with the show and click taken from CVM as the GPU kernel.
 template <typename T, typename DeviceContext>
 class FusedSeqpoolCVMGradOpCPUKernel : public framework::OpKernel<T> {
  public:
   void Compute(const framework::ExecutionContext& ctx) const override {
-    PADDLE_THROW(platform::errors::Unimplemented(
-        "Unimplemented CPU kernel for FusedSeqpoolCVMGradOp, only support GPU "
-        "now."));
+    auto out_grads =
+        ctx.MultiInput<phi::DenseTensor>(framework::GradVarName("Out"));
+    auto in_grads =
+        ctx.MultiOutput<phi::DenseTensor>(framework::GradVarName("X"));
+    const auto* cvm = ctx.Input<phi::DenseTensor>("CVM");
+    const bool use_cvm = ctx.Attr<bool>("use_cvm");
+    const int cvm_offset = ctx.Attr<int>("cvm_offset");
+
+    const int64_t slot_size = static_cast<int64_t>(in_grads.size());
+    std::vector<const phi::DenseTensor*> const_in_grads(in_grads.begin(),
+                                                        in_grads.end());
+    const int64_t embedding_size =
+        in_grads[0]->dims()[in_grads[0]->dims().size() - 1];
+    CheckSeqpoolWidth(const_in_grads, embedding_size);
+    const int64_t out_width =
+        use_cvm ? embedding_size : embedding_size - cvm_offset;
+    int64_t batch_size = -1;
+    std::vector<std::vector<size_t>> lods_storage;
+    auto lods = GetSeqpoolLods(const_in_grads, &batch_size, &lods_storage);
+    PADDLE_ENFORCE_GE(
+        cvm->numel(),
+        batch_size * cvm_offset,
+        platform::errors::InvalidArgument(
+            "Input(CVM) should have %d elements for batch size %d, but it has "
+            "%d.",
+            batch_size * cvm_offset,
+            batch_size,
+            cvm->numel()));
+
+    std::vector<const T*> out_grads_data(slot_size);
+    std::vector<T*> in_grads_data(slot_size);
+    for (int64_t i = 0; i < slot_size; ++i) {
+      out_grads_data[i] = out_grads[i]->data<T>();
+      in_grads_data[i] = in_grads[i]->mutable_data<T>(ctx.GetPlace());
+    }
+    const T* cvm_data = cvm->data<T>();
+
+    const int64_t num_rows = slot_size * batch_size;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for schedule(static)
+#endif
+    for (int64_t row = 0; row < num_rows; ++row) {
+      const int64_t slot = row / batch_size;
+      const int64_t ins = row % batch_size;
+      const size_t start = lods[slot][ins];
+      const size_t end = lods[slot][ins + 1];
+      if (end == start) {
+        continue;
+      }
+      // The first row of the instance is written from the inputs, and then
+      // copied to the others.
+      T* first = in_grads_data[slot] + start * embedding_size;
+      std::memcpy(first, cvm_data + ins * cvm_offset, cvm_offset * sizeof(T));
+      const T* out_grad = out_grads_data[slot] + ins * out_width +
+                          (use_cvm ? cvm_offset : 0);
+      std::memcpy(first + cvm_offset,
+                  out_grad,
+                  (embedding_size - cvm_offset) * sizeof(T));
+      for (size_t k = start + 1; k < end; ++k) {
+        std::memcpy(in_grads_data[slot] + k * embedding_size,
+                    first,
+                    embedding_size * sizeof(T));
+      }
+    }
   }
 };
 
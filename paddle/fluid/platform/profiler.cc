@@ -474,6 +474,22 @@ RecordMemEvent::RecordMemEvent(const void *ptr,
   }
 }
 
+RecordMemVarEvent::RecordMemVarEvent(const void *ptr,
+                                     const phi::Place &place,
+                                     const std::string &var_name) {
+  // Only the new profiler analyses the memory of the variables.
+  if (FLAGS_enable_host_event_recorder_hook == false ||
+      RecordMemEvent::IsEnabled() == false) {
+    return;
+  }
+  HostEventRecorder<CommonMemEvent>::GetInstance().RecordEvent(
+      PosixInNsec(),
+      reinterpret_cast<uint64_t>(ptr),
+      TracerMemEventType::VarBinding,
+      place,
+      var_name);
+}
+
 void MemEvenRecorder::PushMemRecord(const void *ptr,
                                     const Place &place,
                                     size_t size) {
@@ -110,6 +110,83 @@ void ChromeTracingLogger::LogNodeTrees(const NodeTrees& node_trees) {
       }
     }
   }
+  MemoryAnalysis memory_analysis(node_trees);
+  for (const auto& item : memory_analysis.GetSummaries()) {
+    LogMemorySummary(item.second);
+  }
+}
+
+void ChromeTracingLogger::LogMemorySummary(const PlaceMemorySummary& summary) {
+  if (!output_file_stream_) {
+    return;
+  }
+  // the memory of the place as counter tracks
+  for (const auto& sample : summary.timeline) {
+    output_file_stream_ << string_format(
+        std::string(
+            R"JSON(
+  {
+    "name": "memory %s", "pid": %lld,
+    "ts": %lld,
+    "ph": "C",
+    "args": {
+      "live_bytes": %llu,
+      "allocated": %llu,
+      "reserved": %llu
+    }
+  },
+  )JSON"),
+        summary.place.c_str(),
+        summary.process_id,
+        nsToUs(sample.timestamp_ns),
+        sample.live_bytes,
+        sample.allocated,
+        sample.reserved);
+  }
+  if (summary.peak.live_bytes == 0) {
+    return;
+  }
+  // the peak with its top contributors
+  std::string contributors;
+  for (const auto& contributor : summary.top_contributors) {
+    std::string name = contributor.op_name.empty() ? std::string("(none)")
+                                                   : contributor.op_name;
+    if (!contributor.var_name.empty()) {
+      name += " -> " + contributor.var_name;
+    }
+    name = std::regex_replace(name, std::regex("\""), "\'");
+    contributors += string_format(std::string(R"JSON(%s
+        "%s": "%llu bytes in %llu allocations")JSON"),
+                                  contributors.empty() ? "" : ",",
+                                  name.c_str(),
+                                  contributor.bytes,
+                                  contributor.num_allocations);
+  }
+  output_file_stream_ << string_format(
+      std::string(
+          R"JSON(
+  {
+    "name": "[memory peak] %s", "pid": %lld, "tid": "memory",
+    "ts": %lld,
+    "ph": "i", "s": "p",
+    "args": {
+      "live_bytes": %llu,
+      "allocated": %llu,
+      "reserved": %llu,
+      "fragmentation": %.3f,
+      "top_contributors": {%s
+      }
+    }
+  },
+  )JSON"),
+      summary.place.c_str(),
+      summary.process_id,
+      nsToUs(summary.peak.timestamp_ns),
+      summary.peak.live_bytes,
+      summary.peak.allocated,
+      summary.peak.reserved,
+      summary.fragmentation,
+      contributors.c_str());
 }
 
 void ChromeTracingLogger::LogMemTraceEventNode(
@@ -173,6 +250,21 @@ void ChromeTracingLogger::LogHostTraceEventNode(
     callstack = std::regex_replace(callstack, std::regex("\""), "\'");
     callstack = std::regex_replace(callstack, std::regex("\n"), "\\n");
   }
+  // The hardware performance counters are appended to the args.
+  std::string counters;
+  for (const auto& counter : host_node.Counters()) {
+    counters += string_format(std::string(",\n      \"%s\": %llu"),
+                              counter.first.c_str(),
+                              counter.second);
+  }
+  auto cycles = host_node.Counters().find("cycles");
+  auto instructions = host_node.Counters().find("instructions");
+  if (cycles != host_node.Counters().end() &&
+      instructions != host_node.Counters().end() && cycles->second > 0) {
+    counters += string_format(
+        std::string(",\n      \"ipc\": %.3f"),
+        static_cast<double>(instructions->second) / cycles->second);
+  }
   switch (host_node.Type()) {
     case TracerEventType::ProfileStep:
     case TracerEventType::Forward:
@@ -193,7 +285,7 @@ void ChromeTracingLogger::LogHostTraceEventNode(
     "cname": "thread_state_runnable",
     "args": {
       "start_time": "%.3f us",
-      "end_time": "%.3f us"
+      "end_time": "%.3f us"%s
     }
   },
   )JSON"),
@@ -205,7 +297,8 @@ void ChromeTracingLogger::LogHostTraceEventNode(
           nsToUsFloat(host_node.Duration()),
           StringTracerEventType(host_node.Type()),
           nsToUsFloat(host_node.StartNs(), start_time_),
-          nsToUsFloat(host_node.EndNs(), start_time_));
+          nsToUsFloat(host_node.EndNs(), start_time_),
+          counters.c_str());
       break;
 
     case TracerEventType::Operator:
@@ -223,7 +316,7 @@ void ChromeTracingLogger::LogHostTraceEventNode(
       "end_time": "%.3f us",
       "input_shapes": %s,
       "input_dtypes": %s,
-      "callstack": "%s"
+      "callstack": "%s"%s
     }
   },
   )JSON"),
@@ -238,7 +331,8 @@ void ChromeTracingLogger::LogHostTraceEventNode(
           nsToUsFloat(host_node.EndNs(), start_time_),
           json_dict(input_shapes).c_str(),
           json_dict(input_dtypes).c_str(),
-          callstack.c_str());
+          callstack.c_str(),
+          counters.c_str());
       break;
     case TracerEventType::CudaRuntime:
     case TracerEventType::Kernel:
@@ -259,7 +353,7 @@ void ChromeTracingLogger::LogHostTraceEventNode(
     "cname": "thread_state_runnable",
     "args": {
       "start_time": "%.3f us",
-      "end_time": "%.3f us"
+      "end_time": "%.3f us"%s
     }
   },
   )JSON"),
@@ -271,7 +365,8 @@ void ChromeTracingLogger::LogHostTraceEventNode(
           nsToUsFloat(host_node.Duration()),
           StringTracerEventType(host_node.Type()),
           nsToUsFloat(host_node.StartNs(), start_time_),
-          nsToUsFloat(host_node.EndNs(), start_time_));
+          nsToUsFloat(host_node.EndNs(), start_time_),
+          counters.c_str());
       break;
   }
 
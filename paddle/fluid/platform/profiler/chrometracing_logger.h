@@ -24,6 +24,8 @@ limitations under the License. */
 namespace paddle {
 namespace platform {
 
+struct PlaceMemorySummary;  // forward declaration
+
 // Dump a NodeTrees into a chrome tracing file.
 // A ChromeTracingLogger object can only dump a NodeTrees object,
 // creates a file in the constructor and closes the file in the destructor.
@@ -51,6 +53,7 @@ class ChromeTracingLogger : public BaseLogger {
   void HandleTypeKernel(const DeviceTraceEventNode&);
   void HandleTypeMemset(const DeviceTraceEventNode&);
   void HandleTypeMemcpy(const DeviceTraceEventNode&);
+  void LogMemorySummary(const PlaceMemorySummary&);
   void StartLog();
   void EndLog();
   void RefineDisplayName(std::unordered_map<std::string, std::string>);
@@ -244,6 +244,9 @@ HostTraceEventNode* DeserializationReader::RestoreHostTraceEventNode(
   host_event.end_ns = host_event_proto.end_ns();
   host_event.process_id = host_event_proto.process_id();
   host_event.thread_id = host_event_proto.thread_id();
+  for (const auto& counter : host_event_proto.counters()) {
+    host_event.counters[counter.name()] = counter.value();
+  }
   return new HostTraceEventNode(host_event);
 }
 
@@ -262,6 +265,7 @@ MemTraceEventNode* DeserializationReader::RestoreMemTraceEventNode(
   mem_event.current_reserved = mem_event_proto.current_reserved();
   mem_event.peak_allocated = mem_event_proto.peak_allocated();
   mem_event.peak_reserved = mem_event_proto.peak_reserved();
+  mem_event.var_name = mem_event_proto.var_name();
   return new MemTraceEventNode(mem_event);
 }
 
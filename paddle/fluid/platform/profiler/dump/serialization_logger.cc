@@ -158,6 +158,9 @@ void SerializationLogger::LogMemTraceEventNode(
   mem_trace_event->set_current_reserved(mem_node.CurrentReserved());
   mem_trace_event->set_peak_allocated(mem_node.PeakAllocated());
   mem_trace_event->set_peak_reserved(mem_node.PeakReserved());
+  if (!mem_node.VarName().empty()) {
+    mem_trace_event->set_var_name(mem_node.VarName());
+  }
   current_mem_trace_event_node_proto_->set_allocated_mem_event(mem_trace_event);
 }
 
@@ -171,6 +174,12 @@ void SerializationLogger::LogHostTraceEventNode(
   host_trace_event->set_end_ns(host_node.EndNs());
   host_trace_event->set_process_id(host_node.ProcessId());
   host_trace_event->set_thread_id(host_node.ThreadId());
+  for (const auto& counter : host_node.Counters()) {
+    HostTraceEventProto::counter_proto* counter_proto =
+        host_trace_event->add_counters();
+    counter_proto->set_name(counter.first);
+    counter_proto->set_value(counter.second);
+  }
   current_host_trace_event_node_proto_->set_allocated_host_trace_event(
       host_trace_event);
   OperatorSupplementEventNode* op_supplement_event_node =
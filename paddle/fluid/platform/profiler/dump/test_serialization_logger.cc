@@ -52,6 +52,8 @@ TEST(SerializationLoggerTest, dump_case0) {
                            10);
   host_events.emplace_back(
       std::string("op1"), TracerEventType::Operator, 11000, 20000, 10, 10);
+  host_events.back().counters["cycles"] = 27000;
+  host_events.back().counters["instructions"] = 54000;
   host_events.emplace_back(
       std::string("op2"), TracerEventType::Operator, 21000, 30000, 10, 10);
   host_events.emplace_back(
@@ -284,6 +286,12 @@ TEST(DeserializationReaderTest, restore_case0) {
       EXPECT_EQ((*it)->GetRuntimeTraceEventNodes().size(), 2u);
       EXPECT_EQ((*it)->GetMemTraceEventNodes().size(), 2u);
       EXPECT_NE((*it)->GetOperatorSupplementEventNode(), nullptr);
+      EXPECT_EQ((*it)->Counters().size(), 2u);
+      EXPECT_EQ((*it)->Counters().at("cycles"), 27000u);
+      EXPECT_EQ((*it)->Counters().at("instructions"), 54000u);
+    }
+    if ((*it)->Name() == "op2") {
+      EXPECT_TRUE((*it)->Counters().empty());
     }
   }
   for (auto it = thread2_nodes.begin(); it != thread2_nodes.end(); it++) {
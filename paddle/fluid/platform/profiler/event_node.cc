@@ -17,6 +17,7 @@ limitations under the License. */
 #include <deque>
 #include <set>
 #include <stack>
+#include <utility>
 
 #include "paddle/fluid/platform/profiler/utils.h"
 
@@ -450,5 +451,173 @@ void NodeTrees::HandleTrees(
     }
   }
 }
+
+MemoryAnalysis::MemoryAnalysis(const NodeTrees& node_trees, size_t top_k) {
+  // Attribute the memory events to the innermost operator of their host node.
+  std::map<std::string, std::vector<AttributedMemEvent>> place2events;
+  for (const auto& item : node_trees.GetNodeTrees()) {
+    // the host node, its operator and whether it is an operator indeed
+    std::stack<std::pair<const HostTraceEventNode*,
+                         std::pair<std::string, bool>>>
+        stack;
+    stack.push({item.second, {std::string(), false}});
+    while (!stack.empty()) {
+      auto current = stack.top();
+      stack.pop();
+      for (auto mem_node : current.first->GetMemTraceEventNodes()) {
+        place2events[mem_node->Place()].push_back(
+            {mem_node, current.second.first});
+      }
+      for (auto child : current.first->GetChildren()) {
+        if (child->Type() == TracerEventType::Operator) {
+          stack.push({child, {child->Name(), true}});
+        } else if (current.second.second) {
+          stack.push({child, current.second});
+        } else {
+          stack.push({child, {child->Name(), false}});
+        }
+      }
+    }
+  }
+  for (auto& item : place2events) {
+    auto& events = item.second;
+    std::stable_sort(
+        events.begin(),
+        events.end(),
+        [](const AttributedMemEvent& a, const AttributedMemEvent& b) {
+          return a.node->TimeStampNs() < b.node->TimeStampNs();
+        });
+    auto& summary = summaries_[item.first];
+    summary.place = item.first;
+    summary.process_id = events.front().node->ProcessId();
+    Analyse(events, top_k, &summary);
+  }
+}
+
+void MemoryAnalysis::Analyse(const std::vector<AttributedMemEvent>& events,
+                             size_t top_k,
+                             PlaceMemorySummary* summary) {
+  struct LiveAllocation {
+    uint64_t bytes;
+    const std::string* op_name;
+    const std::string* var_name;
+  };
+  // The live allocations keyed by address, a variable is bound to the
+  // allocation holding its data.
+  std::map<uint64_t, LiveAllocation> live;
+  auto find_allocation = [&live](uint64_t addr) {
+    auto it = live.upper_bound(addr);
+    if (it == live.begin()) return live.end();
+    --it;
+    return addr < it->first + it->second.bytes ? it : live.end();
+  };
+
+  // Replay the events, and find the peak of the live bytes.
+  MemorySample sample;
+  size_t peak_index = 0;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const MemTraceEventNode* node = events[i].node;
+    switch (node->Type()) {
+      case TracerMemEventType::Allocate:
+        // the allocator may reuse an address whose free is not traced
+        if (live.count(node->Addr())) {
+          sample.live_bytes -= live[node->Addr()].bytes;
+        }
+        live[node->Addr()] = {static_cast<uint64_t>(node->IncreaseBytes()),
+                              &events[i].op_name,
+                              nullptr};
+        sample.live_bytes += node->IncreaseBytes();
+        break;
+      case TracerMemEventType::Free: {
+        auto it = live.find(node->Addr());
+        // the memory allocated before the profiling is not tracked
+        if (it != live.end()) {
+          sample.live_bytes -= it->second.bytes;
+          live.erase(it);
+        }
+        break;
+      }
+      case TracerMemEventType::VarBinding:
+        continue;
+      default:
+        break;
+    }
+    // 0 means the allocator kept the value of the previous event.
+    if (node->CurrentAllocated() != 0) {
+      sample.allocated = node->CurrentAllocated();
+    }
+    if (node->CurrentReserved() != 0) {
+      sample.reserved = node->CurrentReserved();
+    }
+    sample.timestamp_ns = node->TimeStampNs();
+    summary->timeline.push_back(sample);
+    if (sample.live_bytes > summary->peak.live_bytes) {
+      summary->peak = sample;
+      peak_index = i;
+    }
+  }
+  if (summary->peak.reserved > summary->peak.allocated) {
+    summary->fragmentation =
+        static_cast<double>(summary->peak.reserved - summary->peak.allocated) /
+        summary->peak.reserved;
+  }
+
+  // Replay the events again up to the peak to take the allocations live at
+  // the peak, and keep binding them to the variables after the peak, since an
+  // operator binds its outputs when it ends. A free after the peak only stops
+  // the binding of the allocation, which stays live at the peak.
+  live.clear();
+  std::set<uint64_t> bindable;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const MemTraceEventNode* node = events[i].node;
+    if (i == peak_index + 1) {
+      for (const auto& item : live) bindable.insert(item.first);
+    }
+    if (i > peak_index && bindable.empty()) break;
+    if (node->Type() == TracerMemEventType::VarBinding) {
+      auto it = find_allocation(node->Addr());
+      // an allocation is attributed to the first variable written to it
+      if (it != live.end() && it->second.var_name == nullptr &&
+          (i <= peak_index || bindable.count(it->first))) {
+        it->second.var_name = &node->VarName();
+      }
+    } else if (i <= peak_index) {
+      if (node->Type() == TracerMemEventType::Allocate) {
+        live[node->Addr()] = {static_cast<uint64_t>(node->IncreaseBytes()),
+                              &events[i].op_name,
+                              nullptr};
+      } else if (node->Type() == TracerMemEventType::Free) {
+        live.erase(node->Addr());
+      }
+    } else if (node->Type() == TracerMemEventType::Free) {
+      bindable.erase(node->Addr());
+    }
+  }
+
+  std::map<std::pair<std::string, std::string>, MemoryContributor>
+      contributors;
+  for (const auto& item : live) {
+    const auto& allocation = item.second;
+    std::string var_name =
+        allocation.var_name ? *allocation.var_name : std::string();
+    auto& contributor = contributors[{*allocation.op_name, var_name}];
+    contributor.op_name = *allocation.op_name;
+    contributor.var_name = var_name;
+    contributor.bytes += allocation.bytes;
+    contributor.num_allocations += 1;
+  }
+  for (auto& item : contributors) {
+    summary->top_contributors.push_back(std::move(item.second));
+  }
+  std::stable_sort(summary->top_contributors.begin(),
+                   summary->top_contributors.end(),
+                   [](const MemoryContributor& a, const MemoryContributor& b) {
+                     return a.bytes > b.bytes;
+                   });
+  if (summary->top_contributors.size() > top_k) {
+    summary->top_contributors.resize(top_k);
+  }
+}
+
 }  // namespace platform
 }  // namespace paddle
@@ -49,6 +49,7 @@ class MemTraceEventNode {
   uint64_t CurrentReserved() const { return mem_event_.current_reserved; }
   uint64_t PeakAllocated() const { return mem_event_.peak_allocated; }
   uint64_t PeakReserved() const { return mem_event_.peak_reserved; }
+  const std::string& VarName() const { return mem_event_.var_name; }
 
   // member function
   void LogMe(BaseLogger* logger) { logger->LogMemTraceEventNode(*this); }
@@ -197,6 +198,9 @@ class HostTraceEventNode {
   uint64_t Duration() const {
     return host_event_.end_ns - host_event_.start_ns;
   }
+  const std::map<std::string, uint64_t>& Counters() const {
+    return host_event_.counters;
+  }
 
   // member function
   void AddChild(HostTraceEventNode* node) { children_.push_back(node); }
@@ -307,5 +311,65 @@ class NodeTrees {
       std::vector<OperatorSupplementEventNode*> op_supplement_event_nodes);
 };
 
+// The memory of the live allocations with the same operator and variable.
+struct MemoryContributor {
+  // The innermost operator running when the memory was allocated, or the
+  // innermost host event if it was allocated outside of the operators, empty
+  // if there is no host event.
+  std::string op_name;
+  // The variable the operator wrote to the memory, empty if unknown.
+  std::string var_name;
+  uint64_t bytes = 0;
+  uint64_t num_allocations = 0;
+};
+
+struct MemorySample {
+  uint64_t timestamp_ns = 0;
+  // The bytes allocated during the profiling and not freed yet.
+  uint64_t live_bytes = 0;
+  // The allocated and reserved bytes reported by the allocator, which include
+  // the memory allocated before the profiling.
+  uint64_t allocated = 0;
+  uint64_t reserved = 0;
+};
+
+struct PlaceMemorySummary {
+  std::string place;
+  uint64_t process_id = 0;
+  // A sample after every allocation, free or reservation on the place.
+  std::vector<MemorySample> timeline;
+  // The sample where live_bytes is the largest.
+  MemorySample peak;
+  // The share of the reserved memory which is not allocated at the peak.
+  double fragmentation = 0.0;
+  // The largest contributors to live_bytes at the peak.
+  std::vector<MemoryContributor> top_contributors;
+};
+
+// Reconstructs the live memory over time per place from the memory events of
+// the trees, and attributes the memory live at the peak to the operators and
+// variables which caused it.
+class MemoryAnalysis {
+ public:
+  explicit MemoryAnalysis(const NodeTrees& node_trees, size_t top_k = 10);
+
+  // Keyed by place.
+  const std::map<std::string, PlaceMemorySummary>& GetSummaries() const {
+    return summaries_;
+  }
+
+ private:
+  struct AttributedMemEvent {
+    const MemTraceEventNode* node;
+    std::string op_name;
+  };
+
+  void Analyse(const std::vector<AttributedMemEvent>& events,
+               size_t top_k,
+               PlaceMemorySummary* summary);
+
+  std::map<std::string, PlaceMemorySummary> summaries_;
+};
+
 }  // namespace platform
 }  // namespace paddle
@@ -14,24 +14,41 @@
 #include "paddle/fluid/platform/profiler/host_tracer.h"
 
 #include <sstream>
+#include <unordered_map>
 
 #include "glog/logging.h"
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/platform/profiler/common_event.h"
 #include "paddle/fluid/platform/profiler/host_event_recorder.h"
+#include "paddle/phi/api/profiler/perf_counters.h"
 
 namespace paddle {
 namespace platform {
 
 namespace {
 
-void ProcessHostEvents(const HostEventSection<CommonEvent>& host_events,
-                       TraceEventCollector* collector) {
+void ProcessHostEvents(
+    const HostEventSection<CommonEvent>& host_events,
+    const HostEventSection<phi::PerfCounterEvent>& perf_counter_events,
+    TraceEventCollector* collector) {
+  std::unordered_map<uint64_t, const std::vector<phi::PerfCounterEvent>*>
+      thr_perf_counters;
+  for (const auto& thr_sec : perf_counter_events.thr_sections) {
+    thr_perf_counters[thr_sec.thread_id] = &thr_sec.events;
+  }
   for (const auto& thr_sec : host_events.thr_sections) {
     uint64_t tid = thr_sec.thread_id;
     if (thr_sec.thread_name != phi::kDefaultThreadName) {
       collector->AddThreadName(tid, thr_sec.thread_name);
     }
+    // RecordEvent records the counters of a thread right after its events,
+    // so they are in the same order.
+    const std::vector<phi::PerfCounterEvent>* perf_counters = nullptr;
+    auto iter = thr_perf_counters.find(tid);
+    if (iter != thr_perf_counters.end()) {
+      perf_counters = iter->second;
+    }
+    size_t perf_idx = 0;
     for (const auto& evt : thr_sec.events) {
       HostTraceEvent event;
       event.name = evt.name;
@@ -40,6 +57,17 @@ void ProcessHostEvents(const HostEventSection<CommonEvent>& host_events,
       event.end_ns = evt.end_ns;
       event.process_id = host_events.process_id;
       event.thread_id = tid;
+      if (perf_counters != nullptr && perf_idx < perf_counters->size() &&
+          (*perf_counters)[perf_idx].start_ns == evt.start_ns &&
+          (*perf_counters)[perf_idx].end_ns == evt.end_ns) {
+        const auto& counters = (*perf_counters)[perf_idx++].counters;
+        for (int i = 0; i < phi::kNumPerfCounters; ++i) {
+          auto type = static_cast<phi::PerfCounterType>(i);
+          if (counters.IsValid(type)) {
+            event.counters[phi::PerfCounterName(type)] = counters.Get(type);
+          }
+        }
+      }
       collector->AddHostEvent(std::move(event));
     }
   }
@@ -64,6 +92,9 @@ void ProcessHostMemEvents(
       event.current_reserved = evt.current_reserved;
       event.peak_allocated = evt.peak_allocated;
       event.peak_reserved = evt.peak_reserved;
+      if (evt.var_name != nullptr) {
+        event.var_name = evt.var_name;
+      }
       event.process_id = host_mem_events.process_id;
       event.thread_id = tid;
       collector->AddMemEvent(std::move(event));
@@ -147,6 +178,10 @@ void HostTracer::StartTracing() {
   HostEventRecorder<CommonMemEvent>::GetInstance().GatherEvents();
   HostEventRecorder<OperatorSupplementOriginEvent>::GetInstance()
       .GatherEvents();
+  HostEventRecorder<phi::PerfCounterEvent>::GetInstance().GatherEvents();
+  if (options_.with_perf_counters) {
+    phi::PerfCounters::Enable();
+  }
   HostTraceLevel::GetInstance().SetLevel(options_.trace_level);
   state_ = TracerState::STARTED;
 }
@@ -157,6 +192,9 @@ void HostTracer::StopTracing() {
       TracerState::STARTED,
       platform::errors::PreconditionNotMet("TracerState must be STARTED"));
   HostTraceLevel::GetInstance().SetLevel(HostTraceLevel::kDisabled);
+  if (options_.with_perf_counters) {
+    phi::PerfCounters::Disable();
+  }
   state_ = TracerState::STOPED;
 }
 
@@ -167,7 +205,9 @@ void HostTracer::CollectTraceData(TraceEventCollector* collector) {
       platform::errors::PreconditionNotMet("TracerState must be STOPED"));
   HostEventSection<CommonEvent> host_events =
       HostEventRecorder<CommonEvent>::GetInstance().GatherEvents();
-  ProcessHostEvents(host_events, collector);
+  HostEventSection<phi::PerfCounterEvent> perf_counter_events =
+      HostEventRecorder<phi::PerfCounterEvent>::GetInstance().GatherEvents();
+  ProcessHostEvents(host_events, perf_counter_events, collector);
   HostEventSection<CommonMemEvent> host_mem_events =
       HostEventRecorder<CommonMemEvent>::GetInstance().GatherEvents();
   ProcessHostMemEvents(host_mem_events, collector);
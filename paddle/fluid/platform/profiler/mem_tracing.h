@@ -52,5 +52,20 @@ class RecordMemEvent {
   static std::map<const char*, std::map<uint64_t, bool>> has_initialized;
 };
 
+// Binds the memory at ptr to a variable after an operator has written it, so
+// that the memory analysis can attribute the allocation holding ptr to the
+// variable.
+class RecordMemVarEvent {
+ public:
+  /**
+   * @param ptr: Data address of the variable.
+   * @param place: Device of the variable.
+   * @param var_name: Name of the variable.
+   */
+  RecordMemVarEvent(const void* ptr,
+                    const Place& place,
+                    const std::string& var_name);
+};
+
 }  // namespace platform
 }  // namespace paddle
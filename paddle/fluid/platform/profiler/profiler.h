@@ -28,6 +28,7 @@
 #include "paddle/fluid/platform/profiler/tracer_base.h"
 
 PHI_DECLARE_int64(host_trace_level);
+PHI_DECLARE_bool(enable_host_perf_counters);
 
 namespace paddle {
 namespace platform {
@@ -42,6 +43,8 @@ void SynchronizeDevice();
 struct ProfilerOptions {
   uint32_t trace_switch = 0;  // bit 0: cpu, bit 1: gpu, bit 2: xpu
   uint32_t trace_level = FLAGS_host_trace_level;
+  // Collect the hardware performance counters of the host events.
+  bool with_perf_counters = FLAGS_enable_host_perf_counters;
 };
 
 class Profiler {
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <map>
 #include <set>
 #include <string>
 
@@ -141,3 +142,53 @@ TEST(ProfilerTest, TestHostTracerForMem) {
   auto profiler_result = profiler->Stop();
   auto nodetree = profiler_result->GetNodeTrees();
 }
+
+TEST(ProfilerTest, TestHostTracerPerfCounters) {
+  using paddle::platform::EnableHostEventRecorder;
+  using paddle::platform::Profiler;
+  using paddle::platform::ProfilerOptions;
+  using paddle::platform::RecordEvent;
+  using paddle::platform::TracerEventType;
+  ProfilerOptions options;
+  options.trace_level = 1;
+  options.trace_switch = 1;
+  options.with_perf_counters = true;
+  auto profiler = Profiler::Create(options);
+  EXPECT_TRUE(profiler);
+  EnableHostEventRecorder();
+  profiler->Prepare();
+  profiler->Start();
+  volatile float sum = 0.f;
+  {
+    RecordEvent outer(
+        "TestPerfCounters_outer", TracerEventType::UserDefined, 1);
+    for (int i = 0; i < 100000; ++i) sum = sum + i * 0.5f;
+    RecordEvent inner(
+        "TestPerfCounters_inner", TracerEventType::UserDefined, 1);
+    for (int i = 0; i < 100000; ++i) sum = sum + i * 0.5f;
+  }
+  auto profiler_result = profiler->Stop();
+  auto nodetree = profiler_result->GetNodeTrees();
+  std::map<std::string, std::map<std::string, uint64_t>> counters;
+  for (const auto& pair : nodetree->Traverse(true)) {
+    for (const auto evt : pair.second) {
+      counters[evt->Name()] = evt->Counters();
+    }
+  }
+  ASSERT_EQ(counters.count("TestPerfCounters_outer"), 1u);
+  ASSERT_EQ(counters.count("TestPerfCounters_inner"), 1u);
+  const auto& outer = counters["TestPerfCounters_outer"];
+  const auto& inner = counters["TestPerfCounters_inner"];
+  // The events are still traced if perf events are not available.
+  if (outer.empty()) {
+    LOG(WARNING) << "perf events are not available, skip the checks";
+    return;
+  }
+  ASSERT_GT(outer.count("cycles"), 0u);
+  ASSERT_GT(outer.count("instructions"), 0u);
+  EXPECT_GT(outer.at("instructions"), 200000u);
+  // The counters of an event include its nested events.
+  ASSERT_GT(inner.count("instructions"), 0u);
+  EXPECT_GT(outer.at("instructions"), inner.at("instructions"));
+  profiler_result->Save("test_host_tracer_perf_counters.json", "json");
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The overhead of the sampling profiler against the full host tracing. This
+// target is built with the tests but not run by ctest, run it by hand.
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/fluid/platform/profiler/profiler.h"
+#include "paddle/phi/api/profiler/sampling_profiler.h"
+
+using paddle::platform::RecordEvent;
+using paddle::platform::TracerEventType;
+
+namespace {
+
+// An operator of about a microsecond with an inner compute event.
+float RunOp(const std::vector<float>& data) {
+  RecordEvent op("sampled_op", TracerEventType::Operator, 1);
+  RecordEvent compute("sampled_op::compute", TracerEventType::OperatorInner, 2);
+  float sum = 0.f;
+  for (float x : data) sum += x * x;
+  return sum;
+}
+
+double RunOps(int num_ops) {
+  std::vector<float> data(512, 0.5f);
+  volatile float sink = 0.f;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_ops; ++i) sink = sink + RunOp(data);
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+TEST(SamplingProfilerTest, OverheadBenchmark) {
+  constexpr int kNumOps = 200000;
+  RunOps(kNumOps / 10);
+  double disabled_ms = RunOps(kNumOps);
+
+  phi::SamplingProfilerOptions options;
+  options.sample_period = 100;
+  auto& profiler = phi::SamplingProfiler::GetInstance();
+  profiler.Start(options);
+  double sampled_ms = RunOps(kNumOps);
+  profiler.Stop();
+
+  paddle::platform::ProfilerOptions tracing_options;
+  tracing_options.trace_level = 2;
+  tracing_options.trace_switch = 1;
+  auto tracer = paddle::platform::Profiler::Create(tracing_options);
+  tracer->Prepare();
+  tracer->Start();
+  double traced_ms = RunOps(kNumOps);
+  tracer->Stop();
+
+  LOG(INFO) << kNumOps << " ops, disabled: " << disabled_ms
+            << " ms, sampled 1/" << options.sample_period << ": "
+            << sampled_ms << " ms ("
+            << (sampled_ms / disabled_ms - 1) * 100
+            << "% overhead), full tracing: " << traced_ms << " ms ("
+            << (traced_ms / disabled_ms - 1) * 100 << "% overhead)";
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/api/profiler/sampling_profiler.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/phi/core/os_info.h"
+
+using paddle::platform::RecordEvent;
+using paddle::platform::TracerEventType;
+
+namespace {
+
+// An operator of about a microsecond with an inner compute event.
+float RunOp(const std::vector<float>& data) {
+  RecordEvent op("sampled_op", TracerEventType::Operator, 1);
+  RecordEvent compute("sampled_op::compute", TracerEventType::OperatorInner, 2);
+  float sum = 0.f;
+  for (float x : data) sum += x * x;
+  return sum;
+}
+
+double RunOps(int num_ops) {
+  std::vector<float> data(512, 0.5f);
+  volatile float sink = 0.f;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_ops; ++i) sink = sink + RunOp(data);
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+const phi::SampledEventStats* FindStats(const phi::SamplingSummary& summary,
+                                        const std::string& name) {
+  for (const auto& stats : summary.events) {
+    if (stats.name == name) return &stats;
+  }
+  return nullptr;
+}
+
+std::string SummaryPath(const std::string& dir, int seq) {
+  return dir + "/sampling_profile_" + std::to_string(phi::GetProcessId()) +
+         "_" + std::to_string(seq) + ".json";
+}
+
+}  // namespace
+
+TEST(SamplingProfilerTest, SampleOperators) {
+  phi::SamplingProfilerOptions options;
+  options.sample_period = 10;
+  options.export_interval_ms = 3600 * 1000;
+  auto& profiler = phi::SamplingProfiler::GetInstance();
+  profiler.Start(options);
+  RunOps(1000);
+  std::thread worker([] { RunOps(500); });
+  worker.join();
+  auto summary = profiler.Stop();
+
+  EXPECT_EQ(summary.sample_period, 10u);
+  EXPECT_EQ(summary.dropped, 0u);
+  auto* op = FindStats(summary, "sampled_op");
+  auto* compute = FindStats(summary, "sampled_op::compute");
+  ASSERT_NE(op, nullptr);
+  ASSERT_NE(compute, nullptr);
+  EXPECT_EQ(op->count, 150u);
+  EXPECT_EQ(compute->count, 150u);
+  EXPECT_LE(op->p50_ns, op->p99_ns);
+  EXPECT_LE(op->p99_ns, op->max_ns);
+  EXPECT_GE(op->total_ns, compute->total_ns);
+
+  // The events are not sampled once stopped.
+  RunOps(100);
+  EXPECT_TRUE(profiler.Flush().events.empty());
+}
+
+TEST(SamplingProfilerTest, RollingExport) {
+  std::string dir = "/tmp/sampling_profiler_test_" +
+                    std::to_string(phi::GetProcessId());
+  ASSERT_EQ(system(("mkdir -p " + dir).c_str()), 0);
+  phi::SamplingProfilerOptions options;
+  options.sample_period = 1;
+  options.output_dir = dir;
+  options.export_interval_ms = 3600 * 1000;
+  options.max_files = 2;
+  auto& profiler = phi::SamplingProfiler::GetInstance();
+  profiler.Start(options);
+  for (int i = 0; i < 4; ++i) {
+    RunOps(10);
+    EXPECT_EQ(FindStats(profiler.Flush(), "sampled_op")->count, 10u);
+  }
+  profiler.Stop();
+
+  // Only the latest two summaries are kept.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(std::ifstream(SummaryPath(dir, i)).good(), i >= 3) << i;
+  }
+  std::ifstream file(SummaryPath(dir, 3));
+  std::string content((std::istreambuf_iterator<char>(file)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_NE(content.find("\"name\":\"sampled_op\""), std::string::npos);
+  EXPECT_NE(content.find("\"count\":10"), std::string::npos);
+  ASSERT_EQ(system(("rm -rf " + dir).c_str()), 0);
+}
@@ -26,6 +26,7 @@ using paddle::platform::HostTraceEvent;
 using paddle::platform::HostTraceEventNode;
 using paddle::platform::KernelEventInfo;
 using paddle::platform::MemcpyEventInfo;
+using paddle::platform::MemoryAnalysis;
 using paddle::platform::MemsetEventInfo;
 using paddle::platform::MemTraceEvent;
 using paddle::platform::MemTraceEventNode;
@@ -388,3 +389,89 @@ TEST(NodeTreesTest, HandleTrees_case0) {
                    op_supplement_event_node_handle);
   logger.LogExtraInfo(std::unordered_map<std::string, std::string>());
 }
+
+TEST(MemoryAnalysisTest, PeakAttribution) {
+  std::list<HostTraceEvent> host_events;
+  std::list<RuntimeTraceEvent> runtime_events;
+  std::list<DeviceTraceEvent> device_events;
+  std::list<MemTraceEvent> mem_events;
+  std::list<OperatorSupplementEvent> op_supplement_events;
+  host_events.emplace_back(
+      std::string("op1"), TracerEventType::Operator, 1000, 5000, 10, 10);
+  host_events.emplace_back(std::string("op1::compute"),
+                           TracerEventType::OperatorInner,
+                           1500,
+                           4500,
+                           10,
+                           10);
+  host_events.emplace_back(
+      std::string("op2"), TracerEventType::Operator, 6000, 9000, 10, 10);
+  host_events.emplace_back(std::string("dataloader"),
+                           TracerEventType::UserDefined,
+                           10000,
+                           11000,
+                           10,
+                           10);
+  auto add_mem_event = [&](uint64_t timestamp_ns,
+                           uint64_t addr,
+                           TracerMemEventType type,
+                           int64_t increase_bytes,
+                           uint64_t allocated,
+                           uint64_t reserved) {
+    mem_events.emplace_back(timestamp_ns,
+                            addr,
+                            type,
+                            10,
+                            10,
+                            increase_bytes,
+                            "Place(cpu)",
+                            allocated,
+                            reserved,
+                            allocated,
+                            reserved);
+  };
+  auto bind_var = [&](uint64_t timestamp_ns,
+                      uint64_t addr,
+                      const std::string& var_name) {
+    add_mem_event(timestamp_ns, addr, TracerMemEventType::VarBinding, 0, 0, 0);
+    mem_events.back().var_name = var_name;
+  };
+  add_mem_event(2000, 0x1000, TracerMemEventType::Allocate, 1024, 1024, 4096);
+  add_mem_event(3000, 0x2000, TracerMemEventType::Allocate, 512, 1536, 4096);
+  bind_var(4800, 0x1000, "x");
+  // bound through a pointer into the allocation
+  bind_var(4900, 0x2010, "tmp");
+  add_mem_event(6500, 0x3000, TracerMemEventType::Allocate, 2048, 3584, 8192);
+  add_mem_event(7000, 0x2000, TracerMemEventType::Free, -512, 3072, 8192);
+  bind_var(8500, 0x3000, "y");
+  // allocated before the profiling
+  add_mem_event(8800, 0x9000, TracerMemEventType::Free, -100, 2972, 8192);
+  add_mem_event(10500, 0x3000, TracerMemEventType::Free, -2048, 924, 8192);
+  NodeTrees tree(host_events,
+                 runtime_events,
+                 device_events,
+                 mem_events,
+                 op_supplement_events);
+
+  MemoryAnalysis analysis(tree, 2);
+  const auto& summaries = analysis.GetSummaries();
+  ASSERT_EQ(summaries.size(), 1u);
+  const auto& summary = summaries.at("Place(cpu)");
+  EXPECT_EQ(summary.timeline.size(), 6u);
+  EXPECT_EQ(summary.timeline.back().live_bytes, 1024u);
+  EXPECT_EQ(summary.peak.timestamp_ns, 6500u);
+  EXPECT_EQ(summary.peak.live_bytes, 3584u);
+  EXPECT_EQ(summary.peak.allocated, 3584u);
+  EXPECT_EQ(summary.peak.reserved, 8192u);
+  EXPECT_DOUBLE_EQ(summary.fragmentation, 0.5625);
+  ASSERT_EQ(summary.top_contributors.size(), 2u);
+  EXPECT_EQ(summary.top_contributors[0].op_name, "op2");
+  EXPECT_EQ(summary.top_contributors[0].var_name, "y");
+  EXPECT_EQ(summary.top_contributors[0].bytes, 2048u);
+  EXPECT_EQ(summary.top_contributors[1].op_name, "op1");
+  EXPECT_EQ(summary.top_contributors[1].var_name, "x");
+  EXPECT_EQ(summary.top_contributors[1].bytes, 1024u);
+
+  ChromeTracingLogger logger("test_memory_analysis.json");
+  tree.LogMe(&logger);
+}
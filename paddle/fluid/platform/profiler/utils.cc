@@ -149,7 +149,8 @@ const char* StringTracerMemEventType(TracerMemEventType type) {
                                          "Allocate",
                                          "Free",
                                          "ReservedAllocate",
-                                         "ReservedFree"};
+                                         "ReservedFree",
+                                         "VarBinding"};
   return categary_name_[static_cast<int>(type)];
 }
 
@@ -203,6 +203,7 @@ limitations under the License. */
 #include "paddle/phi/api/ext/op_meta_info.h"
 #include "paddle/phi/api/include/operants_manager.h"
 #include "paddle/phi/api/include/tensor_operants.h"
+#include "paddle/phi/api/profiler/sampling_profiler.h"
 #include "paddle/phi/core/flags.h"
 #include "paddle/phi/kernels/autotune/cache.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
@@ -2554,7 +2555,9 @@ All parameter, weight, gradient are variables in Paddle.
   py::class_<paddle::platform::ProfilerOptions>(m, "ProfilerOptions")
       .def(py::init<>())
       .def_readwrite("trace_switch",
-                     &paddle::platform::ProfilerOptions::trace_switch);
+                     &paddle::platform::ProfilerOptions::trace_switch)
+      .def_readwrite("with_perf_counters",
+                     &paddle::platform::ProfilerOptions::with_perf_counters);
 
   py::class_<platform::RecordEvent>(m, "_RecordEvent")
       .def(py::init([](std::string name, platform::TracerEventType type) {
@@ -2569,7 +2572,8 @@ All parameter, weight, gradient are variables in Paddle.
       .value("ReservedAllocate",
              paddle::platform::TracerMemEventType::ReservedAllocate)
       .value("ReservedFree",
-             paddle::platform::TracerMemEventType::ReservedFree);
+             paddle::platform::TracerMemEventType::ReservedFree)
+      .value("VarBinding", paddle::platform::TracerMemEventType::VarBinding);
 
   py::enum_<paddle::platform::TracerEventType>(m, "TracerEventType")
       .value("Operator", paddle::platform::TracerEventType::Operator)
@@ -2594,6 +2598,46 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("enable_op_info_recorder", &phi::EnableOpInfoRecorder);
   m.def("disable_op_info_recorder", &phi::DisableOpInfoRecorder);
 
+  py::class_<phi::SamplingProfilerOptions>(m, "SamplingProfilerOptions")
+      .def(py::init<>())
+      .def_readwrite("sample_period",
+                     &phi::SamplingProfilerOptions::sample_period)
+      .def_readwrite("sample_steps",
+                     &phi::SamplingProfilerOptions::sample_steps)
+      .def_readwrite("output_dir", &phi::SamplingProfilerOptions::output_dir)
+      .def_readwrite("export_interval_ms",
+                     &phi::SamplingProfilerOptions::export_interval_ms)
+      .def_readwrite("max_files", &phi::SamplingProfilerOptions::max_files)
+      .def_readwrite("ring_capacity",
+                     &phi::SamplingProfilerOptions::ring_capacity);
+
+  py::class_<phi::SampledEventStats>(m, "SampledEventStats")
+      .def_readonly("name", &phi::SampledEventStats::name)
+      .def_readonly("type", &phi::SampledEventStats::type)
+      .def_readonly("count", &phi::SampledEventStats::count)
+      .def_readonly("total_ns", &phi::SampledEventStats::total_ns)
+      .def_readonly("max_ns", &phi::SampledEventStats::max_ns)
+      .def_readonly("p50_ns", &phi::SampledEventStats::p50_ns)
+      .def_readonly("p90_ns", &phi::SampledEventStats::p90_ns)
+      .def_readonly("p99_ns", &phi::SampledEventStats::p99_ns);
+
+  py::class_<phi::SamplingSummary>(m, "SamplingSummary")
+      .def_readonly("start_ns", &phi::SamplingSummary::start_ns)
+      .def_readonly("end_ns", &phi::SamplingSummary::end_ns)
+      .def_readonly("sample_period", &phi::SamplingSummary::sample_period)
+      .def_readonly("dropped", &phi::SamplingSummary::dropped)
+      .def_readonly("events", &phi::SamplingSummary::events);
+
+  m.def("start_sampling_profiler",
+        [](const phi::SamplingProfilerOptions &options) {
+          phi::SamplingProfiler::GetInstance().Start(options);
+        });
+  m.def("stop_sampling_profiler",
+        [] { return phi::SamplingProfiler::GetInstance().Stop(); });
+  m.def("flush_sampling_profiler",
+        [] { return phi::SamplingProfiler::GetInstance().Flush(); });
+  m.def("is_sampling_profiler_enabled", &phi::SamplingProfiler::IsEnabled);
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   m.def("set_cublas_switch", phi::SetAllowTF32Cublas);
   m.def("get_cublas_switch", phi::AllowTF32Cublas);
@@ -94,6 +94,27 @@ struct CommonMemEvent {
         current_reserved(current_reserved),
         peak_allocated(peak_allocated),
         peak_reserved(peak_reserved) {}
+
+  CommonMemEvent(std::function<void *(size_t)> arena_allocator,
+                 uint64_t timestamp_ns,
+                 uint64_t addr,
+                 TracerMemEventType type,
+                 const Place &place,
+                 const std::string &var_name_str)
+      : timestamp_ns(timestamp_ns),
+        addr(addr),
+        type(type),
+        increase_bytes(0),
+        place(place),
+        current_allocated(0),
+        current_reserved(0),
+        peak_allocated(0),
+        peak_reserved(0) {
+    auto buf = static_cast<char *>(arena_allocator(var_name_str.length() + 1));
+    strncpy(buf, var_name_str.c_str(), var_name_str.length() + 1);
+    var_name = buf;
+  }
+
   uint64_t timestamp_ns;
   uint64_t addr;
   TracerMemEventType type;
@@ -103,6 +124,7 @@ struct CommonMemEvent {
   uint64_t current_reserved;
   uint64_t peak_allocated;
   uint64_t peak_reserved;
+  const char *var_name = nullptr;  // not owned, designed for performance
 };
 
 struct OperatorSupplementOriginEvent {
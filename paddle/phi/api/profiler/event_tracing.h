@@ -17,11 +17,14 @@ limitations under the License. */
 #include <string>
 
 #include "paddle/phi/api/profiler/event.h"
+#include "paddle/phi/api/profiler/perf_counters.h"
 #include "paddle/phi/api/profiler/trace_event.h"
 #include "paddle/utils/test_macros.h"
 
 namespace phi {
 
+struct SampledEvent;
+
 // Default tracing level.
 // It is Recommended to set the level explicitly.
 static constexpr uint32_t kDefaultTraceLevel = 4;
@@ -78,6 +81,7 @@ class TEST_API RecordEvent {
   void OriginalConstruct(const std::string& name,
                          const EventRole role,
                          const std::string& attr);
+  void StartPerfCounters();
 
   bool is_enabled_{false};
   bool is_pushed_{false};
@@ -92,6 +96,12 @@ class TEST_API RecordEvent {
   TracerEventType type_{TracerEventType::UserDefined};
   std::string* attr_{nullptr};
   bool finished_{false};
+  // The slot of SamplingProfiler if the event is sampled.
+  SampledEvent* sampled_event_{nullptr};
+  // The hardware performance counters at the start, kept in the event rather
+  // than allocated, valid if with_perf_counters_.
+  bool with_perf_counters_{false};
+  PerfCounterValues perf_counters_;
 };
 
 }  // namespace phi
@@ -38,6 +38,8 @@ class HostTraceLevel {
 
 struct HostTracerOptions {
   uint32_t trace_level = 0;
+  // Collect the hardware performance counters of the host events.
+  bool with_perf_counters = false;
 };
 
 }  // namespace phi
@@ -0,0 +1,207 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/api/profiler/perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include "glog/logging.h"
+
+namespace phi {
+
+namespace {
+
+#ifdef __linux__
+
+const uint64_t kPerfCounterConfigs[kNumPerfCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_HW_STALLED_CYCLES_BACKEND};
+
+// The group of counters of a thread, the cycles counter is the leader.
+class PerfEventGroup {
+ public:
+  PerfEventGroup() {
+    for (int i = 0; i < kNumPerfCounters; ++i) {
+      fds_[i] = -1;
+      ids_[i] = 0;
+    }
+    Open();
+  }
+
+  ~PerfEventGroup() {
+    for (int i = kNumPerfCounters - 1; i >= 0; --i) {
+      if (fds_[i] >= 0) close(fds_[i]);
+    }
+  }
+
+  bool Read(PerfCounterValues* values) {
+    if (fds_[0] < 0) return false;
+    // {nr, time_enabled, time_running, {value, id} * nr}
+    uint64_t data[3 + 2 * kNumPerfCounters];
+    if (read(fds_[0], data, sizeof(data)) <= 0) return false;
+    uint64_t enabled = data[1];
+    uint64_t running = data[2];
+    // The group has not been scheduled on the PMU yet.
+    if (running == 0) return false;
+    double scale = running < enabled ? static_cast<double>(enabled) / running
+                                     : 1.0;
+    values->valid_mask = 0;
+    for (uint64_t i = 0; i < data[0]; ++i) {
+      uint64_t value = data[3 + 2 * i];
+      uint64_t id = data[4 + 2 * i];
+      for (int j = 0; j < kNumPerfCounters; ++j) {
+        if (fds_[j] >= 0 && ids_[j] == id) {
+          values->values[j] = static_cast<uint64_t>(value * scale);
+          values->valid_mask |= 1u << j;
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  int OpenCounter(int index, int group_fd) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = kPerfCounterConfigs[index];
+    attr.disabled = group_fd < 0;
+    // User space only, which is permitted for the own threads unless
+    // perf_event_paranoid is 3 or more.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    int fd = static_cast<int>(syscall(__NR_perf_event_open,
+                                      &attr,
+                                      /*pid=*/0,
+                                      /*cpu=*/-1,
+                                      group_fd,
+                                      PERF_FLAG_FD_CLOEXEC));
+    if (fd >= 0 && ioctl(fd, PERF_EVENT_IOC_ID, &ids_[index]) != 0) {
+      close(fd);
+      fd = -1;
+    }
+    return fd;
+  }
+
+  void Open() {
+    fds_[0] = OpenCounter(0, -1);
+    if (fds_[0] < 0) {
+      LOG_FIRST_N(WARNING, 1)
+          << "Hardware performance counters are not available ("
+          << strerror(errno)
+          << "), the host events are traced without them. Check "
+             "/proc/sys/kernel/perf_event_paranoid if they are expected.";
+      return;
+    }
+    // The counters not supported by the CPU, or not fitting in the PMU
+    // together with the others, fail to open and are left out.
+    for (int i = 1; i < kNumPerfCounters; ++i) {
+      fds_[i] = OpenCounter(i, fds_[0]);
+    }
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    // A group may still never be scheduled if some PMU counters are taken,
+    // e.g. by the NMI watchdog, so drop the optional counters until it is.
+    PerfCounterValues values;
+    for (int i = kNumPerfCounters - 1; i > 0 && !Read(&values); --i) {
+      if (fds_[i] >= 0) {
+        close(fds_[i]);
+        fds_[i] = -1;
+      }
+    }
+  }
+
+  int fds_[kNumPerfCounters];
+  uint64_t ids_[kNumPerfCounters];
+};
+
+#endif
+
+}  // namespace
+
+std::atomic<bool> PerfCounters::enabled_{false};
+
+const char* PerfCounterName(PerfCounterType type) {
+  switch (type) {
+    case PerfCounterType::kCycles:
+      return "cycles";
+    case PerfCounterType::kInstructions:
+      return "instructions";
+    case PerfCounterType::kLlcMisses:
+      return "llc_misses";
+    case PerfCounterType::kBranchMisses:
+      return "branch_misses";
+    case PerfCounterType::kStalledCycles:
+      return "stalled_cycles";
+    default:
+      return "unknown";
+  }
+}
+
+bool PerfCounters::Enable() {
+  PerfCounterValues values;
+  // Every thread opens the same counters, so check them in this thread
+  // rather than paying for the reads in every event if they are not there.
+  if (!Read(&values)) {
+    enabled_.store(false, std::memory_order_relaxed);
+    return false;
+  }
+  enabled_.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+void PerfCounters::Disable() {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+bool PerfCounters::Read(PerfCounterValues* values) {
+#ifdef __linux__
+  thread_local PerfEventGroup group;
+  return group.Read(values);
+#else
+  LOG_FIRST_N(WARNING, 1)
+      << "Hardware performance counters are only supported on Linux.";
+  return false;
+#endif
+}
+
+void PerfCounters::Subtract(const PerfCounterValues& start,
+                            const PerfCounterValues& end,
+                            PerfCounterValues* values) {
+  values->valid_mask = start.valid_mask & end.valid_mask;
+  for (int i = 0; i < kNumPerfCounters; ++i) {
+    // The scaled counts of a multiplexed group are estimates, which may go
+    // back a little.
+    values->values[i] =
+        end.values[i] > start.values[i] ? end.values[i] - start.values[i] : 0;
+  }
+}
+
+}  // namespace phi
@@ -0,0 +1,99 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+enum class PerfCounterType {
+  kCycles = 0,
+  kInstructions = 1,
+  kLlcMisses = 2,
+  kBranchMisses = 3,
+  // Cycles stalled in the backend, not supported by every CPU.
+  kStalledCycles = 4,
+  kNumTypes
+};
+
+static constexpr int kNumPerfCounters =
+    static_cast<int>(PerfCounterType::kNumTypes);
+
+// The name of the counter in the traces, such as "llc_misses".
+TEST_API const char* PerfCounterName(PerfCounterType type);
+
+struct PerfCounterValues {
+  bool IsValid(PerfCounterType type) const {
+    return valid_mask & (1u << static_cast<int>(type));
+  }
+  uint64_t Get(PerfCounterType type) const {
+    return values[static_cast<int>(type)];
+  }
+
+  uint64_t values[kNumPerfCounters] = {};
+  // Bit i is set if values[i] is counted.
+  uint32_t valid_mask = 0;
+};
+
+// The counters of a host event, recorded by RecordEvent along with the
+// CommonEvent of the same thread, start_ns and end_ns.
+struct PerfCounterEvent {
+  PerfCounterEvent(uint64_t start_ns,
+                   uint64_t end_ns,
+                   const PerfCounterValues& counters)
+      : start_ns(start_ns), end_ns(end_ns), counters(counters) {}
+
+  uint64_t start_ns;
+  uint64_t end_ns;
+  // The counts between start_ns and end_ns, including the nested events.
+  PerfCounterValues counters;
+};
+
+// Hardware performance counters of the host threads, read with the Linux
+// perf_event_open interface. Each thread opens its own group of user space
+// counters when it first reads them, and the kernel schedules the group as
+// a whole, so that the counters of an event are always measured over the
+// same period even if they are multiplexed with other groups. The counts
+// are scaled by the enabled time over the running time of the group.
+//
+// Reading fails, and the events get no counters, if perf events are not
+// supported or not permitted (see /proc/sys/kernel/perf_event_paranoid).
+class TEST_API PerfCounters {
+ public:
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Returns false if the counters are not available in the calling thread.
+  static bool Enable();
+
+  // The groups opened by the threads are kept until the threads exit.
+  static void Disable();
+
+  // Read the counters of the calling thread, returns false if they are not
+  // available.
+  static bool Read(PerfCounterValues* values);
+
+  // values = end - start, only the counters valid in both are kept.
+  static void Subtract(const PerfCounterValues& start,
+                       const PerfCounterValues& end,
+                       PerfCounterValues* values);
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace phi
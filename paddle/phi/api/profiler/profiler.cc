@@ -26,7 +26,9 @@ limitations under the License. */
 #include "paddle/phi/api/profiler/device_tracer.h"
 #include "paddle/phi/api/profiler/host_event_recorder.h"
 #include "paddle/phi/api/profiler/host_tracer.h"
+#include "paddle/phi/api/profiler/perf_counters.h"
 #include "paddle/phi/api/profiler/profiler_helper.h"
+#include "paddle/phi/api/profiler/sampling_profiler.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/os_info.h"
 #ifdef PADDLE_WITH_CUDA
@@ -108,6 +110,9 @@ RecordEvent::RecordEvent(const char *name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::IsEnabled())) {
+    sampled_event_ = SamplingProfiler::GetInstance().BeginEvent(name, type);
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -128,6 +133,9 @@ RecordEvent::RecordEvent(const char *name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  if (UNLIKELY(PerfCounters::IsEnabled())) {
+    StartPerfCounters();
+  }
 }
 
 RecordEvent::RecordEvent(const std::string &name,
@@ -142,6 +150,10 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::IsEnabled())) {
+    sampled_event_ =
+        SamplingProfiler::GetInstance().BeginEvent(name.c_str(), type);
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -160,6 +172,9 @@ RecordEvent::RecordEvent(const std::string &name,
   role_ = role;
   type_ = type;
   start_ns_ = PosixInNsec();
+  if (UNLIKELY(PerfCounters::IsEnabled())) {
+    StartPerfCounters();
+  }
 }
 
 RecordEvent::RecordEvent(const std::string &name,
@@ -175,6 +190,10 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::IsEnabled())) {
+    sampled_event_ =
+        SamplingProfiler::GetInstance().BeginEvent(name.c_str(), type);
+  }
 
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
@@ -192,8 +211,11 @@ RecordEvent::RecordEvent(const std::string &name,
   is_enabled_ = true;
   type_ = type;
   name_ = new std::string(name);
-  start_ns_ = PosixInNsec();
   attr_ = new std::string(attr);
+  start_ns_ = PosixInNsec();
+  if (UNLIKELY(PerfCounters::IsEnabled())) {
+    StartPerfCounters();
+  }
 }
 
 void RecordEvent::OriginalConstruct(const std::string &name,
@@ -215,6 +237,10 @@ void RecordEvent::OriginalConstruct(const std::string &name,
   *name_ = e->name();
 }
 
+void RecordEvent::StartPerfCounters() {
+  with_perf_counters_ = PerfCounters::Read(&perf_counters_);
+}
+
 void RecordEvent::End() {
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
@@ -224,7 +250,15 @@ void RecordEvent::End() {
   }
 #endif
 #endif
+  if (UNLIKELY(sampled_event_ != nullptr)) {
+    SamplingProfiler::GetInstance().EndEvent(sampled_event_);
+    sampled_event_ = nullptr;
+  }
   if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
+    PerfCounterValues end_counters;
+    if (UNLIKELY(with_perf_counters_)) {
+      with_perf_counters_ = PerfCounters::Read(&end_counters);
+    }
     uint64_t end_ns = PosixInNsec();
     if (LIKELY(shallow_copy_name_ != nullptr)) {
       HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
@@ -240,6 +274,12 @@ void RecordEvent::End() {
       }
       delete name_;
     }
+    if (UNLIKELY(with_perf_counters_)) {
+      PerfCounters::Subtract(perf_counters_, end_counters, &perf_counters_);
+      HostEventRecorder<PerfCounterEvent>::GetInstance().RecordEvent(
+          start_ns_, end_ns, perf_counters_);
+      with_perf_counters_ = false;
+    }
     // use this flag to avoid double End();
     is_enabled_ = false;
     return;
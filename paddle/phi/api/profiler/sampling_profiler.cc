@@ -0,0 +1,327 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/api/profiler/sampling_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "glog/logging.h"
+
+#include "paddle/phi/common/thread_data_registry.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/os_info.h"
+
+namespace phi {
+
+namespace {
+
+// The aggregation thread drains the ring buffers at least this often, so that
+// they rarely overflow between two summaries.
+constexpr uint64_t kMaxDrainIntervalMs = 100;
+
+int MostSignificantBit(uint64_t x) {
+  int msb = 0;
+  while (x >>= 1) ++msb;
+  return msb;
+}
+
+int BucketIndex(uint64_t ns) {
+  if (ns < 4) return static_cast<int>(ns);
+  int msb = MostSignificantBit(ns);
+  return msb * 4 + static_cast<int>((ns >> (msb - 2)) & 3);
+}
+
+// The middle of the values falling in the bucket.
+uint64_t BucketValue(int index) {
+  if (index < 4) return index;
+  int msb = index / 4;
+  uint64_t step = uint64_t{1} << (msb - 2);
+  uint64_t lower = (uint64_t{1} << msb) + (index % 4) * step;
+  return lower + step / 2;
+}
+
+std::string JsonEscape(const std::string& str) {
+  std::string result;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      result.push_back('\\');
+      result.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      result.push_back(' ');
+    } else {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+std::string SummaryPath(const std::string& dir, uint64_t seq) {
+  return dir + "/sampling_profile_" + std::to_string(GetProcessId()) + "_" +
+         std::to_string(seq) + ".json";
+}
+
+}  // namespace
+
+std::atomic<bool> SamplingProfiler::enabled_{false};
+
+SamplingProfiler& SamplingProfiler::GetInstance() {
+  static SamplingProfiler instance;
+  return instance;
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  if (aggregation_thread_.joinable()) {
+    Stop();
+  }
+}
+
+void SamplingProfiler::Start(const SamplingProfilerOptions& options) {
+  PADDLE_ENFORCE_EQ(
+      aggregation_thread_.joinable(),
+      false,
+      phi::errors::PreconditionNotMet("SamplingProfiler is already started"));
+  PADDLE_ENFORCE_GT(
+      options.sample_period,
+      0,
+      phi::errors::InvalidArgument("The sample period must be positive"));
+  PADDLE_ENFORCE_EQ(options.ring_capacity > 0 &&
+                        (options.ring_capacity & (options.ring_capacity - 1)) ==
+                            0,
+                    true,
+                    phi::errors::InvalidArgument(
+                        "The ring capacity must be a power of two, but got %d",
+                        options.ring_capacity));
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    options_ = options;
+    histograms_.clear();
+    summary_start_ns_ = PosixInNsec();
+    dropped_ = 0;
+  }
+  num_steps_ = 0;
+  in_sampled_step_ = false;
+  stop_aggregation_ = false;
+  aggregation_thread_ = std::thread([this] { AggregationLoop(); });
+  enabled_.store(true, std::memory_order_release);
+}
+
+SamplingSummary SamplingProfiler::Stop() {
+  enabled_.store(false, std::memory_order_release);
+  if (aggregation_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(aggregation_mutex_);
+      stop_aggregation_ = true;
+    }
+    aggregation_cv_.notify_all();
+    aggregation_thread_.join();
+  }
+  return Flush();
+}
+
+SamplingSummary SamplingProfiler::Flush() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  DrainRings();
+  SamplingSummary summary = RollUp();
+  WriteSummary(summary);
+  return summary;
+}
+
+SampledEventRing* SamplingProfiler::CurrentThreadRing() {
+  using RingRegistry = ThreadDataRegistry<std::shared_ptr<SampledEventRing>>;
+  auto* ring = RingRegistry::GetInstance().GetMutableCurrentThreadData();
+  if (UNLIKELY(*ring == nullptr)) {
+    *ring = std::make_shared<SampledEventRing>(options_.ring_capacity);
+    std::lock_guard<std::mutex> guard(mutex_);
+    rings_.push_back(*ring);
+  }
+  return ring->get();
+}
+
+SampledEvent* SamplingProfiler::BeginEvent(const char* name,
+                                           TracerEventType type) {
+  auto* ring = CurrentThreadRing();
+  bool opens_sample = false;
+  if (options_.sample_steps) {
+    if (type == TracerEventType::ProfileStep) {
+      uint64_t step = num_steps_.fetch_add(1, std::memory_order_relaxed);
+      opens_sample = step % options_.sample_period == 0;
+      in_sampled_step_.store(opens_sample, std::memory_order_relaxed);
+      if (!opens_sample) return nullptr;
+    } else if (!in_sampled_step_.load(std::memory_order_relaxed)) {
+      return nullptr;
+    }
+  } else if (ring->sampled_depth == 0) {
+    if (type != TracerEventType::Operator ||
+        ++ring->num_operators % options_.sample_period != 0) {
+      return nullptr;
+    }
+    opens_sample = true;
+  }
+
+  auto* event = ring->Reserve();
+  if (event == nullptr) return nullptr;
+  std::strncpy(event->name, name, SampledEvent::kMaxNameSize - 1);
+  event->name[SampledEvent::kMaxNameSize - 1] = '\0';
+  event->type = type;
+  event->opens_sample = opens_sample;
+  if (opens_sample && !options_.sample_steps) ++ring->sampled_depth;
+  event->start_ns = PosixInNsec();
+  return event;
+}
+
+void SamplingProfiler::EndEvent(SampledEvent* event) {
+  event->end_ns = PosixInNsec();
+  if (event->opens_sample) {
+    if (event->type == TracerEventType::ProfileStep) {
+      in_sampled_step_.store(false, std::memory_order_relaxed);
+    } else {
+      --CurrentThreadRing()->sampled_depth;
+    }
+  }
+  event->ready.store(true, std::memory_order_release);
+}
+
+void SamplingProfiler::AggregationLoop() {
+  uint64_t drain_interval_ms =
+      std::min(options_.export_interval_ms, kMaxDrainIntervalMs);
+  auto next_export = std::chrono::steady_clock::now() +
+                     std::chrono::milliseconds(options_.export_interval_ms);
+  std::unique_lock<std::mutex> lock(aggregation_mutex_);
+  while (!aggregation_cv_.wait_for(
+      lock, std::chrono::milliseconds(drain_interval_ms), [this] {
+        return stop_aggregation_;
+      })) {
+    if (std::chrono::steady_clock::now() >= next_export) {
+      Flush();
+      next_export += std::chrono::milliseconds(options_.export_interval_ms);
+    } else {
+      std::lock_guard<std::mutex> guard(mutex_);
+      DrainRings();
+    }
+  }
+}
+
+void SamplingProfiler::DrainRings() {
+  for (auto it = rings_.begin(); it != rings_.end();) {
+    auto& ring = *it;
+    ring->Consume([this](const SampledEvent& event) {
+      auto& histogram = histograms_[event.name];
+      histogram.type = event.type;
+      histogram.Add(event.end_ns - event.start_ns);
+    });
+    dropped_ += ring->TakeDropped();
+    // The thread owning the ring has exited, and it is fully drained since
+    // the events of a thread are all ended when the thread exits.
+    if (ring.use_count() == 1) {
+      it = rings_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+SamplingSummary SamplingProfiler::RollUp() {
+  SamplingSummary summary;
+  summary.start_ns = summary_start_ns_;
+  summary.end_ns = PosixInNsec();
+  summary.sample_period = options_.sample_period;
+  summary.dropped = dropped_;
+  for (auto& item : histograms_) {
+    const auto& histogram = item.second;
+    SampledEventStats stats;
+    stats.name = item.first;
+    stats.type = histogram.type;
+    stats.count = histogram.count;
+    stats.total_ns = histogram.total_ns;
+    stats.max_ns = histogram.max_ns;
+    stats.p50_ns = histogram.Percentile(50);
+    stats.p90_ns = histogram.Percentile(90);
+    stats.p99_ns = histogram.Percentile(99);
+    summary.events.push_back(std::move(stats));
+  }
+  std::sort(summary.events.begin(),
+            summary.events.end(),
+            [](const SampledEventStats& a, const SampledEventStats& b) {
+              return a.total_ns > b.total_ns;
+            });
+  histograms_.clear();
+  summary_start_ns_ = summary.end_ns;
+  dropped_ = 0;
+  return summary;
+}
+
+void SamplingProfiler::WriteSummary(const SamplingSummary& summary) {
+  if (options_.output_dir.empty()) return;
+  std::ostringstream os;
+  os << "{\"start_ns\":" << summary.start_ns
+     << ",\"end_ns\":" << summary.end_ns
+     << ",\"sample_period\":" << summary.sample_period
+     << ",\"dropped\":" << summary.dropped << ",\"events\":[";
+  for (size_t i = 0; i < summary.events.size(); ++i) {
+    const auto& stats = summary.events[i];
+    os << (i ? "," : "") << "\n{\"name\":\"" << JsonEscape(stats.name)
+       << "\",\"type\":" << static_cast<int>(stats.type)
+       << ",\"count\":" << stats.count << ",\"total_ns\":" << stats.total_ns
+       << ",\"p50_ns\":" << stats.p50_ns << ",\"p90_ns\":" << stats.p90_ns
+       << ",\"p99_ns\":" << stats.p99_ns << ",\"max_ns\":" << stats.max_ns
+       << "}";
+  }
+  os << "]}\n";
+
+  // Write a temporary file first and rename it, so that a reader never sees
+  // a partially written summary.
+  std::string path = SummaryPath(options_.output_dir, num_summaries_);
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::out | std::ios::trunc);
+    file << os.str();
+    if (!file) {
+      LOG_FIRST_N(WARNING, 1) << "Failed to write the sampling profile "
+                              << tmp_path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  std::rename(tmp_path.c_str(), path.c_str());
+  if (num_summaries_ >= options_.max_files) {
+    std::remove(
+        SummaryPath(options_.output_dir, num_summaries_ - options_.max_files)
+            .c_str());
+  }
+  ++num_summaries_;
+}
+
+void SamplingProfiler::Histogram::Add(uint64_t ns) {
+  ++count;
+  total_ns += ns;
+  max_ns = std::max(max_ns, ns);
+  ++buckets[BucketIndex(ns)];
+}
+
+uint64_t SamplingProfiler::Histogram::Percentile(double percent) const {
+  uint64_t rank = static_cast<uint64_t>(count * percent / 100);
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += buckets[i];
+    if (seen > rank) return std::min(BucketValue(i), max_ns);
+  }
+  return max_ns;
+}
+
+}  // namespace phi
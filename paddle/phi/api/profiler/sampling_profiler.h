@@ -0,0 +1,212 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/api/profiler/trace_event.h"
+#include "paddle/phi/core/macros.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+struct SamplingProfilerOptions {
+  // Sample one in sample_period operators, or one in sample_period profile
+  // steps if sample_steps is true. The events nested in a sampled operator
+  // (or happening during a sampled step) are sampled too.
+  uint32_t sample_period = 100;
+  bool sample_steps = false;
+  // The directory to write the rolled-up summaries, nothing is written if it
+  // is empty.
+  std::string output_dir;
+  // Roll up and write a summary every export_interval_ms.
+  uint64_t export_interval_ms = 60000;
+  // Only the latest max_files summaries are kept in output_dir.
+  uint32_t max_files = 10;
+  // The number of events of the per-thread ring buffers, the events sampled
+  // when a ring is full are dropped. It must be a power of two.
+  uint32_t ring_capacity = 4096;
+};
+
+// The latency statistics of the sampled events with the same name.
+struct SampledEventStats {
+  std::string name;
+  TracerEventType type;
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  // Estimated from a log-linear histogram, the error is within 12.5%.
+  uint64_t p50_ns = 0;
+  uint64_t p90_ns = 0;
+  uint64_t p99_ns = 0;
+};
+
+// The summary of the events sampled in [start_ns, end_ns).
+struct SamplingSummary {
+  uint64_t start_ns = 0;
+  uint64_t end_ns = 0;
+  uint32_t sample_period = 0;
+  // The sampled events dropped since the ring buffers were full.
+  uint64_t dropped = 0;
+  std::vector<SampledEventStats> events;
+};
+
+// A sampled event waiting in a ring buffer for the aggregation.
+struct SampledEvent {
+  static constexpr size_t kMaxNameSize = 64;
+
+  char name[kMaxNameSize];
+  TracerEventType type;
+  // Whether the event starts a sampled operator or step.
+  bool opens_sample;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  std::atomic<bool> ready{false};
+};
+
+// A single producer single consumer ring of the events sampled by a thread.
+// The owner thread reserves the slots in order and publishes each one when
+// the event ends, the aggregation thread consumes the published slots in
+// order.
+class SampledEventRing {
+ public:
+  explicit SampledEventRing(uint32_t capacity)
+      : slots_(capacity), mask_(capacity - 1) {}
+
+  // Called by the owner thread, nullptr if the ring is full.
+  SampledEvent* Reserve() {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= slots_.size()) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    head_.store(head + 1, std::memory_order_relaxed);
+    return &slots_[head & mask_];
+  }
+
+  // Called by the aggregation thread.
+  template <typename Callback>
+  void Consume(Callback&& callback) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      auto& slot = slots_[tail & mask_];
+      if (!slot.ready.load(std::memory_order_acquire)) break;
+      callback(slot);
+      slot.ready.store(false, std::memory_order_relaxed);
+      tail_.store(++tail, std::memory_order_release);
+    }
+  }
+
+  uint64_t TakeDropped() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+  // The sampling state of the owner thread.
+  uint64_t num_operators = 0;
+  int sampled_depth = 0;
+
+ private:
+  std::vector<SampledEvent> slots_;
+  uint64_t mask_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  DISABLE_COPY_AND_ASSIGN(SampledEventRing);
+};
+
+// An always-on profiler with a low overhead. RecordEvent samples one in N
+// operators or steps into the lock-free ring buffer of its thread, and a
+// background thread aggregates the sampled events into per-name latency
+// histograms and periodically writes the rolled-up summaries as JSON files.
+class TEST_API SamplingProfiler {
+ public:
+  static SamplingProfiler& GetInstance();
+
+  // Pairs with the release store of Start, so that a thread seeing the
+  // profiler enabled also sees its options.
+  static bool IsEnabled() { return enabled_.load(std::memory_order_acquire); }
+
+  ~SamplingProfiler();
+
+  void Start(const SamplingProfilerOptions& options);
+
+  // Stop sampling and roll up the events sampled since the last summary.
+  SamplingSummary Stop();
+
+  // Roll up the events sampled since the last summary into a summary now,
+  // which is also written to the output directory.
+  SamplingSummary Flush();
+
+  // Called by RecordEvent, returns the slot to record the event into, or
+  // nullptr if the event is not sampled.
+  SampledEvent* BeginEvent(const char* name, TracerEventType type);
+  void EndEvent(SampledEvent* event);
+
+ private:
+  struct Histogram {
+    // Four sub-buckets for every power of two.
+    static constexpr int kNumBuckets = 64 * 4;
+
+    void Add(uint64_t ns);
+    uint64_t Percentile(double percent) const;
+
+    TracerEventType type;
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    std::array<uint64_t, kNumBuckets> buckets{};
+  };
+
+  SamplingProfiler() = default;
+
+  SampledEventRing* CurrentThreadRing();
+  void AggregationLoop();
+  void DrainRings();
+  SamplingSummary RollUp();
+  void WriteSummary(const SamplingSummary& summary);
+
+  static std::atomic<bool> enabled_;
+
+  SamplingProfilerOptions options_;
+  std::atomic<uint64_t> num_steps_{0};
+  std::atomic<bool> in_sampled_step_{false};
+
+  // Guards rings_, the histograms and the summary files.
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<SampledEventRing>> rings_;
+  std::unordered_map<std::string, Histogram> histograms_;
+  uint64_t summary_start_ns_ = 0;
+  uint64_t dropped_ = 0;
+  uint64_t num_summaries_ = 0;
+
+  std::thread aggregation_thread_;
+  std::mutex aggregation_mutex_;
+  std::condition_variable aggregation_cv_;
+  bool stop_aggregation_ = false;
+
+  DISABLE_COPY_AND_ASSIGN(SamplingProfiler);
+};
+
+}  // namespace phi
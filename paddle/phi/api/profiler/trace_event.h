@@ -64,6 +64,8 @@ enum class TracerMemEventType {
   ReservedAllocate = 2,
   // Used to mark reserved memory free which is released to device.
   ReservedFree = 3,
+  // Used to mark the binding of allocated memory to a variable
+  VarBinding = 4,
   // A flag to denote the number of current types
   NumTypes
 };
@@ -161,6 +163,9 @@ struct HostTraceEvent {
   uint64_t process_id;
   // thread id of the record
   uint64_t thread_id;
+  // hardware performance counters of the record, such as "cycles", empty if
+  // they are not collected
+  std::map<std::string, uint64_t> counters;
 };
 
 struct RuntimeTraceEvent {
@@ -329,6 +334,8 @@ struct MemTraceEvent {
   uint64_t peak_allocated;
   // current peak reserved memory
   uint64_t peak_reserved;
+  // the variable bound to the memory, only set for VarBinding
+  std::string var_name;
 };
 
 }  // namespace phi
@@ -24,6 +24,8 @@
 #include <gloo/scatter.h>
 #include <gloo/types.h>
 
+#include <cstring>
+
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/check/static_check.h"
@@ -32,6 +34,56 @@
 namespace phi {
 namespace distributed {
 
+namespace {
+
+// Ring reduce-scatter: in step s every rank sends the partial result of part
+// (rank - s - 1) to its right neighbour and reduces the part (rank - s - 2)
+// received from its left neighbour, so that after size - 1 steps the fully
+// reduced part rank is held locally.
+template <typename T>
+void ReduceScatterRing(gloo::Context* context,
+                       phi::DenseTensor* out_tensor,
+                       const phi::DenseTensor& in_tensor,
+                       int reduce_type,
+                       uint32_t tag) {
+  const int rank = context->rank;
+  const int size = context->size;
+  const size_t chunk = out_tensor->numel();
+  const size_t chunk_bytes = chunk * sizeof(T);
+  const T* in_data = reinterpret_cast<const T*>(in_tensor.data());
+  T* out_data = reinterpret_cast<T*>(out_tensor->data());
+  if (size == 1) {
+    std::memcpy(out_data, in_data, chunk_bytes);
+    return;
+  }
+
+  std::unique_ptr<T[]> acc(new T[chunk * size]);
+  std::unique_ptr<T[]> recv(new T[chunk]);
+  std::memcpy(acc.get(), in_data, chunk_bytes * size);
+  auto acc_buffer =
+      context->createUnboundBuffer(acc.get(), chunk_bytes * size);
+  auto recv_buffer = context->createUnboundBuffer(recv.get(), chunk_bytes);
+  auto reduce_func = GetReduceFunc<T>(reduce_type);
+  const auto slot = gloo::Slot::build(kReduceScatterSlotPrefix, tag);
+  const auto timeout = context->getTimeout();
+  const int right = (rank + 1) % size;
+  const int left = (rank - 1 + size) % size;
+
+  for (int step = 0; step < size - 1; ++step) {
+    const int send_idx = (rank - step - 1 + 2 * size) % size;
+    const int recv_idx = (rank - step - 2 + 2 * size) % size;
+    acc_buffer->send(right, slot, send_idx * chunk_bytes, chunk_bytes);
+    recv_buffer->recv(left, slot, 0, chunk_bytes);
+    recv_buffer->waitRecv(timeout);
+    T* part = acc.get() + recv_idx * chunk;
+    reduce_func(part, part, recv.get(), chunk);
+    acc_buffer->waitSend(timeout);
+  }
+  std::memcpy(out_data, acc.get() + rank * chunk, chunk_bytes);
+}
+
+}  // namespace
+
 GlooCommContext::GlooCommContext(
     int rank,
     int size,
@@ -136,6 +188,102 @@ void GlooCommContext::Scatter(phi::DenseTensor* out_tensor,
   gloo::scatter(opts);
 }
 
+void GlooCommContext::AllToAll(phi::DenseTensor* out_tensor,
+                               const phi::DenseTensor& in_tensor,
+                               const std::vector<int64_t>& out_numel_each_rank,
+                               const std::vector<int64_t>& in_numel_each_rank,
+                               uint32_t tag) {
+  PADDLE_ENFORCE_EQ(
+      static_cast<int>(out_numel_each_rank.size()),
+      size_,
+      phi::errors::InvalidArgument("The length of out_numel_each_rank must be "
+                                   "equal to the group size."));
+  PADDLE_ENFORCE_EQ(
+      static_cast<int>(in_numel_each_rank.size()),
+      size_,
+      phi::errors::InvalidArgument("The length of in_numel_each_rank must be "
+                                   "equal to the group size."));
+  PADDLE_ENFORCE_EQ(
+      out_numel_each_rank[rank_],
+      in_numel_each_rank[rank_],
+      phi::errors::InvalidArgument(
+          "The part sent to the current rank must have the same size as the "
+          "part received from it, but got %d and %d.",
+          in_numel_each_rank[rank_],
+          out_numel_each_rank[rank_]));
+
+  const size_t elem_size = phi::SizeOf(in_tensor.dtype());
+  std::vector<size_t> in_offsets(size_, 0), out_offsets(size_, 0);
+  for (int i = 1; i < size_; ++i) {
+    in_offsets[i] = in_offsets[i - 1] + in_numel_each_rank[i - 1] * elem_size;
+    out_offsets[i] =
+        out_offsets[i - 1] + out_numel_each_rank[i - 1] * elem_size;
+  }
+
+  auto* in_data =
+      reinterpret_cast<char*>(const_cast<void*>(in_tensor.data()));
+  auto* out_data = reinterpret_cast<char*>(out_tensor->data());
+  std::memcpy(out_data + out_offsets[rank_],
+              in_data + in_offsets[rank_],
+              in_numel_each_rank[rank_] * elem_size);
+  if (size_ == 1) return;
+
+  // gloo only support mutable data input
+  auto in_buffer = gloo_context_->createUnboundBuffer(
+      in_data, in_tensor.numel() * elem_size);
+  auto out_buffer = gloo_context_->createUnboundBuffer(
+      out_data, out_tensor->numel() * elem_size);
+  const auto slot = gloo::Slot::build(kAllToAllSlotPrefix, tag);
+
+  // Post all the transfers at once, starting from the neighbours so that not
+  // every rank talks to rank 0 first.
+  int num_sends = 0, num_recvs = 0;
+  for (int i = 1; i < size_; ++i) {
+    int dst = (rank_ + i) % size_;
+    int src = (rank_ - i + size_) % size_;
+    if (in_numel_each_rank[dst] > 0) {
+      in_buffer->send(dst,
+                      slot,
+                      in_offsets[dst],
+                      in_numel_each_rank[dst] * elem_size);
+      ++num_sends;
+    }
+    if (out_numel_each_rank[src] > 0) {
+      out_buffer->recv(src,
+                       slot,
+                       out_offsets[src],
+                       out_numel_each_rank[src] * elem_size);
+      ++num_recvs;
+    }
+  }
+  const auto timeout = gloo_context_->getTimeout();
+  for (int i = 0; i < num_recvs; ++i) out_buffer->waitRecv(timeout);
+  for (int i = 0; i < num_sends; ++i) in_buffer->waitSend(timeout);
+}
+
+void GlooCommContext::ReduceScatter(phi::DenseTensor* out_tensor,
+                                    const phi::DenseTensor& in_tensor,
+                                    int reduce_type,
+                                    uint32_t tag) {
+  PADDLE_ENFORCE_EQ(
+      in_tensor.numel(),
+      out_tensor->numel() * size_,
+      phi::errors::InvalidArgument(
+          "The number of elements of the input (%d) must be the group size "
+          "(%d) times that of the output (%d).",
+          in_tensor.numel(),
+          size_,
+          out_tensor->numel()));
+  const auto& dtype = in_tensor.dtype();
+  GENERATE_FUNC(dtype,
+                ReduceScatterRing,
+                gloo_context_.get(),
+                out_tensor,
+                in_tensor,
+                reduce_type,
+                tag);
+}
+
 void GlooCommContext::Barrier() {
   gloo::BarrierOptions opts(gloo_context_);
   gloo::barrier(opts);
@@ -18,6 +18,7 @@
 #include <gloo/transport/tcp/device.h>
 
 #include <memory>
+#include <vector>
 
 #include "paddle/phi/core/distributed/comm_context.h"
 #include "paddle/phi/core/macros.h"
@@ -64,6 +65,22 @@ class GlooCommContext final : public CommContext {
                int size,
                uint32_t tag = 0);
 
+  // The i-th part of in_tensor is sent to rank i and the part received from
+  // rank i is written to the i-th part of out_tensor. The sizes are the
+  // number of elements of each part.
+  void AllToAll(phi::DenseTensor* out_tensor,
+                const phi::DenseTensor& in_tensor,
+                const std::vector<int64_t>& out_numel_each_rank,
+                const std::vector<int64_t>& in_numel_each_rank,
+                uint32_t tag = 0);
+
+  // in_tensor is split evenly into size parts, the reduced result of the
+  // rank-th part is written to out_tensor.
+  void ReduceScatter(phi::DenseTensor* out_tensor,
+                     const phi::DenseTensor& in_tensor,
+                     int reduce_type,
+                     uint32_t tag = 0);
+
   void Barrier();
 
   void Send(const phi::DenseTensor& in_tensor, int dst, uint32_t tag = 0);
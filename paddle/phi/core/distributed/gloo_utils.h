@@ -117,41 +117,38 @@ void SetInputForScatter(P* opts, const phi::DenseTensor& tensor, int nranks) {
   opts->setInputs(ret, tensor.numel() / nranks);
 }
 
-template <typename T, typename P>
-void SetReduceFunc(P* opts, int reduce_type) {
-  // gloo only support mutable data input
+using GlooReduceFunc = void (*)(void*, const void*, const void*, size_t);
+
+template <typename T>
+GlooReduceFunc GetReduceFunc(int reduce_type) {
   ReduceType reduce_type_enum = static_cast<ReduceType>(reduce_type);
   switch (reduce_type_enum) {
     case ReduceType::kRedSum:
-      opts->setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::sum<T>));
-      break;
+      return static_cast<GlooReduceFunc>(&gloo::sum<T>);
     case ReduceType::kRedMax:
-      opts->setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::max<T>));
-      break;
+      return static_cast<GlooReduceFunc>(&gloo::max<T>);
     case ReduceType::kRedMin:
-      opts->setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::min<T>));
-      break;
+      return static_cast<GlooReduceFunc>(&gloo::min<T>);
     case ReduceType::kRedProd:
-      opts->setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::product<T>));
-      break;
+      return static_cast<GlooReduceFunc>(&gloo::product<T>);
     default:
       PADDLE_THROW(
           errors::InvalidArgument("Unsupport reduce type: %d.", reduce_type));
   }
 }
 
+template <typename T, typename P>
+void SetReduceFunc(P* opts, int reduce_type) {
+  // gloo only support mutable data input
+  opts->setReduceFunction(GetReduceFunc<T>(reduce_type));
+}
+
 // env preparation
 std::shared_ptr<gloo::transport::Device> CreateGlooDevice();
 
 constexpr uint8_t kSendRecvSlotPrefix = 0x08;
+constexpr uint8_t kAllToAllSlotPrefix = 0x10;
+constexpr uint8_t kReduceScatterSlotPrefix = 0x11;
 
 class SendRecvOptions {
  public:
@@ -1071,6 +1071,16 @@ PD_DEFINE_bool(enable_slotrecord_reset_shrink,  // NOLINT
 PD_DEFINE_bool(enable_ins_parser_file,  // NOLINT
                false,
                "enable parser ins file, default false");
+PD_DEFINE_bool(enable_local_block_reader,  // NOLINT
+               true,
+               "read the uncompressed local files of the in-memory data feeds "
+               "in blocks and decode them in parallel, instead of parsing the "
+               "lines from the pipe command, if the pipe command is empty or "
+               "cat. The records of a file keep the order of the file.");
+PD_DEFINE_int32(local_block_reader_decode_threads,  // NOLINT
+                4,
+                "the number of threads decoding the blocks of a local file "
+                "in every data feed thread, default 4");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_hbm_table_collision_stat,
     false,
@@ -1327,6 +1337,13 @@ PHI_DEFINE_EXPORTED_int64(host_trace_level,
                           "RecordEvent will works "
                           "if host_trace_level >= level.");
 
+// Collect the hardware performance counters (cycles, instructions, LLC
+// misses, branch misses and stalled cycles) of the host events.
+PHI_DEFINE_EXPORTED_bool(enable_host_perf_counters,
+                         false,
+                         "Collect the hardware performance counters of the "
+                         "host events with perf_event_open.");
+
 PHI_DEFINE_EXPORTED_int32(
     multiple_of_cupti_buffer_size,
     1,
@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/activation_functor.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 #include "paddle/phi/kernels/impl/activation_impl.h"
 
 namespace phi {
@@ -123,6 +124,25 @@ DEFINE_CPU_ACT_KERNEL_WITH_TWO_ATTRS(HardSigmoid,
                                      slope,
                                      offset)
 
+// bfloat16 is computed in float by the jit kernels a block at a time, rather
+// than converting the whole tensor.
+#define DEFINE_CPU_BF16_JIT_ACTIVATION_KERNEL(name, tuple)                 \
+  template <>                                                              \
+  void name##Kernel<dtype::bfloat16, CPUContext>(                          \
+      const CPUContext& dev_ctx, const DenseTensor& x, DenseTensor* out) { \
+    jit::RunXYNInBlocks<jit::tuple<dtype::bfloat16>, CPUPlace>(            \
+        x.data<dtype::bfloat16>(),                                         \
+        dev_ctx.Alloc<dtype::bfloat16>(out),                               \
+        x.numel());                                                        \
+  }
+
+DEFINE_CPU_BF16_JIT_ACTIVATION_KERNEL(Relu, VReluTuple)
+DEFINE_CPU_BF16_JIT_ACTIVATION_KERNEL(Tanh, VTanhTuple)
+DEFINE_CPU_BF16_JIT_ACTIVATION_KERNEL(Sigmoid, VSigmoidTuple)
+DEFINE_CPU_BF16_JIT_ACTIVATION_KERNEL(Exp, VExpTuple)
+
+#undef DEFINE_CPU_BF16_JIT_ACTIVATION_KERNEL
+
 template <typename T, typename Context>
 void HardSwishKernel(const Context& dev_ctx,
                      const DenseTensor& x,
@@ -161,7 +181,13 @@ void Relu6Kernel(const Context& dev_ctx,
       dev_ctx, x, out, functor);
 }
 }  // namespace phi
-PD_REGISTER_KERNEL(relu, CPU, ALL_LAYOUT, phi::ReluKernel, float, double) {}
+PD_REGISTER_KERNEL(relu,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::ReluKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16) {}
 
 #define PD_REGISTER_ACTIVATION_KERNEL(name, func) \
   PD_REGISTER_KERNEL(name, CPU, ALL_LAYOUT, phi::func, float, double) {}
@@ -187,7 +213,15 @@ PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(cosh, CoshKernel)
 PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(asinh, AsinhKernel)
 PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(acosh, AcoshKernel)
 PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(atanh, AtanhKernel)
-PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(tanh, TanhKernel)
+PD_REGISTER_KERNEL(tanh,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::TanhKernel,
+                   float,
+                   double,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>,
+                   phi::dtype::bfloat16) {}
 PD_REGISTER_ACTIVATION_KERNEL(hardtanh, HardTanhKernel)
 PD_REGISTER_ACTIVATION_KERNEL(leaky_relu, LeakyReluKernel)
 PD_REGISTER_ACTIVATION_KERNEL(thresholded_relu, ThresholdedReluKernel)
@@ -213,7 +247,8 @@ PD_REGISTER_KERNEL(exp,
                    int64_t,
                    phi::dtype::float16,
                    phi::dtype::complex<float>,
-                   phi::dtype::complex<double>) {}
+                   phi::dtype::complex<double>,
+                   phi::dtype::bfloat16) {}
 
 PD_REGISTER_KERNEL(expm1,
                    CPU,
@@ -231,7 +266,15 @@ PD_REGISTER_KERNEL(logit, CPU, ALL_LAYOUT, phi::LogitKernel, float, double) {}
 PD_REGISTER_KERNEL(
     square, CPU, ALL_LAYOUT, phi::SquareKernel, float, double, int, int64_t) {}
 PD_REGISTER_ACTIVATION_KERNEL(softsign, SoftsignKernel)
-PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(sigmoid, SigmoidKernel)
+PD_REGISTER_KERNEL(sigmoid,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::SigmoidKernel,
+                   float,
+                   double,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>,
+                   phi::dtype::bfloat16) {}
 PD_REGISTER_ACTIVATION_KERNEL_WITH_COMPLEX(logsigmoid, LogSigmoidKernel)
 PD_REGISTER_ACTIVATION_KERNEL(hardsigmoid, HardSigmoidKernel)
 PD_REGISTER_ACTIVATION_KERNEL(swish, SwishKernel)
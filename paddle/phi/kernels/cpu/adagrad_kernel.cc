@@ -16,6 +16,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/lazy_sparse_optimizer.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 #include "paddle/phi/kernels/impl/adagrad_kernel_impl.h"
@@ -77,27 +78,17 @@ struct SparseAdagradFunctor<phi::CPUContext, T> {
     phi::funcs::scatter::MergeAdd<phi::CPUContext, T> merge_func;
     auto grad_merge = merge_func(context, grad);
     auto& merge_rows = grad_merge.rows();
-    auto* grad_merge_data = grad_merge.mutable_value()->template data<T>();
-
-    // 2. m += g_m * g_m
-    auto grad_square =
-        SquareSelectedRows<phi::CPUContext, T>(context, grad_merge);
-
-    phi::funcs::SelectedRowsAddToTensor<phi::CPUContext, T> functor;
-    functor(context, grad_square, moment);
-
-    // 3. update parameter
-    auto* lr = learning_rate.data<T>();
-    auto* param_data = param->data<T>();
-    auto* moment_data = moment->data<T>();
-
-    for (size_t i = 0; i < merge_rows.size(); i++) {
-      for (int64_t j = 0; j < grad_width; j++) {
-        param_data[merge_rows[i] * grad_width + j] -=
-            lr[0] * grad_merge_data[i * grad_width + j] /
-            (std::sqrt(moment_data[merge_rows[i] * grad_width + j]) + epsilon);
-      }
-    }
+    auto* grad_merge_data = grad_merge.value().template data<T>();
+
+    // 2. m += g_m * g_m and update parameter, of a row in one pass
+    phi::funcs::AdagradRowUpdate<T> update(learning_rate.data<T>()[0],
+                                           epsilon,
+                                           grad_merge_data,
+                                           moment->data<T>(),
+                                           param->data<T>(),
+                                           merge_rows.data(),
+                                           grad_width);
+    phi::funcs::ForEachSparseRow(merge_rows.size(), grad_width, update);
   }
 };
 
@@ -16,8 +16,7 @@ limitations under the License. */
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/funcs/math_function.h"
-#include "paddle/phi/kernels/impl/transpose_grad_kernel_impl.h"
+#include "paddle/phi/kernels/funcs/cpu_strided_copy.h"
 
 namespace phi {
 
@@ -30,24 +29,15 @@ void ContiguousKernel(const Context& dev_ctx,
   meta.offset = 0;
   out->set_meta(meta);
 
-  const T* input_data = input.data<T>();
   T* output_data = dev_ctx.template Alloc<T>(out);
-  int rank = input.dims().size();
-  auto dims = input.dims();
-  auto input_stride = input.strides();
-  auto numel = input.numel();
-
-  for (int64_t i = 0; i < numel; i++) {
-    int64_t input_offset = 0;
-    int64_t index_tmp = i;
-    for (int dim = rank - 1; dim >= 0; --dim) {
-      int64_t mod = index_tmp % dims[dim];
-      index_tmp = index_tmp / dims[dim];
-      input_offset += mod * input_stride[dim];
-    }
-
-    output_data[i] = input_data[input_offset];
+  if (input.numel() <= 0) {
+    return;
   }
+  funcs::CPUStridedCopy(input.data<T>(),
+                        output_data,
+                        phi::vectorize(input.dims()),
+                        phi::vectorize(input.strides()),
+                        phi::vectorize(meta.strides));
 }
 }  // namespace phi
 
@@ -20,6 +20,7 @@ limitations under the License. */
 #include "paddle/phi/kernels/funcs/broadcast_function.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 
@@ -49,11 +50,29 @@ struct SameDimsAddFunctor<
   }
 };
 
+// bfloat16 is computed in float by the jit kernel, a block at a time.
 template <typename DevCtx, typename T>
 struct SameDimsAddFunctor<
     DevCtx,
     T,
-    typename std::enable_if<!std::is_floating_point<T>::value>::type> {
+    typename std::enable_if<
+        std::is_same<T, phi::dtype::bfloat16>::value>::type> {
+  void operator()(const DevCtx& dev_ctx,
+                  const DenseTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* z) {
+    jit::RunXYZNInBlocks<jit::VAddTuple<T>, phi::CPUPlace>(
+        x.data<T>(), y.data<T>(), dev_ctx.template Alloc<T>(z), x.numel());
+  }
+};
+
+template <typename DevCtx, typename T>
+struct SameDimsAddFunctor<
+    DevCtx,
+    T,
+    typename std::enable_if<
+        !std::is_floating_point<T>::value &&
+        !std::is_same<T, phi::dtype::bfloat16>::value>::type> {
   void operator()(const DevCtx& dev_ctx,
                   const DenseTensor& x,
                   const DenseTensor& y,
@@ -171,11 +190,29 @@ struct SameDimsMultiplyFunctor<
   }
 };
 
+// bfloat16 is computed in float by the jit kernel, a block at a time.
 template <typename DevCtx, typename T>
 struct SameDimsMultiplyFunctor<
     DevCtx,
     T,
-    typename std::enable_if<!std::is_floating_point<T>::value>::type> {
+    typename std::enable_if<
+        std::is_same<T, phi::dtype::bfloat16>::value>::type> {
+  void operator()(const DevCtx& dev_ctx,
+                  const DenseTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* z) {
+    jit::RunXYZNInBlocks<jit::VMulTuple<T>, phi::CPUPlace>(
+        x.data<T>(), y.data<T>(), dev_ctx.template Alloc<T>(z), x.numel());
+  }
+};
+
+template <typename DevCtx, typename T>
+struct SameDimsMultiplyFunctor<
+    DevCtx,
+    T,
+    typename std::enable_if<
+        !std::is_floating_point<T>::value &&
+        !std::is_same<T, phi::dtype::bfloat16>::value>::type> {
   void operator()(const DevCtx& dev_ctx,
                   const DenseTensor& x,
                   const DenseTensor& y,
@@ -80,7 +80,8 @@ PD_REGISTER_KERNEL(add,
                    int,
                    int64_t,
                    complex64,
-                   complex128) {}
+                   complex128,
+                   phi::dtype::bfloat16) {}
 
 PD_REGISTER_KERNEL(grad_add,
                    CPU,
@@ -17,6 +17,7 @@
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/cpu/embedding_grad_util.h"
 #include "paddle/phi/kernels/funcs/embedding_util.h"
 
 namespace phi {
@@ -41,55 +42,14 @@ struct EmbeddingGradCPUFunctor {
     DDim table_dim = weight_.dims();
 
     auto ids = CopyIdsToVector<IdT, int64_t>(input_);
-    auto ids_num = static_cast<int64_t>(ids.size());
-
-    // Since paddings are not trainable and fixed in forward, the gradient of
-    // paddings makes no sense and we don't deal with it in backward.
-    {
-      auto* d_output = &out_grad_;
-      auto* ids_data = ids.data();
-
-      int64_t N = table_dim[0];
-      int64_t D = table_dim[1];
-
-      auto* d_output_data = d_output->template data<T>();
-
-      dev_ctx_.template Alloc<T>(weight_grad_);
-      auto* d_table_data = weight_grad_->data<T>();
-
-      memset(d_table_data, 0, weight_grad_->numel() * sizeof(T));
-
-      for (int64_t i = 0; i < ids_num; ++i) {
-        if (padding_idx_ != kNoPadding && ids_data[i] == padding_idx_) {
-          // the gradient of padding_idx should be 0, already done by memset, so
-          // do nothing.
-        } else {
-          PADDLE_ENFORCE_LT(
-              ids_data[i],
-              N,
-              phi::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          PADDLE_ENFORCE_GE(
-              ids_data[i],
-              0,
-              phi::errors::InvalidArgument(
-                  "Variable value (input) of "
-                  "OP(paddle.nn.functional.embedding) "
-                  "expected >= 0 and < %ld, but got %ld. Please check input "
-                  "value.",
-                  N,
-                  ids_data[i]));
-          for (int j = 0; j < D; ++j) {
-            d_table_data[ids_data[i] * D + j] += d_output_data[i * D + j];
-          }
-        }
-      }
-    }
+
+    EmbeddingDenseGradCPU<T>(dev_ctx_,
+                             ids,
+                             out_grad_,
+                             table_dim[0],
+                             table_dim[1],
+                             padding_idx_,
+                             weight_grad_);
   }
 
  private:
@@ -140,37 +100,9 @@ struct EmbeddingSparseGradCPUFunctor {
     DDim table_dim = weight_.dims();
 
     auto ids = CopyIdsToVector<IdT, int64_t>(input_);
-    auto ids_num = static_cast<int64_t>(ids.size());
-
-    // Since paddings are not trainable and fixed in forward, the gradient of
-    // paddings makes no sense and we don't deal with it in backward.
-    auto* d_table = weight_grad_;
-    auto* d_output = &out_grad_;
-    d_table->set_rows(ids);
-
-    auto* d_table_value = d_table->mutable_value();
-    d_table_value->Resize({ids_num, table_dim[1]});
-
-    dev_ctx_.template Alloc<T>(d_table_value);
-
-    d_table->set_height(table_dim[0]);
-
-    auto* d_output_data = d_output->template data<T>();
-    auto* d_table_data = d_table_value->template data<T>();
-
-    auto d_output_dims = d_output->dims();
-    auto d_output_dims_2d =
-        flatten_to_2d(d_output_dims, d_output_dims.size() - 1);
-    PADDLE_ENFORCE_EQ(d_table_value->dims(),
-                      d_output_dims_2d,
-                      phi::errors::InvalidArgument(
-                          "ShapeError: The shape of lookup_table@Grad and "
-                          "output@Grad should be same. "
-                          "But received lookup_table@Grad's shape = [%s], "
-                          "output@Grad's shape = [%s].",
-                          d_table_value->dims(),
-                          d_output_dims_2d));
-    memcpy(d_table_data, d_output_data, sizeof(T) * d_output->numel());
+
+    EmbeddingSparseGradCPU<T>(
+        dev_ctx_, ids, out_grad_, table_dim[0], table_dim[1], weight_grad_);
   }
 
  private:
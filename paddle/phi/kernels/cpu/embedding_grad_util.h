@@ -0,0 +1,123 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/funcs/embedding_util.h"
+#include "paddle/phi/kernels/funcs/sorted_segments.h"
+
+namespace phi {
+
+// The gradient of the table of height rows: the rows of out_grad of the same
+// id are summed by the sorted segments of the ids, so that every row of the
+// table is written by one thread. Since paddings are not trainable and fixed
+// in forward, the gradient of padding_idx is left 0.
+template <typename T>
+void EmbeddingDenseGradCPU(const CPUContext& dev_ctx,
+                           const std::vector<int64_t>& ids,
+                           const DenseTensor& out_grad,
+                           int64_t height,
+                           int64_t width,
+                           int64_t padding_idx,
+                           DenseTensor* weight_grad) {
+  for (int64_t id : ids) {
+    if (padding_idx != kNoPadding && id == padding_idx) {
+      continue;
+    }
+    PADDLE_ENFORCE_LT(
+        id,
+        height,
+        phi::errors::InvalidArgument(
+            "Variable value (input) of "
+            "OP(paddle.nn.functional.embedding) "
+            "expected >= 0 and < %ld, but got %ld. Please check input "
+            "value.",
+            height,
+            id));
+    PADDLE_ENFORCE_GE(
+        id,
+        0,
+        phi::errors::InvalidArgument(
+            "Variable value (input) of "
+            "OP(paddle.nn.functional.embedding) "
+            "expected >= 0 and < %ld, but got %ld. Please check input "
+            "value.",
+            height,
+            id));
+  }
+
+  const T* d_output_data = out_grad.data<T>();
+  T* d_table_data = dev_ctx.template Alloc<T>(weight_grad);
+  memset(d_table_data, 0, weight_grad->numel() * sizeof(T));
+
+  funcs::SortedSegments segments;
+  funcs::SortIntoSegments(ids.data(),
+                          static_cast<int64_t>(ids.size()),
+                          &segments,
+                          padding_idx != kNoPadding ? &padding_idx : nullptr);
+  funcs::SegmentSum<T>(
+      segments,
+      width,
+      [&](int64_t i) { return d_output_data + i * width; },
+      [&](int64_t s) { return d_table_data + segments.ids[s] * width; });
+}
+
+// The SelectedRows gradient of the table of height rows, with a row for every
+// unique id in ascending order, which is what MergeAdd would make of a row for
+// every id.
+template <typename T>
+void EmbeddingSparseGradCPU(const CPUContext& dev_ctx,
+                            const std::vector<int64_t>& ids,
+                            const DenseTensor& out_grad,
+                            int64_t height,
+                            int64_t width,
+                            SelectedRows* weight_grad) {
+  auto d_output_dims = out_grad.dims();
+  auto d_output_dims_2d =
+      phi::flatten_to_2d(d_output_dims, d_output_dims.size() - 1);
+  PADDLE_ENFORCE_EQ(
+      d_output_dims_2d,
+      phi::make_ddim({static_cast<int64_t>(ids.size()), width}),
+      phi::errors::InvalidArgument(
+          "ShapeError: The shape of output@Grad should be [%d, %d] of the "
+          "ids and the table. But received output@Grad's shape = [%s].",
+          ids.size(),
+          width,
+          d_output_dims_2d));
+
+  funcs::SortedSegments segments;
+  funcs::SortIntoSegments(
+      ids.data(), static_cast<int64_t>(ids.size()), &segments);
+  weight_grad->set_height(height);
+  weight_grad->set_rows(segments.ids);
+  auto* d_table_value = weight_grad->mutable_value();
+  d_table_value->Resize({segments.size(), width});
+  T* d_table_data = dev_ctx.template Alloc<T>(d_table_value);
+
+  const T* d_output_data = out_grad.data<T>();
+  funcs::SegmentSum<T>(
+      segments,
+      width,
+      [&](int64_t i) { return d_output_data + i * width; },
+      [&](int64_t s) { return d_table_data + s * width; });
+}
+
+}  // namespace phi
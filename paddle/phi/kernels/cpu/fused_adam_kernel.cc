@@ -20,6 +20,8 @@
 
 #include "paddle/phi/kernels/adam_kernel.h"
 #include "paddle/phi/kernels/adamw_kernel.h"
+#include "paddle/phi/kernels/funcs/cpu_multi_tensor_apply.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 
@@ -96,62 +98,170 @@ void FusedAdamKernel(
                         beta2_pows.size(),
                         params_num));
 
+  bool skip_update_ = false;
+  if (skip_update.is_initialized()) {
+    PADDLE_ENFORCE_EQ(
+        skip_update->numel(),
+        1,
+        errors::InvalidArgument("Input(SkipUpdate) size must be 1, but get %d",
+                                skip_update->numel()));
+    std::vector<bool> skip_update_vec;
+    phi::TensorToVector(*skip_update, dev_ctx, &skip_update_vec);
+    skip_update_ = skip_update_vec[0];
+  }
+
+  // the kernel of every param copies the inputs to the outputs
+  if (skip_update_) {
+    for (size_t idx = 0; idx < params_num; idx++) {
+      auto master_params_tmp = TensorPtrToOptionalTensor(master_params, idx);
+      if (!use_adamw) {
+        AdamDenseKernel<T, Context>(
+            dev_ctx,
+            *params[idx],
+            *grads[idx],
+            learning_rate,
+            *moments1[idx],
+            *moments2[idx],
+            *beta1_pows[idx],
+            *beta2_pows[idx],
+            master_params_tmp,
+            skip_update,
+            beta1,
+            beta2,
+            epsilon,
+            false,
+            1000,
+            multi_precision,
+            use_global_beta_pow,
+            params_out[idx],
+            moments1_out[idx],
+            moments2_out[idx],
+            beta1_pows_out[idx],
+            beta2_pows_out[idx],
+            master_params_out.empty() ? nullptr : master_params_out[idx]);
+      } else {
+        AdamwDenseKernel<T, Context>(
+            dev_ctx,
+            *params[idx],
+            *grads[idx],
+            learning_rate,
+            *moments1[idx],
+            *moments2[idx],
+            *beta1_pows[idx],
+            *beta2_pows[idx],
+            master_params_tmp,
+            skip_update,
+            beta1,
+            beta2,
+            epsilon,
+            1.0,
+            weight_decay,
+            use_adamw,
+            false,
+            1000,
+            multi_precision,
+            use_global_beta_pow,
+            params_out[idx],
+            moments1_out[idx],
+            moments2_out[idx],
+            beta1_pows_out[idx],
+            beta2_pows_out[idx],
+            master_params_out.empty() ? nullptr : master_params_out[idx]);
+      }
+    }
+    return;
+  }
+
+  PADDLE_ENFORCE_GT(
+      chunk_size,
+      0,
+      errors::InvalidArgument("The chunk_size must be greater than 0, but got "
+                              "%d.",
+                              chunk_size));
+
+  T beta1_ = beta1.to<T>();
+  T beta2_ = beta2.to<T>();
+  T epsilon_ = epsilon.to<T>();
+  T old_lr = learning_rate.data<T>()[0];
+  T lr_ratio = static_cast<T>(1.0);
+  T coeff = static_cast<T>(weight_decay);
+
+  std::vector<int64_t> numels(params_num);
+  std::vector<T> lrs(params_num), epsilons(params_num);
+  std::vector<T*> params_out_ptr(params_num), moments1_out_ptr(params_num),
+      moments2_out_ptr(params_num);
   for (size_t idx = 0; idx < params_num; idx++) {
-    auto master_params_tmp = TensorPtrToOptionalTensor(master_params, idx);
-    if (!use_adamw) {
-      AdamDenseKernel<T, Context>(
-          dev_ctx,
-          *params[idx],
-          *grads[idx],
-          learning_rate,
-          *moments1[idx],
-          *moments2[idx],
-          *beta1_pows[idx],
-          *beta2_pows[idx],
-          master_params_tmp,
-          skip_update,
-          beta1,
-          beta2,
-          epsilon,
-          false,
-          1000,
-          multi_precision,
-          use_global_beta_pow,
-          params_out[idx],
-          moments1_out[idx],
-          moments2_out[idx],
-          beta1_pows_out[idx],
-          beta2_pows_out[idx],
-          master_params_out.empty() ? nullptr : master_params_out[idx]);
-    } else {
-      AdamwDenseKernel<T, Context>(
-          dev_ctx,
-          *params[idx],
-          *grads[idx],
-          learning_rate,
-          *moments1[idx],
-          *moments2[idx],
-          *beta1_pows[idx],
-          *beta2_pows[idx],
-          master_params_tmp,
-          skip_update,
-          beta1,
-          beta2,
-          epsilon,
-          1.0,
-          weight_decay,
-          use_adamw,
-          false,
-          1000,
-          multi_precision,
-          use_global_beta_pow,
-          params_out[idx],
-          moments1_out[idx],
-          moments2_out[idx],
-          beta1_pows_out[idx],
-          beta2_pows_out[idx],
-          master_params_out.empty() ? nullptr : master_params_out[idx]);
+    PADDLE_ENFORCE_EQ(
+        beta1_pows_out[idx]->numel(),
+        1,
+        errors::InvalidArgument("beta1 pow output size should be 1, but "
+                                "received value is:%d.",
+                                beta1_pows_out[idx]->numel()));
+    PADDLE_ENFORCE_EQ(
+        beta2_pows_out[idx]->numel(),
+        1,
+        errors::InvalidArgument("beta2 pow output size should be 1, but "
+                                "received value is:%d.",
+                                beta2_pows_out[idx]->numel()));
+    T beta1_p = beta1_pows[idx]->data<T>()[0];
+    T beta2_p = beta2_pows[idx]->data<T>()[0];
+    if (!use_global_beta_pow) {
+      dev_ctx.template Alloc<T>(beta1_pows_out[idx])[0] = beta1_ * beta1_p;
+      dev_ctx.template Alloc<T>(beta2_pows_out[idx])[0] = beta2_ * beta2_p;
     }
+    lrs[idx] = old_lr * (sqrt(1 - beta2_p) / (1 - beta1_p));
+    epsilons[idx] = epsilon_ * sqrt(1 - beta2_p);
+    numels[idx] = params[idx]->numel();
+    params_out_ptr[idx] = dev_ctx.template Alloc<T>(params_out[idx]);
+    moments1_out_ptr[idx] = dev_ctx.template Alloc<T>(moments1_out[idx]);
+    moments2_out_ptr[idx] = dev_ctx.template Alloc<T>(moments2_out[idx]);
+  }
+
+  // The params are updated by the chunks of all of them at once, instead of
+  // by a kernel of every param, which leaves the threads idle on the small
+  // params of a model.
+  if (use_adamw) {
+    auto adamw = phi::jit::KernelFuncs<phi::jit::AdamWTuple<T>,
+                                       phi::CPUPlace>::Cache()
+                     .At(1);
+    funcs::CPUMultiTensorApply(
+        numels, chunk_size, [&](size_t idx, int64_t begin, int64_t end) {
+          adamw(beta1_,
+                beta2_,
+                -lrs[idx],
+                epsilons[idx],
+                old_lr,
+                lr_ratio,
+                coeff,
+                end - begin,
+                grads[idx]->data<T>() + begin,
+                moments1[idx]->data<T>() + begin,
+                moments2[idx]->data<T>() + begin,
+                params[idx]->data<T>() + begin,
+                moments1_out_ptr[idx] + begin,
+                moments2_out_ptr[idx] + begin,
+                params_out_ptr[idx] + begin);
+        });
+  } else {
+    phi::jit::adam_attr_t attr(beta1_, beta2_);
+    auto adam =
+        phi::jit::KernelFuncs<phi::jit::AdamTuple<T>, phi::CPUPlace>::Cache()
+            .At(attr);
+    funcs::CPUMultiTensorApply(
+        numels, chunk_size, [&](size_t idx, int64_t begin, int64_t end) {
+          adam(beta1_,
+               beta2_,
+               -lrs[idx],
+               epsilons[idx],
+               end - begin,
+               grads[idx]->data<T>() + begin,
+               moments1[idx]->data<T>() + begin,
+               moments2[idx]->data<T>() + begin,
+               params[idx]->data<T>() + begin,
+               moments1_out_ptr[idx] + begin,
+               moments2_out_ptr[idx] + begin,
+               params_out_ptr[idx] + begin);
+        });
   }
 }
 
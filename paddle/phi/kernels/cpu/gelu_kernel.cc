@@ -25,6 +25,7 @@
 #include "paddle/phi/kernels/funcs/blas/blas_impl.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 
@@ -87,12 +88,25 @@ struct GeluFunctor {
   }
 };
 
+template <typename T>
+void GeluJit(const T* x, T* out, int64_t n, bool approximate) {
+  if (approximate) {
+    jit::RunXYNInBlocks<jit::VGeluTanhTuple<T>, phi::CPUPlace>(x, out, n);
+  } else {
+    jit::RunXYNInBlocks<jit::VGeluTuple<T>, phi::CPUPlace>(x, out, n);
+  }
+}
+
 template <typename T, typename Context>
 void GeluKernel(const Context& dev_ctx,
                 const DenseTensor& x,
                 bool approximate,
                 DenseTensor* out) {
   dev_ctx.template Alloc<T>(out);
+  if (std::is_same<T, float>::value) {
+    GeluJit<T>(x.data<T>(), out->data<T>(), x.numel(), approximate);
+    return;
+  }
   auto eigen_out = EigenVector<T>::Flatten(*out);
   auto eigen_x = EigenVector<T>::Flatten(x);
   auto& dev = *dev_ctx.eigen_device();
@@ -101,6 +115,26 @@ void GeluKernel(const Context& dev_ctx,
   functor(dev, eigen_x, eigen_out, approximate);
 }
 
+// bfloat16 is computed in float by the jit kernels a block at a time, rather
+// than converting the whole tensor.
+template <>
+void GeluKernel<dtype::bfloat16, CPUContext>(const CPUContext& dev_ctx,
+                                             const DenseTensor& x,
+                                             bool approximate,
+                                             DenseTensor* out) {
+  dev_ctx.Alloc<dtype::bfloat16>(out);
+  GeluJit<dtype::bfloat16>(x.data<dtype::bfloat16>(),
+                           out->data<dtype::bfloat16>(),
+                           x.numel(),
+                           approximate);
+}
+
 }  // namespace phi
 
-PD_REGISTER_KERNEL(gelu, CPU, ALL_LAYOUT, phi::GeluKernel, float, double) {}
+PD_REGISTER_KERNEL(gelu,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::GeluKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16) {}
@@ -15,6 +15,7 @@
 #include "paddle/phi/kernels/layer_norm_kernel.h"
 
 #include "paddle/phi/kernels/cpu/elementwise.h"
+#include "paddle/phi/kernels/funcs/cpu_layer_norm.h"
 #include "paddle/phi/kernels/funcs/layer_norm_util.h"
 #if !defined(PADDLE_WITH_CUDA) && !defined(_WIN32) && !defined(__APPLE__) && \
     !defined(__OSX__)
@@ -126,15 +127,25 @@ void LayerNormKernel(const Context& dev_ctx,
   auto ker =
       phi::jit::KernelFuncs<phi::jit::LayerNormTuple<T>, phi::CPUPlace>::Cache()
           .At(right);
-  ker(x_tmp.data<T>(),
-      out.data<T>(),
-      mean->data<T>(),
-      var->data<T>(),
-      scale ? scale->data<T>() : nullptr,
-      bias ? bias->data<T>() : nullptr,
-      static_cast<int>(left),
-      static_cast<float>(epsilon),
-      right);
+  // the rows are split into a block of contiguous rows for every thread
+  T* x_data = x_tmp.data<T>();
+  T* out_data = out.data<T>();
+  T* mean_data = mean->data<T>();
+  T* var_data = var->data<T>();
+  funcs::ForEachRowBlock(
+      left,
+      funcs::LayerNormRowBlocks(left, right),
+      [&](int, int64_t begin, int64_t end) {
+        ker(x_data + begin * right,
+            out_data + begin * right,
+            mean_data + begin,
+            var_data + begin,
+            scale ? scale->data<T>() : nullptr,
+            bias ? bias->data<T>() : nullptr,
+            static_cast<int>(end - begin),
+            static_cast<float>(epsilon),
+            right);
+      });
 #endif
 }
 
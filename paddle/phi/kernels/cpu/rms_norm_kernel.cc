@@ -0,0 +1,96 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/rms_norm_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void RmsNormKernel(const Context& dev_ctx,
+                   const DenseTensor& x,
+                   const paddle::optional<DenseTensor>& bias,
+                   const paddle::optional<DenseTensor>& residual,
+                   const DenseTensor& norm_weight,
+                   const paddle::optional<DenseTensor>& norm_bias,
+                   const float epsilon,
+                   const int begin_norm_axis,
+                   const float quant_scale,
+                   const int quant_round_type,
+                   const float quant_max_bound,
+                   const float quant_min_bound,
+                   DenseTensor* out,
+                   DenseTensor* residual_out) {
+  PADDLE_ENFORCE_LE(quant_scale,
+                    0.0f,
+                    phi::errors::Unimplemented(
+                        "The int8 output of rms_norm is not supported on CPU, "
+                        "but received quant_scale %f.",
+                        quant_scale));
+
+  int rows = 1;
+  int cols = 1;
+  for (int i = 0; i < begin_norm_axis; i++) {
+    rows *= static_cast<int>(x.dims()[i]);
+  }
+  for (int i = begin_norm_axis; i < x.dims().size(); i++) {
+    cols *= static_cast<int>(x.dims()[i]);
+  }
+  PADDLE_ENFORCE_EQ(norm_weight.numel(),
+                    cols,
+                    phi::errors::InvalidArgument(
+                        "norm_weight's length (%d) is not equal with "
+                        "expected (%d).",
+                        norm_weight.numel(),
+                        cols));
+
+  const T* x_data = x.data<T>();
+  if (residual) {
+    // Do RMSNorm(bias_add + residual + x)
+    T* residual_out_data = dev_ctx.template Alloc<T>(residual_out);
+    const T* residual_data = residual.get().data<T>();
+    auto compute_vadd =
+        jit::KernelFuncs<jit::VAddTuple<T>, phi::CPUPlace>::Cache().At(cols);
+    for (int i = 0; i < rows; ++i) {
+      compute_vadd(x_data + i * cols,
+                   residual_data + i * cols,
+                   residual_out_data + i * cols,
+                   cols);
+      if (bias) {
+        compute_vadd(residual_out_data + i * cols,
+                     bias.get().data<T>(),
+                     residual_out_data + i * cols,
+                     cols);
+      }
+    }
+    x_data = residual_out_data;
+  }
+
+  auto compute_rms_norm =
+      jit::KernelFuncs<jit::RMSNormTuple<T>, phi::CPUPlace>::Cache().At(cols);
+  compute_rms_norm(x_data,
+                   dev_ctx.template Alloc<T>(out),
+                   norm_weight.data<T>(),
+                   norm_bias ? norm_bias.get().data<T>() : nullptr,
+                   rows,
+                   epsilon,
+                   cols);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(rms_norm, CPU, ALL_LAYOUT, phi::RmsNormKernel, float) {}
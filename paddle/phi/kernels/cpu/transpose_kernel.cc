@@ -19,7 +19,8 @@
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/cpu_strided_copy.h"
 
 namespace phi {
 
@@ -41,39 +42,24 @@ void TransposeKernel(const Context& ctx,
     return;
   }
   int rank = static_cast<int>(formated_axis.size());
-  switch (rank) {
-    case 0:
-      phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
-      break;
-    case 1:
-      funcs::Transpose<Context, T, 1> trans1;
-      trans1(ctx, x, out, formated_axis);
-      break;
-    case 2:
-      funcs::Transpose<Context, T, 2> trans2;
-      trans2(ctx, x, out, formated_axis);
-      break;
-    case 3:
-      funcs::Transpose<Context, T, 3> trans3;
-      trans3(ctx, x, out, formated_axis);
-      break;
-    case 4:
-      funcs::Transpose<Context, T, 4> trans4;
-      trans4(ctx, x, out, formated_axis);
-      break;
-    case 5:
-      funcs::Transpose<Context, T, 5> trans5;
-      trans5(ctx, x, out, formated_axis);
-      break;
-    case 6:
-      funcs::Transpose<Context, T, 6> trans6;
-      trans6(ctx, x, out, formated_axis);
-      break;
-    default:
-      // for rank >= 7 situation
-      funcs::TransposeNormal<Context, T> trans_normal;
-      trans_normal(ctx, x, out, formated_axis);
+  if (rank == 0) {
+    phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
+    return;
+  }
+  // out is the copy of x with the strides of x permuted by axis
+  std::vector<int64_t> x_strides =
+      funcs::ContiguousStrides(phi::vectorize(x.dims()));
+  std::vector<int64_t> out_dims(rank);
+  std::vector<int64_t> src_strides(rank);
+  for (int i = 0; i < rank; ++i) {
+    out_dims[i] = x.dims()[formated_axis[i]];
+    src_strides[i] = x_strides[formated_axis[i]];
   }
+  funcs::CPUStridedCopy(x.data<T>(),
+                        out->data<T>(),
+                        out_dims,
+                        src_strides,
+                        funcs::ContiguousStrides(out_dims));
 }
 
 }  // namespace phi
@@ -70,11 +70,20 @@ struct CBlas<phi::dtype::bfloat16> {
     detail::axpy(args...);
   }
 
-  template <typename... ARGS>
-  static void VCOPY(ARGS... args UNUSED) {
-    PADDLE_THROW(phi::errors::Unimplemented(
-        "Blas VCOPY do not supported on CPU with bfloat16,"
-        " please check your code"));
+  static void VCOPY(int n,
+                    const phi::dtype::bfloat16 *x,
+                    const int incx,
+                    phi::dtype::bfloat16 *y,
+                    const int incy) {
+    if (incx == 1 && incy == 1) {
+      std::copy(x, x + n, y);
+      return;
+    }
+    while (n-- > 0) {
+      *y = *x;
+      y = y + incy;
+      x = x + incx;
+    }
   }
 
   template <typename... ARGS>
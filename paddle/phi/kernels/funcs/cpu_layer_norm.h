@@ -0,0 +1,183 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/kernels/funcs/cpu_parallel.h"
+
+namespace phi {
+namespace funcs {
+
+// The number of blocks of contiguous rows that rows of cols elements are
+// split into, a block for every thread.
+inline int LayerNormRowBlocks(int64_t rows, int64_t cols) {
+  return CPUParallelThreads(rows * cols, /*min_work_per_thread=*/16384, rows);
+}
+
+// Calls func(block, begin, end) for the rows [begin, end) of every block,
+// with a thread for every block.
+template <typename Func>
+void ForEachRowBlock(int64_t rows, int blocks, const Func& func) {
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel for num_threads(blocks)
+#endif
+  for (int b = 0; b < blocks; ++b) {
+    func(b, rows * b / blocks, rows * (b + 1) / blocks);
+  }
+}
+
+// The gradient of the layer norm of rows of cols elements, which reads x and
+// dy once for the reductions of a row and once more for dx while the row is
+// in cache. dscale and dbias are summed into a partial row for every block,
+// and the partial rows are added up at the end. Any of dx, dscale and dbias
+// may be nullptr, and so may scale.
+template <typename T>
+void LayerNormGradRows(const T* x,
+                       const T* dy,
+                       const T* mean,
+                       const T* var,
+                       const T* scale,
+                       float epsilon,
+                       int64_t rows,
+                       int64_t cols,
+                       T* dx,
+                       T* dscale,
+                       T* dbias) {
+  const int blocks = LayerNormRowBlocks(rows, cols);
+  std::vector<T> dscale_partial(dscale ? blocks * cols : 0);
+  std::vector<T> dbias_partial(dbias ? blocks * cols : 0);
+  ForEachRowBlock(rows, blocks, [&](int b, int64_t begin, int64_t end) {
+    T* ds = dscale ? dscale_partial.data() + b * cols : nullptr;
+    T* db = dbias ? dbias_partial.data() + b * cols : nullptr;
+    for (int64_t i = begin; i < end; ++i) {
+      const T* x_row = x + i * cols;
+      const T* dy_row = dy + i * cols;
+      const T row_mean = mean[i];
+      const T inv_std =
+          static_cast<T>(1) / sqrt(var[i] + static_cast<T>(epsilon));
+      T sum_dy = 0;
+      T sum_dy_x_norm = 0;
+      for (int64_t j = 0; j < cols; ++j) {
+        const T x_norm = (x_row[j] - row_mean) * inv_std;
+        const T dy_scaled = scale ? dy_row[j] * scale[j] : dy_row[j];
+        sum_dy += dy_scaled;
+        sum_dy_x_norm += dy_scaled * x_norm;
+        if (ds) {
+          ds[j] += dy_row[j] * x_norm;
+        }
+        if (db) {
+          db[j] += dy_row[j];
+        }
+      }
+      if (dx) {
+        const T mean_dy = sum_dy / cols;
+        const T mean_dy_x_norm = sum_dy_x_norm / cols;
+        T* dx_row = dx + i * cols;
+        for (int64_t j = 0; j < cols; ++j) {
+          const T x_norm = (x_row[j] - row_mean) * inv_std;
+          const T dy_scaled = scale ? dy_row[j] * scale[j] : dy_row[j];
+          dx_row[j] =
+              (dy_scaled - mean_dy - x_norm * mean_dy_x_norm) * inv_std;
+        }
+      }
+    }
+  });
+
+  auto add_partials = [&](const std::vector<T>& partial, T* sum) {
+    std::copy(partial.begin(), partial.begin() + cols, sum);
+    for (int b = 1; b < blocks; ++b) {
+      for (int64_t j = 0; j < cols; ++j) {
+        sum[j] += partial[b * cols + j];
+      }
+    }
+  };
+  if (dscale) {
+    add_partials(dscale_partial, dscale);
+  }
+  if (dbias) {
+    add_partials(dbias_partial, dbias);
+  }
+}
+
+// The layer norm of the rows of x + bias + alpha * residual, in one pass over
+// every row: the sum is written to residual_out, normalized while the row is
+// in cache, scaled by norm_weight, shifted by norm_bias, and stored to out
+// through convert(value). The mean and variance of every row are written to
+// mean and var. Any of bias, residual, norm_weight and norm_bias may be
+// nullptr, and residual_out may be nullptr without a residual.
+template <typename T, typename OutT, typename Convert>
+void ResidualAddLayerNormRows(const T* x,
+                              const T* bias,
+                              const T* residual,
+                              float alpha,
+                              const float* norm_weight,
+                              const float* norm_bias,
+                              float epsilon,
+                              int64_t rows,
+                              int64_t cols,
+                              T* residual_out,
+                              OutT* out,
+                              float* mean,
+                              float* var,
+                              const Convert& convert) {
+  const T alpha_ = static_cast<T>(alpha);
+  const int blocks = LayerNormRowBlocks(rows, cols);
+  ForEachRowBlock(rows, blocks, [&](int, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const T* src = x + i * cols;
+      if (residual) {
+        const T* residual_row = residual + i * cols;
+        T* sum_row = residual_out + i * cols;
+        for (int64_t j = 0; j < cols; ++j) {
+          T value = src[j] + alpha_ * residual_row[j];
+          sum_row[j] = bias ? value + bias[j] : value;
+        }
+        src = sum_row;
+      }
+      float sum = 0;
+      for (int64_t j = 0; j < cols; ++j) {
+        sum += static_cast<float>(src[j]);
+      }
+      const float row_mean = sum / cols;
+      float square_sum = 0;
+      for (int64_t j = 0; j < cols; ++j) {
+        const float diff = static_cast<float>(src[j]) - row_mean;
+        square_sum += diff * diff;
+      }
+      const float row_var = square_sum / cols;
+      const float inv_std = 1.0f / sqrtf(row_var + epsilon);
+      OutT* out_row = out + i * cols;
+      for (int64_t j = 0; j < cols; ++j) {
+        float value = (static_cast<float>(src[j]) - row_mean) * inv_std;
+        if (norm_weight) {
+          value *= norm_weight[j];
+        }
+        if (norm_bias) {
+          value += norm_bias[j];
+        }
+        out_row[j] = convert(value);
+      }
+      mean[i] = row_mean;
+      var[i] = row_var;
+    }
+  });
+}
+
+}  // namespace funcs
+}  // namespace phi
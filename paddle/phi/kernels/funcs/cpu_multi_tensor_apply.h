@@ -0,0 +1,134 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/macros.h"
+#include "paddle/phi/kernels/funcs/cpu_parallel.h"
+#include "paddle/phi/kernels/funcs/for_range.h"
+
+namespace phi {
+namespace funcs {
+
+// The default number of elements of a chunk, which is large enough for the
+// cost of a work item to be negligible and small enough to balance the
+// threads on a model of a few million elements.
+constexpr int64_t kCPUMultiTensorChunkSize = 16384;
+
+// The elements [begin, end) of the tensor of index tensor_id.
+struct TensorChunk {
+  size_t tensor_id;
+  int64_t begin;
+  int64_t end;
+};
+
+// The chunks of a list of tensors, packed into work items of about
+// chunk_size elements: a large tensor is split into chunks of chunk_size
+// elements, and the small tensors of a model share a work item, so that the
+// work items are balanced however the sizes of the tensors are spread.
+class TensorChunks {
+ public:
+  TensorChunks(const std::vector<int64_t>& numels, int64_t chunk_size) {
+    int64_t item_numel = 0;
+    item_offsets_.push_back(0);
+    for (size_t t = 0; t < numels.size(); ++t) {
+      for (int64_t begin = 0; begin < numels[t]; begin += chunk_size) {
+        int64_t end = std::min(begin + chunk_size, numels[t]);
+        chunks_.push_back({t, begin, end});
+        item_numel += end - begin;
+        if (item_numel >= chunk_size) {
+          item_offsets_.push_back(chunks_.size());
+          item_numel = 0;
+        }
+      }
+      numel_ += numels[t];
+    }
+    if (item_offsets_.back() != chunks_.size()) {
+      item_offsets_.push_back(chunks_.size());
+    }
+  }
+
+  int64_t numel() const { return numel_; }
+  int64_t items() const {
+    return static_cast<int64_t>(item_offsets_.size()) - 1;
+  }
+  const TensorChunk* item_begin(int64_t i) const {
+    return chunks_.data() + item_offsets_[i];
+  }
+  const TensorChunk* item_end(int64_t i) const {
+    return chunks_.data() + item_offsets_[i + 1];
+  }
+
+ private:
+  std::vector<TensorChunk> chunks_;
+  std::vector<size_t> item_offsets_;
+  int64_t numel_{0};
+};
+
+// The CPU counterpart of the CUDA multi tensor apply: calls
+// functor(tensor_id, begin, end) for every chunk of the tensors of numels
+// elements, with the work items run by the OpenMP threads. The functor must
+// only write the elements [begin, end) of the tensor.
+template <typename Functor>
+void CPUMultiTensorApply(const std::vector<int64_t>& numels,
+                         int64_t chunk_size,
+                         const Functor& functor) {
+  TensorChunks chunks(numels, chunk_size);
+  const int64_t items = chunks.items();
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+  const int threads = CPUParallelThreads(
+      chunks.numel(), /*min_work_per_thread=*/16384, items);
+#pragma omp parallel for num_threads(threads) schedule(dynamic)
+#endif
+  for (int64_t i = 0; i < items; ++i) {
+    for (auto* chunk = chunks.item_begin(i); chunk != chunks.item_end(i);
+         ++chunk) {
+      functor(chunk->tensor_id, chunk->begin, chunk->end);
+    }
+  }
+}
+
+// ForRange, except that on CPU the range is split into chunks run by the
+// threads of CPUMultiTensorApply. func(i) must only write the elements of
+// index i.
+template <typename Context>
+struct ChunkedForRange : public ForRange<Context> {
+  using ForRange<Context>::ForRange;
+};
+
+template <>
+struct ChunkedForRange<phi::CPUContext> {
+  ChunkedForRange(const phi::CPUContext& dev_ctx UNUSED, size_t limit)
+      : limit_(limit) {}
+
+  template <typename Function>
+  void operator()(Function func) const {
+    CPUMultiTensorApply({static_cast<int64_t>(limit_)},
+                        kCPUMultiTensorChunkSize,
+                        [&](size_t, int64_t begin, int64_t end) {
+                          for (int64_t i = begin; i < end; ++i) {
+                            func(static_cast<size_t>(i));
+                          }
+                        });
+  }
+
+  size_t limit_;
+};
+
+}  // namespace funcs
+}  // namespace phi
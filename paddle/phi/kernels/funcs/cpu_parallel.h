@@ -0,0 +1,48 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#include <omp.h>
+#endif
+
+namespace phi {
+namespace funcs {
+
+// The number of OpenMP threads for a parallel loop over work units of work,
+// split into at most tasks tasks. A thread below min_work_per_thread units
+// costs more than it saves, so every thread gets at least that much work.
+// Returns 1 without OpenMP.
+inline int CPUParallelThreads(
+    int64_t work,
+    int64_t min_work_per_thread,
+    int64_t tasks = std::numeric_limits<int64_t>::max()) {
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+  return static_cast<int>(std::max<int64_t>(
+      1,
+      std::min<int64_t>({static_cast<int64_t>(omp_get_max_threads()),
+                         work / min_work_per_thread,
+                         tasks})));
+#else
+  return 1;
+#endif
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,336 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/cpu_parallel.h"
+
+namespace phi {
+namespace funcs {
+
+// The dims of a copy from src to dst with the strides of both in elements,
+// in the order of the dims of dst.
+struct StridedCopyDims {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> src_strides;
+  std::vector<int64_t> dst_strides;
+
+  int rank() const { return static_cast<int>(dims.size()); }
+};
+
+// Drops the dims of size 1 and merges every dim into the next one when it
+// is contiguous with it in both src and dst, e.g. the permute of NCHW to
+// NHWC becomes the transpose of [N, HW, C] from [N, C, HW].
+inline StridedCopyDims SimplifyStridedCopyDims(
+    const std::vector<int64_t>& dims,
+    const std::vector<int64_t>& src_strides,
+    const std::vector<int64_t>& dst_strides) {
+  StridedCopyDims out;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (dims[i] == 1) {
+      continue;
+    }
+    if (!out.dims.empty() &&
+        out.src_strides.back() == src_strides[i] * dims[i] &&
+        out.dst_strides.back() == dst_strides[i] * dims[i]) {
+      out.dims.back() *= dims[i];
+      out.src_strides.back() = src_strides[i];
+      out.dst_strides.back() = dst_strides[i];
+      continue;
+    }
+    out.dims.push_back(dims[i]);
+    out.src_strides.push_back(src_strides[i]);
+    out.dst_strides.push_back(dst_strides[i]);
+  }
+  return out;
+}
+
+// The strides in elements of a contiguous tensor of dims.
+inline std::vector<int64_t> ContiguousStrides(
+    const std::vector<int64_t>& dims) {
+  std::vector<int64_t> strides(dims.size());
+  int64_t stride = 1;
+  for (int i = static_cast<int>(dims.size()) - 1; i >= 0; --i) {
+    strides[i] = stride;
+    stride *= dims[i];
+  }
+  return strides;
+}
+
+// Copies the tile of rows x cols elements of a transpose, which reads the
+// rows of src with a stride of src_stride and writes the columns of dst with
+// a stride of dst_stride, i.e. dst[i * dst_stride + j] =
+// src[i + j * src_stride] for i < rows and j < cols.
+template <typename T, typename Enable = void>
+struct TransposeTile {
+  static void Copy(const T* src,
+                   int64_t src_stride,
+                   T* dst,
+                   int64_t dst_stride,
+                   int64_t rows,
+                   int64_t cols) {
+    for (int64_t i = 0; i < rows; ++i) {
+      for (int64_t j = 0; j < cols; ++j) {
+        dst[i * dst_stride + j] = src[i + j * src_stride];
+      }
+    }
+  }
+};
+
+#ifdef __AVX__
+// The types of 4 bytes are transposed by blocks of 8 x 8 elements in the
+// ymm registers, whatever their type is, since only their bits are moved.
+template <typename T>
+struct TransposeTile<
+    T,
+    typename std::enable_if<sizeof(T) == 4 &&
+                            std::is_trivially_copyable<T>::value>::type> {
+  static void Copy(const T* src,
+                   int64_t src_stride,
+                   T* dst,
+                   int64_t dst_stride,
+                   int64_t rows,
+                   int64_t cols) {
+    const float* s = reinterpret_cast<const float*>(src);
+    float* d = reinterpret_cast<float*>(dst);
+    int64_t i = 0;
+    for (; i + 8 <= rows; i += 8) {
+      int64_t j = 0;
+      for (; j + 8 <= cols; j += 8) {
+        Transpose8x8(s + i + j * src_stride,
+                     src_stride,
+                     d + i * dst_stride + j,
+                     dst_stride);
+      }
+      for (; j < cols; ++j) {
+        for (int64_t k = i; k < i + 8; ++k) {
+          d[k * dst_stride + j] = s[k + j * src_stride];
+        }
+      }
+    }
+    for (; i < rows; ++i) {
+      for (int64_t j = 0; j < cols; ++j) {
+        d[i * dst_stride + j] = s[i + j * src_stride];
+      }
+    }
+  }
+
+ private:
+  // dst[i * dst_stride + j] = src[i + j * src_stride] for i, j < 8
+  static void Transpose8x8(const float* src,
+                           int64_t src_stride,
+                           float* dst,
+                           int64_t dst_stride) {
+    __m256 r0 = _mm256_loadu_ps(src);
+    __m256 r1 = _mm256_loadu_ps(src + src_stride);
+    __m256 r2 = _mm256_loadu_ps(src + 2 * src_stride);
+    __m256 r3 = _mm256_loadu_ps(src + 3 * src_stride);
+    __m256 r4 = _mm256_loadu_ps(src + 4 * src_stride);
+    __m256 r5 = _mm256_loadu_ps(src + 5 * src_stride);
+    __m256 r6 = _mm256_loadu_ps(src + 6 * src_stride);
+    __m256 r7 = _mm256_loadu_ps(src + 7 * src_stride);
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+    r0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    r1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    r2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    r3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    r4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    r5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    r6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    r7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps(dst + dst_stride, _mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps(dst + 2 * dst_stride,
+                     _mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps(dst + 3 * dst_stride,
+                     _mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps(dst + 4 * dst_stride,
+                     _mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps(dst + 5 * dst_stride,
+                     _mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps(dst + 6 * dst_stride,
+                     _mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps(dst + 7 * dst_stride,
+                     _mm256_permute2f128_ps(r3, r7, 0x31));
+  }
+};
+#endif
+
+// Whether no two elements of the dims of copy are written to the same
+// element of dst, i.e. with the dims sorted by their stride in dst, every
+// stride is at least the extent of the dims of smaller strides.
+inline bool DstDoesNotOverlap(const StridedCopyDims& copy) {
+  std::vector<int> order(copy.rank());
+  for (int i = 0; i < copy.rank(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return copy.dst_strides[a] < copy.dst_strides[b];
+  });
+  int64_t extent = 1;
+  for (int i : order) {
+    if (copy.dst_strides[i] < extent) {
+      return false;
+    }
+    extent = copy.dst_strides[i] * copy.dims[i];
+  }
+  return true;
+}
+
+// Moves the dim i of copy to the innermost position.
+inline void MoveDimInnermost(int i, StridedCopyDims* copy) {
+  for (auto* v : {&copy->dims, &copy->src_strides, &copy->dst_strides}) {
+    std::rotate(v->begin() + i, v->begin() + i + 1, v->end());
+  }
+}
+
+// The offsets in src and dst of the index of the outer dims [0, rank).
+inline std::pair<int64_t, int64_t> OuterOffsets(const StridedCopyDims& copy,
+                                                int rank,
+                                                int64_t index) {
+  int64_t src_offset = 0;
+  int64_t dst_offset = 0;
+  for (int i = rank - 1; i >= 0; --i) {
+    int64_t k = index % copy.dims[i];
+    index /= copy.dims[i];
+    src_offset += k * copy.src_strides[i];
+    dst_offset += k * copy.dst_strides[i];
+  }
+  return {src_offset, dst_offset};
+}
+
+// Copies the elements of dims from src to dst with the strides of both, for
+// transpose, contiguous and strided_copy. After the dims are simplified, the
+// copy of the inner dims is picked:
+// - a copy of contiguous rows when the innermost dim is contiguous in both;
+// - a transpose by tiles of the dim contiguous in src and the dim contiguous
+//   in dst, with the tiles of 4 byte types transposed in registers;
+// - a loop with the strides otherwise, which writes dst contiguously when a
+//   dim of dst is contiguous.
+// The outer dims are split among the threads. When dst overlaps itself, the
+// elements are copied by a single thread in the order of the dims instead,
+// without reordering the dims nor tiling, so the last write wins as in a
+// serial loop.
+template <typename T>
+void CPUStridedCopy(const T* src,
+                    T* dst,
+                    const std::vector<int64_t>& dims,
+                    const std::vector<int64_t>& src_strides,
+                    const std::vector<int64_t>& dst_strides) {
+  StridedCopyDims copy =
+      SimplifyStridedCopyDims(dims, src_strides, dst_strides);
+  if (copy.rank() == 0) {
+    dst[0] = src[0];
+    return;
+  }
+  int64_t numel = 1;
+  for (int i = 0; i < copy.rank(); ++i) {
+    numel *= copy.dims[i];
+  }
+  if (numel == 0) {
+    return;
+  }
+  const bool dst_overlaps = !DstDoesNotOverlap(copy);
+
+  // the order of the dims is free unless dst overlaps itself
+  if (!dst_overlaps) {
+    auto find_unit_stride = [&](const std::vector<int64_t>& strides) {
+      for (int i = copy.rank() - 1; i >= 0; --i) {
+        if (strides[i] == 1) {
+          return i;
+        }
+      }
+      return -1;
+    };
+    int dst_unit = find_unit_stride(copy.dst_strides);
+    if (dst_unit >= 0) {
+      MoveDimInnermost(dst_unit, &copy);
+      int src_unit = find_unit_stride(copy.src_strides);
+      if (src_unit >= 0 && src_unit < copy.rank() - 1) {
+        MoveDimInnermost(src_unit, &copy);
+        MoveDimInnermost(copy.rank() - 2, &copy);
+      }
+    }
+  }
+
+  const int inner = copy.rank() - 1;
+  const bool rows_copy =
+      copy.src_strides[inner] == 1 && copy.dst_strides[inner] == 1;
+  const bool tiled = !dst_overlaps && !rows_copy && copy.rank() >= 2 &&
+                     copy.dst_strides[inner] == 1 &&
+                     copy.src_strides[inner - 1] == 1;
+
+  // a tile of about 128 bytes by 128 bytes stays in the L1 cache
+  const int64_t tile = std::max<int64_t>(8, 128 / sizeof(T));
+  const int outer_rank = tiled ? inner - 1 : inner;
+  int64_t outer = 1;
+  for (int i = 0; i < outer_rank; ++i) {
+    outer *= copy.dims[i];
+  }
+  const int64_t rows = tiled ? copy.dims[inner - 1] : 1;
+  const int64_t row_tiles = (rows + tile - 1) / tile;
+  const int64_t items = outer * row_tiles;
+
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+  const int threads =
+      dst_overlaps ? 1
+                   : CPUParallelThreads(
+                         numel, /*min_work_per_thread=*/16384, items);
+#pragma omp parallel for num_threads(threads)
+#endif
+  for (int64_t item = 0; item < items; ++item) {
+    auto offsets = OuterOffsets(copy, outer_rank, item / row_tiles);
+    const T* src_item = src + offsets.first;
+    T* dst_item = dst + offsets.second;
+    const int64_t cols = copy.dims[inner];
+    if (rows_copy) {
+      std::copy(src_item, src_item + cols, dst_item);
+    } else if (tiled) {
+      const int64_t row_begin = item % row_tiles * tile;
+      const int64_t row_end = std::min(row_begin + tile, rows);
+      const int64_t src_stride = copy.src_strides[inner];
+      const int64_t dst_stride = copy.dst_strides[inner - 1];
+      for (int64_t col = 0; col < cols; col += tile) {
+        TransposeTile<T>::Copy(src_item + row_begin + col * src_stride,
+                               src_stride,
+                               dst_item + row_begin * dst_stride + col,
+                               dst_stride,
+                               row_end - row_begin,
+                               std::min(tile, cols - col));
+      }
+    } else {
+      const int64_t src_stride = copy.src_strides[inner];
+      const int64_t dst_stride = copy.dst_strides[inner];
+      for (int64_t j = 0; j < cols; ++j) {
+        dst_item[j * dst_stride] = src_item[j * src_stride];
+      }
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
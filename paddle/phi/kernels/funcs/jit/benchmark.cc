@@ -12,6 +12,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License. */
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <random>
 
@@ -22,6 +24,7 @@
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
 #include "paddle/utils/flags.h"
+#include "unsupported/Eigen/CXX11/Tensor"
 
 PD_DEFINE_int32(burning, 10, "Burning times.");
 PD_DEFINE_int32(repeat, 3000, "Repeat times.");
@@ -108,8 +111,13 @@ struct BenchFunc {
 
 namespace jit = phi::jit;
 
+// Besides the kernels, extra_infos holds the time of other implementations,
+// such as the Eigen code the phi kernels run without the jit kernels.
 template <typename KernelTuple, typename PlaceType, typename... Args>
-void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
+void BenchAllImplsWith(
+    const typename KernelTuple::attr_type& attr,
+    const std::vector<std::pair<std::string, double>>& extra_infos,
+    Args... args) {
   BenchFunc<KernelTuple, Args...> benchmark;
   std::vector<std::pair<std::string, double>> infos;
   auto funcs = jit::GetAllCandidateFuncsWithTypes<KernelTuple, PlaceType>(attr);
@@ -123,6 +131,7 @@ void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
     PADDLE_THROW(phi::errors::Fatal("Benchmark target can not be empty."));
   }
   infos.push_back(std::make_pair("Target", benchmark(tgt, args...)));
+  infos.insert(infos.end(), extra_infos.begin(), extra_infos.end());
 
   // print
   std::ostringstream loginfos;
@@ -134,6 +143,94 @@ void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
   LOG(INFO) << loginfos.str();
 }
 
+template <typename KernelTuple, typename PlaceType, typename... Args>
+void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
+  BenchAllImplsWith<KernelTuple, PlaceType>(attr, {}, args...);
+}
+
+// return the avg time of func as BenchFunc does
+template <typename Func>
+double BenchEigen(Func func) {
+  for (int i = 0; i < FLAGS_burning; ++i) {
+    func();
+  }
+  double start = static_cast<double>(phi::PosixInNsec()) * 1e-3;
+  for (int i = 0; i < FLAGS_repeat; ++i) {
+    func();
+  }
+  double end = static_cast<double>(phi::PosixInNsec()) * 1e-3;
+  return static_cast<double>(end - start) / FLAGS_repeat;
+}
+
+template <typename T>
+using EigenRows =
+    Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor, Eigen::DenseIndex>>;
+template <typename T>
+using EigenVec =
+    Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor, Eigen::DenseIndex>>;
+
+// The Eigen expressions of the gelu and softmax phi kernels and the RMSNorm
+// the CPU kernels would otherwise write.
+template <typename T>
+void EigenGelu(const T* x, T* y, int n, bool approximate) {
+  EigenVec<const T> in(x, n);
+  EigenVec<T> out(y, n);
+  if (approximate) {
+    auto tmp = (static_cast<T>(GELU_TANH_SCALE) *
+                (in + static_cast<T>(GELU_TANH_CUBIC) * in.cube()))
+                   .tanh();
+    out = in * static_cast<T>(0.5) * (static_cast<T>(1) + tmp);
+  } else {
+    auto tmp = (in * static_cast<T>(M_SQRT1_2)).erf();
+    out = in * static_cast<T>(0.5) * (static_cast<T>(1) + tmp);
+  }
+}
+
+template <typename T>
+void EigenSoftmax(const T* x, T* y, int n, int bs) {
+  EigenRows<const T> in(x, bs, n);
+  EigenRows<T> out(y, bs, n);
+  Eigen::DSizes<int, 1> along_class(1);
+  Eigen::DSizes<int, 2> batch_by_one(bs, 1);
+  Eigen::DSizes<int, 2> one_by_class(1, n);
+  out = (in - in.maximum(along_class)
+                  .eval()
+                  .reshape(batch_by_one)
+                  .broadcast(one_by_class))
+            .exp();
+  out = out * out.sum(along_class)
+                  .inverse()
+                  .eval()
+                  .reshape(batch_by_one)
+                  .broadcast(one_by_class);
+}
+
+template <typename T>
+void EigenRMSNorm(const T* x,
+                  T* y,
+                  const T* scale,
+                  const T* bias,
+                  int height,
+                  float epsilon,
+                  int right) {
+  EigenRows<const T> in(x, height, right);
+  EigenRows<T> out(y, height, right);
+  Eigen::DSizes<int, 1> along_class(1);
+  Eigen::DSizes<int, 2> batch_by_one(height, 1);
+  Eigen::DSizes<int, 2> one_by_class(1, right);
+  auto rstd = (in.square().mean(along_class) + static_cast<T>(epsilon))
+                  .rsqrt()
+                  .eval()
+                  .reshape(batch_by_one)
+                  .broadcast(one_by_class);
+  Eigen::DSizes<int, 2> batch_by_one_row(height, 1);
+  auto scale_rows =
+      EigenRows<const T>(scale, 1, right).broadcast(batch_by_one_row);
+  auto bias_rows =
+      EigenRows<const T>(bias, 1, right).broadcast(batch_by_one_row);
+  out = in * rstd * scale_rows + bias_rows;
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelXYZN() {
   using T = typename KernelTuple::data_type;
@@ -185,6 +282,128 @@ void BenchKernelXYN() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelXRN() {
+  using T = typename KernelTuple::data_type;
+  for (int d : TestSizes()) {
+    phi::DenseTensor x;
+    x.Resize({d});
+    T* x_data = x.mutable_data<T>(PlaceType());
+    RandomVec<T>(d, x_data);
+    T res;
+    BenchAllImpls<KernelTuple, PlaceType>(d, x.data<T>(), &res, d);
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelGelu(bool approximate) {
+  using T = typename KernelTuple::data_type;
+  for (int d : TestSizes()) {
+    phi::DenseTensor x, y;
+    x.Resize({d});
+    y.Resize({d});
+    T* x_data = x.mutable_data<T>(PlaceType());
+    T* y_data = y.mutable_data<T>(PlaceType());
+    RandomVec<T>(d, x_data, -4.f, 4.f);
+    double eigen =
+        BenchEigen([&] { EigenGelu(x_data, y_data, d, approximate); });
+    BenchAllImplsWith<KernelTuple, PlaceType>(
+        d, {{"Eigen", eigen}}, x.data<T>(), y_data, d);
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelVGelu() {
+  BenchKernelGelu<KernelTuple, PlaceType>(false);
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelVGeluTanh() {
+  BenchKernelGelu<KernelTuple, PlaceType>(true);
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelSoftmax() {
+  using T = typename KernelTuple::data_type;
+  for (int bs : {1, 32}) {
+    for (int n : TestSizes()) {
+      phi::DenseTensor x, y;
+      x.Resize({bs, n});
+      y.Resize({bs, n});
+      RandomVec<T>(bs * n, x.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      const T* x_data = x.data<T>();
+      T* y_data = y.mutable_data<T>(PlaceType());
+      double eigen = BenchEigen([&] { EigenSoftmax(x_data, y_data, n, bs); });
+      BenchAllImplsWith<KernelTuple, PlaceType>(
+          n, {{"Eigen", eigen}}, x_data, y_data, n, bs);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelRMSNorm() {
+  using T = typename KernelTuple::data_type;
+  const float epsilon = 1e-6f;
+  for (int height : {1, 32}) {
+    for (int right : TestSizes()) {
+      phi::DenseTensor x, scale, bias, out;
+      x.Resize({height, right});
+      out.Resize({height, right});
+      scale.Resize({right});
+      bias.Resize({right});
+      RandomVec<T>(height * right, x.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      RandomVec<T>(right, scale.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      RandomVec<T>(right, bias.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      const T* x_data = x.data<T>();
+      const T* scale_data = scale.data<T>();
+      const T* bias_data = bias.data<T>();
+      T* out_data = out.mutable_data<T>(PlaceType());
+      double eigen = BenchEigen([&] {
+        EigenRMSNorm(
+            x_data, out_data, scale_data, bias_data, height, epsilon, right);
+      });
+      BenchAllImplsWith<KernelTuple, PlaceType>(right,
+                                                {{"Eigen", eigen}},
+                                                x_data,
+                                                out_data,
+                                                scale_data,
+                                                bias_data,
+                                                height,
+                                                epsilon,
+                                                right);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelVBiasAct() {
+  using T = typename KernelTuple::data_type;
+  for (int h : {1, 32}) {
+    for (int w : TestSizes()) {
+      const jit::bias_act_attr_t attr(w, jit::kVGelu);
+      phi::DenseTensor x, bias, y;
+      x.Resize({h, w});
+      bias.Resize({w});
+      y.Resize({h, w});
+      RandomVec<T>(h * w, x.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      RandomVec<T>(w, bias.mutable_data<T>(PlaceType()), -2.f, 2.f);
+      const T* x_data = x.data<T>();
+      const T* bias_data = bias.data<T>();
+      T* y_data = y.mutable_data<T>(PlaceType());
+      // the elementwise add and the gelu kernels with a tensor between them
+      double eigen = BenchEigen([&] {
+        Eigen::DSizes<int, 2> batch_by_one(h, 1);
+        EigenRows<T>(y_data, h, w) =
+            EigenRows<const T>(x_data, h, w) +
+            EigenRows<const T>(bias_data, 1, w).broadcast(batch_by_one);
+        EigenGelu<T>(y_data, y_data, h * w, false);
+      });
+      BenchAllImplsWith<KernelTuple, PlaceType>(
+          attr, {{"Eigen", eigen}}, x_data, bias_data, y_data, h, &attr);
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelLSTM() {
   using T = typename KernelTuple::data_type;
@@ -379,6 +598,93 @@ void BenchKernelMatMul() {
   }
 }
 
+using bfloat16 = phi::dtype::bfloat16;
+
+void RandomBF16Vec(const int n, bfloat16* a) {
+  std::vector<float> f(n);
+  RandomVec<float>(n, f.data(), -2.f, 2.f);
+  std::copy(f.begin(), f.end(), a);
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelBF16XYZN() {
+  for (int d : TestSizes()) {
+    phi::DenseTensor x, y, z;
+    x.Resize({d});
+    y.Resize({d});
+    z.Resize({d});
+    RandomBF16Vec(d, x.mutable_data<bfloat16>(PlaceType()));
+    RandomBF16Vec(d, y.mutable_data<bfloat16>(PlaceType()));
+    BenchAllImpls<KernelTuple, PlaceType>(d,
+                                          x.data<bfloat16>(),
+                                          y.data<bfloat16>(),
+                                          z.mutable_data<bfloat16>(PlaceType()),
+                                          d);
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelBF16XYN() {
+  for (int d : TestSizes()) {
+    phi::DenseTensor x, y;
+    x.Resize({d});
+    y.Resize({d});
+    RandomBF16Vec(d, x.mutable_data<bfloat16>(PlaceType()));
+    BenchAllImpls<KernelTuple, PlaceType>(
+        d, x.data<bfloat16>(), y.mutable_data<bfloat16>(PlaceType()), d);
+  }
+}
+
+// The jitcode of bfloat16 and int8 matmul only supports m == 1 and n
+// divisible by 16.
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelBF16MatMul() {
+  for (int n = 16; n <= FLAGS_max_size; n += 16) {
+    for (int k : TestSizes()) {
+      phi::DenseTensor a, b, c;
+      a.Resize({k});
+      b.Resize({k * n});
+      c.Resize({n});
+      RandomBF16Vec(k, a.mutable_data<bfloat16>(PlaceType()));
+      RandomBF16Vec(k * n, b.mutable_data<bfloat16>(PlaceType()));
+      const jit::matmul_attr_t attr{1, n, k};
+      BenchAllImpls<KernelTuple, PlaceType>(
+          attr,
+          a.data<bfloat16>(),
+          b.data<bfloat16>(),
+          c.mutable_data<bfloat16>(PlaceType()),
+          &attr);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void BenchKernelMatMulInt8() {
+  std::mt19937 rng(100);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  for (int n = 16; n <= FLAGS_max_size; n += 16) {
+    for (int k = 4; k <= FLAGS_max_size; k += 4) {
+      std::vector<uint8_t> a(k);
+      std::vector<int8_t> b(k * n), packed(k * n);
+      std::vector<int32_t> c(n);
+      for (auto& i : a) {
+        i = static_cast<uint8_t>(dist(rng) + 128);
+      }
+      for (auto& i : b) {
+        i = static_cast<int8_t>(dist(rng));
+      }
+      jit::pack_int8_weights(b.data(), packed.data(), n, k);
+      const jit::matmul_attr_t attr{1, n, k};
+      BenchAllImpls<KernelTuple, PlaceType>(
+          attr,
+          static_cast<const uint8_t*>(a.data()),
+          static_cast<const int8_t*>(packed.data()),
+          c.data(),
+          &attr);
+    }
+  }
+}
+
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelLayerNorm() {
   using T = typename KernelTuple::data_type;
@@ -487,6 +793,9 @@ void BenchKernelVBroadcast() {
 #define BenchKernelVTanh BenchKernelXYN
 #define BenchKernelVCopy BenchKernelXYN
 
+#define BenchKernelHMax BenchKernelXRN
+#define BenchKernelHSum BenchKernelXRN
+
 #define BenchKernelLSTMCtHt BenchKernelLSTM
 #define BenchKernelLSTMC1H1 BenchKernelLSTM
 
@@ -519,6 +828,12 @@ BENCH_FP32_CPU(VExp);
 BENCH_FP32_CPU(VSigmoid);
 BENCH_FP32_CPU(VTanh);
 BENCH_FP32_CPU(VCopy);
+BENCH_FP32_CPU(VGelu);
+BENCH_FP32_CPU(VGeluTanh);
+
+// xrn
+BENCH_FP32_CPU(HMax);
+BENCH_FP32_CPU(HSum);
 
 // LSTM
 BENCH_FP32_CPU(LSTMCtHt);
@@ -530,6 +845,9 @@ BENCH_FP32_CPU(GRUHtPart1);
 BENCH_FP32_CPU(GRUHtPart2);
 
 BENCH_FP32_CPU(LayerNorm);
+BENCH_FP32_CPU(RMSNorm);
+BENCH_FP32_CPU(Softmax);
+BENCH_FP32_CPU(VBiasAct);
 BENCH_FP32_CPU(CRFDecoding);
 
 BENCH_FP32_CPU(SeqPool);
@@ -538,6 +856,21 @@ BENCH_FP32_CPU(MatMul);
 BENCH_FP32_CPU(Sgd);
 BENCH_FP32_CPU(VBroadcast);
 
+#define BENCH_BF16_CPU(name, bench)                             \
+  BENCH_JITKERNEL(name, BF16, CPU) {                            \
+    BenchKernel##bench<jit::name##Tuple<bfloat16>, CPUPlace>(); \
+  }
+
+BENCH_BF16_CPU(VMul, BF16XYZN);
+BENCH_BF16_CPU(VAdd, BF16XYZN);
+BENCH_BF16_CPU(VRelu, BF16XYN);
+BENCH_BF16_CPU(VGelu, BF16XYN);
+BENCH_BF16_CPU(MatMul, BF16MatMul);
+
+BENCH_JITKERNEL(MatMulInt8, INT8, CPU) {
+  BenchKernelMatMulInt8<jit::MatMulInt8Tuple<int8_t>, CPUPlace>();
+}
+
 // Benchmark all jit kernels including jitcode, mkl and refer.
 // To use this tool, run command: ./benchmark [options...]
 // Options:
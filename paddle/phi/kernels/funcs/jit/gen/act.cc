@@ -14,8 +14,10 @@
 
 #include "paddle/phi/kernels/funcs/jit/gen/act.h"
 #include <array>
+#include <cmath>
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
 namespace phi {
@@ -41,6 +43,19 @@ const float ALIGN32_BEG exp_float_consts[] ALIGN32_END = {  // NOLINT
     REPEAT_8TIMES(SIGMOID_THRESHOLD_MAX),
     REPEAT_8TIMES(SIGMOID_THRESHOLD_MIN)};
 
+const float ALIGN32_BEG gelu_float_consts[] ALIGN32_END = {  // NOLINT
+    REPEAT_8TIMES(1.f),
+    REPEAT_8TIMES(0.5f),
+    REPEAT_8TIMES(static_cast<float>(M_SQRT1_2)),
+    REPEAT_8TIMES(static_cast<float>(GELU_ERF_P)),
+    REPEAT_8TIMES(static_cast<float>(GELU_ERF_A1)),
+    REPEAT_8TIMES(static_cast<float>(GELU_ERF_A2)),
+    REPEAT_8TIMES(static_cast<float>(GELU_ERF_A3)),
+    REPEAT_8TIMES(static_cast<float>(GELU_ERF_A4)),
+    REPEAT_8TIMES(static_cast<float>(GELU_ERF_A5)),
+    REPEAT_8TIMES(static_cast<float>(GELU_TANH_CUBIC)),
+    REPEAT_8TIMES(static_cast<float>(2 * GELU_TANH_SCALE))};
+
 const int ALIGN32_BEG exp_int_0x7f[] ALIGN32_END = {  // NOLINT
     REPEAT_8TIMES(0x7f)};                             // NOLINT
 int ALIGN32_BEG g_tmp_mem[16] ALIGN32_END = {0};      // NOLINT
@@ -80,6 +95,36 @@ void VActJitCode::genCode() {
   ret();
 }
 
+void VActBF16JitCode::genCode() {
+  init_bf16_consts(ymm_one, ymm_round);
+  int offset = 0;
+  for (int i = 0; i < num_ / YMM_FLOAT_BLOCK; ++i) {
+    load_bf16(ymm_src, ptr[param1 + offset]);
+    act<ymm_t>(ymm_dst, ymm_src, type_);
+    store_bf16(ptr[param2 + offset],
+               ymm_dst,
+               xmm_half,
+               ymm_tmp,
+               ymm_one,
+               ymm_round);
+    offset += sizeof(int16_t) * YMM_FLOAT_BLOCK;
+  }
+  int rest = num_ % YMM_FLOAT_BLOCK;
+  if (rest > 0) {
+    set_tail_mask(k_tail, rest);
+    load_bf16(ymm_src, ptr[param1 + offset], k_tail);
+    act<ymm_t>(ymm_dst, ymm_src, type_);
+    store_bf16(ptr[param2 + offset],
+               ymm_dst,
+               xmm_half,
+               ymm_tmp,
+               ymm_one,
+               ymm_round,
+               k_tail);
+  }
+  ret();
+}
+
 #define DECLARE_ACT_CREATOR(name)                                            \
   class name##Creator : public JitCodeCreator<int> {                         \
    public:                                                                   \
@@ -96,6 +141,8 @@ DECLARE_ACT_CREATOR(VIdentity);
 DECLARE_ACT_CREATOR(VExp);
 DECLARE_ACT_CREATOR(VSigmoid);
 DECLARE_ACT_CREATOR(VTanh);
+DECLARE_ACT_CREATOR(VGelu);
+DECLARE_ACT_CREATOR(VGeluTanh);
 
 // TODO(TJ): tuning use me
 bool VReluCreator::CanBeUsed(const int& d) const {
@@ -122,6 +169,14 @@ bool VTanhCreator::CanBeUsed(const int& d) const {
   return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
 }
 
+bool VGeluCreator::CanBeUsed(const int& d) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+}
+
+bool VGeluTanhCreator::CanBeUsed(const int& d) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+}
+
 size_t VReluCreator::CodeSize(const int& d) const {
   return 96 /* init size */ + (d / YMM_FLOAT_BLOCK + 3) * 4 /* instructions */ *
                                   8 /* average bytes for each instruction */;
@@ -147,17 +202,53 @@ size_t VTanhCreator::CodeSize(const int& d) const {
   return 96 + (d / YMM_FLOAT_BLOCK + 3) * 84 * 8;
 }
 
+size_t VGeluCreator::CodeSize(const int& d) const {
+  return 96 + (d / YMM_FLOAT_BLOCK + 3) * 104 * 8;
+}
+
+size_t VGeluTanhCreator::CodeSize(const int& d) const {
+  return 96 + (d / YMM_FLOAT_BLOCK + 3) * 94 * 8;
+}
+
 #undef DECLARE_ACT_CREATOR
 
+// The size of the float act on every block, with the conversions.
+#define DECLARE_ACT_BF16_CREATOR(name, block_size)                           \
+  class name##BF16Creator                                                    \
+      : public JitCodeCreator<int, phi::dtype::bfloat16> {                   \
+   public:                                                                   \
+    bool CanBeUsed(const int& attr) const override {                         \
+      return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_core);   \
+    }                                                                        \
+    size_t CodeSize(const int& d) const override {                           \
+      return 96 + (d / YMM_FLOAT_BLOCK + 3) * (block_size + 10) * 8;         \
+    }                                                                        \
+    std::unique_ptr<GenBase> CreateJitCode(const int& attr) const override { \
+      return make_unique<name##BF16JitCode>(attr, CodeSize(attr));           \
+    }                                                                        \
+  }
+
+DECLARE_ACT_BF16_CREATOR(VRelu, 4);
+DECLARE_ACT_BF16_CREATOR(VExp, 70);
+DECLARE_ACT_BF16_CREATOR(VSigmoid, 82);
+DECLARE_ACT_BF16_CREATOR(VTanh, 84);
+DECLARE_ACT_BF16_CREATOR(VGelu, 104);
+
+#undef DECLARE_ACT_BF16_CREATOR
+
 }  // namespace gen
 }  // namespace jit
 }  // namespace phi
 
 namespace gen = phi::jit::gen;
 
-REGISTER_JITKERNEL_GEN(kVRelu, gen::VReluCreator);
+REGISTER_JITKERNEL_GEN(kVRelu, gen::VReluCreator, gen::VReluBF16Creator);
 REGISTER_JITKERNEL_GEN(kVSquare, gen::VSquareCreator);
 REGISTER_JITKERNEL_GEN(kVIdentity, gen::VIdentityCreator);
-REGISTER_JITKERNEL_GEN(kVExp, gen::VExpCreator);
-REGISTER_JITKERNEL_GEN(kVSigmoid, gen::VSigmoidCreator);
-REGISTER_JITKERNEL_GEN(kVTanh, gen::VTanhCreator);
+REGISTER_JITKERNEL_GEN(kVExp, gen::VExpCreator, gen::VExpBF16Creator);
+REGISTER_JITKERNEL_GEN(kVSigmoid,
+                       gen::VSigmoidCreator,
+                       gen::VSigmoidBF16Creator);
+REGISTER_JITKERNEL_GEN(kVTanh, gen::VTanhCreator, gen::VTanhBF16Creator);
+REGISTER_JITKERNEL_GEN(kVGelu, gen::VGeluCreator, gen::VGeluBF16Creator);
+REGISTER_JITKERNEL_GEN(kVGeluTanh, gen::VGeluTanhCreator);
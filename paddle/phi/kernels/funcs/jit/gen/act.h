@@ -25,6 +25,7 @@ namespace jit {
 namespace gen {
 
 extern const float exp_float_consts[];
+extern const float gelu_float_consts[];
 extern const int exp_int_0x7f[];
 extern int g_tmp_mem[];
 
@@ -40,6 +41,15 @@ extern int g_tmp_mem[];
 #define CEPHES_EXP_P4 1.6666665459E-1
 #define CEPHES_EXP_P5 5.0000001201E-1
 
+// erf(z) ~= 1 - (A1 * t + ... + A5 * t^5) * e^(-z^2), t = 1 / (1 + P * z)
+// for z >= 0, with an error below 1.5e-7 (Abramowitz and Stegun, 7.1.26)
+#define GELU_ERF_P 0.3275911
+#define GELU_ERF_A1 0.254829592
+#define GELU_ERF_A2 -0.284496736
+#define GELU_ERF_A3 1.421413741
+#define GELU_ERF_A4 -1.453152027
+#define GELU_ERF_A5 1.061405429
+
 #define REPEAT_8TIMES(val) val, val, val, val, val, val, val, val
 
 #define OFFSET_EXP_ONE 0 * YMM_FLOAT_BLOCK * sizeof(float)
@@ -60,6 +70,18 @@ extern int g_tmp_mem[];
 #define OFFSET_SIGMOID_MAX 15 * YMM_FLOAT_BLOCK * sizeof(float)
 #define OFFSET_SIGMOID_MIN 16 * YMM_FLOAT_BLOCK * sizeof(float)
 
+#define OFFSET_GELU_ONE 0 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_0P5 1 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_SQRT1_2 2 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_ERF_P 3 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_ERF_A1 4 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_ERF_A2 5 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_ERF_A3 6 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_ERF_A4 7 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_ERF_A5 8 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_TANH_CUBIC 9 * YMM_FLOAT_BLOCK * sizeof(float)
+#define OFFSET_GELU_TANH_SCALE2 10 * YMM_FLOAT_BLOCK * sizeof(float)
+
 class VActFunc : public JitCode {
  public:
   explicit VActFunc(size_t code_size, void* code_ptr)
@@ -232,6 +254,95 @@ class VActFunc : public JitCode {
     pop(reg_ptr_global);
   }
 
+  // compute GELU with ymm, xmm, which uses abs_idx ~ poly_idx besides the
+  // registers of EXP
+  template <typename JMM>
+  void gelu_jmm(JMM& dst,          // NOLINT
+                JMM& src,          // NOLINT
+                int abs_idx = 6,   // NOLINT
+                int z_idx = 7,
+                int t_idx = 8,
+                int poly_idx = 9,
+                int src_idx = 11,
+                int fx_idx = 12,
+                int fy_idx = 13,
+                int mask_idx = 14,
+                int tmp_idx = 15) {
+    // y = 0.5 * x * (1 + erf(x / sqrt(2)))
+    //   = 0.5 * (x + |x| * erf(|x| / sqrt(2)))
+    JMM jmm_abs = JMM(abs_idx);
+    JMM jmm_z = JMM(z_idx);
+    JMM jmm_t = JMM(t_idx);
+    JMM jmm_poly = JMM(poly_idx);
+    JMM jmm_tmp = JMM(tmp_idx);
+    reg64_t reg_ptr_global = rax;
+    push(reg_ptr_global);
+    mov(reg_ptr_global, reinterpret_cast<size_t>(gelu_float_consts));
+    vxorps(jmm_tmp, jmm_tmp, jmm_tmp);
+    vsubps(jmm_abs, jmm_tmp, src);
+    vmaxps(jmm_abs, jmm_abs, src);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_SQRT1_2]);
+    vmulps(jmm_z, jmm_abs, jmm_tmp);
+    // t = 1 / (1 + p * z)
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_ERF_P]);
+    vmulps(jmm_t, jmm_z, jmm_tmp);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_ONE]);
+    vaddps(jmm_t, jmm_t, jmm_tmp);
+    vdivps(jmm_t, jmm_tmp, jmm_t);
+    // poly = ((((a5 * t + a4) * t + a3) * t + a2) * t + a1) * t
+    vmovaps(jmm_poly, ptr[reg_ptr_global + OFFSET_GELU_ERF_A5]);
+    for (size_t i = OFFSET_GELU_ERF_A4; i >= OFFSET_GELU_ERF_A1;
+         i -= (YMM_FLOAT_BLOCK * sizeof(float))) {
+      vmulps(jmm_poly, jmm_poly, jmm_t);
+      vmovaps(jmm_tmp, ptr[reg_ptr_global + i]);  // A4~A1
+      vaddps(jmm_poly, jmm_poly, jmm_tmp);
+    }
+    vmulps(jmm_poly, jmm_poly, jmm_t);
+    // erf(z) = 1 - poly * e^(-z^2)
+    vmulps(jmm_z, jmm_z, jmm_z);
+    vxorps(jmm_tmp, jmm_tmp, jmm_tmp);
+    vsubps(jmm_z, jmm_tmp, jmm_z);
+    exp_jmm<JMM>(dst, jmm_z, src_idx, fx_idx, fy_idx, mask_idx, tmp_idx);
+    vmulps(dst, dst, jmm_poly);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_ONE]);
+    vsubps(dst, jmm_tmp, dst);
+    vmulps(dst, dst, jmm_abs);
+    vaddps(dst, dst, src);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_0P5]);
+    vmulps(dst, dst, jmm_tmp);
+    pop(reg_ptr_global);
+  }
+
+  // compute GELU with the tanh approximation with ymm, xmm
+  template <typename JMM>
+  void gelu_tanh_jmm(JMM& dst,          // NOLINT
+                     JMM& src,          // NOLINT
+                     int z_idx = 7,     // NOLINT
+                     int src_idx = 11,  // NOLINT
+                     int fx_idx = 12,
+                     int fy_idx = 13,
+                     int mask_idx = 14,
+                     int tmp_idx = 15) {
+    // y = 0.5 * x * (1 + tanh(s * (x + c * x^3)))
+    //   = x * sigmoid(2s * (x + c * x^3))
+    JMM jmm_z = JMM(z_idx);
+    JMM jmm_tmp = JMM(tmp_idx);
+    reg64_t reg_ptr_global = rax;
+    push(reg_ptr_global);
+    mov(reg_ptr_global, reinterpret_cast<size_t>(gelu_float_consts));
+    vmulps(jmm_z, src, src);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_TANH_CUBIC]);
+    vmulps(jmm_z, jmm_z, jmm_tmp);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_ONE]);
+    vaddps(jmm_z, jmm_z, jmm_tmp);
+    vmulps(jmm_z, jmm_z, src);
+    vmovaps(jmm_tmp, ptr[reg_ptr_global + OFFSET_GELU_TANH_SCALE2]);
+    vmulps(jmm_z, jmm_z, jmm_tmp);
+    sigmoid_jmm<JMM>(dst, jmm_z, src_idx, fx_idx, fy_idx, mask_idx, tmp_idx);
+    vmulps(dst, dst, src);
+    pop(reg_ptr_global);
+  }
+
   // compute IDENTITY with ymm, xmm
   template <typename JMM>
   void identity_jmm(JMM& dst, JMM& src, int zero_idx) {  // NOLINT
@@ -244,7 +355,7 @@ class VActFunc : public JitCode {
 
   template <typename JMM>
   void act(JMM& dst, JMM& src, operand_type type) {  // NOLINT
-    // use 11~15
+    // use 11~15, and 6~9 for GELU
     switch (type) {
       case operand_type::RELU:
         relu_jmm<JMM>(dst, src, 15);
@@ -264,6 +375,12 @@ class VActFunc : public JitCode {
       case operand_type::IDENTITY:
         identity_jmm<JMM>(dst, src, 15);
         break;
+      case operand_type::GELU:
+        gelu_jmm<JMM>(dst, src, 6, 7, 8, 9, 11, 12, 13, 14, 15);
+        break;
+      case operand_type::GELU_TANH:
+        gelu_tanh_jmm<JMM>(dst, src, 7, 11, 12, 13, 14, 15);
+        break;
       default:
         PADDLE_THROW(phi::errors::Unimplemented(
             "Do not support operand type code: %d.", type));
@@ -281,7 +398,8 @@ class VActJitCode : public VActFunc {
       : VActFunc(code_size, code_ptr), num_(d), type_(type) {
     if (!(type_ == operand_type::RELU || type_ == operand_type::EXP ||
           type_ == operand_type::SIGMOID || type_ == operand_type::TANH ||
-          type_ == operand_type::IDENTITY || type_ == operand_type::SQUARE)) {
+          type_ == operand_type::IDENTITY || type_ == operand_type::SQUARE ||
+          type_ == operand_type::GELU || type_ == operand_type::GELU_TANH)) {
       PADDLE_THROW(phi::errors::Unimplemented(
           "Do not support operand type code: %d.", type));
     }
@@ -309,6 +427,12 @@ class VActJitCode : public VActFunc {
       case operand_type::IDENTITY:
         base += "_Identity";
         break;
+      case operand_type::GELU:
+        base += "_Gelu";
+        break;
+      case operand_type::GELU_TANH:
+        base += "_GeluTanh";
+        break;
       default:
         break;
     }
@@ -342,9 +466,67 @@ DECLARE_ACT_JITCODE(VIdentity, operand_type::IDENTITY);
 DECLARE_ACT_JITCODE(VExp, operand_type::EXP);
 DECLARE_ACT_JITCODE(VSigmoid, operand_type::SIGMOID);
 DECLARE_ACT_JITCODE(VTanh, operand_type::TANH);
+DECLARE_ACT_JITCODE(VGelu, operand_type::GELU);
+DECLARE_ACT_JITCODE(VGeluTanh, operand_type::GELU_TANH);
 
 #undef DECLARE_ACT_JITCODE
 
+// The act of bfloat16, computed in float by the act of VActFunc on ymm.
+class VActBF16JitCode : public VActFunc {
+ public:
+  explicit VActBF16JitCode(int d,
+                           operand_type type,
+                           size_t code_size,
+                           void* code_ptr = nullptr)
+      : VActFunc(code_size, code_ptr), num_(d), type_(type) {
+    if (!(type_ == operand_type::RELU || type_ == operand_type::EXP ||
+          type_ == operand_type::SIGMOID || type_ == operand_type::TANH ||
+          type_ == operand_type::GELU)) {
+      PADDLE_THROW(phi::errors::Unimplemented(
+          "Do not support operand type code: %d.", type));
+    }
+    this->genCode();
+  }
+
+  std::string name() const override {
+    return "VActBF16JitCode_" + std::to_string(type_) + "_D" +
+           std::to_string(num_);
+  }
+  void genCode() override;
+
+ protected:
+  int num_;
+  operand_type type_;
+  reg64_t param1{abi_param1};
+  reg64_t param2{abi_param2};
+
+  // the act uses ymm 6 ~ 9 and 11 ~ 15
+  ymm_t ymm_src = ymm_t(0);
+  ymm_t ymm_dst = ymm_t(1);
+  ymm_t ymm_tmp = ymm_t(2);
+  xmm_t xmm_half = xmm_t(2);
+  ymm_t ymm_one = ymm_t(3);
+  ymm_t ymm_round = ymm_t(4);
+  opmask_t k_tail = opmask_t(1);
+};
+
+#define DECLARE_ACT_BF16_JITCODE(name, op_type)               \
+  class name##BF16JitCode : public VActBF16JitCode {          \
+   public:                                                    \
+    explicit name##BF16JitCode(int d,                         \
+                               size_t code_size,              \
+                               void* code_ptr = nullptr)      \
+        : VActBF16JitCode(d, op_type, code_size, code_ptr) {} \
+  };
+
+DECLARE_ACT_BF16_JITCODE(VRelu, operand_type::RELU);
+DECLARE_ACT_BF16_JITCODE(VExp, operand_type::EXP);
+DECLARE_ACT_BF16_JITCODE(VSigmoid, operand_type::SIGMOID);
+DECLARE_ACT_BF16_JITCODE(VTanh, operand_type::TANH);
+DECLARE_ACT_BF16_JITCODE(VGelu, operand_type::GELU);
+
+#undef DECLARE_ACT_BF16_JITCODE
+
 }  // namespace gen
 }  // namespace jit
 }  // namespace phi
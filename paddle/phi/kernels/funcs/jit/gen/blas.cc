@@ -15,6 +15,7 @@
 #include "paddle/phi/kernels/funcs/jit/gen/blas.h"
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/kernels/funcs/jit/macro.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
@@ -110,6 +111,45 @@ void VXXJitCode::genCode() {
   ret();
 }
 
+void VXXBF16JitCode::genCode() {
+  init_bf16_consts(zmm_one, zmm_round);
+  int offset = 0;
+  auto compute = [&]() {
+    if (type_ == operand_type::MUL) {
+      vmulps(zmm_dst, zmm_src1, zmm_src2);
+    } else {
+      vaddps(zmm_dst, zmm_src1, zmm_src2);
+    }
+  };
+  for (int i = 0; i < num_ / ZMM_FLOAT_BLOCK; ++i) {
+    load_bf16(zmm_src1, ptr[param1 + offset]);
+    load_bf16(zmm_src2, ptr[param2 + offset]);
+    compute();
+    store_bf16(ptr[param3 + offset],
+               zmm_dst,
+               ymm_half,
+               zmm_tmp,
+               zmm_one,
+               zmm_round);
+    offset += sizeof(int16_t) * ZMM_FLOAT_BLOCK;
+  }
+  int rest = num_ % ZMM_FLOAT_BLOCK;
+  if (rest > 0) {
+    set_tail_mask(k_tail, rest);
+    load_bf16(zmm_src1, ptr[param1 + offset], k_tail);
+    load_bf16(zmm_src2, ptr[param2 + offset], k_tail);
+    compute();
+    store_bf16(ptr[param3 + offset],
+               zmm_dst,
+               ymm_half,
+               zmm_tmp,
+               zmm_one,
+               zmm_round,
+               k_tail);
+  }
+  ret();
+}
+
 #define DECLARE_BLAS_CREATOR(name)                                           \
   class name##Creator : public JitCodeCreator<int> {                         \
    public:                                                                   \
@@ -134,14 +174,35 @@ DECLARE_BLAS_CREATOR(VAddBias);
 
 #undef DECLARE_BLAS_CREATOR
 
+#define DECLARE_BLAS_BF16_CREATOR(name)                                      \
+  class name##BF16Creator                                                    \
+      : public JitCodeCreator<int, phi::dtype::bfloat16> {                   \
+   public:                                                                   \
+    bool CanBeUsed(const int& attr) const override {                         \
+      return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_core) && \
+             attr <= 1024;                                                   \
+    }                                                                        \
+    size_t CodeSize(const int& d) const override {                           \
+      return 96 + (d / ZMM_FLOAT_BLOCK + 1) * 14 * 8;                        \
+    }                                                                        \
+    std::unique_ptr<GenBase> CreateJitCode(const int& attr) const override { \
+      return make_unique<name##BF16JitCode>(attr, CodeSize(attr));           \
+    }                                                                        \
+  }
+
+DECLARE_BLAS_BF16_CREATOR(VMul);
+DECLARE_BLAS_BF16_CREATOR(VAdd);
+
+#undef DECLARE_BLAS_BF16_CREATOR
+
 }  // namespace gen
 }  // namespace jit
 }  // namespace phi
 
 namespace gen = phi::jit::gen;
 
-REGISTER_JITKERNEL_GEN(kVMul, gen::VMulCreator);
-REGISTER_JITKERNEL_GEN(kVAdd, gen::VAddCreator);
+REGISTER_JITKERNEL_GEN(kVMul, gen::VMulCreator, gen::VMulBF16Creator);
+REGISTER_JITKERNEL_GEN(kVAdd, gen::VAddCreator, gen::VAddBF16Creator);
 REGISTER_JITKERNEL_GEN(kVSub, gen::VSubCreator);
 REGISTER_JITKERNEL_GEN(kVAddRelu, gen::VAddReluCreator);
 REGISTER_JITKERNEL_GEN(kVScal, gen::VScalCreator);
@@ -108,6 +108,58 @@ DECLARE_BLAS_JITCODE(VAddBias, operand_type::ADD, 1, false);
 
 #undef DECLARE_BLAS_JITCODE
 
+// function: vec = Operand(vec, vec) of bfloat16, computed in float
+class VXXBF16JitCode : public JitCode {
+ public:
+  explicit VXXBF16JitCode(int d,
+                          operand_type type,
+                          size_t code_size = 256 * 1024,
+                          void* code_ptr = nullptr)
+      : JitCode(code_size, code_ptr), num_(d), type_(type) {
+    if (!(type_ == operand_type::MUL || type_ == operand_type::ADD)) {
+      PADDLE_THROW(phi::errors::Unimplemented(
+          "Do not support operand type code: %d.", type));
+    }
+    this->genCode();
+  }
+
+  std::string name() const override {
+    std::string base = "VXXBF16JitCode";
+    base += (type_ == operand_type::MUL ? "_Mul" : "_Add");
+    base += "_D" + std::to_string(num_);
+    return base;
+  }
+  void genCode() override;
+
+ private:
+  int num_;
+  operand_type type_;
+  reg64_t param1{abi_param1};
+  reg64_t param2{abi_param2};
+  reg64_t param3{abi_param3};
+
+  zmm_t zmm_src1 = zmm_t(0);
+  zmm_t zmm_src2 = zmm_t(1);
+  zmm_t zmm_dst = zmm_t(2);
+  zmm_t zmm_tmp = zmm_t(3);
+  ymm_t ymm_half = ymm_t(3);
+  zmm_t zmm_one = zmm_t(4);
+  zmm_t zmm_round = zmm_t(5);
+  opmask_t k_tail = opmask_t(1);
+};
+
+class VMulBF16JitCode : public VXXBF16JitCode {
+ public:
+  explicit VMulBF16JitCode(int d, size_t code_size, void* code_ptr = nullptr)
+      : VXXBF16JitCode(d, operand_type::MUL, code_size, code_ptr) {}
+};
+
+class VAddBF16JitCode : public VXXBF16JitCode {
+ public:
+  explicit VAddBF16JitCode(int d, size_t code_size, void* code_ptr = nullptr)
+      : VXXBF16JitCode(d, operand_type::ADD, code_size, code_ptr) {}
+};
+
 }  // namespace gen
 }  // namespace jit
 }  // namespace phi
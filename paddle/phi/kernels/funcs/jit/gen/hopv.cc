@@ -0,0 +1,113 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/jit/gen/hopv.h"
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/registry.h"
+
+namespace phi {
+namespace jit {
+namespace gen {
+
+template <typename JMM>
+int HOPVJitCode::process_blocks(JMM& dst,  // NOLINT
+                                JMM& src,  // NOLINT
+                                int block,
+                                int offset) {
+  const int float_size = static_cast<int>(sizeof(float));
+  const int num_blocks = (num_ - offset / float_size) / block;
+  if (num_blocks == 0) {
+    return offset;
+  }
+  // The blocks are folded in a loop, so the code size does not grow with d.
+  Label l_next_block;
+  mov(reg_ptr_src_i, param_src);
+  add(reg_ptr_src_i, offset);
+  mov(reg_ptr_src_end, reg_ptr_src_i);
+  add(reg_ptr_src_end, num_blocks * block * float_size);
+  L(l_next_block);
+  {
+    vmovups(src, ptr[reg_ptr_src_i]);
+    process<JMM>(dst, dst, src);
+    add(reg_ptr_src_i, block * float_size);
+    cmp(reg_ptr_src_i, reg_ptr_src_end);
+    jb(l_next_block, T_NEAR);
+  }
+  return offset + num_blocks * block * float_size;
+}
+
+void HOPVJitCode::genCode() {
+  int offset = 0;
+  if (num_ >= YMM_FLOAT_BLOCK) {
+    if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
+        num_ >= ZMM_FLOAT_BLOCK) {
+      vmovups(zmm_dst, ptr[param_src]);
+      offset = process_blocks<zmm_t>(
+          zmm_dst, zmm_src, ZMM_FLOAT_BLOCK, ZMM_FLOAT_BLOCK * sizeof(float));
+      vextractf64x4(ymm_src, zmm_dst, 1);
+      process<ymm_t>(ymm_dst, ymm_dst, ymm_src);
+    } else {
+      vmovups(ymm_dst, ptr[param_src]);
+      offset = YMM_FLOAT_BLOCK * sizeof(float);
+    }
+    offset = process_blocks<ymm_t>(ymm_dst, ymm_src, YMM_FLOAT_BLOCK, offset);
+    // fold the 8 floats into the lowest one
+    vextractf128(xmm_src, ymm_dst, 1);
+    process<xmm_t>(xmm_dst, xmm_dst, xmm_src);
+    vpermilps(xmm_src, xmm_dst, 0x4E);  // [2, 3, 0, 1]
+    process<xmm_t>(xmm_dst, xmm_dst, xmm_src);
+    vpermilps(xmm_src, xmm_dst, 0xB1);  // [1, 0, 3, 2]
+    process<xmm_t>(xmm_dst, xmm_dst, xmm_src);
+  } else {
+    vmovss(xmm_dst, ptr[param_src]);
+    offset = sizeof(float);
+  }
+  for (; offset < num_ * static_cast<int>(sizeof(float));
+       offset += sizeof(float)) {
+    vmovss(xmm_src, ptr[param_src + offset]);
+    process_scalar(xmm_dst, xmm_src);
+  }
+  vmovss(ptr[param_dst], xmm_dst);
+  vzeroupper();
+  ret();
+}
+
+#define DECLARE_HOP_CREATOR(name)                                            \
+  class name##Creator : public JitCodeCreator<int> {                         \
+   public:                                                                   \
+    bool CanBeUsed(const int& attr) const override {                         \
+      return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);           \
+    }                                                                        \
+    size_t CodeSize(const int& d) const override {                           \
+      return 96 + (YMM_FLOAT_BLOCK * 2 + 32) * 8;                            \
+    }                                                                        \
+    std::unique_ptr<GenBase> CreateJitCode(const int& attr) const override { \
+      return make_unique<name##JitCode>(attr, CodeSize(attr));               \
+    }                                                                        \
+  }
+
+DECLARE_HOP_CREATOR(HMax);
+DECLARE_HOP_CREATOR(HSum);
+
+#undef DECLARE_HOP_CREATOR
+
+}  // namespace gen
+}  // namespace jit
+}  // namespace phi
+
+namespace gen = phi::jit::gen;
+
+REGISTER_JITKERNEL_GEN(kHMax, gen::HMaxCreator);
+REGISTER_JITKERNEL_GEN(kHSum, gen::HSumCreator);
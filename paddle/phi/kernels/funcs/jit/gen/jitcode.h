@@ -61,7 +61,9 @@ typedef enum {
   SQUARE,
   SIGMOID,
   TANH,
-  IDENTITY
+  IDENTITY,
+  GELU,
+  GELU_TANH
 } operand_type;
 
 #define DECLARE_JIT_CODE(codename) \
@@ -101,6 +103,70 @@ class JitCode : public GenBase, public Xbyak::CodeGenerator {
     }
     ret();
   }
+
+  // The bfloat16 kernels widen the elements to float and compute as the float
+  // kernels, which needs AVX512 BW and VL for the conversions and the masks.
+  // They use r11 as a scratch register.
+
+  // Sets the lowest n bits of the mask, for a tail of n elements.
+  void set_tail_mask(const Xbyak::Opmask& mask, int n) {
+    mov(r11d, (1u << n) - 1);
+    kmovd(mask, r11d);
+  }
+
+  // Sets the integers to round float to bfloat16 when the CPU does not have
+  // AVX512_BF16.
+  template <typename JMM>
+  void init_bf16_consts(const JMM& one, const JMM& round) {
+    mov(r11d, 1);
+    vpbroadcastd(one, r11d);
+    mov(r11d, 0x7fff);
+    vpbroadcastd(round, r11d);
+  }
+
+  // Widens the bfloat16 elements at src to float, only the elements of the
+  // mask unless it is k0.
+  template <typename JMM>
+  void load_bf16(const JMM& dst,
+                 const Xbyak::Address& src,
+                 const Xbyak::Opmask& mask = Xbyak::Opmask(0)) {
+    if (mask.getIdx() == 0) {
+      vpmovzxwd(dst, src);
+    } else {
+      vpmovzxwd(dst | mask | T_z, src);
+    }
+    vpslld(dst, dst, 16);
+  }
+
+  // Rounds the float elements of src to nearest even bfloat16 in half, which
+  // is the lower half of tmp, and stores them to dst, only the elements of
+  // the mask unless it is k0.
+  template <typename JMM, typename HALF>
+  void store_bf16(const Xbyak::Address& dst,
+                  const JMM& src,
+                  const HALF& half,
+                  const JMM& tmp,
+                  const JMM& one,
+                  const JMM& round,
+                  const Xbyak::Opmask& mask = Xbyak::Opmask(0)) {
+    if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_bf16)) {
+      vcvtneps2bf16(half, src);
+    } else {
+      // the upper 16 bits of src + 0x7fff + (bit 16 of src)
+      vpsrld(tmp, src, 16);
+      vpandd(tmp, tmp, one);
+      vpaddd(tmp, tmp, round);
+      vpaddd(tmp, tmp, src);
+      vpsrld(tmp, tmp, 16);
+      vpmovdw(half, tmp);
+    }
+    if (mask.getIdx() == 0) {
+      vmovdqu16(dst, half);
+    } else {
+      vmovdqu16(dst | mask, half);
+    }
+  }
+
   void L(const char* label) { Xbyak::CodeGenerator::L(label); }
   void L(Xbyak::Label& label) { Xbyak::CodeGenerator::L(label); }  // NOLINT
   // Enhanced vector extension
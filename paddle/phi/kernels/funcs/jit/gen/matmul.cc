@@ -14,9 +14,11 @@
 
 #include "paddle/phi/kernels/funcs/jit/gen/matmul.h"
 
+#include <algorithm>
 #include <cstddef>  // offsetof
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
 namespace phi {
@@ -106,6 +108,62 @@ void MatMulJitCode::genCode() {
   postCode();
 }
 
+void MatMulBF16JitCode::genCode() {
+  init_bf16_consts(zmm_one, zmm_round);
+  const int blocks = n_ / ZMM_FLOAT_BLOCK;
+  const int block_len = sizeof(int16_t) * ZMM_FLOAT_BLOCK;
+  for (int g0 = 0; g0 < blocks; g0 += max_acc_regs) {
+    const int acc_regs = std::min(max_acc_regs, blocks - g0);
+    for (int i = 0; i < acc_regs; ++i) {
+      vxorps(zmm_t(i), zmm_t(i), zmm_t(i));
+    }
+    for (int k = 0; k < k_; ++k) {
+      // every dword of x holds A[k] in its upper 16 bits
+      vpbroadcastw(zmm_x, word[param_x + k * sizeof(int16_t)]);
+      vpslld(zmm_x, zmm_x, 16);
+      for (int i = 0; i < acc_regs; ++i) {
+        load_bf16(zmm_wgt,
+                  ptr[param_y + (k * n_ + (g0 + i) * ZMM_FLOAT_BLOCK) *
+                                    sizeof(int16_t)]);
+        vfmadd231ps(zmm_t(i), zmm_wgt, zmm_x);
+      }
+    }
+    for (int i = 0; i < acc_regs; ++i) {
+      store_bf16(ptr[param_z + (g0 + i) * block_len],
+                 zmm_t(i),
+                 ymm_half,
+                 zmm_tmp,
+                 zmm_one,
+                 zmm_round);
+    }
+  }
+  ret();
+}
+
+void MatMulInt8JitCode::genCode() {
+  const int blocks = n_ / ZMM_FLOAT_BLOCK;
+  const int block_len = sizeof(int32_t) * ZMM_FLOAT_BLOCK;
+  for (int g0 = 0; g0 < blocks; g0 += max_acc_regs) {
+    const int acc_regs = std::min(max_acc_regs, blocks - g0);
+    for (int i = 0; i < acc_regs; ++i) {
+      vpxord(zmm_t(i), zmm_t(i), zmm_t(i));
+    }
+    for (int p = 0; p < k_ / 4; ++p) {
+      // 4 elements of A, multiplied with the 4 packed rows of B
+      vpbroadcastd(zmm_x, dword[param_x + p * 4]);
+      for (int i = 0; i < acc_regs; ++i) {
+        vpdpbusd(zmm_t(i),
+                 zmm_x,
+                 ptr[param_y + (p * n_ + (g0 + i) * ZMM_FLOAT_BLOCK) * 4]);
+      }
+    }
+    for (int i = 0; i < acc_regs; ++i) {
+      vmovdqu32(ptr[param_z + (g0 + i) * block_len], zmm_t(i));
+    }
+  }
+  ret();
+}
+
 class MatMulCreator : public JitCodeCreator<matmul_attr_t> {
  public:
   bool CanBeUsed(const matmul_attr_t& attr) const override {
@@ -147,10 +205,45 @@ class MatMulCreator : public JitCodeCreator<matmul_attr_t> {
   }
 };
 
+class MatMulBF16Creator
+    : public JitCodeCreator<matmul_attr_t, phi::dtype::bfloat16> {
+ public:
+  bool CanBeUsed(const matmul_attr_t& attr) const override {
+    return attr.m == 1 &&
+           phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_core) &&
+           attr.n % ZMM_FLOAT_BLOCK == 0 && attr.k < 512;
+  }
+  size_t CodeSize(const matmul_attr_t& attr) const override {
+    return 96 + 4 * (attr.k + 2) * (attr.n / ZMM_FLOAT_BLOCK + 1) * 8;
+  }
+  std::unique_ptr<GenBase> CreateJitCode(
+      const matmul_attr_t& attr) const override {
+    return make_unique<MatMulBF16JitCode>(attr, CodeSize(attr));
+  }
+};
+
+class MatMulInt8Creator : public JitCodeCreator<matmul_attr_t, int8_t> {
+ public:
+  bool CanBeUsed(const matmul_attr_t& attr) const override {
+    return attr.m == 1 &&
+           phi::backends::cpu::MayIUse(
+               phi::backends::cpu::avx512_core_vnni) &&
+           attr.n % ZMM_FLOAT_BLOCK == 0 && attr.k % 4 == 0 && attr.k < 2048;
+  }
+  size_t CodeSize(const matmul_attr_t& attr) const override {
+    return 96 + 2 * (attr.k / 4 + 2) * (attr.n / ZMM_FLOAT_BLOCK + 1) * 8;
+  }
+  std::unique_ptr<GenBase> CreateJitCode(
+      const matmul_attr_t& attr) const override {
+    return make_unique<MatMulInt8JitCode>(attr, CodeSize(attr));
+  }
+};
+
 }  // namespace gen
 }  // namespace jit
 }  // namespace phi
 
 namespace gen = phi::jit::gen;
 
-REGISTER_JITKERNEL_GEN(kMatMul, gen::MatMulCreator);
+REGISTER_JITKERNEL_GEN(kMatMul, gen::MatMulCreator, gen::MatMulBF16Creator);
+REGISTER_JITKERNEL_GEN(kMatMulInt8, gen::MatMulInt8Creator);
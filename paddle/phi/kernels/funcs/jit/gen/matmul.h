@@ -62,6 +62,92 @@ class MatMulJitCode : public JitCode {
   reg64_t reg_ptr_wgt{r10};
 };
 
+// The bfloat16 matmul of m == 1 widens A and B to float and accumulates C in
+// float, which is rounded to bfloat16 only once at the end.
+class MatMulBF16JitCode : public JitCode {
+ public:
+  explicit MatMulBF16JitCode(const matmul_attr_t& attr,
+                             size_t code_size = 256 * 1024,
+                             void* code_ptr = nullptr)
+      : JitCode(code_size, code_ptr), m_(attr.m), n_(attr.n), k_(attr.k) {
+    PADDLE_ENFORCE_EQ(m_,
+                      1,
+                      phi::errors::Unimplemented(
+                          "Jitcode of bfloat16 matmul only support m==1 "
+                          "(first matrix's row) now. But m is %d.",
+                          m_));
+    this->genCode();
+  }
+
+  std::string name() const override {
+    std::string base = "MatMulBF16JitCode";
+    base = base + "_M" + std::to_string(m_) + "_N" + std::to_string(n_) + "_K" +
+           std::to_string(k_);
+    return base;
+  }
+  void genCode() override;
+
+ private:
+  int m_, n_, k_;
+
+  reg64_t param_x{abi_param1};
+  reg64_t param_y{abi_param2};
+  reg64_t param_z{abi_param3};
+
+  // zmm 0 ~ 23 accumulate the blocks of C
+  const int max_acc_regs = 24;
+  zmm_t zmm_tmp = zmm_t(27);
+  ymm_t ymm_half = ymm_t(27);
+  zmm_t zmm_one = zmm_t(28);
+  zmm_t zmm_round = zmm_t(29);
+  zmm_t zmm_wgt = zmm_t(30);
+  zmm_t zmm_x = zmm_t(31);
+};
+
+// The int8 matmul of m == 1 with the AVX512 VNNI dot products of 4 uint8
+// elements of A and 4 int8 elements of B, which is packed by
+// pack_int8_weights.
+class MatMulInt8JitCode : public JitCode {
+ public:
+  explicit MatMulInt8JitCode(const matmul_attr_t& attr,
+                             size_t code_size = 256 * 1024,
+                             void* code_ptr = nullptr)
+      : JitCode(code_size, code_ptr), m_(attr.m), n_(attr.n), k_(attr.k) {
+    PADDLE_ENFORCE_EQ(m_,
+                      1,
+                      phi::errors::Unimplemented(
+                          "Jitcode of int8 matmul only support m==1 "
+                          "(first matrix's row) now. But m is %d.",
+                          m_));
+    PADDLE_ENFORCE_EQ(k_ % 4,
+                      0,
+                      phi::errors::Unimplemented(
+                          "Jitcode of int8 matmul only support k (second "
+                          "matrix's row) divisible by 4. But k is %d.",
+                          k_));
+    this->genCode();
+  }
+
+  std::string name() const override {
+    std::string base = "MatMulInt8JitCode";
+    base = base + "_M" + std::to_string(m_) + "_N" + std::to_string(n_) + "_K" +
+           std::to_string(k_);
+    return base;
+  }
+  void genCode() override;
+
+ private:
+  int m_, n_, k_;
+
+  reg64_t param_x{abi_param1};
+  reg64_t param_y{abi_param2};
+  reg64_t param_z{abi_param3};
+
+  // zmm 0 ~ 29 accumulate the blocks of C
+  const int max_acc_regs = 30;
+  zmm_t zmm_x = zmm_t(31);
+};
+
 }  // namespace gen
 }  // namespace jit
 }  // namespace phi
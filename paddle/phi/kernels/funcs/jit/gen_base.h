@@ -65,7 +65,8 @@ class GenCreator {
   virtual ~GenCreator() = default;
 };
 
-template <typename Attr>
+// T is the data type of the kernel tuple the jit code computes.
+template <typename Attr, typename T = float>
 class JitCodeCreator : public GenCreator {
  public:
   virtual ~JitCodeCreator() = default;
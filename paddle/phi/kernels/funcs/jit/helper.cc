@@ -47,6 +47,12 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kVSquare);
     ONE_CASE(kVSigmoid);
     ONE_CASE(kVTanh);
+    ONE_CASE(kVGelu);
+    ONE_CASE(kVGeluTanh);
+    ONE_CASE(kVBiasAct);
+    ONE_CASE(kHMax);
+    ONE_CASE(kHSum);
+    ONE_CASE(kSoftmax);
     ONE_CASE(kLSTMCtHt);
     ONE_CASE(kLSTMC1H1);
     ONE_CASE(kGRUH1);
@@ -54,8 +60,10 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kGRUHtPart2);
     ONE_CASE(kCRFDecoding);
     ONE_CASE(kLayerNorm);
+    ONE_CASE(kRMSNorm);
     ONE_CASE(kSeqPool);
     ONE_CASE(kMatMul);
+    ONE_CASE(kMatMulInt8);
     ONE_CASE(kAdam);
     ONE_CASE(kAdamW);
     ONE_CASE(kEmbSeqPool);
@@ -96,6 +104,10 @@ KernelType to_kerneltype(const std::string& act) {
     return kVSigmoid;
   } else if (lower == "tanh" || lower == "vtanh") {
     return kVTanh;
+  } else if (lower == "gelu" || lower == "vgelu") {
+    return kVGelu;
+  } else if (lower == "gelu_tanh" || lower == "vgelutanh") {
+    return kVGeluTanh;
   }
   PADDLE_THROW(phi::errors::Unimplemented(
       "Act JIT kernel do not support type: %s.", act));
@@ -142,6 +154,16 @@ void pack_weights<float>(const float* src, float* dst, int n, int k) {
   }
 }
 
+void pack_int8_weights(const int8_t* src, int8_t* dst, int n, int k) {
+  int k_blocks = (k + 3) / 4;
+  std::memset(dst, 0, k_blocks * 4 * n * sizeof(int8_t));
+  for (int i = 0; i < k; ++i) {
+    for (int j = 0; j < n; ++j) {
+      dst[(i / 4) * n * 4 + j * 4 + i % 4] = src[i * n + j];
+    }
+  }
+}
+
 template <typename T>
 typename std::enable_if<!std::is_same<T, float>::value>::type pack_weights(
     const T* src, T* dst, int n, int k) {
@@ -22,6 +22,7 @@
 #include <utility>  // for std::move
 #include <vector>
 
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/kernels/funcs/jit/gen_base.h"
@@ -34,15 +35,24 @@ namespace jit {
 
 class GenBase;
 
+// The data types the jitcode is generated for.
+template <typename T>
+struct IsJitCodeType {
+  static constexpr bool value = std::is_same<T, float>::value ||
+                                std::is_same<T, phi::dtype::bfloat16>::value ||
+                                std::is_same<T, int8_t>::value;
+};
+
 template <typename KernelTuple, typename PlaceType>
 inline typename std::enable_if<
-    std::is_same<typename KernelTuple::data_type, float>::value &&
+    IsJitCodeType<typename KernelTuple::data_type>::value &&
         std::is_same<PlaceType, phi::CPUPlace>::value,
     const Kernel*>::type
 GetJitCode(const typename KernelTuple::attr_type& attr) {
   using Attr = typename KernelTuple::attr_type;
+  using T = typename KernelTuple::data_type;
   int64_t key = JitCodeKey<Attr>(attr);
-  auto& codes = JitCodePool<KernelTuple::kernel_type>::Instance();
+  auto& codes = JitCodePool<KernelTuple::kernel_type, T>::Instance();
   if (codes.Has(key)) {
     return codes.AllKernels().at(key).get();
   }
@@ -55,7 +65,7 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
   if (iter != creator_map.end()) {
     auto& creators = iter->second;
     for (auto& cur : creators) {
-      auto i = dynamic_cast<const JitCodeCreator<Attr>*>(cur.get());
+      auto i = dynamic_cast<const JitCodeCreator<Attr, T>*>(cur.get());
       if (i && i->CanBeUsed(attr)) {
         auto p = i->CreateJitCode(attr);
         if (p) {
@@ -71,7 +81,7 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
 
 template <typename KernelTuple, typename PlaceType>
 inline typename std::enable_if<
-    !std::is_same<typename KernelTuple::data_type, float>::value ||
+    !IsJitCodeType<typename KernelTuple::data_type>::value ||
         !std::is_same<PlaceType, phi::CPUPlace>::value,
     const Kernel*>::type
 GetJitCode(const typename KernelTuple::attr_type& attr UNUSED) {
@@ -245,6 +255,50 @@ class KernelFuncs {
   DISABLE_COPY_AND_ASSIGN(KernelFuncs);
 };
 
+// The code of the jit kernels may grow with their length, so the kernels on
+// whole tensors run them on blocks of a fixed length.
+constexpr int kJitBlockSize = 256;
+
+// y = f(x) on the n elements of x, with the kernel of KernelTuple run on
+// blocks of kJitBlockSize elements, e.g. for VRelu.
+template <typename KernelTuple, typename PlaceType>
+void RunXYNInBlocks(const typename KernelTuple::data_type* x,
+                    typename KernelTuple::data_type* y,
+                    int64_t n) {
+  auto& cache = KernelFuncs<KernelTuple, PlaceType>::Cache();
+  int64_t end = n - n % kJitBlockSize;
+  if (end > 0) {
+    auto func = cache.At(kJitBlockSize);
+    for (int64_t i = 0; i < end; i += kJitBlockSize) {
+      func(x + i, y + i, kJitBlockSize);
+    }
+  }
+  int rest = static_cast<int>(n - end);
+  if (rest > 0) {
+    cache.At(rest)(x + end, y + end, rest);
+  }
+}
+
+// z = f(x, y) on the n elements of x and y, e.g. for VAdd.
+template <typename KernelTuple, typename PlaceType>
+void RunXYZNInBlocks(const typename KernelTuple::data_type* x,
+                     const typename KernelTuple::data_type* y,
+                     typename KernelTuple::data_type* z,
+                     int64_t n) {
+  auto& cache = KernelFuncs<KernelTuple, PlaceType>::Cache();
+  int64_t end = n - n % kJitBlockSize;
+  if (end > 0) {
+    auto func = cache.At(kJitBlockSize);
+    for (int64_t i = 0; i < end; i += kJitBlockSize) {
+      func(x + i, y + i, z + i, kJitBlockSize);
+    }
+  }
+  int rest = static_cast<int>(n - end);
+  if (rest > 0) {
+    cache.At(rest)(x + end, y + end, z + end, rest);
+  }
+}
+
 const char* to_string(KernelType kt);
 const char* to_string(SeqPoolType kt);
 
@@ -292,6 +346,11 @@ inline std::ostream& operator<<(std::ostream& os, const sgd_attr_t& attr) {
   return os;
 }
 
+inline std::ostream& operator<<(std::ostream& os, const bias_act_attr_t& attr) {
+  os << "width_size[" << attr.w << "],act[" << to_string(attr.act) << "]";
+  return os;
+}
+
 inline std::ostream& operator<<(std::ostream& os, const matmul_attr_t& attr) {
   os << "M[" << attr.m << "],N[" << attr.n << "],K[" << attr.k << "]";
   return os;
@@ -301,5 +360,10 @@ inline std::ostream& operator<<(std::ostream& os, const matmul_attr_t& attr) {
 template <typename T>
 void pack_weights(const T* src, T* dst, int n, int k);
 
+// expose the method to pack the int8 weight (k, n) of MatMulInt8, where every
+// 4 rows are interleaved as the VNNI dot products read them, and k is padded
+// to a multiple of 4 by zeros, so dst has (k + 3) / 4 * 4 * n elements.
+void pack_int8_weights(const int8_t* src, int8_t* dst, int n, int k);
+
 }  // namespace jit
 }  // namespace phi
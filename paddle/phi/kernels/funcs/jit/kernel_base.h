@@ -31,17 +31,25 @@ typedef enum {
   kGRUH1,
   kGRUHtPart1,
   kGRUHtPart2,
+  kHMax,
+  kHSum,
   kLSTMCtHt,
   kLSTMC1H1,
   kLayerNorm,
   kMatMul,
+  kMatMulInt8,
+  kRMSNorm,
   kSeqPool,
+  kSoftmax,
   kVAdd,
   kVAddBias,
   kVAddRelu,
+  kVBiasAct,
   kVBroadcast,
   kVCopy,
   kVExp,
+  kVGelu,
+  kVGeluTanh,
   kVIdentity,
   kVMul,
   kVRelu,
@@ -88,6 +96,10 @@ struct XYNTuple {
   typedef void (*func_type)(const T*, T*, int);
 };
 
+// x, returned value, n
+template <typename T>
+struct XRNTuple : public XYNTuple<T> {};
+
 // x, returned value, n, stride
 template <typename T>
 struct XRNSTuple {
@@ -118,6 +130,11 @@ DECLARE_KERNELTUPLE(XYNTuple, VExp);
 DECLARE_KERNELTUPLE(XYNTuple, VSigmoid);
 DECLARE_KERNELTUPLE(XYNTuple, VTanh);
 DECLARE_KERNELTUPLE(XYNTuple, VCopy);
+DECLARE_KERNELTUPLE(XYNTuple, VGelu);
+DECLARE_KERNELTUPLE(XYNTuple, VGeluTanh);
+
+DECLARE_KERNELTUPLE(XRNTuple, HMax);
+DECLARE_KERNELTUPLE(XRNTuple, HSum);
 
 typedef struct {
   void* gates;  // gates: x_ch, x_ih, x_fh, x_oh
@@ -317,6 +334,18 @@ struct MatMulTuple {
   typedef void (*func_type)(const T*, const T*, T*, const matmul_attr_t*);
 };
 
+// x: uint8 (m, k), y: weight packed by pack_int8_weights, z: int32 (m, n)
+template <typename T>
+struct MatMulInt8Tuple {
+  static constexpr KernelType kernel_type = kMatMulInt8;
+  typedef T data_type;
+  typedef matmul_attr_t attr_type;
+  typedef void (*func_type)(const uint8_t*,
+                            const T*,
+                            int32_t*,
+                            const matmul_attr_t*);
+};
+
 template <typename T>
 struct CRFDecodingTuple {
   static constexpr KernelType kernel_type = kCRFDecoding;
@@ -334,6 +363,43 @@ struct LayerNormTuple {
       T*, T*, T*, T*, const T*, const T*, int, const float, int);
 };
 
+template <typename T>
+struct SoftmaxTuple {
+  static constexpr KernelType kernel_type = kSoftmax;
+  typedef T data_type;
+  typedef int attr_type;
+  // x, y, n, bs
+  typedef void (*func_type)(const T*, T*, int, int);
+};
+
+template <typename T>
+struct RMSNormTuple {
+  static constexpr KernelType kernel_type = kRMSNorm;
+  typedef T data_type;
+  typedef int attr_type;
+  // x, out, scale, bias, height, epsilon, right
+  typedef void (*func_type)(
+      const T*, T*, const T*, const T*, int, const float, int);
+};
+
+typedef struct bias_act_attr_s {
+  int w;
+  KernelType act;
+  bias_act_attr_s() = default;
+  explicit bias_act_attr_s(int width, KernelType act_type)
+      : w(width), act(act_type) {}
+} bias_act_attr_t;
+
+template <typename T>
+struct VBiasActTuple {
+  static constexpr KernelType kernel_type = kVBiasAct;
+  typedef T data_type;
+  typedef bias_act_attr_t attr_type;
+  // x, bias, y, height
+  typedef void (*func_type)(
+      const T*, const T*, T*, int, const bias_act_attr_t*);
+};
+
 // Just for adding to kernel pool without template
 class Kernel {
  public:
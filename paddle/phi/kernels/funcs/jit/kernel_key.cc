@@ -71,5 +71,11 @@ int64_t JitCodeKey<adam_attr_t>(const adam_attr_t& attr) {
   return static_cast<int64_t>(attr.beta1 + attr.beta2);
 }
 
+template <>
+int64_t JitCodeKey<bias_act_attr_t>(const bias_act_attr_t& attr) {
+  std::array<int, 2> keys = {attr.w, static_cast<int>(attr.act)};
+  return static_cast<int64_t>(XXH64(keys.data(), sizeof(int) * 2, 0));
+}
+
 }  // namespace jit
 }  // namespace phi
@@ -21,6 +21,9 @@ namespace jit {
 #define SIGMOID_THRESHOLD_MIN -40.0
 #define SIGMOID_THRESHOLD_MAX 13.0
 #define EXP_MAX_INPUT 40.0
+// gelu(x) ~= 0.5 * x * (1 + tanh(SCALE * (x + CUBIC * x^3)))
+#define GELU_TANH_SCALE 0.7978845608028654  // sqrt(2 / pi)
+#define GELU_TANH_CUBIC 0.044715
 
 #define XMM_FLOAT_BLOCK 4
 #define YMM_FLOAT_BLOCK 8
@@ -0,0 +1,87 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/jit/more/intrinsic/rms_norm.h"
+
+#include <cmath>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/registry.h"
+
+namespace phi {
+namespace jit {
+namespace more {
+namespace intrinsic {
+
+void RMSNorm(const float* x,
+             float* out,
+             const float* scale,
+             const float* bias,
+             int height,
+             const float epsilon,
+             int right) {
+  constexpr int block = YMM_FLOAT_BLOCK;
+  const int end = right - right % block;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < height; ++i) {
+    const float* row = x + static_cast<size_t>(i) * right;
+    float* out_row = out + static_cast<size_t>(i) * right;
+
+    // sum of squares, with the horizontal add of the 8 lanes at the end
+    __m256 sum = _mm256_setzero_ps();
+    for (int j = 0; j < end; j += block) {
+      __m256 tmp = _mm256_loadu_ps(row + j);
+      sum = _mm256_add_ps(sum, _mm256_mul_ps(tmp, tmp));
+    }
+    __m128 lo = _mm_add_ps(_mm256_extractf128_ps(sum, 1),
+                           _mm256_castps256_ps128(sum));
+    lo = _mm_hadd_ps(lo, lo);
+    lo = _mm_hadd_ps(lo, lo);
+    float square_sum = _mm_cvtss_f32(lo);
+    for (int j = end; j < right; ++j) {
+      square_sum += row[j] * row[j];
+    }
+
+    const float rstd =
+        1.f / std::sqrt(square_sum / static_cast<float>(right) + epsilon);
+    __m256 rstd_vec = _mm256_set1_ps(rstd);
+    for (int j = 0; j < end; j += block) {
+      __m256 tmp = _mm256_mul_ps(_mm256_loadu_ps(row + j), rstd_vec);
+      tmp = _mm256_mul_ps(tmp, _mm256_loadu_ps(scale + j));
+      if (bias) {
+        tmp = _mm256_add_ps(tmp, _mm256_loadu_ps(bias + j));
+      }
+      _mm256_storeu_ps(out_row + j, tmp);
+    }
+    for (int j = end; j < right; ++j) {
+      out_row[j] = row[j] * rstd * scale[j] + (bias ? bias[j] : 0.f);
+    }
+  }
+}
+
+bool RMSNormKernel::CanBeUsed(const int& d) const {
+  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
+         d >= YMM_FLOAT_BLOCK;
+}
+
+}  // namespace intrinsic
+}  // namespace more
+}  // namespace jit
+}  // namespace phi
+
+namespace intrinsic = phi::jit::more::intrinsic;
+
+REGISTER_JITKERNEL_MORE(kRMSNorm, intrinsic, intrinsic::RMSNormKernel);
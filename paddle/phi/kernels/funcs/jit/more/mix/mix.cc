@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/funcs/jit/more/mix/mix.h"
 
+#include <algorithm>
+
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
@@ -58,12 +60,93 @@ void (*getActFunc(KernelType type, int d))(const T*, T*, int) {  // NOLINT
     return KernelFuncs<VTanhTuple<T>, CPUPlace>::Cache().At(d);
   } else if (type == kVIdentity) {
     return KernelFuncs<VIdentityTuple<T>, CPUPlace>::Cache().At(d);
+  } else if (type == kVGelu) {
+    return KernelFuncs<VGeluTuple<T>, CPUPlace>::Cache().At(d);
+  } else if (type == kVGeluTanh) {
+    return KernelFuncs<VGeluTanhTuple<T>, CPUPlace>::Cache().At(d);
   }
   PADDLE_THROW(phi::errors::Unimplemented(
       "Act JIT kernel do not support type: %s", type));
   return nullptr;
 }
 
+void Softmax(const T* x, T* y, int n, int bs) {
+  // hmax and hsum loop over the row, while the code of the others grows with
+  // their length, so they run in blocks of a wide row.
+  constexpr int block = 256;
+  int bn = std::min(n, block);
+  int end = n - n % bn;
+  int rest = n - end;
+  auto compute_hmax = KernelFuncs<HMaxTuple<T>, CPUPlace>::Cache().At(n);
+  auto compute_hsum = KernelFuncs<HSumTuple<T>, CPUPlace>::Cache().At(n);
+  auto compute_vscal = KernelFuncs<VScalTuple<T>, CPUPlace>::Cache().At(bn);
+  auto compute_vaddbias =
+      KernelFuncs<VAddBiasTuple<T>, CPUPlace>::Cache().At(bn);
+  auto compute_vexp = KernelFuncs<VExpTuple<T>, CPUPlace>::Cache().At(bn);
+  auto compute_vscal_rest =
+      rest > 0 ? KernelFuncs<VScalTuple<T>, CPUPlace>::Cache().At(rest)
+               : nullptr;
+  auto compute_vaddbias_rest =
+      rest > 0 ? KernelFuncs<VAddBiasTuple<T>, CPUPlace>::Cache().At(rest)
+               : nullptr;
+  auto compute_vexp_rest =
+      rest > 0 ? KernelFuncs<VExpTuple<T>, CPUPlace>::Cache().At(rest)
+               : nullptr;
+
+  for (int i = 0; i < bs; ++i) {
+    T scalar;
+    compute_hmax(x, &scalar, n);
+    scalar = static_cast<T>(0) - scalar;
+    for (int j = 0; j < end; j += bn) {
+      compute_vaddbias(&scalar, x + j, y + j, bn);  // x - max
+      compute_vexp(y + j, y + j, bn);
+    }
+    if (rest > 0) {
+      compute_vaddbias_rest(&scalar, x + end, y + end, rest);
+      compute_vexp_rest(y + end, y + end, rest);
+    }
+    compute_hsum(y, &scalar, n);
+    scalar = static_cast<T>(1) / scalar;
+    for (int j = 0; j < end; j += bn) {
+      compute_vscal(&scalar, y + j, y + j, bn);
+    }
+    if (rest > 0) {
+      compute_vscal_rest(&scalar, y + end, y + end, rest);
+    }
+    x += n;
+    y += n;
+  }
+}
+
+void VBiasAct(
+    const T* x, const T* bias, T* y, int h, const bias_act_attr_t* attr) {
+  // The code of the jit kernels grows with their length, so a wide row runs
+  // in blocks, which also stay in cache between the add and the act.
+  constexpr int block = 256;
+  int w = attr->w;
+  int bw = std::min(w, block);
+  int end = w - w % bw;
+  int rest = w - end;
+  auto compute_vadd = KernelFuncs<VAddTuple<T>, CPUPlace>::Cache().At(bw);
+  auto compute_act = getActFunc(attr->act, bw);
+  auto compute_vadd_rest =
+      rest > 0 ? KernelFuncs<VAddTuple<T>, CPUPlace>::Cache().At(rest)
+               : nullptr;
+  auto compute_act_rest = rest > 0 ? getActFunc(attr->act, rest) : nullptr;
+  for (int i = 0; i < h; ++i) {
+    for (int j = 0; j < end; j += bw) {
+      compute_vadd(x + j, bias + j, y + j, bw);
+      compute_act(y + j, y + j, bw);
+    }
+    if (rest > 0) {
+      compute_vadd_rest(x + end, bias + end, y + end, rest);
+      compute_act_rest(y + end, y + end, rest);
+    }
+    x += w;
+    y += w;
+  }
+}
+
 void LSTMCtHt(lstm_t* step, const lstm_attr_t* attr) {
   T* gates = reinterpret_cast<T*>(step->gates);
   const T* ct_1 = reinterpret_cast<const T*>(step->ct_1);
@@ -186,6 +269,12 @@ bool VSigmoidKernel::CanBeUsed(const int& d) const { return true; }
 
 bool VTanhKernel::CanBeUsed(const int& d) const { return true; }
 
+bool SoftmaxKernel::CanBeUsed(const int& d) const { return true; }
+
+bool VBiasActKernel::CanBeUsed(const bias_act_attr_t& attr) const {
+  return true;
+}
+
 bool LSTMCtHtKernel::CanBeUsed(const lstm_attr_t& attr) const { return true; }
 
 bool LSTMC1H1Kernel::CanBeUsed(const lstm_attr_t& attr) const { return true; }
@@ -208,6 +297,8 @@ namespace mix = phi::jit::more::mix;
 
 REGISTER_MORE_KERNEL(VSigmoid);
 REGISTER_MORE_KERNEL(VTanh);
+REGISTER_MORE_KERNEL(Softmax);
+REGISTER_MORE_KERNEL(VBiasAct);
 REGISTER_MORE_KERNEL(LSTMCtHt);
 REGISTER_MORE_KERNEL(LSTMC1H1);
 REGISTER_MORE_KERNEL(GRUH1);
@@ -26,6 +26,9 @@ using T = float;
 
 void VSigmoid(const T* x, T* y, int n);
 void VTanh(const T* x, T* y, int n);
+void Softmax(const T* x, T* y, int n, int bs);
+void VBiasAct(
+    const T* x, const T* bias, T* y, int h, const bias_act_attr_t* attr);
 
 void LSTMCtHt(lstm_t* step, const lstm_attr_t* attr);
 void LSTMC1H1(lstm_t* step, const lstm_attr_t* attr);
@@ -45,6 +48,9 @@ void GRUHtPart2(gru_t* step, const gru_attr_t* attr);
 DECLARE_MORE_KERNEL(VSigmoid);
 DECLARE_MORE_KERNEL(VTanh);
 
+DECLARE_MORE_KERNEL(Softmax);
+DECLARE_MORE_KERNEL(VBiasAct);
+
 // XRN
 DECLARE_MORE_KERNEL(LSTMCtHt);
 DECLARE_MORE_KERNEL(LSTMC1H1);
@@ -22,21 +22,33 @@ namespace refer = phi::jit::refer;
   REGISTER_JITKERNEL_REFER(         \
       k##func, refer::func##Kernel<float>, refer::func##Kernel<double>)
 
-REGISTER_REFER_KERNEL(VMul);
-REGISTER_REFER_KERNEL(VAdd);
+// the kernels with bfloat16, all with jitcode but VGeluTanh
+#define REGISTER_REFER_KERNEL_WITH_BF16(func)           \
+  REGISTER_JITKERNEL_REFER(k##func,                     \
+                           refer::func##Kernel<float>,  \
+                           refer::func##Kernel<double>, \
+                           refer::func##Kernel<phi::dtype::bfloat16>)
+
+REGISTER_REFER_KERNEL_WITH_BF16(VMul);
+REGISTER_REFER_KERNEL_WITH_BF16(VAdd);
 REGISTER_REFER_KERNEL(VAddRelu);
 REGISTER_REFER_KERNEL(VSub);
 
 REGISTER_REFER_KERNEL(VScal);
 REGISTER_REFER_KERNEL(VAddBias);
 
-REGISTER_REFER_KERNEL(VRelu);
+REGISTER_REFER_KERNEL_WITH_BF16(VRelu);
 REGISTER_REFER_KERNEL(VCopy);
 REGISTER_REFER_KERNEL(VIdentity);
 REGISTER_REFER_KERNEL(VSquare);
-REGISTER_REFER_KERNEL(VExp);
-REGISTER_REFER_KERNEL(VSigmoid);
-REGISTER_REFER_KERNEL(VTanh);
+REGISTER_REFER_KERNEL_WITH_BF16(VExp);
+REGISTER_REFER_KERNEL_WITH_BF16(VSigmoid);
+REGISTER_REFER_KERNEL_WITH_BF16(VTanh);
+REGISTER_REFER_KERNEL_WITH_BF16(VGelu);
+REGISTER_REFER_KERNEL_WITH_BF16(VGeluTanh);
+
+REGISTER_REFER_KERNEL(HMax);
+REGISTER_REFER_KERNEL(HSum);
 
 REGISTER_REFER_KERNEL(LSTMCtHt);
 REGISTER_REFER_KERNEL(LSTMC1H1);
@@ -47,8 +59,12 @@ REGISTER_REFER_KERNEL(GRUHtPart2);
 
 REGISTER_REFER_KERNEL(CRFDecoding);
 REGISTER_REFER_KERNEL(LayerNorm);
+REGISTER_REFER_KERNEL(RMSNorm);
+REGISTER_REFER_KERNEL(Softmax);
+REGISTER_REFER_KERNEL(VBiasAct);
 REGISTER_REFER_KERNEL(SeqPool);
-REGISTER_REFER_KERNEL(MatMul);
+REGISTER_REFER_KERNEL_WITH_BF16(MatMul);
+REGISTER_JITKERNEL_REFER(kMatMulInt8, refer::MatMulInt8Kernel<int8_t>);
 REGISTER_REFER_KERNEL(EmbSeqPool);
 REGISTER_REFER_KERNEL(Adam);
 REGISTER_REFER_KERNEL(AdamW);
@@ -56,3 +72,4 @@ REGISTER_REFER_KERNEL(Sgd);
 REGISTER_REFER_KERNEL(VBroadcast);
 
 #undef REGISTER_REFER_KERNEL
+#undef REGISTER_REFER_KERNEL_WITH_BF16
@@ -15,9 +15,13 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <string>
+#include <vector>
 
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/kernels/funcs/jit/helper.h"
 #include "paddle/phi/kernels/funcs/jit/kernel_base.h"
@@ -135,6 +139,25 @@ void VTanh(const T* x, T* y, int n) {
   }
 }
 
+template <typename T>
+void VGelu(const T* x, T* y, int n) {
+  // y = 0.5 * x * (1 + erf(x / sqrt(2)))
+  for (int i = 0; i < n; ++i) {
+    y[i] = static_cast<T>(0.5) * x[i] *
+           (static_cast<T>(1) + std::erf(x[i] * static_cast<T>(M_SQRT1_2)));
+  }
+}
+
+template <typename T>
+void VGeluTanh(const T* x, T* y, int n) {
+  // y = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+  for (int i = 0; i < n; ++i) {
+    T inner = static_cast<T>(GELU_TANH_SCALE) *
+              (x[i] + static_cast<T>(GELU_TANH_CUBIC) * x[i] * x[i] * x[i]);
+    y[i] = static_cast<T>(0.5) * x[i] * (static_cast<T>(1) + std::tanh(inner));
+  }
+}
+
 template <typename T>
 void (*getActFunc(KernelType type))(const T*, T*, int) {  // NOLINT
   if (type == kVSigmoid) {
@@ -145,12 +168,64 @@ void (*getActFunc(KernelType type))(const T*, T*, int) {  // NOLINT
     return VTanh<T>;
   } else if (type == kVIdentity) {
     return VIdentity<T>;
+  } else if (type == kVGelu) {
+    return VGelu<T>;
+  } else if (type == kVGeluTanh) {
+    return VGeluTanh<T>;
   }
   PADDLE_THROW(phi::errors::Unimplemented(
       "Act JIT kernel do not support type: %s.", type));
   return nullptr;
 }
 
+// res = max(x)
+template <typename T>
+void HMax(const T* x, T* res, int n) {
+  res[0] = x[0];
+  for (int i = 1; i < n; ++i) {
+    res[0] = res[0] < x[i] ? x[i] : res[0];
+  }
+}
+
+// res = sum(x)
+template <typename T>
+void HSum(const T* x, T* res, int n) {
+  res[0] = x[0];
+  for (int i = 1; i < n; ++i) {
+    res[0] += x[i];
+  }
+}
+
+// x shape: (bs, n), softmax over every row
+template <typename T>
+void Softmax(const T* x, T* y, int n, int bs) {
+  for (int i = 0; i < bs; ++i) {
+    T scalar;
+    HMax(x, &scalar, n);
+    scalar = static_cast<T>(0) - scalar;
+    VAddBias(&scalar, x, y, n);  // x - max
+    VExp(y, y, n);
+    HSum(y, &scalar, n);
+    scalar = static_cast<T>(1) / scalar;
+    VScal(&scalar, y, y, n);
+    x += n;
+    y += n;
+  }
+}
+
+// x shape: (h, w), y = act(x + bias) with bias of shape (w)
+template <typename T>
+void VBiasAct(
+    const T* x, const T* bias, T* y, int h, const bias_act_attr_t* attr) {
+  auto act = getActFunc<T>(attr->act);
+  for (int i = 0; i < h; ++i) {
+    VAdd(x, bias, y, attr->w);
+    act(y, y, attr->w);
+    x += attr->w;
+    y += attr->w;
+  }
+}
+
 // TODO(TJ): add refer gemm and make LSTM kernels combine as same GRU kernels
 
 // compute ct and ht
@@ -353,6 +428,30 @@ void LayerNorm(T* x,
   }
 }
 
+// out = x / sqrt(mean(x^2) + epsilon) * scale + bias, every row of right
+template <typename T>
+void RMSNorm(const T* x,
+             T* out,
+             const T* scale,
+             const T* bias,
+             int height,
+             const float epsilon,
+             int right) {
+  for (int i = 0; i < height; ++i) {
+    const T* row = x + i * right;
+    T* out_row = out + i * right;
+    T sum = 0;
+    for (int j = 0; j < right; ++j) {
+      sum += row[j] * row[j];
+    }
+    T rstd = static_cast<T>(1) /
+             std::sqrt(sum / right + static_cast<T>(epsilon));
+    for (int j = 0; j < right; ++j) {
+      out_row[j] = row[j] * rstd * scale[j] + (bias ? bias[j] : 0);
+    }
+  }
+}
+
 template <typename T>
 void SeqPool(const T* x, T* y, const seq_pool_attr_t* attr) {
   for (int w = 0; w < attr->w; ++w) {
@@ -562,6 +661,115 @@ void AdamW(T beta1,
   }
 }
 
+// A(M,K) * B(K,N) = C(M,N) of uint8 A and int8 B, accumulated in int32.
+// B is packed by pack_int8_weights.
+template <typename T>
+void MatMulInt8(const uint8_t* A,
+                const T* B,
+                int32_t* C,
+                const matmul_attr_t* attr) {
+  int M = attr->m;
+  int N = attr->n;
+  int K = attr->k;
+  for (int m = 0; m < M; ++m) {
+    const uint8_t* pa = A + m * K;
+    int32_t* pc = C + m * N;
+    for (int n = 0; n < N; ++n) {
+      int32_t sum = 0;
+      for (int k = 0; k < K; ++k) {
+        sum += static_cast<int32_t>(pa[k]) *
+               static_cast<int32_t>(B[(k / 4) * N * 4 + n * 4 + k % 4]);
+      }
+      pc[n] = sum;
+    }
+  }
+}
+
+// Rounds value to the nearest bfloat16 with ties to even, as the jitcode
+// stores it, while the constructor of bfloat16 truncates on CPU.
+inline phi::dtype::bfloat16 RoundToBF16(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if (std::isnan(value)) {
+    // keep it a quiet NaN
+    return phi::dtype::raw_uint16_to_bfloat16(
+        static_cast<uint16_t>((bits >> 16) | 0x40));
+  }
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return phi::dtype::raw_uint16_to_bfloat16(static_cast<uint16_t>(bits >> 16));
+}
+
+// The bfloat16 kernels compute in float, as the jitcode does.
+template <typename Func>
+void BF16XYN(Func func,
+             const phi::dtype::bfloat16* x,
+             phi::dtype::bfloat16* y,
+             int n) {
+  std::vector<float> buf(n);
+  for (int i = 0; i < n; ++i) {
+    buf[i] = static_cast<float>(x[i]);
+  }
+  func(buf.data(), buf.data(), n);
+  for (int i = 0; i < n; ++i) {
+    y[i] = RoundToBF16(buf[i]);
+  }
+}
+
+template <>
+inline void VMul<phi::dtype::bfloat16>(const phi::dtype::bfloat16* x,
+                                       const phi::dtype::bfloat16* y,
+                                       phi::dtype::bfloat16* z,
+                                       int n) {
+  for (int i = 0; i < n; ++i) {
+    z[i] = RoundToBF16(static_cast<float>(x[i]) * static_cast<float>(y[i]));
+  }
+}
+
+template <>
+inline void VAdd<phi::dtype::bfloat16>(const phi::dtype::bfloat16* x,
+                                       const phi::dtype::bfloat16* y,
+                                       phi::dtype::bfloat16* z,
+                                       int n) {
+  for (int i = 0; i < n; ++i) {
+    z[i] = RoundToBF16(static_cast<float>(x[i]) + static_cast<float>(y[i]));
+  }
+}
+
+#define DEFINE_BF16_XYN(name)                                          \
+  template <>                                                          \
+  inline void name<phi::dtype::bfloat16>(                              \
+      const phi::dtype::bfloat16* x, phi::dtype::bfloat16* y, int n) { \
+    BF16XYN(name<float>, x, y, n);                                     \
+  }
+
+DEFINE_BF16_XYN(VRelu);
+DEFINE_BF16_XYN(VExp);
+DEFINE_BF16_XYN(VSigmoid);
+DEFINE_BF16_XYN(VTanh);
+DEFINE_BF16_XYN(VGelu);
+DEFINE_BF16_XYN(VGeluTanh);
+
+#undef DEFINE_BF16_XYN
+
+template <>
+inline void MatMul<phi::dtype::bfloat16>(const phi::dtype::bfloat16* A,
+                                         const phi::dtype::bfloat16* B,
+                                         phi::dtype::bfloat16* C,
+                                         const matmul_attr_t* attr) {
+  std::vector<float> a(attr->m * attr->k), b(attr->k * attr->n);
+  std::vector<float> c(attr->m * attr->n);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<float>(A[i]);
+  }
+  for (size_t i = 0; i < b.size(); ++i) {
+    b[i] = static_cast<float>(B[i]);
+  }
+  MatMul<float>(a.data(), b.data(), c.data(), attr);
+  for (size_t i = 0; i < c.size(); ++i) {
+    C[i] = RoundToBF16(c[i]);
+  }
+}
+
 #define DECLARE_REFER_KERNEL(name)                          \
   template <typename T>                                     \
   class name##Kernel : public ReferKernel<name##Tuple<T>> { \
@@ -587,6 +795,12 @@ DECLARE_REFER_KERNEL(VSigmoid);
 DECLARE_REFER_KERNEL(VTanh);
 DECLARE_REFER_KERNEL(VSquare);
 DECLARE_REFER_KERNEL(VCopy);
+DECLARE_REFER_KERNEL(VGelu);
+DECLARE_REFER_KERNEL(VGeluTanh);
+
+// const T* x, T* res, int n
+DECLARE_REFER_KERNEL(HMax);
+DECLARE_REFER_KERNEL(HSum);
 
 // lstm_t*, const lstm_attr_t*
 DECLARE_REFER_KERNEL(LSTMCtHt);
@@ -600,8 +814,12 @@ DECLARE_REFER_KERNEL(GRUHtPart2);
 // others
 DECLARE_REFER_KERNEL(CRFDecoding);
 DECLARE_REFER_KERNEL(LayerNorm);
+DECLARE_REFER_KERNEL(RMSNorm);
+DECLARE_REFER_KERNEL(Softmax);
+DECLARE_REFER_KERNEL(VBiasAct);
 DECLARE_REFER_KERNEL(SeqPool);
 DECLARE_REFER_KERNEL(MatMul);
+DECLARE_REFER_KERNEL(MatMulInt8);
 DECLARE_REFER_KERNEL(EmbSeqPool);
 DECLARE_REFER_KERNEL(Adam);
 DECLARE_REFER_KERNEL(AdamW);
@@ -12,13 +12,16 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <iostream>
 #include <random>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
@@ -1048,6 +1051,165 @@ void TestKernelVBroadcast() {
   }
 }
 
+template <typename KernelTuple, typename PlaceType>
+void TestKernelXRN() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  for (int d : TestSizes()) {
+    auto ref = jit::GetReferFunc<KernelTuple>();
+    EXPECT_TRUE(ref != nullptr);
+    std::vector<T> x(d);
+    RandomVec<T>(d, x.data());
+    T ref_res;
+    ref(x.data(), &ref_res, d);
+    // the lanes are reduced in another order than the refer code
+    T abs_sum = 0;
+    for (T v : x) {
+      abs_sum += std::abs(v);
+    }
+    auto verifier = [](const typename KernelTuple::func_type tgt,
+                       const std::vector<T>& x,
+                       const T ref_res,
+                       const T abs_sum) {
+      EXPECT_TRUE(tgt != nullptr);
+      T tgt_res;
+      tgt(x.data(), &tgt_res, x.size());
+      EXPECT_NEAR(tgt_res, ref_res, FLAGS_acc * std::max<T>(1, abs_sum));
+    };
+    TestAllImpls<KernelTuple, PlaceType>(d, verifier, x, ref_res, abs_sum);
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelSoftmax() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  for (int bs : {1, 2, 10}) {
+    for (int n : TestSizes()) {
+      auto ref = jit::GetReferFunc<KernelTuple>();
+      EXPECT_TRUE(ref != nullptr);
+      std::vector<T> x(bs * n), y(bs * n);
+      RandomVec<T>(bs * n, x.data());
+      ref(x.data(), y.data(), n, bs);
+      // test refer code inplace
+      std::vector<T> xinp(x);
+      ref(xinp.data(), xinp.data(), n, bs);
+      ExpectEQ<T>(xinp.data(), y.data(), n * bs);
+
+      auto verifier = [](const typename KernelTuple::func_type tgt,
+                         const std::vector<T>& x,
+                         const std::vector<T>& yref,
+                         int n,
+                         int bs) {
+        EXPECT_TRUE(tgt != nullptr);
+        std::vector<T> ytgt(yref.size());
+        tgt(x.data(), ytgt.data(), n, bs);
+        ExpectEQ<T>(ytgt.data(), yref.data(), n * bs);
+        // test inplace x
+        std::copy(x.begin(), x.end(), ytgt.begin());
+        tgt(ytgt.data(), ytgt.data(), n, bs);
+        ExpectEQ<T>(ytgt.data(), yref.data(), n * bs);
+      };
+      TestAllImpls<KernelTuple, PlaceType>(n, verifier, x, y, n, bs);
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelRMSNorm() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  const float epsilon = 1e-6f;
+  for (int height : {1, 9, 50}) {
+    for (int right : TestSizes()) {
+      for (bool with_bias : {true, false}) {
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        int sz = height * right;
+        std::vector<T> x(sz), scale(right), bias(right), outref(sz);
+        RandomVec<T>(sz, x.data());
+        RandomVec<T>(right, scale.data());
+        RandomVec<T>(right, bias.data());
+        const T* bias_data = with_bias ? bias.data() : nullptr;
+        ref(x.data(),
+            outref.data(),
+            scale.data(),
+            bias_data,
+            height,
+            epsilon,
+            right);
+
+        auto verifier = [](const typename KernelTuple::func_type tgt,
+                           const std::vector<T>& x,
+                           const std::vector<T>& outref,
+                           const std::vector<T>& scale,
+                           const T* bias,
+                           int height,
+                           float epsilon,
+                           int right) {
+          EXPECT_TRUE(tgt != nullptr);
+          std::vector<T> outtgt(outref.size());
+          tgt(x.data(),
+              outtgt.data(),
+              scale.data(),
+              bias,
+              height,
+              epsilon,
+              right);
+          ExpectEQ<T>(outtgt.data(), outref.data(), outref.size());
+        };
+        TestAllImpls<KernelTuple, PlaceType>(right,
+                                             verifier,
+                                             x,
+                                             outref,
+                                             scale,
+                                             bias_data,
+                                             height,
+                                             epsilon,
+                                             right);
+      }
+    }
+  }
+}
+
+template <typename KernelTuple, typename PlaceType>
+void TestKernelVBiasAct() {
+  using T = typename KernelTuple::data_type;
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  for (auto act :
+       {jit::kVIdentity, jit::kVRelu, jit::kVGelu, jit::kVGeluTanh}) {
+    for (int h : {1, 3, 10}) {
+      for (int w : TestSizes()) {
+        const jit::bias_act_attr_t attr(w, act);
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        std::vector<T> x(h * w), bias(w), yref(h * w);
+        RandomVec<T>(h * w, x.data());
+        RandomVec<T>(w, bias.data());
+        ref(x.data(), bias.data(), yref.data(), h, &attr);
+
+        auto verifier = [](const typename KernelTuple::func_type tgt,
+                           const std::vector<T>& x,
+                           const std::vector<T>& bias,
+                           const std::vector<T>& yref,
+                           int h,
+                           const jit::bias_act_attr_t& attr) {
+          EXPECT_TRUE(tgt != nullptr);
+          std::vector<T> ytgt(yref.size());
+          tgt(x.data(), bias.data(), ytgt.data(), h, &attr);
+          ExpectEQ<T>(ytgt.data(), yref.data(), yref.size());
+          // test inplace x
+          std::copy(x.begin(), x.end(), ytgt.begin());
+          tgt(ytgt.data(), bias.data(), ytgt.data(), h, &attr);
+          ExpectEQ<T>(ytgt.data(), yref.data(), yref.size());
+        };
+        TestAllImpls<KernelTuple, PlaceType>(
+            attr, verifier, x, bias, yref, h, attr);
+      }
+    }
+  }
+}
+
 // test pool
 TEST(JITKernel_pool, jitcreator) {
   const auto& jitcreators = jit::JitCodeCreatorPool::Instance().AllCreators();
@@ -1207,6 +1369,21 @@ TEST(JITKernel_helper, pack_weights) {
   ExpectEQ<float>(y.data(), ref, N * K);
 }
 
+TEST(JITKernel_helper, pack_int8_weights) {
+  const int N = 3, K = 6;
+  std::array<int8_t, N * K> src;
+  for (int i = 0; i < N * K; ++i) {
+    src[i] = static_cast<int8_t>(i + 1);
+  }
+  // every 4 rows are interleaved, and the last 2 rows are padded by zeros
+  std::array<int8_t, N * 8> ref = {1,  4,  7,  10, 2,  5,  8,  11,
+                                   3,  6,  9,  12, 13, 16, 0,  0,
+                                   14, 17, 0,  0,  15, 18, 0,  0};
+  std::array<int8_t, N * 8> y;
+  jit::pack_int8_weights(src.data(), y.data(), N, K);
+  ExpectEQ<int8_t>(y.data(), ref.data(), N * 8);
+}
+
 TEST(JITKernel_helper, attr) {
   std::ostringstream out;
   // KernelTypes
@@ -1404,6 +1581,23 @@ TEST(JITKernel_key, sgd) {
   EXPECT_TRUE(key4 != key5);
 }
 
+TEST(JITKernel_key, bias_act) {
+  jit::bias_act_attr_t attr1(8, jit::kVGelu);
+  jit::bias_act_attr_t attr2(8, jit::kVGelu);
+  jit::bias_act_attr_t attr3(8, jit::kVRelu);
+  jit::bias_act_attr_t attr4(16, jit::kVGelu);
+
+  auto key1 = jit::JitCodeKey<jit::bias_act_attr_t>(attr1);
+  auto key2 = jit::JitCodeKey<jit::bias_act_attr_t>(attr2);
+  auto key3 = jit::JitCodeKey<jit::bias_act_attr_t>(attr3);
+  auto key4 = jit::JitCodeKey<jit::bias_act_attr_t>(attr4);
+
+  EXPECT_TRUE(key1 == key2);
+  EXPECT_TRUE(key2 != key3);
+  EXPECT_TRUE(key2 != key4);
+  EXPECT_TRUE(key3 != key4);
+}
+
 // test kernels
 #define TestKernelVMul TestKernelXYZN
 #define TestKernelVAdd TestKernelXYZN
@@ -1420,6 +1614,11 @@ TEST(JITKernel_key, sgd) {
 #define TestKernelVSigmoid TestKernelXYN
 #define TestKernelVTanh TestKernelXYN
 #define TestKernelVCopy TestKernelXYN
+#define TestKernelVGelu TestKernelXYN
+#define TestKernelVGeluTanh TestKernelXYN
+
+#define TestKernelHMax TestKernelXRN
+#define TestKernelHSum TestKernelXRN
 
 #define TestKernelLSTMCtHt TestKernelLSTM
 #define TestKernelLSTMC1H1 TestKernelLSTM
@@ -1449,6 +1648,11 @@ TEST_CPU_KERNEL(VExp);
 TEST_CPU_KERNEL(VSigmoid);
 TEST_CPU_KERNEL(VTanh);
 TEST_CPU_KERNEL(VCopy);
+TEST_CPU_KERNEL(VGelu);
+TEST_CPU_KERNEL(VGeluTanh);
+
+TEST_CPU_KERNEL(HMax);
+TEST_CPU_KERNEL(HSum);
 
 TEST_CPU_KERNEL(LSTMCtHt);
 TEST_CPU_KERNEL(LSTMC1H1);
@@ -1458,6 +1662,9 @@ TEST_CPU_KERNEL(GRUHtPart1);
 TEST_CPU_KERNEL(GRUHtPart2);
 
 TEST_CPU_KERNEL(LayerNorm);
+TEST_CPU_KERNEL(RMSNorm);
+TEST_CPU_KERNEL(Softmax);
+TEST_CPU_KERNEL(VBiasAct);
 TEST_CPU_KERNEL(CRFDecoding);
 
 TEST_CPU_KERNEL(SeqPool);
@@ -1467,3 +1674,151 @@ TEST_CPU_KERNEL(Adam);
 TEST_CPU_KERNEL(AdamW);
 TEST_CPU_KERNEL(Sgd);
 TEST_CPU_KERNEL(VBroadcast);
+
+using bfloat16 = phi::dtype::bfloat16;
+
+std::vector<bfloat16> RandomBF16Vec(const int n) {
+  std::vector<float> f(n);
+  RandomVec<float>(n, f.data());
+  return std::vector<bfloat16>(f.begin(), f.end());
+}
+
+// Both the jitcode and the refer code round to nearest even. The element-wise
+// arithmetic is exact in float, so only the approximations of the activations
+// and the order of the sums of the matmul may move the result by an ulp.
+void ExpectBF16Ulps(const bfloat16* target,
+                    const bfloat16* refer,
+                    size_t n,
+                    int max_ulps) {
+  // the bits of bfloat16 as integers in the order of their values
+  auto ordered = [](bfloat16 v) {
+    return v.x & 0x8000 ? -static_cast<int>(v.x & 0x7fff)
+                        : static_cast<int>(v.x);
+  };
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_LE(std::abs(ordered(target[i]) - ordered(refer[i])), max_ulps)
+        << static_cast<float>(target[i]) << " vs "
+        << static_cast<float>(refer[i]) << " at index : " << i;
+  }
+}
+
+template <typename KernelTuple>
+void TestKernelBF16XYZN() {
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  for (int d : TestSizes()) {
+    auto ref = jit::GetReferFunc<KernelTuple>();
+    EXPECT_TRUE(ref != nullptr);
+    auto x = RandomBF16Vec(d);
+    auto y = RandomBF16Vec(d);
+    std::vector<bfloat16> zref(d);
+    ref(x.data(), y.data(), zref.data(), d);
+    auto verifier = [](const typename KernelTuple::func_type tgt,
+                       const std::vector<bfloat16>& x,
+                       const std::vector<bfloat16>& y,
+                       const std::vector<bfloat16>& zref) {
+      EXPECT_TRUE(tgt != nullptr);
+      std::vector<bfloat16> ztgt(zref.size());
+      tgt(x.data(), y.data(), ztgt.data(), zref.size());
+      ExpectBF16Ulps(ztgt.data(), zref.data(), zref.size(), 0);
+    };
+    TestAllImpls<KernelTuple, CPUPlace>(d, verifier, x, y, zref);
+  }
+}
+
+template <typename KernelTuple>
+void TestKernelBF16XYN() {
+  VLOG(10) << "Test JITKernel: " << jit::to_string(KernelTuple::kernel_type);
+  for (int d : TestSizes()) {
+    auto ref = jit::GetReferFunc<KernelTuple>();
+    EXPECT_TRUE(ref != nullptr);
+    auto x = RandomBF16Vec(d);
+    std::vector<bfloat16> yref(d);
+    ref(x.data(), yref.data(), d);
+    auto verifier = [](const typename KernelTuple::func_type tgt,
+                       const std::vector<bfloat16>& x,
+                       const std::vector<bfloat16>& yref) {
+      EXPECT_TRUE(tgt != nullptr);
+      std::vector<bfloat16> ytgt(yref.size());
+      tgt(x.data(), ytgt.data(), yref.size());
+      ExpectBF16Ulps(ytgt.data(), yref.data(), yref.size(), 1);
+    };
+    TestAllImpls<KernelTuple, CPUPlace>(d, verifier, x, yref);
+  }
+}
+
+TEST(JITKernel_bf16, VMul) { TestKernelBF16XYZN<jit::VMulTuple<bfloat16>>(); }
+TEST(JITKernel_bf16, VAdd) { TestKernelBF16XYZN<jit::VAddTuple<bfloat16>>(); }
+TEST(JITKernel_bf16, VRelu) { TestKernelBF16XYN<jit::VReluTuple<bfloat16>>(); }
+TEST(JITKernel_bf16, VExp) { TestKernelBF16XYN<jit::VExpTuple<bfloat16>>(); }
+TEST(JITKernel_bf16, VSigmoid) {
+  TestKernelBF16XYN<jit::VSigmoidTuple<bfloat16>>();
+}
+TEST(JITKernel_bf16, VTanh) { TestKernelBF16XYN<jit::VTanhTuple<bfloat16>>(); }
+TEST(JITKernel_bf16, VGelu) { TestKernelBF16XYN<jit::VGeluTuple<bfloat16>>(); }
+TEST(JITKernel_bf16, VGeluTanh) {
+  TestKernelBF16XYN<jit::VGeluTanhTuple<bfloat16>>();
+}
+
+TEST(JITKernel_bf16, MatMul) {
+  using KernelTuple = jit::MatMulTuple<bfloat16>;
+  for (int n : {16, 48, 400, 512}) {
+    for (int k : {1, 7, 31, 100, 511}) {
+      auto ref = jit::GetReferFunc<KernelTuple>();
+      EXPECT_TRUE(ref != nullptr);
+      auto a = RandomBF16Vec(k);
+      auto b = RandomBF16Vec(k * n);
+      std::vector<bfloat16> cref(n);
+      const jit::matmul_attr_t attr{1, n, k};
+      ref(a.data(), b.data(), cref.data(), &attr);
+      auto verifier = [](const typename KernelTuple::func_type tgt,
+                         const std::vector<bfloat16>& a,
+                         const std::vector<bfloat16>& b,
+                         const std::vector<bfloat16>& cref,
+                         const jit::matmul_attr_t& attr) {
+        EXPECT_TRUE(tgt != nullptr);
+        std::vector<bfloat16> c(cref.size());
+        tgt(a.data(), b.data(), c.data(), &attr);
+        ExpectBF16Ulps(c.data(), cref.data(), cref.size(), 1);
+      };
+      TestAllImpls<KernelTuple, CPUPlace>(attr, verifier, a, b, cref, attr);
+    }
+  }
+}
+
+TEST(JITKernel_int8, MatMulInt8) {
+  using KernelTuple = jit::MatMulInt8Tuple<int8_t>;
+  std::mt19937 rng(100);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  for (int n : {16, 48, 400, 512}) {
+    for (int k : {4, 8, 12, 100, 1000}) {
+      std::vector<uint8_t> a(k);
+      std::vector<int8_t> b(k * n), packed((k + 3) / 4 * 4 * n);
+      for (auto& i : a) {
+        i = static_cast<uint8_t>(dist(rng) + 128);
+      }
+      for (auto& i : b) {
+        i = static_cast<int8_t>(dist(rng));
+      }
+      jit::pack_int8_weights(b.data(), packed.data(), n, k);
+      std::vector<int32_t> cref(n, 0);
+      for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < k; ++i) {
+          cref[j] += static_cast<int32_t>(a[i]) * b[i * n + j];
+        }
+      }
+      const jit::matmul_attr_t attr{1, n, k};
+      auto verifier = [](const typename KernelTuple::func_type tgt,
+                         const std::vector<uint8_t>& a,
+                         const std::vector<int8_t>& packed,
+                         const std::vector<int32_t>& cref,
+                         const jit::matmul_attr_t& attr) {
+        EXPECT_TRUE(tgt != nullptr);
+        std::vector<int32_t> c(cref.size());
+        tgt(a.data(), packed.data(), c.data(), &attr);
+        ExpectEQ<int32_t>(c.data(), cref.data(), cref.size());
+      };
+      TestAllImpls<KernelTuple, CPUPlace>(
+          attr, verifier, a, packed, cref, attr);
+    }
+  }
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <math.h>
+
+#include "paddle/phi/kernels/funcs/sorted_segments.h"
+
+namespace phi {
+namespace funcs {
+
+// Calls update(i) for every row i of a merged SelectedRows gradient of
+// row_count rows of row_numel elements. The rows of a merged gradient are
+// unique, so that every row of the parameter is updated by one thread.
+template <typename Update>
+void ForEachSparseRow(int64_t row_count,
+                      int64_t row_numel,
+                      const Update& update) {
+  const int threads = SegmentThreads(row_count * row_numel);
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel for num_threads(threads)
+#endif
+  for (int64_t i = 0; i < row_count; ++i) {
+    update(i);
+  }
+}
+
+// The lazy Adam update of a row of the gradient, which reads and writes the
+// row of the parameter and of both moments in the same loop. With a nonzero
+// decay, the row of the parameter is first decayed by (1 - decay), which is
+// the decoupled weight decay of AdamW.
+template <typename T>
+class LazyAdamRowUpdate {
+ public:
+  LazyAdamRowUpdate(T beta1,
+                    T beta2,
+                    T epsilon,
+                    T lr,
+                    T beta1_pow,
+                    T beta2_pow,
+                    T decay,
+                    const T* grad,
+                    const T* mom1,
+                    T* mom1_out,
+                    const T* mom2,
+                    T* mom2_out,
+                    const T* param,
+                    T* param_out,
+                    const int64_t* rows,
+                    int64_t row_numel)
+      : beta1_(beta1),
+        beta2_(beta2),
+        epsilon_(epsilon * sqrt(1 - beta2_pow)),
+        lr_(lr * sqrt(1 - beta2_pow) / (1 - beta1_pow)),
+        decay_(decay),
+        grad_(grad),
+        moment1_(mom1),
+        moment1_out_(mom1_out),
+        moment2_(mom2),
+        moment2_out_(mom2_out),
+        param_(param),
+        param_out_(param_out),
+        rows_(rows),
+        row_numel_(row_numel) {}
+
+  void operator()(int64_t i) const {
+    const T* g = grad_ + i * row_numel_;
+    const int64_t offset = rows_[i] * row_numel_;
+    for (int64_t k = 0; k < row_numel_; ++k) {
+      T mom1 = beta1_ * moment1_[offset + k] + (1 - beta1_) * g[k];
+      T mom2 = beta2_ * moment2_[offset + k] + (1 - beta2_) * g[k] * g[k];
+      T p = param_[offset + k];
+      if (decay_ != static_cast<T>(0)) {
+        p -= decay_ * p;
+      }
+      p -= lr_ * (mom1 / (sqrt(mom2) + epsilon_));
+      moment1_out_[offset + k] = mom1;
+      moment2_out_[offset + k] = mom2;
+      param_out_[offset + k] = p;
+    }
+  }
+
+ private:
+  T beta1_;
+  T beta2_;
+  T epsilon_;
+  T lr_;
+  T decay_;
+
+  const T* grad_;
+  const T* moment1_;
+  T* moment1_out_;
+  const T* moment2_;
+  T* moment2_out_;
+  const T* param_;
+  T* param_out_;
+
+  const int64_t* rows_;
+  int64_t row_numel_;
+};
+
+// The Adagrad update of a row of the gradient, which accumulates the square
+// of the gradient into the row of the moment and updates the row of the
+// parameter in the same loop.
+template <typename T>
+class AdagradRowUpdate {
+ public:
+  AdagradRowUpdate(T lr,
+                   T epsilon,
+                   const T* grad,
+                   T* moment,
+                   T* param,
+                   const int64_t* rows,
+                   int64_t row_numel)
+      : lr_(lr),
+        epsilon_(epsilon),
+        grad_(grad),
+        moment_(moment),
+        param_(param),
+        rows_(rows),
+        row_numel_(row_numel) {}
+
+  void operator()(int64_t i) const {
+    const T* g = grad_ + i * row_numel_;
+    const int64_t offset = rows_[i] * row_numel_;
+    for (int64_t k = 0; k < row_numel_; ++k) {
+      T mom = moment_[offset + k] + g[k] * g[k];
+      moment_[offset + k] = mom;
+      param_[offset + k] -= lr_ * g[k] / (sqrt(mom) + epsilon_);
+    }
+  }
+
+ private:
+  T lr_;
+  T epsilon_;
+
+  const T* grad_;
+  T* moment_;
+  T* param_;
+
+  const int64_t* rows_;
+  int64_t row_numel_;
+};
+
+}  // namespace funcs
+}  // namespace phi
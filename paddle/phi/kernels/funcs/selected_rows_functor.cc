@@ -21,15 +21,12 @@ limitations under the License. */
 
 #include "paddle/phi/core/ddim.h"
 #include "paddle/phi/core/mixed_vector.h"
+#include "paddle/phi/kernels/funcs/sorted_segments.h"
 
 #ifdef PADDLE_WITH_XPU
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
 #endif
 
-#ifdef PADDLE_WITH_DNNL
-#include "paddle/phi/backends/onednn/axpy_handler.h"
-#endif
-
 #include "glog/logging.h"
 
 namespace phi {
@@ -431,70 +428,6 @@ typename std::enable_if<std::is_integral<T>::value>::type elementwise_add_to(
   }
 }
 
-template <typename T, typename DeviceContext>
-typename std::enable_if<std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-#ifndef PADDLE_WITH_DNNL
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-#endif
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-#ifdef PADDLE_WITH_DNNL
-    OneDNNContext onednn_context(context.GetPlace());
-    funcs::OneDNNAXPYHandler<T> axpy_handler(
-        input_width, T(1.f), onednn_context.GetEngine());
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      axpy_handler(&input_data[i * input_width],
-                   &out_data[out_i * input_width]);
-    }
-#else
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
-    }
-#endif
-  }
-}
-
-template <typename T, typename DeviceContext>
-typename std::enable_if<!std::is_same<T, phi::dtype::bfloat16>::value>::type
-add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
-                  int64_t input_width,
-                  const DeviceContext& context,
-                  T* out_data) {
-  VLOG(4) << "[CPU] add_sparse_inputs <" << typeid(T).name();
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
-    }
-  }
-}
-
 template <typename DeviceContext, typename T>
 struct MergeAddImpl {
   phi::SelectedRows operator()(const DeviceContext& context,
@@ -536,8 +469,9 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
-    size_t row_num = 0;
+    // the rows of all the inputs, and the data of every row
+    std::vector<int64_t> input_rows;
+    std::vector<const T*> input_row_data;
     for (auto* input : inputs) {
       if (input->rows().empty()) {
         continue;
@@ -551,26 +485,28 @@ struct MergeAddImpl {
           input_height,
           input->height(),
           phi::errors::InvalidArgument("All inputs should have same height."));
-      row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
+      auto* input_data = input->value().data<T>();
+      for (size_t i = 0; i < input->rows().size(); ++i) {
+        input_rows.push_back(input->rows()[i]);
+        input_row_data.push_back(input_data + i * input_width);
+      }
     }
+    size_t row_num = input_rows.size();
+
+    // The rows are merged by the sorted segments of the row ids, in parallel
+    // and without hashing the ids.
+    SortedSegments segments;
+    SortIntoSegments(
+        input_rows.data(), static_cast<int64_t>(row_num), &segments);
 
     out.set_height(input_height);
     DenseTensor* out_tensor = out.mutable_value();
-    out_tensor->Resize(phi::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+    out_tensor->Resize(phi::make_ddim({segments.size(), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (segments.ids.size() == row_num && !sorted_result) {
       // no duplicated ids, just concat the result together
-      std::vector<int64_t> merge_rows;
-      merge_rows.reserve(row_num);
-      // concat rows
-      for (auto* in : inputs) {
-        merge_rows.insert(
-            merge_rows.end(), in->rows().begin(), in->rows().end());
-      }
-      out.set_rows(merge_rows);
+      out.set_rows(input_rows);
       auto in_place = inputs[0]->place();
       auto out_place = out.place();
       int64_t copied_numel = 0;
@@ -585,25 +521,12 @@ struct MergeAddImpl {
         copied_numel += static_cast<int64_t>(in_numel);
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
-      }
-
-      out.set_rows(merge_rows);
-
-      phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-      constant_functor(context, out.mutable_value(), static_cast<T>(0.f));
-
-      std::unordered_map<int64_t, size_t> rows_to_id;
-      for (size_t i = 0; i < merge_rows.size(); ++i) {
-        rows_to_id[merge_rows[i]] = i;
-      }
-
-      add_sparse_inputs<T, DeviceContext>(
-          inputs, rows_to_id, input_width, context, out_data);
+      out.set_rows(segments.ids);
+      SegmentSum<T>(
+          segments,
+          input_width,
+          [&](int64_t i) { return input_row_data[i]; },
+          [&](int64_t s) { return out_data + s * input_width; });
     }
   }
 };
@@ -23,6 +23,7 @@ limitations under the License. */
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/cpu_vec.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
 
 namespace phi {
 namespace funcs {
@@ -245,8 +246,14 @@ class SoftmaxFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
     const int batch_size = in_dims[kBatchDim];
     const int num_remain = num_classes / axis_dim;
 
-    if (num_remain == 1 &&
-        phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
+    if (num_remain == 1 && std::is_same<T, float>::value) {
+      // The jit softmax keeps every row in cache over its passes.
+      auto compute_softmax =
+          jit::KernelFuncs<jit::SoftmaxTuple<T>, phi::CPUPlace>::Cache().At(
+              num_classes);
+      compute_softmax(X->data<T>(), Y->data<T>(), num_classes, batch_size);
+    } else if (num_remain == 1 &&
+               phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
       const T* in_data = X->data<T>();
       T* out_data = Y->data<T>();
       for (int bs = 0; bs < batch_size; ++bs) {
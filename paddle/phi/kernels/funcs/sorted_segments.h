@@ -0,0 +1,236 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/kernels/funcs/cpu_parallel.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+
+namespace phi {
+namespace funcs {
+
+// The positions of the ids grouped by the id. ids holds the unique ids in
+// ascending order, and the positions of ids[i] are order[offsets[i]] ...
+// order[offsets[i + 1] - 1], in ascending order.
+struct SortedSegments {
+  std::vector<int64_t> ids;
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> order;
+
+  int64_t size() const { return static_cast<int64_t>(ids.size()); }
+  int64_t length(int64_t i) const { return offsets[i + 1] - offsets[i]; }
+};
+
+inline int SegmentThreads(int64_t work) {
+  return CPUParallelThreads(work, /*min_work_per_thread=*/4096);
+}
+
+// Groups the positions of the ids, except the ones equal to *skip_id when it
+// is given, by the stable LSD radix sort of the ids less the smallest id.
+// Every pass sorts 8 bits with the histograms of the slices of the threads,
+// and the passes stop at the highest byte of the range of the ids, which is
+// much cheaper than hashing the ids of a large table.
+inline void SortIntoSegments(const int64_t* ids,
+                             int64_t n,
+                             SortedSegments* segments,
+                             const int64_t* skip_id = nullptr) {
+  std::vector<int64_t> order;
+  order.reserve(n);
+  int64_t min_id = 0, max_id = 0;
+  for (int64_t i = 0; i < n; ++i) {
+    if (skip_id == nullptr || ids[i] != *skip_id) {
+      if (order.empty()) {
+        min_id = max_id = ids[i];
+      }
+      min_id = std::min(min_id, ids[i]);
+      max_id = std::max(max_id, ids[i]);
+      order.push_back(i);
+    }
+  }
+  n = static_cast<int64_t>(order.size());
+  // the unsigned offsets from the smallest id keep the order of any ids
+  std::vector<uint64_t> keys(n);
+  for (int64_t i = 0; i < n; ++i) {
+    keys[i] = static_cast<uint64_t>(ids[order[i]]) -
+              static_cast<uint64_t>(min_id);
+  }
+  const uint64_t range =
+      static_cast<uint64_t>(max_id) - static_cast<uint64_t>(min_id);
+
+  constexpr int kRadixBits = 8;
+  constexpr int kRadix = 1 << kRadixBits;
+  const int threads = SegmentThreads(n);
+  std::vector<uint64_t> tmp_keys(n);
+  std::vector<int64_t> tmp_order(n);
+  std::vector<int64_t> offsets(threads * kRadix);
+  for (int shift = 0; shift < 64 && (range >> shift) > 0;
+       shift += kRadixBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel for num_threads(threads)
+#endif
+    for (int t = 0; t < threads; ++t) {
+      int64_t* count = offsets.data() + t * kRadix;
+      for (int64_t i = n * t / threads; i < n * (t + 1) / threads; ++i) {
+        ++count[(keys[i] >> shift) & (kRadix - 1)];
+      }
+    }
+    // the elements of a digit are placed in the order of the threads
+    int64_t begin = 0;
+    bool same_digit = false;
+    for (int d = 0; d < kRadix; ++d) {
+      int64_t digit_begin = begin;
+      for (int t = 0; t < threads; ++t) {
+        int64_t count = offsets[t * kRadix + d];
+        offsets[t * kRadix + d] = begin;
+        begin += count;
+      }
+      same_digit = same_digit || begin - digit_begin == n;
+    }
+    if (same_digit) {
+      continue;
+    }
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel for num_threads(threads)
+#endif
+    for (int t = 0; t < threads; ++t) {
+      int64_t* offset = offsets.data() + t * kRadix;
+      for (int64_t i = n * t / threads; i < n * (t + 1) / threads; ++i) {
+        int64_t pos = offset[(keys[i] >> shift) & (kRadix - 1)]++;
+        tmp_keys[pos] = keys[i];
+        tmp_order[pos] = order[i];
+      }
+    }
+    keys.swap(tmp_keys);
+    order.swap(tmp_order);
+  }
+
+  segments->ids.clear();
+  segments->offsets.clear();
+  for (int64_t i = 0; i < n; ++i) {
+    if (i == 0 || keys[i] != keys[i - 1]) {
+      segments->ids.push_back(
+          static_cast<int64_t>(keys[i] + static_cast<uint64_t>(min_id)));
+      segments->offsets.push_back(i);
+    }
+  }
+  segments->offsets.push_back(n);
+  segments->order.swap(order);
+}
+
+template <typename T>
+struct IsJitVAddType {
+  static constexpr bool value = std::is_same<T, float>::value ||
+                                std::is_same<T, double>::value ||
+                                std::is_same<T, phi::dtype::bfloat16>::value;
+};
+
+// y += x of a row, with the vectorized jit kernel of VAdd when there is one.
+template <typename T, typename Enable = void>
+class RowAddTo {
+ public:
+  explicit RowAddTo(int64_t width) : width_(width) {}
+  void operator()(const T* x, T* y) const {
+    for (int64_t i = 0; i < width_; ++i) {
+      y[i] += x[i];
+    }
+  }
+
+ private:
+  int64_t width_;
+};
+
+template <typename T>
+class RowAddTo<T, typename std::enable_if<IsJitVAddType<T>::value>::type> {
+ public:
+  explicit RowAddTo(int64_t width)
+      : width_(static_cast<int>(width)),
+        vadd_(jit::KernelFuncs<jit::VAddTuple<T>, phi::CPUPlace>::Cache().At(
+            width_)) {}
+  void operator()(const T* x, T* y) const { vadd_(x, y, y, width_); }
+
+ private:
+  int width_;
+  typename jit::VAddTuple<T>::func_type vadd_;
+};
+
+// Sets every row dst_row(i) to the sum of the rows src_row(p) of the
+// positions p of the segment i, where src_row and dst_row return the
+// pointers of the rows of width elements. The segments are summed in
+// parallel, and a segment longer than the share of a thread, such as the
+// hot ids of a skewed batch, is split among the threads.
+template <typename T, typename SrcRow, typename DstRow>
+void SegmentSum(const SortedSegments& segments,
+                int64_t width,
+                const SrcRow& src_row,
+                const DstRow& dst_row) {
+  RowAddTo<T> add_to(width);
+  auto sum_range = [&](int64_t begin, int64_t end, T* dst) {
+    std::memcpy(dst, src_row(segments.order[begin]), width * sizeof(T));
+    for (int64_t j = begin + 1; j < end; ++j) {
+      add_to(src_row(segments.order[j]), dst);
+    }
+  };
+
+  const int64_t num = segments.size();
+  const int64_t total = segments.offsets.back();
+  const int threads = SegmentThreads(total * width);
+  const int64_t long_length =
+      threads > 1 ? std::max<int64_t>(total / threads, 1024) : total + 1;
+  std::vector<int64_t> long_segments;
+  for (int64_t i = 0; i < num; ++i) {
+    if (segments.length(i) >= long_length) {
+      long_segments.push_back(i);
+    }
+  }
+
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 64)
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    if (segments.length(i) < long_length) {
+      sum_range(segments.offsets[i], segments.offsets[i + 1], dst_row(i));
+    }
+  }
+
+  std::vector<T> partial(threads * width);
+  for (int64_t i : long_segments) {
+    const int64_t begin = segments.offsets[i];
+    const int64_t length = segments.length(i);
+    const int parts = static_cast<int>(std::min<int64_t>(threads, length));
+#if defined(_OPENMP) && !defined(PADDLE_WITH_CUDA)
+#pragma omp parallel for num_threads(parts)
+#endif
+    for (int t = 0; t < parts; ++t) {
+      sum_range(begin + length * t / parts,
+                begin + length * (t + 1) / parts,
+                partial.data() + t * width);
+    }
+    T* dst = dst_row(i);
+    std::memcpy(dst, partial.data(), width * sizeof(T));
+    for (int t = 1; t < parts; ++t) {
+      add_to(partial.data() + t * width, dst);
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename Context>
+void FusedBiasActKernel(const Context& dev_ctx,
+                        const DenseTensor& x,
+                        const paddle::optional<DenseTensor>& bias,
+                        const paddle::optional<DenseTensor>& dequant_scales,
+                        const paddle::optional<DenseTensor>& shift,
+                        const paddle::optional<DenseTensor>& smooth,
+                        const std::string& act_method,
+                        const std::string& compute_dtype,
+                        float quant_scale,
+                        int quant_round_type,
+                        float quant_max_bound,
+                        float quant_min_bound,
+                        DenseTensor* out) {
+  PADDLE_ENFORCE_EQ(
+      !dequant_scales && !shift && !smooth && quant_scale <= 0.0f,
+      true,
+      phi::errors::Unimplemented(
+          "The dequantization, shift, smooth and quantization of "
+          "fused_bias_act are not supported on CPU."));
+  PADDLE_ENFORCE_EQ(act_method == "gelu" || act_method == "relu",
+                    true,
+                    phi::errors::Unimplemented(
+                        "Currently, fused_bias_act on CPU only supports gelu "
+                        "and relu, but received %s.",
+                        act_method));
+
+  int rows = static_cast<int>(x.dims()[0]);
+  int cols = static_cast<int>(x.dims()[1]);
+  const T* x_data = x.data<T>();
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  std::vector<T> zeros;
+  const T* bias_data = nullptr;
+  if (bias) {
+    PADDLE_ENFORCE_EQ(bias->numel(),
+                      cols,
+                      phi::errors::InvalidArgument(
+                          "bias's length (%d) is not equal with expected (%d).",
+                          bias->numel(),
+                          cols));
+    bias_data = bias->data<T>();
+  } else {
+    zeros.resize(cols, static_cast<T>(0));
+    bias_data = zeros.data();
+  }
+
+  const jit::bias_act_attr_t attr(
+      cols, act_method == "gelu" ? jit::kVGelu : jit::kVRelu);
+  auto compute_bias_act =
+      jit::KernelFuncs<jit::VBiasActTuple<T>, phi::CPUPlace>::Cache().At(attr);
+  compute_bias_act(x_data, bias_data, out_data, rows, &attr);
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_bias_act,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedBiasActKernel,
+                   float) {}
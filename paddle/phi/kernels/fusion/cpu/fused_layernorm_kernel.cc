@@ -0,0 +1,147 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/cpu_layer_norm.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename Context>
+void FusedLayerNormKernel(const Context& dev_ctx,
+                          const DenseTensor& x,
+                          const paddle::optional<DenseTensor>& bias,
+                          const paddle::optional<DenseTensor>& residual,
+                          const paddle::optional<DenseTensor>& norm_weight,
+                          const paddle::optional<DenseTensor>& norm_bias,
+                          const float epsilon,
+                          const float residual_alpha,
+                          const int begin_norm_axis,
+                          const float quant_scale,
+                          const int quant_round_type,
+                          const float quant_max_bound,
+                          const float quant_min_bound,
+                          DenseTensor* out,
+                          DenseTensor* residual_out,
+                          DenseTensor* mean,
+                          DenseTensor* variance) {
+  auto matrix_dim = phi::flatten_to_2d(x.dims(), begin_norm_axis);
+  const int64_t rows = matrix_dim[0];
+  const int64_t cols = matrix_dim[1];
+  if (bias) {
+    PADDLE_ENFORCE_EQ(bias->numel(),
+                      cols,
+                      phi::errors::InvalidArgument(
+                          "bias's length (%d) is not equal with expected (%d).",
+                          bias->numel(),
+                          cols));
+  }
+  if (norm_bias) {
+    PADDLE_ENFORCE_EQ(
+        norm_bias->numel(),
+        cols,
+        phi::errors::InvalidArgument(
+            "norm_bias's length (%d) is not equal with expected (%d).",
+            norm_bias->numel(),
+            cols));
+  }
+
+  const T* x_data = x.data<T>();
+  const T* bias_data = bias ? bias->data<T>() : nullptr;
+  const float* norm_weight_data =
+      norm_weight ? norm_weight->data<float>() : nullptr;
+  const float* norm_bias_data = norm_bias ? norm_bias->data<float>() : nullptr;
+
+  // Do residual + bias + x
+  if (residual && norm_weight_data == nullptr && norm_bias_data == nullptr) {
+    const T* residual_data = residual->data<T>();
+    T* out_data = dev_ctx.template Alloc<T>(out);
+    const T alpha = static_cast<T>(residual_alpha);
+    funcs::ForEachRowBlock(
+        rows,
+        funcs::LayerNormRowBlocks(rows, cols),
+        [&](int, int64_t begin, int64_t end) {
+          for (int64_t i = begin * cols; i < end * cols; ++i) {
+            T value = x_data[i] + alpha * residual_data[i];
+            out_data[i] = bias_data ? value + bias_data[i % cols] : value;
+          }
+        });
+    return;
+  }
+
+  // Do Layernorm(residual + bias + x), or Layernorm(x) without a residual
+  const T* residual_data = residual ? residual->data<T>() : nullptr;
+  T* residual_out_data =
+      residual ? dev_ctx.template Alloc<T>(residual_out) : nullptr;
+  float* mean_data = dev_ctx.template Alloc<float>(mean);
+  float* variance_data = dev_ctx.template Alloc<float>(variance);
+  if (quant_scale <= 0.0f) {
+    funcs::ResidualAddLayerNormRows(
+        x_data,
+        residual ? bias_data : nullptr,
+        residual_data,
+        residual_alpha,
+        norm_weight_data,
+        norm_bias_data,
+        epsilon,
+        rows,
+        cols,
+        residual_out_data,
+        dev_ctx.template Alloc<T>(out),
+        mean_data,
+        variance_data,
+        [](float value) { return static_cast<T>(value); });
+  } else {
+    // Quantize and output int8.
+    funcs::ResidualAddLayerNormRows(
+        x_data,
+        residual ? bias_data : nullptr,
+        residual_data,
+        residual_alpha,
+        norm_weight_data,
+        norm_bias_data,
+        epsilon,
+        rows,
+        cols,
+        residual_out_data,
+        dev_ctx.template Alloc<int8_t>(out),
+        mean_data,
+        variance_data,
+        [&](float value) {
+          float quant_value = quant_max_bound * quant_scale * value;
+          quant_value =
+              quant_round_type == 0 ? rintf(quant_value) : roundf(quant_value);
+          return static_cast<int8_t>(std::min(
+              std::max(quant_value, quant_min_bound), quant_max_bound));
+        });
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_bias_residual_layernorm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedLayerNormKernel,
+                   float) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(3).SetDataType(phi::DataType::FLOAT32);
+}
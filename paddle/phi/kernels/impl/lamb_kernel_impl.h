@@ -17,6 +17,7 @@
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/full_kernel.h"
+#include "paddle/phi/kernels/funcs/cpu_multi_tensor_apply.h"
 #include "paddle/phi/kernels/funcs/lamb_functors.h"
 
 namespace phi {
@@ -167,7 +168,8 @@ void ComputeImpl(const Context& dev_ctx,
   auto beta2 = static_cast<MT>(beta2_f);
   auto epsilon = static_cast<MT>(epsilon_f);
   auto numel = param.numel();
-  phi::funcs::ForRange<Context> for_range(dev_ctx, numel);
+  // the moments and the params are updated by chunks on the CPU threads
+  phi::funcs::ChunkedForRange<Context> for_range(dev_ctx, numel);
   DenseTensor trust_ratio_div;
   trust_ratio_div.Resize(param.dims());
   auto* trust_ratio_div_ptr = dev_ctx.template Alloc<MT>(&trust_ratio_div);
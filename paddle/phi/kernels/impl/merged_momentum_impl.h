@@ -20,6 +20,7 @@
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/hostdevice.h"
 #include "paddle/phi/core/macros.h"
+#include "paddle/phi/kernels/funcs/cpu_multi_tensor_apply.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
 #include "paddle/phi/kernels/impl/momentum_kernel_impl.h"
 #include "paddle/phi/kernels/merged_momentum_kernel.h"
@@ -85,6 +86,58 @@ struct MergedMomentumKernelParam
   }
 };
 
+// MergedMomentum on CPU, which updates the chunks of all of the params at
+// once on the threads, instead of a param at a time. The grad is rescaled
+// before the regularization, as the DenseMomentumFunctor does.
+template <typename T, typename MT, typename MPType>
+void MergedMomentumCPUCompute(
+    const std::vector<const DenseTensor *> &grads,
+    const std::vector<const DenseTensor *> &lrs,
+    float mu,
+    bool use_nesterov,
+    const std::vector<std::string> &regularization_methods,
+    const std::vector<float> &regularization_coeffs,
+    float rescale_grad,
+    const std::vector<DenseTensor *> &params_out,
+    const std::vector<DenseTensor *> &velocitys_out) {
+  size_t n = params_out.size();
+  std::vector<int64_t> numels(n);
+  std::vector<MT> reg_coeffs(n, static_cast<MT>(0));
+  for (size_t idx = 0; idx < n; ++idx) {
+    numels[idx] = params_out[idx]->numel();
+    if (regularization_methods.size() > 0 &&
+        regularization_methods[idx] == "l2_decay") {
+      reg_coeffs[idx] = static_cast<MT>(regularization_coeffs[idx]);
+    }
+  }
+  const MT mu_ = static_cast<MT>(mu);
+  const MT rescale_grad_ = static_cast<MT>(rescale_grad);
+  phi::funcs::CPUMultiTensorApply(
+      numels,
+      phi::funcs::kCPUMultiTensorChunkSize,
+      [&](size_t idx, int64_t begin, int64_t end) {
+        T *param_p = params_out[idx]->data<T>();
+        const T *grad_p = grads[idx]->data<T>();
+        MT *velocity_p = velocitys_out[idx]->data<MT>();
+        const MT lr = static_cast<MT>(
+            (lrs.size() > 1 ? lrs[idx] : lrs[0])->data<MPType>()[0]);
+        const MT reg_coeff = reg_coeffs[idx];
+        for (int64_t i = begin; i < end; ++i) {
+          const MT param = static_cast<MT>(param_p[i]);
+          MT grad = static_cast<MT>(grad_p[i]) * rescale_grad_;
+          if (reg_coeff != static_cast<MT>(0)) {
+            grad += reg_coeff * param;
+          }
+          const MT velocity_out = velocity_p[i] * mu_ + grad;
+          const MT param_out = use_nesterov
+                                   ? param - (grad + velocity_out * mu_) * lr
+                                   : param - lr * velocity_out;
+          velocity_p[i] = velocity_out;
+          param_p[i] = static_cast<T>(param_out);
+        }
+      });
+}
+
 template <typename MT, typename Context, typename MPType, typename T>
 void MergedMomentumInnerCompute(
     const Context &ctx,
@@ -229,8 +282,20 @@ void MergedMomentumInnerCompute(
           << ",  regularization_coeffs.size(): "
           << regularization_coeffs.size();
 
-  if (lrs.size() == 1 && use_nesterov == false &&
-      regularization_methods.size() == 0) {
+  if (ctx.GetPlace().GetType() == phi::AllocationType::CPU &&
+      !multi_precision) {
+    MergedMomentumCPUCompute<T, MT, MPType>(grads,
+                                            lrs,
+                                            mu,
+                                            use_nesterov,
+                                            regularization_methods,
+                                            regularization_coeffs,
+                                            rescale_grad,
+                                            params_out,
+                                            velocitys_out);
+    VLOG(10) << "Launch MergedMomentum cpu kernel of " << n << " params.";
+  } else if (lrs.size() == 1 && use_nesterov == false &&
+             regularization_methods.size() == 0) {
 #define PADDLE_LAUNCH_MERGED_MOMENTUM_KERNEL(kMultiPrecision)            \
   MergedMomentumKernelParam<T, MT, kMultiPrecision> kernel_params;       \
   constexpr auto kMaxMergedNum = decltype(kernel_params)::N;             \
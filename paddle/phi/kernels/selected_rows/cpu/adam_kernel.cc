@@ -22,16 +22,18 @@
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/core/threadpool.h"
 #include "paddle/phi/kernels/funcs/adam_functors.h"
+#include "paddle/phi/kernels/funcs/lazy_sparse_optimizer.h"
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
+#include "paddle/phi/kernels/selected_rows/cpu/adam_util.h"
 
 PD_DECLARE_int32(inner_op_parallelism);
 
 namespace phi {
 namespace sr {
 
-template <typename T, typename Context>
-void AdamDenseParamSparseGradKernel(
-    const Context& dev_ctx,
+template <typename T>
+void AdamDenseParamSparseGradCPU(
+    const CPUContext& dev_ctx,
     const DenseTensor& param,
     const SelectedRows& grad,
     const DenseTensor& learning_rate,
@@ -53,7 +55,8 @@ void AdamDenseParamSparseGradKernel(
     DenseTensor* moment2_out,
     DenseTensor* beta1_pow_out,
     DenseTensor* beta2_pow_out,
-    DenseTensor* master_param_outs UNUSED) {
+    DenseTensor* master_param_outs UNUSED,
+    T weight_decay) {
   VLOG(4) << "use_global_beta_pow:" << use_global_beta_pow;
 
   bool skip_update_ = false;
@@ -124,7 +127,7 @@ void AdamDenseParamSparseGradKernel(
   } else {
     // merge duplicated rows if any.
     // The rows of grad_merge have been sorted inside MergeAdd functor
-    phi::funcs::scatter::MergeAdd<Context, T> merge_func;
+    phi::funcs::scatter::MergeAdd<CPUContext, T> merge_func;
     merge_func(dev_ctx, grad, &tmp_grad_merge, true);
     grad_merge_ptr = &tmp_grad_merge;
   }
@@ -164,14 +167,24 @@ void AdamDenseParamSparseGradKernel(
   }
   if (lazy_mode) {
     VLOG(3) << "run cpu lazy mode";
-    size_t row_count = grad_merge.rows().size();
-    std::vector<int64_t> cpu_rows(grad_merge.rows());
-    for (size_t row_index = 0; row_index < row_count; ++row_index) {
-      for (size_t offset = 0; offset < row_numel; ++offset) {
-        size_t i = cpu_rows[row_index] * row_numel + offset;
-        functor.adam_update(i, grad_data[row_index * row_numel + offset]);
-      }
-    }
+    funcs::LazyAdamRowUpdate<T> update(
+        beta1_,
+        beta2_,
+        epsilon_,
+        learning_rate.data<T>()[0],
+        beta1_pow.data<T>()[0],
+        beta2_pow.data<T>()[0],
+        weight_decay,
+        grad_data,
+        moment1.data<T>(),
+        moment1_out->data<T>(),
+        moment2.data<T>(),
+        moment2_out->data<T>(),
+        param.data<T>(),
+        param_out->data<T>(),
+        rows,
+        row_numel);
+    funcs::ForEachSparseRow(grad_merge.rows().size(), row_numel, update);
   }
 #ifndef _WIN32
   else if (FLAGS_inner_op_parallelism > 1 &&  // NOLINT
@@ -237,6 +250,109 @@ void AdamDenseParamSparseGradKernel(
   }
 }
 
+template void AdamDenseParamSparseGradCPU<float>(
+    const CPUContext& dev_ctx,
+    const DenseTensor& param,
+    const SelectedRows& grad,
+    const DenseTensor& learning_rate,
+    const DenseTensor& moment1,
+    const DenseTensor& moment2,
+    const DenseTensor& beta1_pow,
+    const DenseTensor& beta2_pow,
+    const paddle::optional<DenseTensor>& master_param,
+    const paddle::optional<DenseTensor>& skip_update,
+    const Scalar& beta1,
+    const Scalar& beta2,
+    const Scalar& epsilon,
+    bool lazy_mode,
+    int64_t min_row_size_to_use_multithread,
+    bool multi_precision,
+    bool use_global_beta_pow,
+    DenseTensor* param_out,
+    DenseTensor* moment1_out,
+    DenseTensor* moment2_out,
+    DenseTensor* beta1_pow_out,
+    DenseTensor* beta2_pow_out,
+    DenseTensor* master_param_outs,
+    float weight_decay);
+
+template void AdamDenseParamSparseGradCPU<double>(
+    const CPUContext& dev_ctx,
+    const DenseTensor& param,
+    const SelectedRows& grad,
+    const DenseTensor& learning_rate,
+    const DenseTensor& moment1,
+    const DenseTensor& moment2,
+    const DenseTensor& beta1_pow,
+    const DenseTensor& beta2_pow,
+    const paddle::optional<DenseTensor>& master_param,
+    const paddle::optional<DenseTensor>& skip_update,
+    const Scalar& beta1,
+    const Scalar& beta2,
+    const Scalar& epsilon,
+    bool lazy_mode,
+    int64_t min_row_size_to_use_multithread,
+    bool multi_precision,
+    bool use_global_beta_pow,
+    DenseTensor* param_out,
+    DenseTensor* moment1_out,
+    DenseTensor* moment2_out,
+    DenseTensor* beta1_pow_out,
+    DenseTensor* beta2_pow_out,
+    DenseTensor* master_param_outs,
+    double weight_decay);
+
+template <typename T, typename Context>
+void AdamDenseParamSparseGradKernel(
+    const Context& dev_ctx,
+    const DenseTensor& param,
+    const SelectedRows& grad,
+    const DenseTensor& learning_rate,
+    const DenseTensor& moment1,
+    const DenseTensor& moment2,
+    const DenseTensor& beta1_pow,
+    const DenseTensor& beta2_pow,
+    const paddle::optional<DenseTensor>& master_param,
+    const paddle::optional<DenseTensor>& skip_update,
+    const Scalar& beta1,
+    const Scalar& beta2,
+    const Scalar& epsilon,
+    bool lazy_mode,
+    int64_t min_row_size_to_use_multithread,
+    bool multi_precision,
+    bool use_global_beta_pow,
+    DenseTensor* param_out,
+    DenseTensor* moment1_out,
+    DenseTensor* moment2_out,
+    DenseTensor* beta1_pow_out,
+    DenseTensor* beta2_pow_out,
+    DenseTensor* master_param_outs) {
+  AdamDenseParamSparseGradCPU<T>(dev_ctx,
+                                 param,
+                                 grad,
+                                 learning_rate,
+                                 moment1,
+                                 moment2,
+                                 beta1_pow,
+                                 beta2_pow,
+                                 master_param,
+                                 skip_update,
+                                 beta1,
+                                 beta2,
+                                 epsilon,
+                                 lazy_mode,
+                                 min_row_size_to_use_multithread,
+                                 multi_precision,
+                                 use_global_beta_pow,
+                                 param_out,
+                                 moment1_out,
+                                 moment2_out,
+                                 beta1_pow_out,
+                                 beta2_pow_out,
+                                 master_param_outs,
+                                 static_cast<T>(0));
+}
+
 }  // namespace sr
 }  // namespace phi
 
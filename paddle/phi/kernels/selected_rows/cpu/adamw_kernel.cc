@@ -23,6 +23,7 @@
 #include "paddle/phi/kernels/adam_kernel.h"
 #include "paddle/phi/kernels/funcs/adam_functors.h"
 #include "paddle/phi/kernels/selected_rows/adam_kernel.h"
+#include "paddle/phi/kernels/selected_rows/cpu/adam_util.h"
 
 namespace phi {
 namespace sr {
@@ -95,6 +96,37 @@ void AdamwDenseParamSparseGradKernel(
     return;
   }
 
+  if (lazy_mode) {
+    // only the rows of grad are decayed, in the pass of the Adam update
+    AdamDenseParamSparseGradCPU<T>(
+        dev_ctx,
+        param,
+        grad,
+        learning_rate,
+        moment1,
+        moment2,
+        beta1_pow,
+        beta2_pow,
+        master_param,
+        skip_update,
+        beta1,
+        beta2,
+        epsilon,
+        lazy_mode,
+        min_row_size_to_use_multithread,
+        multi_precision,
+        use_global_beta_pow,
+        param_out,
+        moment1_out,
+        moment2_out,
+        beta1_pow_out,
+        beta2_pow_out,
+        master_param_outs,
+        learning_rate.data<T>()[0] * static_cast<T>(lr_ratio) *
+            static_cast<T>(coeff));
+    return;
+  }
+
   auto* param_ =
       master_param.is_initialized() ? master_param.get_ptr() : &param;
   T coeff_ = static_cast<T>(coeff);
@@ -62,6 +62,8 @@ class Builder {
   Builder(IrContext *context, const InsertPoint &insert_point)
       : context_(context), insert_point_(insert_point) {}
 
+  virtual ~Builder() = default;
+
   void SetInsertionPoint(const InsertPoint &insert_point) {
     insert_point_ = insert_point;
   }
@@ -135,9 +137,12 @@ class Builder {
   IR_API ArrayAttribute array_attr(const std::vector<Attribute> &value);
   IR_API PointerAttribute pointer_attr(void *value);
 
- private:
-  Operation *Insert(Operation *op);
+ protected:
+  /// Insert the created operation at the current insertion point. Derived
+  /// classes may override it to get notified of every created operation.
+  IR_API virtual Operation *Insert(Operation *op);
 
+ private:
   IrContext *context_;
 
   InsertPoint insert_point_;
@@ -0,0 +1,181 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "paddle/pir/core/enforce.h"
+
+namespace pir {
+namespace bytecode {
+
+///
+/// \brief Layout of a serialized program (all integers are LEB128 varints
+/// unless noted otherwise):
+///
+///   Header     := Magic(4 bytes) Version
+///   Strings    := Count { Length Bytes }
+///   Types      := Count { TypeEntry }
+///   Attributes := Count { AttributeEntry }
+///   Body       := Region
+///
+///   Region     := ByteSize NumValues NumBlocks { Block }
+///   Block      := NumArgs { TypeIdx } NumOps { Operation }
+///   Operation  := NameIdx NumOperands { ValueIdx }
+///                 NumAttrs { NameIdx AttrIdx } NumResults { TypeIdx }
+///                 NumSuccessors { BlockIdx } NumRegions { Region }
+///
+/// Types and attributes are interned in dependency order, so an entry only
+/// refers to entries with a smaller index. Values are numbered in definition
+/// order starting from 1 (0 stands for a null value). A region records its
+/// byte size and the number of values defined inside it, which allows the
+/// reader to skip it and materialize it later on demand.
+///
+constexpr char kMagic[4] = {'P', 'I', 'R', 'B'};
+constexpr uint64_t kVersion = 1;
+
+enum class TypeKind : uint8_t {
+  kNull = 0,
+  kBuiltin = 1,
+  kVector = 2,
+  kDialect = 3,
+};
+
+enum class BuiltinTypeId : uint8_t {
+  kBFloat16 = 0,
+  kFloat16,
+  kFloat32,
+  kFloat64,
+  kInt8,
+  kUInt8,
+  kInt16,
+  kInt32,
+  kInt64,
+  kIndex,
+  kBool,
+  kComplex64,
+  kComplex128,
+};
+
+enum class AttributeKind : uint8_t {
+  kNull = 0,
+  kStr = 1,
+  kBool = 2,
+  kFloat = 3,
+  kDouble = 4,
+  kInt32 = 5,
+  kInt64 = 6,
+  kArray = 7,
+  kType = 8,
+  kDialect = 9,
+};
+
+///
+/// \brief Append-only byte buffer used by the writer.
+///
+class EncodingBuffer {
+ public:
+  void EmitByte(uint8_t value) { data_.push_back(static_cast<char>(value)); }
+
+  void EmitVarInt(uint64_t value) {
+    while (value >= 0x80) {
+      EmitByte(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    EmitByte(static_cast<uint8_t>(value));
+  }
+
+  void EmitSignedVarInt(int64_t value) {
+    EmitVarInt((static_cast<uint64_t>(value) << 1) ^
+               static_cast<uint64_t>(value >> 63));
+  }
+
+  template <typename T>
+  void EmitRaw(const T& value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    data_.append(bytes, sizeof(T));
+  }
+
+  void EmitBytes(const std::string& bytes) { data_.append(bytes); }
+
+  const std::string& data() const { return data_; }
+  size_t size() const { return data_.size(); }
+
+ private:
+  std::string data_;
+};
+
+///
+/// \brief Bounds-checked cursor over a serialized buffer used by the reader.
+///
+class DecodingCursor {
+ public:
+  DecodingCursor(const char* begin, const char* end)
+      : cur_(begin), end_(end) {}
+
+  uint8_t ParseByte() {
+    IR_ENFORCE(cur_ < end_, "Unexpected end of pir bytecode.");
+    return static_cast<uint8_t>(*cur_++);
+  }
+
+  uint64_t ParseVarInt() {
+    uint64_t result = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = ParseByte();
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return result;
+    }
+    IR_THROW("Malformed varint in pir bytecode.");
+  }
+
+  int64_t ParseSignedVarInt() {
+    uint64_t value = ParseVarInt();
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+  }
+
+  template <typename T>
+  T ParseRaw() {
+    IR_ENFORCE(remaining() >= sizeof(T), "Unexpected end of pir bytecode.");
+    T value;
+    std::memcpy(&value, cur_, sizeof(T));
+    cur_ += sizeof(T);
+    return value;
+  }
+
+  std::string ParseBytes(size_t size) {
+    IR_ENFORCE(remaining() >= size, "Unexpected end of pir bytecode.");
+    std::string bytes(cur_, size);
+    cur_ += size;
+    return bytes;
+  }
+
+  void Skip(size_t size) {
+    IR_ENFORCE(remaining() >= size, "Unexpected end of pir bytecode.");
+    cur_ += size;
+  }
+
+  const char* current() const { return cur_; }
+  size_t remaining() const { return static_cast<size_t>(end_ - cur_); }
+
+ private:
+  const char* cur_;
+  const char* end_;
+};
+
+}  // namespace bytecode
+}  // namespace pir
@@ -0,0 +1,376 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/pir/core/bytecode/bytecode_reader.h"
+
+#include <iterator>
+#include <sstream>
+
+#include "paddle/pir/core/block.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_type.h"
+#include "paddle/pir/core/operation.h"
+#include "paddle/pir/core/region.h"
+
+namespace pir {
+
+using bytecode::AttributeKind;
+using bytecode::BuiltinTypeId;
+using bytecode::DecodingCursor;
+using bytecode::TypeKind;
+
+BytecodeReader::BytecodeReader(IrContext* ctx,
+                               std::istream& is,
+                               bool lazy_regions)
+    : ctx_(ctx),
+      lazy_regions_(lazy_regions),
+      buffer_(std::istreambuf_iterator<char>(is),
+              std::istreambuf_iterator<char>()) {}
+
+const std::string& BytecodeReader::GetString(uint64_t index) const {
+  IR_ENFORCE(index < strings_.size(),
+             "String index %d is out of range in pir bytecode.",
+             index);
+  return strings_[index];
+}
+
+Type BytecodeReader::GetType(uint64_t index) const {
+  IR_ENFORCE(index < types_.size(),
+             "Type index %d is out of range in pir bytecode.",
+             index);
+  return types_[index];
+}
+
+Attribute BytecodeReader::GetAttribute(uint64_t index) const {
+  IR_ENFORCE(index < attrs_.size(),
+             "Attribute index %d is out of range in pir bytecode.",
+             index);
+  return attrs_[index];
+}
+
+Value BytecodeReader::GetValue(uint64_t index) const {
+  if (index == 0) {
+    return Value();
+  }
+  IR_ENFORCE(index < values_.size() && values_[index],
+             "Value %d is used before its definition in pir bytecode.",
+             index);
+  return values_[index];
+}
+
+void BytecodeReader::DefineValue(uint64_t index, Value value) {
+  IR_ENFORCE(index < values_.size() && !values_[index],
+             "Value %d is defined out of its region in pir bytecode.",
+             index);
+  values_[index] = value;
+}
+
+Type BytecodeReader::ParseTypeEntry(DecodingCursor* cursor) {
+  auto kind = static_cast<TypeKind>(cursor->ParseByte());
+  switch (kind) {
+    case TypeKind::kNull:
+      return Type();
+    case TypeKind::kBuiltin:
+      switch (static_cast<BuiltinTypeId>(cursor->ParseByte())) {
+        case BuiltinTypeId::kBFloat16:
+          return BFloat16Type::get(ctx_);
+        case BuiltinTypeId::kFloat16:
+          return Float16Type::get(ctx_);
+        case BuiltinTypeId::kFloat32:
+          return Float32Type::get(ctx_);
+        case BuiltinTypeId::kFloat64:
+          return Float64Type::get(ctx_);
+        case BuiltinTypeId::kInt8:
+          return Int8Type::get(ctx_);
+        case BuiltinTypeId::kUInt8:
+          return UInt8Type::get(ctx_);
+        case BuiltinTypeId::kInt16:
+          return Int16Type::get(ctx_);
+        case BuiltinTypeId::kInt32:
+          return Int32Type::get(ctx_);
+        case BuiltinTypeId::kInt64:
+          return Int64Type::get(ctx_);
+        case BuiltinTypeId::kIndex:
+          return IndexType::get(ctx_);
+        case BuiltinTypeId::kBool:
+          return BoolType::get(ctx_);
+        case BuiltinTypeId::kComplex64:
+          return Complex64Type::get(ctx_);
+        case BuiltinTypeId::kComplex128:
+          return Complex128Type::get(ctx_);
+        default:
+          IR_THROW("Unknown builtin type in pir bytecode.");
+      }
+    case TypeKind::kVector: {
+      uint64_t size = cursor->ParseVarInt();
+      IR_ENFORCE(size <= cursor->remaining(),
+                 "Malformed vector type in pir bytecode.");
+      std::vector<Type> inner_types;
+      inner_types.reserve(size);
+      for (uint64_t i = 0; i < size; ++i) {
+        inner_types.push_back(GetType(cursor->ParseVarInt()));
+      }
+      return VectorType::get(ctx_, inner_types);
+    }
+    case TypeKind::kDialect: {
+      std::istringstream is(GetString(cursor->ParseVarInt()));
+      return Type::Parse(is, ctx_);
+    }
+    default:
+      IR_THROW("Unknown type kind in pir bytecode.");
+  }
+}
+
+Attribute BytecodeReader::ParseAttributeEntry(DecodingCursor* cursor) {
+  auto kind = static_cast<AttributeKind>(cursor->ParseByte());
+  switch (kind) {
+    case AttributeKind::kNull:
+      return Attribute();
+    case AttributeKind::kStr:
+      return StrAttribute::get(ctx_, GetString(cursor->ParseVarInt()));
+    case AttributeKind::kBool:
+      return BoolAttribute::get(ctx_, cursor->ParseByte() != 0);
+    case AttributeKind::kFloat:
+      return FloatAttribute::get(ctx_, cursor->ParseRaw<float>());
+    case AttributeKind::kDouble:
+      return DoubleAttribute::get(ctx_, cursor->ParseRaw<double>());
+    case AttributeKind::kInt32:
+      return Int32Attribute::get(
+          ctx_, static_cast<int32_t>(cursor->ParseSignedVarInt()));
+    case AttributeKind::kInt64:
+      return Int64Attribute::get(ctx_, cursor->ParseSignedVarInt());
+    case AttributeKind::kArray: {
+      uint64_t size = cursor->ParseVarInt();
+      IR_ENFORCE(size <= cursor->remaining(),
+                 "Malformed array attribute in pir bytecode.");
+      std::vector<Attribute> elements;
+      elements.reserve(size);
+      for (uint64_t i = 0; i < size; ++i) {
+        elements.push_back(GetAttribute(cursor->ParseVarInt()));
+      }
+      return ArrayAttribute::get(ctx_, elements);
+    }
+    case AttributeKind::kType:
+      return TypeAttribute::get(ctx_, GetType(cursor->ParseVarInt()));
+    case AttributeKind::kDialect: {
+      std::istringstream is(GetString(cursor->ParseVarInt()));
+      return Attribute::Parse(is, ctx_);
+    }
+    default:
+      IR_THROW("Unknown attribute kind in pir bytecode.");
+  }
+}
+
+void BytecodeReader::ParseHeader(DecodingCursor* cursor) {
+  for (char c : bytecode::kMagic) {
+    IR_ENFORCE(cursor->ParseByte() == static_cast<uint8_t>(c),
+               "The input is not a pir bytecode file.");
+  }
+  uint64_t version = cursor->ParseVarInt();
+  IR_ENFORCE(version <= bytecode::kVersion,
+             "The pir bytecode version %d is newer than the supported "
+             "version %d.",
+             version,
+             bytecode::kVersion);
+
+  uint64_t num_strings = cursor->ParseVarInt();
+  IR_ENFORCE(num_strings <= cursor->remaining(),
+             "Malformed string section in pir bytecode.");
+  strings_.reserve(num_strings);
+  for (uint64_t i = 0; i < num_strings; ++i) {
+    strings_.push_back(cursor->ParseBytes(cursor->ParseVarInt()));
+  }
+
+  uint64_t num_types = cursor->ParseVarInt();
+  IR_ENFORCE(num_types <= cursor->remaining(),
+             "Malformed type section in pir bytecode.");
+  types_.reserve(num_types);
+  for (uint64_t i = 0; i < num_types; ++i) {
+    types_.push_back(ParseTypeEntry(cursor));
+  }
+
+  uint64_t num_attrs = cursor->ParseVarInt();
+  IR_ENFORCE(num_attrs <= cursor->remaining(),
+             "Malformed attribute section in pir bytecode.");
+  attrs_.reserve(num_attrs);
+  for (uint64_t i = 0; i < num_attrs; ++i) {
+    attrs_.push_back(ParseAttributeEntry(cursor));
+  }
+}
+
+void BytecodeReader::ParseRegion(DecodingCursor* cursor,
+                                 Region& region,  // NOLINT
+                                 bool lazy,
+                                 uint64_t* next_value) {
+  uint64_t byte_size = cursor->ParseVarInt();
+  uint64_t num_values = cursor->ParseVarInt();
+  // Every value costs at least one byte for its type in the region body.
+  IR_ENFORCE(byte_size <= cursor->remaining() && num_values <= byte_size,
+             "Malformed region in pir bytecode.");
+  uint64_t value_begin = *next_value;
+  *next_value += num_values;
+  if (values_.size() < *next_value) {
+    values_.resize(*next_value);
+  }
+
+  PendingRegion body{
+      cursor->current(), cursor->current() + byte_size, value_begin};
+  cursor->Skip(byte_size);
+  if (lazy) {
+    pending_regions_[&region] = body;
+    return;
+  }
+  DecodingCursor region_cursor(body.begin, body.end);
+  uint64_t region_next_value = value_begin;
+  ParseRegionBody(&region_cursor, region, &region_next_value);
+  IR_ENFORCE(region_cursor.remaining() == 0 && region_next_value == *next_value,
+             "Region size mismatch in pir bytecode.");
+}
+
+void BytecodeReader::ParseRegionBody(DecodingCursor* cursor,
+                                     Region& region,  // NOLINT
+                                     uint64_t* next_value) {
+  uint64_t num_blocks = cursor->ParseVarInt();
+  IR_ENFORCE(num_blocks <= cursor->remaining() + 1,
+             "Malformed region in pir bytecode.");
+  IR_ENFORCE(region.empty() || region.size() == num_blocks,
+             "The region to be filled already contains different blocks.");
+  if (region.empty()) {
+    for (uint64_t i = 0; i < num_blocks; ++i) {
+      region.push_back(new Block());
+    }
+  }
+  std::vector<Block*> blocks(region.begin(), region.end());
+
+  for (auto block : blocks) {
+    uint64_t num_args = cursor->ParseVarInt();
+    for (uint64_t i = 0; i < num_args; ++i) {
+      auto arg = block->AddArgument(GetType(cursor->ParseVarInt()));
+      DefineValue((*next_value)++, arg);
+    }
+    uint64_t num_ops = cursor->ParseVarInt();
+    for (uint64_t i = 0; i < num_ops; ++i) {
+      block->push_back(ParseOperation(cursor, blocks, next_value));
+    }
+  }
+}
+
+Operation* BytecodeReader::ParseOperation(DecodingCursor* cursor,
+                                          const std::vector<Block*>& blocks,
+                                          uint64_t* next_value) {
+  const std::string& op_name = GetString(cursor->ParseVarInt());
+  OpInfo op_info = ctx_->GetRegisteredOpInfo(op_name);
+  IR_ENFORCE(op_info, "Operation [%s] is not registered.", op_name);
+
+  uint64_t num_operands = cursor->ParseVarInt();
+  IR_ENFORCE(num_operands <= cursor->remaining(),
+             "Malformed operation in pir bytecode.");
+  std::vector<Value> inputs;
+  inputs.reserve(num_operands);
+  for (uint64_t i = 0; i < num_operands; ++i) {
+    inputs.push_back(GetValue(cursor->ParseVarInt()));
+  }
+
+  uint64_t num_attrs = cursor->ParseVarInt();
+  AttributeMap attributes;
+  for (uint64_t i = 0; i < num_attrs; ++i) {
+    const std::string& name = GetString(cursor->ParseVarInt());
+    attributes[name] = GetAttribute(cursor->ParseVarInt());
+  }
+
+  uint64_t num_results = cursor->ParseVarInt();
+  IR_ENFORCE(num_results <= cursor->remaining(),
+             "Malformed operation in pir bytecode.");
+  std::vector<Type> output_types;
+  output_types.reserve(num_results);
+  for (uint64_t i = 0; i < num_results; ++i) {
+    output_types.push_back(GetType(cursor->ParseVarInt()));
+  }
+
+  uint64_t num_successors = cursor->ParseVarInt();
+  std::vector<Block*> successors;
+  for (uint64_t i = 0; i < num_successors; ++i) {
+    uint64_t block_id = cursor->ParseVarInt();
+    IR_ENFORCE(block_id < blocks.size(),
+               "Successor index %d is out of range in pir bytecode.",
+               block_id);
+    successors.push_back(blocks[block_id]);
+  }
+
+  uint64_t num_regions = cursor->ParseVarInt();
+  IR_ENFORCE(num_regions <= cursor->remaining(),
+             "Malformed operation in pir bytecode.");
+  Operation* op = Operation::Create(
+      inputs, attributes, output_types, op_info, num_regions, successors);
+  for (uint32_t i = 0; i < op->num_results(); ++i) {
+    DefineValue((*next_value)++, op->result(i));
+  }
+  for (uint32_t i = 0; i < op->num_regions(); ++i) {
+    ParseRegion(cursor, op->region(i), lazy_regions_, next_value);
+  }
+  return op;
+}
+
+std::unique_ptr<Program> BytecodeReader::ReadProgram() {
+  DecodingCursor cursor(buffer_.data(), buffer_.data() + buffer_.size());
+  ParseHeader(&cursor);
+
+  std::unique_ptr<Program> program(new Program{ctx_});
+  // Value index 0 is reserved for null values.
+  values_.assign(1, Value());
+  uint64_t next_value = 1;
+  ParseRegion(&cursor, program->module_op()->region(0), false, &next_value);
+  IR_ENFORCE(cursor.remaining() == 0,
+             "Unexpected trailing bytes in pir bytecode.");
+  return program;
+}
+
+bool BytecodeReader::IsMaterialized(Operation* op) const {
+  for (uint32_t i = 0; i < op->num_regions(); ++i) {
+    if (pending_regions_.count(&op->region(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BytecodeReader::Materialize(Operation* op) {
+  for (uint32_t i = 0; i < op->num_regions(); ++i) {
+    auto iter = pending_regions_.find(&op->region(i));
+    if (iter == pending_regions_.end()) {
+      continue;
+    }
+    PendingRegion body = iter->second;
+    pending_regions_.erase(iter);
+    DecodingCursor cursor(body.begin, body.end);
+    uint64_t next_value = body.value_begin;
+    ParseRegionBody(&cursor, op->region(i), &next_value);
+    IR_ENFORCE(cursor.remaining() == 0,
+               "Region size mismatch in pir bytecode.");
+  }
+}
+
+void BytecodeReader::MaterializeAll() {
+  while (!pending_regions_.empty()) {
+    Operation* op = pending_regions_.begin()->first->GetParent();
+    Materialize(op);
+  }
+}
+
+std::unique_ptr<Program> ReadBytecode(std::istream& is, IrContext* ctx) {
+  BytecodeReader reader(ctx, is);
+  return reader.ReadProgram();
+}
+
+}  // namespace pir
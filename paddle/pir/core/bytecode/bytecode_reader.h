@@ -0,0 +1,97 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/pir/core/attribute.h"
+#include "paddle/pir/core/bytecode/bytecode_format.h"
+#include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/program.h"
+#include "paddle/pir/core/type.h"
+#include "paddle/pir/core/value.h"
+
+namespace pir {
+
+///
+/// \brief BytecodeReader deserializes a Program written by BytecodeWriter.
+///
+/// When lazy_regions is true, only the top level block of the program is
+/// materialized and the regions of nested operations are left empty until
+/// Materialize() is called on their parent operation. The reader keeps the
+/// serialized buffer alive for this purpose, so it must outlive any pending
+/// materialization of the program it returned.
+///
+class IR_API BytecodeReader {
+ public:
+  BytecodeReader(IrContext* ctx, std::istream& is, bool lazy_regions = false);
+
+  std::unique_ptr<Program> ReadProgram();
+
+  /// @brief whether the regions of op still wait for materialization
+  bool IsMaterialized(Operation* op) const;
+
+  /// @brief materialize the regions of op, nested regions stay lazy
+  void Materialize(Operation* op);
+
+  /// @brief materialize all the pending regions recursively
+  void MaterializeAll();
+
+ private:
+  struct PendingRegion {
+    const char* begin;
+    const char* end;
+    uint64_t value_begin;
+  };
+
+  void ParseHeader(bytecode::DecodingCursor* cursor);
+  void ParseRegion(bytecode::DecodingCursor* cursor,
+                   Region& region,  // NOLINT
+                   bool lazy,
+                   uint64_t* next_value);
+  void ParseRegionBody(bytecode::DecodingCursor* cursor,
+                       Region& region,  // NOLINT
+                       uint64_t* next_value);
+  Operation* ParseOperation(bytecode::DecodingCursor* cursor,
+                            const std::vector<Block*>& blocks,
+                            uint64_t* next_value);
+  Type ParseTypeEntry(bytecode::DecodingCursor* cursor);
+  Attribute ParseAttributeEntry(bytecode::DecodingCursor* cursor);
+
+  const std::string& GetString(uint64_t index) const;
+  Type GetType(uint64_t index) const;
+  Attribute GetAttribute(uint64_t index) const;
+  Value GetValue(uint64_t index) const;
+  void DefineValue(uint64_t index, Value value);
+
+  IrContext* ctx_;
+  bool lazy_regions_;
+  std::string buffer_;
+
+  std::vector<std::string> strings_;
+  std::vector<Type> types_;
+  std::vector<Attribute> attrs_;
+  std::vector<Value> values_;
+  std::unordered_map<Region*, PendingRegion> pending_regions_;
+};
+
+/// @brief deserialize program from pir bytecode
+IR_API std::unique_ptr<Program> ReadBytecode(std::istream& is, IrContext* ctx);
+
+}  // namespace pir
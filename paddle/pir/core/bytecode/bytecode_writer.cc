@@ -0,0 +1,290 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/pir/core/bytecode/bytecode_writer.h"
+
+#include <map>
+#include <sstream>
+
+#include "paddle/pir/core/block.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_type.h"
+#include "paddle/pir/core/operation.h"
+#include "paddle/pir/core/region.h"
+
+namespace pir {
+
+using bytecode::AttributeKind;
+using bytecode::BuiltinTypeId;
+using bytecode::EncodingBuffer;
+using bytecode::TypeKind;
+
+namespace {
+
+bool GetBuiltinTypeId(Type type, BuiltinTypeId* id) {
+  if (type.isa<BFloat16Type>()) {
+    *id = BuiltinTypeId::kBFloat16;
+  } else if (type.isa<Float16Type>()) {
+    *id = BuiltinTypeId::kFloat16;
+  } else if (type.isa<Float32Type>()) {
+    *id = BuiltinTypeId::kFloat32;
+  } else if (type.isa<Float64Type>()) {
+    *id = BuiltinTypeId::kFloat64;
+  } else if (type.isa<Int8Type>()) {
+    *id = BuiltinTypeId::kInt8;
+  } else if (type.isa<UInt8Type>()) {
+    *id = BuiltinTypeId::kUInt8;
+  } else if (type.isa<Int16Type>()) {
+    *id = BuiltinTypeId::kInt16;
+  } else if (type.isa<Int32Type>()) {
+    *id = BuiltinTypeId::kInt32;
+  } else if (type.isa<Int64Type>()) {
+    *id = BuiltinTypeId::kInt64;
+  } else if (type.isa<IndexType>()) {
+    *id = BuiltinTypeId::kIndex;
+  } else if (type.isa<BoolType>()) {
+    *id = BuiltinTypeId::kBool;
+  } else if (type.isa<Complex64Type>()) {
+    *id = BuiltinTypeId::kComplex64;
+  } else if (type.isa<Complex128Type>()) {
+    *id = BuiltinTypeId::kComplex128;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint64_t BytecodeWriter::InternString(const std::string& str) {
+  auto iter = string_ids_.find(str);
+  if (iter != string_ids_.end()) {
+    return iter->second;
+  }
+  uint64_t id = strings_.size();
+  strings_.push_back(str);
+  string_ids_.emplace(str, id);
+  return id;
+}
+
+uint64_t BytecodeWriter::InternType(Type type) {
+  auto iter = type_ids_.find(type);
+  if (iter != type_ids_.end()) {
+    return iter->second;
+  }
+
+  // Intern nested types first so that every entry only refers to entries
+  // with a smaller index.
+  EncodingBuffer entry;
+  BuiltinTypeId builtin_id;
+  if (!type) {
+    entry.EmitByte(static_cast<uint8_t>(TypeKind::kNull));
+  } else if (GetBuiltinTypeId(type, &builtin_id)) {
+    entry.EmitByte(static_cast<uint8_t>(TypeKind::kBuiltin));
+    entry.EmitByte(static_cast<uint8_t>(builtin_id));
+  } else if (auto vec_type = type.dyn_cast<VectorType>()) {
+    std::vector<uint64_t> inner_ids;
+    for (auto inner_type : vec_type.data()) {
+      inner_ids.push_back(InternType(inner_type));
+    }
+    entry.EmitByte(static_cast<uint8_t>(TypeKind::kVector));
+    entry.EmitVarInt(inner_ids.size());
+    for (auto inner_id : inner_ids) {
+      entry.EmitVarInt(inner_id);
+    }
+  } else {
+    std::ostringstream os;
+    type.Print(os);
+    uint64_t str_id = InternString(os.str());
+    entry.EmitByte(static_cast<uint8_t>(TypeKind::kDialect));
+    entry.EmitVarInt(str_id);
+  }
+
+  type_section_.EmitBytes(entry.data());
+  uint64_t id = num_types_++;
+  type_ids_.emplace(type, id);
+  return id;
+}
+
+uint64_t BytecodeWriter::InternAttribute(Attribute attr) {
+  auto iter = attr_ids_.find(attr);
+  if (iter != attr_ids_.end()) {
+    return iter->second;
+  }
+
+  EncodingBuffer entry;
+  if (!attr) {
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kNull));
+  } else if (auto s = attr.dyn_cast<StrAttribute>()) {
+    uint64_t str_id = InternString(s.AsString());
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kStr));
+    entry.EmitVarInt(str_id);
+  } else if (auto b = attr.dyn_cast<BoolAttribute>()) {
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kBool));
+    entry.EmitByte(b.data() ? 1 : 0);
+  } else if (auto f = attr.dyn_cast<FloatAttribute>()) {
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kFloat));
+    entry.EmitRaw(f.data());
+  } else if (auto d = attr.dyn_cast<DoubleAttribute>()) {
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kDouble));
+    entry.EmitRaw(d.data());
+  } else if (auto i = attr.dyn_cast<Int32Attribute>()) {
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kInt32));
+    entry.EmitSignedVarInt(i.data());
+  } else if (auto i = attr.dyn_cast<Int64Attribute>()) {
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kInt64));
+    entry.EmitSignedVarInt(i.data());
+  } else if (auto arr = attr.dyn_cast<ArrayAttribute>()) {
+    std::vector<uint64_t> element_ids;
+    for (auto element : arr.AsVector()) {
+      element_ids.push_back(InternAttribute(element));
+    }
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kArray));
+    entry.EmitVarInt(element_ids.size());
+    for (auto element_id : element_ids) {
+      entry.EmitVarInt(element_id);
+    }
+  } else if (auto type_attr = attr.dyn_cast<TypeAttribute>()) {
+    uint64_t type_id = InternType(type_attr.data());
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kType));
+    entry.EmitVarInt(type_id);
+  } else if (attr.isa<PointerAttribute>()) {
+    IR_THROW("PointerAttribute can't be serialized into pir bytecode.");
+  } else {
+    std::ostringstream os;
+    attr.Print(os);
+    uint64_t str_id = InternString(os.str());
+    entry.EmitByte(static_cast<uint8_t>(AttributeKind::kDialect));
+    entry.EmitVarInt(str_id);
+  }
+
+  attr_section_.EmitBytes(entry.data());
+  uint64_t id = num_attrs_++;
+  attr_ids_.emplace(attr, id);
+  return id;
+}
+
+uint64_t BytecodeWriter::DefineValue(Value value) {
+  uint64_t id = ++num_values_;
+  value_ids_[value.impl()] = id;
+  return id;
+}
+
+uint64_t BytecodeWriter::GetValueIndex(Value value) const {
+  if (!value) {
+    return 0;
+  }
+  auto iter = value_ids_.find(value.impl());
+  IR_ENFORCE(iter != value_ids_.end(),
+             "The value used by operation is not defined before its use, "
+             "which can't be serialized into pir bytecode.");
+  return iter->second;
+}
+
+void BytecodeWriter::EncodeRegion(const Region& region,
+                                  EncodingBuffer* buffer) {
+  uint64_t value_begin = num_values_;
+  uint64_t block_id = 0;
+  for (auto block : region) {
+    block_ids_[block] = block_id++;
+  }
+
+  EncodingBuffer body;
+  body.EmitVarInt(region.size());
+  for (auto block : region) {
+    body.EmitVarInt(block->args_size());
+    for (uint32_t i = 0; i < block->args_size(); ++i) {
+      DefineValue(block->argument(i));
+      body.EmitVarInt(InternType(block->argument_type(i)));
+    }
+    body.EmitVarInt(block->size());
+    for (auto op : *block) {
+      EncodeOperation(op, &body);
+    }
+  }
+
+  buffer->EmitVarInt(body.size());
+  buffer->EmitVarInt(num_values_ - value_begin);
+  buffer->EmitBytes(body.data());
+}
+
+void BytecodeWriter::EncodeOperation(Operation* op, EncodingBuffer* buffer) {
+  buffer->EmitVarInt(InternString(op->name()));
+
+  buffer->EmitVarInt(op->num_operands());
+  for (uint32_t i = 0; i < op->num_operands(); ++i) {
+    buffer->EmitVarInt(GetValueIndex(op->operand_source(i)));
+  }
+
+  // Sort attributes by name to make the output deterministic.
+  std::map<std::string, Attribute> order_attributes(op->attributes().begin(),
+                                                    op->attributes().end());
+  buffer->EmitVarInt(order_attributes.size());
+  for (auto& item : order_attributes) {
+    buffer->EmitVarInt(InternString(item.first));
+    buffer->EmitVarInt(InternAttribute(item.second));
+  }
+
+  buffer->EmitVarInt(op->num_results());
+  for (uint32_t i = 0; i < op->num_results(); ++i) {
+    auto result = op->result(i);
+    DefineValue(result);
+    buffer->EmitVarInt(InternType(result ? result.type() : Type()));
+  }
+
+  buffer->EmitVarInt(op->num_successors());
+  for (uint32_t i = 0; i < op->num_successors(); ++i) {
+    auto iter = block_ids_.find(op->successor(i));
+    IR_ENFORCE(iter != block_ids_.end(),
+               "The successor of operation [%s] must be a block of its "
+               "parent region.",
+               op->name());
+    buffer->EmitVarInt(iter->second);
+  }
+
+  buffer->EmitVarInt(op->num_regions());
+  for (uint32_t i = 0; i < op->num_regions(); ++i) {
+    EncodeRegion(op->region(i), buffer);
+  }
+}
+
+void BytecodeWriter::WriteProgram(const Program* program) {
+  EncodingBuffer body;
+  EncodeRegion(program->module_op()->region(0), &body);
+
+  EncodingBuffer header;
+  for (char c : bytecode::kMagic) {
+    header.EmitByte(static_cast<uint8_t>(c));
+  }
+  header.EmitVarInt(bytecode::kVersion);
+  header.EmitVarInt(strings_.size());
+  for (auto& str : strings_) {
+    header.EmitVarInt(str.size());
+    header.EmitBytes(str);
+  }
+  header.EmitVarInt(num_types_);
+  header.EmitBytes(type_section_.data());
+  header.EmitVarInt(num_attrs_);
+  header.EmitBytes(attr_section_.data());
+
+  os_.write(header.data().data(), header.size());
+  os_.write(body.data().data(), body.size());
+}
+
+void WriteBytecode(const Program& program, std::ostream& os) {
+  BytecodeWriter writer(os);
+  writer.WriteProgram(&program);
+}
+
+}  // namespace pir
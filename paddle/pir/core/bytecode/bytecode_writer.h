@@ -0,0 +1,74 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/pir/core/attribute.h"
+#include "paddle/pir/core/bytecode/bytecode_format.h"
+#include "paddle/pir/core/program.h"
+#include "paddle/pir/core/type.h"
+#include "paddle/pir/core/value.h"
+
+namespace pir {
+
+///
+/// \brief BytecodeWriter serializes a Program into the compact binary format
+/// described in bytecode_format.h. Strings, types and attributes are interned
+/// so that each distinct entity is stored only once. Types and attributes
+/// that are not defined by the builtin dialect are stored in their textual
+/// form and are parsed back by their dialect when the program is read.
+///
+class IR_API BytecodeWriter {
+ public:
+  explicit BytecodeWriter(std::ostream& os) : os_(os) {}
+
+  void WriteProgram(const Program* program);
+
+ private:
+  void EncodeRegion(const Region& region, bytecode::EncodingBuffer* buffer);
+  void EncodeOperation(Operation* op, bytecode::EncodingBuffer* buffer);
+
+  uint64_t InternString(const std::string& str);
+  uint64_t InternType(Type type);
+  uint64_t InternAttribute(Attribute attr);
+  uint64_t DefineValue(Value value);
+  uint64_t GetValueIndex(Value value) const;
+
+  std::ostream& os_;
+
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint64_t> string_ids_;
+
+  bytecode::EncodingBuffer type_section_;
+  uint64_t num_types_{0};
+  std::unordered_map<Type, uint64_t> type_ids_;
+
+  bytecode::EncodingBuffer attr_section_;
+  uint64_t num_attrs_{0};
+  std::unordered_map<Attribute, uint64_t> attr_ids_;
+
+  uint64_t num_values_{0};
+  std::unordered_map<const void*, uint64_t> value_ids_;
+  std::unordered_map<const Block*, uint64_t> block_ids_;
+};
+
+/// @brief serialize program into pir bytecode
+IR_API void WriteBytecode(const Program& program, std::ostream& os);
+
+}  // namespace pir
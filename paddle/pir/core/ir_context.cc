@@ -14,6 +14,8 @@
 
 #include "paddle/pir/core/ir_context.h"
 
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include "paddle/pir/core/attribute_base.h"
@@ -21,7 +23,6 @@
 #include "paddle/pir/core/builtin_type.h"
 #include "paddle/pir/core/dialect.h"
 #include "paddle/pir/core/op_info_impl.h"
-#include "paddle/pir/core/spin_lock.h"
 #include "paddle/pir/core/type_base.h"
 
 namespace pir {
@@ -32,7 +33,7 @@ class IrContextImpl {
   IrContextImpl() = default;
 
   ~IrContextImpl() {
-    std::lock_guard<pir::SpinLock> guard(destructor_lock_);
+    std::lock_guard<std::mutex> guard(destructor_lock_);
     for (auto &abstract_type_map : registed_abstract_types_) {
       delete abstract_type_map.second;
     }
@@ -55,7 +56,7 @@ class IrContextImpl {
   }
 
   void RegisterAbstractType(pir::TypeId type_id, AbstractType *abstract_type) {
-    std::lock_guard<pir::SpinLock> guard(registed_abstract_types_lock_);
+    std::lock_guard<std::shared_mutex> guard(registed_abstract_types_lock_);
     VLOG(6) << "Register an abstract_type of: [TypeId_hash="
             << std::hash<pir::TypeId>()(type_id)
             << ", AbstractType_ptr=" << abstract_type << "].";
@@ -63,7 +64,7 @@ class IrContextImpl {
   }
 
   AbstractType *GetAbstractType(pir::TypeId type_id) {
-    std::lock_guard<pir::SpinLock> guard(registed_abstract_types_lock_);
+    std::shared_lock<std::shared_mutex> guard(registed_abstract_types_lock_);
     auto iter = registed_abstract_types_.find(type_id);
     if (iter != registed_abstract_types_.end()) {
       VLOG(6) << "Found a cached abstract_type of: [TypeId_hash="
@@ -78,7 +79,7 @@ class IrContextImpl {
 
   void RegisterAbstractAttribute(pir::TypeId type_id,
                                  AbstractAttribute *abstract_attribute) {
-    std::lock_guard<pir::SpinLock> guard(registed_abstract_attributes_lock_);
+    std::lock_guard<std::shared_mutex> guard(registed_abstract_attributes_lock_);
     VLOG(6) << "Register an abstract_attribute of: [TypeId_hash="
             << std::hash<pir::TypeId>()(type_id)
             << ", AbstractAttribute_ptr=" << abstract_attribute << "].";
@@ -86,7 +87,7 @@ class IrContextImpl {
   }
 
   AbstractAttribute *GetAbstractAttribute(pir::TypeId type_id) {
-    std::lock_guard<pir::SpinLock> guard(registed_abstract_attributes_lock_);
+    std::shared_lock<std::shared_mutex> guard(registed_abstract_attributes_lock_);
     auto iter = registed_abstract_attributes_.find(type_id);
     if (iter != registed_abstract_attributes_.end()) {
       VLOG(4) << "Found a cached abstract_attribute of: [TypeId_hash="
@@ -100,18 +101,19 @@ class IrContextImpl {
   }
 
   bool IsOpInfoRegistered(const std::string &name) {
+    std::shared_lock<std::shared_mutex> guard(registed_op_infos_lock_);
     return registed_op_infos_.find(name) != registed_op_infos_.end();
   }
 
   void RegisterOpInfo(const std::string &name, OpInfo info) {
-    std::lock_guard<pir::SpinLock> guard(registed_op_infos_lock_);
+    std::lock_guard<std::shared_mutex> guard(registed_op_infos_lock_);
     VLOG(6) << "Register an operation of: [Name=" << name
             << ", OpInfo ptr=" << info << "].";
     registed_op_infos_.emplace(name, info);
   }
 
   OpInfo GetOpInfo(const std::string &name) {
-    std::lock_guard<pir::SpinLock> guard(registed_op_infos_lock_);
+    std::shared_lock<std::shared_mutex> guard(registed_op_infos_lock_);
     auto iter = registed_op_infos_.find(name);
     if (iter != registed_op_infos_.end()) {
       VLOG(8) << "Found a cached OpInfo of: [name=" << name
@@ -124,18 +126,19 @@ class IrContextImpl {
   const OpInfoMap &registered_op_info_map() { return registed_op_infos_; }
 
   void RegisterDialect(std::string name, Dialect *dialect) {
-    std::lock_guard<pir::SpinLock> guard(registed_dialect_lock_);
+    std::lock_guard<std::shared_mutex> guard(registed_dialect_lock_);
     VLOG(6) << "Register a dialect of: [name=" << name
             << ", dialect_ptr=" << dialect << "].";
     registed_dialect_.emplace(name, dialect);
   }
 
   bool IsDialectRegistered(const std::string &name) {
+    std::shared_lock<std::shared_mutex> guard(registed_dialect_lock_);
     return registed_dialect_.find(name) != registed_dialect_.end();
   }
 
   Dialect *GetDialect(const std::string &name) {
-    std::lock_guard<pir::SpinLock> guard(registed_dialect_lock_);
+    std::shared_lock<std::shared_mutex> guard(registed_dialect_lock_);
     auto iter = registed_dialect_.find(name);
     if (iter != registed_dialect_.end()) {
       VLOG(6) << "Found a cached dialect of: [name=" << name
@@ -147,8 +150,10 @@ class IrContextImpl {
   }
 
   // Cached AbstractType instances.
+  // The registries below are written once per registration and read on every
+  // type, attribute and operation creation, so readers share the lock.
   std::unordered_map<TypeId, AbstractType *> registed_abstract_types_;
-  pir::SpinLock registed_abstract_types_lock_;
+  std::shared_mutex registed_abstract_types_lock_;
   // TypeStorage uniquer and cache instances.
   StorageManager registed_type_storage_manager_;
   // Cache some built-in type objects.
@@ -168,19 +173,19 @@ class IrContextImpl {
 
   // Cached AbstractAttribute instances.
   std::unordered_map<TypeId, AbstractAttribute *> registed_abstract_attributes_;
-  pir::SpinLock registed_abstract_attributes_lock_;
+  std::shared_mutex registed_abstract_attributes_lock_;
   // AttributeStorage uniquer and cache instances.
   StorageManager registed_attribute_storage_manager_;
 
   // The dialect registered in the context.
   std::unordered_map<std::string, Dialect *> registed_dialect_;
-  pir::SpinLock registed_dialect_lock_;
+  std::shared_mutex registed_dialect_lock_;
 
   // The Op registered in the context.
   OpInfoMap registed_op_infos_;
-  pir::SpinLock registed_op_infos_lock_;
+  std::shared_mutex registed_op_infos_lock_;
 
-  pir::SpinLock destructor_lock_;
+  std::mutex destructor_lock_;
 };
 
 IrContext *IrContext::Instance() {
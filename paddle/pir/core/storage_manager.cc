@@ -14,14 +14,25 @@
 
 #include "paddle/pir/core/storage_manager.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/pir/core/enforce.h"
 
 namespace pir {
 // This is a structure for creating, caching, and looking up Storage of
 // parametric types.
+//
+// The storages are spread over shards by their hash value. Each shard is an
+// open addressing hash table whose slots are filled at most once, so lookups
+// probe the current table without taking any lock and only a cache miss locks
+// the shard to construct and insert the new storage. When a shard grows, the
+// slots are copied into a new table and the old one is retired rather than
+// freed, because concurrent readers may still be probing it. The retired
+// tables are released together with the manager.
 struct ParametricStorageManager {
   using StorageBase = StorageManager::StorageBase;
 
@@ -29,10 +40,15 @@ struct ParametricStorageManager {
       : destroy_(destroy) {}
 
   ~ParametricStorageManager() {  // NOLINT
-    for (const auto &instance : parametric_instances_) {
-      destroy_(instance.second);
+    for (auto &shard : shards_) {
+      Table *table = shard.table.load(std::memory_order_relaxed);
+      if (!table) continue;
+      for (size_t i = 0; i <= table->mask; ++i) {
+        StorageBase *storage =
+            table->slots[i].storage.load(std::memory_order_relaxed);
+        if (storage) destroy_(storage);
+      }
     }
-    parametric_instances_.clear();
   }
 
   // Get the storage of parametric type, if not in the cache, create and
@@ -40,19 +56,23 @@ struct ParametricStorageManager {
   StorageBase *GetOrCreate(std::size_t hash_value,
                            std::function<bool(StorageBase *)> equal_func,
                            std::function<StorageBase *()> constructor) {
-    if (parametric_instances_.count(hash_value) != 0) {
-      auto pr = parametric_instances_.equal_range(hash_value);
-      while (pr.first != pr.second) {
-        if (equal_func(pr.first->second)) {
-          VLOG(6) << "Found a cached parametric storage of: [param_hash="
-                  << hash_value << ", storage_ptr=" << pr.first->second << "].";
-          return pr.first->second;
-        }
-        ++pr.first;
-      }
+    Shard &shard = shards_[ShardIndex(hash_value)];
+    StorageBase *storage = Lookup(
+        shard.table.load(std::memory_order_acquire), hash_value, equal_func);
+    if (storage) {
+      VLOG(6) << "Found a cached parametric storage of: [param_hash="
+              << hash_value << ", storage_ptr=" << storage << "].";
+      return storage;
     }
-    StorageBase *storage = constructor();
-    parametric_instances_.emplace(hash_value, storage);
+
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    // Another thread may have inserted the storage before we got the lock.
+    storage = Lookup(
+        shard.table.load(std::memory_order_relaxed), hash_value, equal_func);
+    if (storage) return storage;
+
+    storage = constructor();
+    Insert(&shard, hash_value, storage);
     VLOG(6) << "No cache found, construct and cache a new parametric storage "
                "of: [param_hash="
             << hash_value << ", storage_ptr=" << storage << "].";
@@ -60,9 +80,89 @@ struct ParametricStorageManager {
   }
 
  private:
-  // In order to prevent hash conflicts, the unordered_multimap data structure
-  // is used for storage.
-  std::unordered_multimap<size_t, StorageBase *> parametric_instances_;
+  struct Slot {
+    std::atomic<std::size_t> hash{0};
+    // Published after hash, an empty slot ends the probe sequence.
+    std::atomic<StorageBase *> storage{nullptr};
+  };
+
+  struct Table {
+    explicit Table(size_t capacity)
+        : mask(capacity - 1), slots(new Slot[capacity]) {}
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+  };
+
+  struct Shard {
+    std::atomic<Table *> table{nullptr};
+    std::mutex mutex;
+    size_t size{0};
+    // All the tables ever created by this shard, including the retired ones.
+    std::vector<std::unique_ptr<Table>> tables;
+  };
+
+  static constexpr size_t kNumShards = 32;
+  static constexpr size_t kInitialCapacity = 16;
+
+  static size_t ShardIndex(std::size_t hash_value) {
+    // Use the high bits of a mixed hash, the low bits select the slot.
+    uint64_t mixed = static_cast<uint64_t>(hash_value) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(mixed >> 59) % kNumShards;
+  }
+
+  static StorageBase *Lookup(
+      Table *table,
+      std::size_t hash_value,
+      const std::function<bool(StorageBase *)> &equal_func) {
+    if (!table) return nullptr;
+    for (size_t i = hash_value & table->mask;; i = (i + 1) & table->mask) {
+      Slot &slot = table->slots[i];
+      StorageBase *storage = slot.storage.load(std::memory_order_acquire);
+      if (!storage) return nullptr;
+      if (slot.hash.load(std::memory_order_relaxed) == hash_value &&
+          equal_func(storage)) {
+        return storage;
+      }
+    }
+  }
+
+  // Must be called with the lock of shard held, or before table is published.
+  static void Place(Table *table, std::size_t hash_value, StorageBase *storage) {
+    size_t i = hash_value & table->mask;
+    while (table->slots[i].storage.load(std::memory_order_relaxed)) {
+      i = (i + 1) & table->mask;
+    }
+    table->slots[i].hash.store(hash_value, std::memory_order_relaxed);
+    table->slots[i].storage.store(storage, std::memory_order_release);
+  }
+
+  // Must be called with the lock of shard held.
+  static void Insert(Shard *shard,
+                     std::size_t hash_value,
+                     StorageBase *storage) {
+    Table *table = shard->table.load(std::memory_order_relaxed);
+    // Keep the load factor under 1/2 so that the probe sequences stay short.
+    if (!table || (shard->size + 1) * 2 > table->mask + 1) {
+      size_t capacity = table ? (table->mask + 1) * 2 : kInitialCapacity;
+      shard->tables.emplace_back(std::make_unique<Table>(capacity));
+      Table *new_table = shard->tables.back().get();
+      if (table) {
+        for (size_t i = 0; i <= table->mask; ++i) {
+          Slot &slot = table->slots[i];
+          StorageBase *old = slot.storage.load(std::memory_order_relaxed);
+          if (old) {
+            Place(new_table, slot.hash.load(std::memory_order_relaxed), old);
+          }
+        }
+      }
+      shard->table.store(new_table, std::memory_order_release);
+      table = new_table;
+    }
+    Place(table, hash_value, storage);
+    ++shard->size;
+  }
+
+  Shard shards_[kNumShards];
   std::function<void(StorageBase *)> destroy_;
 };
 
@@ -75,31 +175,35 @@ StorageManager::StorageBase *StorageManager::GetParametricStorageImpl(
     std::size_t hash_value,
     std::function<bool(const StorageBase *)> equal_func,
     std::function<StorageBase *()> constructor) {
-  std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
   VLOG(6) << "Try to get a parametric storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << ", param_hash=" << hash_value
           << "].";
-  if (parametric_instance_.find(type_id) == parametric_instance_.end()) {
-    IR_THROW("The input data pointer is null.");
+  ParametricStorageManager *parametric_storage = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> guard(parametric_instance_lock_);
+    auto iter = parametric_instance_.find(type_id);
+    if (iter == parametric_instance_.end()) {
+      IR_THROW("The input data pointer is null.");
+    }
+    parametric_storage = iter->second.get();
   }
-  ParametricStorageManager &parametric_storage = *parametric_instance_[type_id];
-  return parametric_storage.GetOrCreate(hash_value, equal_func, constructor);
+  return parametric_storage->GetOrCreate(hash_value, equal_func, constructor);
 }
 
 StorageManager::StorageBase *StorageManager::GetParameterlessStorageImpl(
     TypeId type_id) {
-  std::lock_guard<pir::SpinLock> guard(parameterless_instance_lock_);
+  std::shared_lock<std::shared_mutex> guard(parameterless_instance_lock_);
   VLOG(6) << "Try to get a parameterless storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << "].";
-  if (parameterless_instance_.find(type_id) == parameterless_instance_.end())
+  auto iter = parameterless_instance_.find(type_id);
+  if (iter == parameterless_instance_.end())
     IR_THROW("TypeId not found in IrContext.");
-  StorageBase *parameterless_instance = parameterless_instance_[type_id];
-  return parameterless_instance;
+  return iter->second;
 }
 
 void StorageManager::RegisterParametricStorageImpl(
     TypeId type_id, std::function<void(StorageBase *)> destroy) {
-  std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
+  std::lock_guard<std::shared_mutex> guard(parametric_instance_lock_);
   VLOG(6) << "Register a parametric storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << "].";
   parametric_instance_.emplace(
@@ -108,7 +212,7 @@ void StorageManager::RegisterParametricStorageImpl(
 
 void StorageManager::RegisterParameterlessStorageImpl(
     TypeId type_id, std::function<StorageBase *()> constructor) {
-  std::lock_guard<pir::SpinLock> guard(parameterless_instance_lock_);
+  std::lock_guard<std::shared_mutex> guard(parameterless_instance_lock_);
   VLOG(6) << "Register a parameterless storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << "].";
   if (parameterless_instance_.find(type_id) != parameterless_instance_.end())
@@ -14,7 +14,17 @@
 
 #include "paddle/pir/pass/pass.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "paddle/pir/core/block_argument.h"
 #include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/op_result.h"
 #include "paddle/pir/core/operation.h"
 #include "paddle/pir/core/program.h"
 #include "paddle/pir/core/region.h"
@@ -32,6 +42,84 @@ Pass::~Pass() = default;
 
 bool Pass::CanApplyOn(Operation* op) const { return op->num_regions() > 0; }
 
+//----------------------------------------------------------------------------------------------//
+// PassWorkerPool
+//----------------------------------------------------------------------------------------------//
+namespace detail {
+// A fixed set of threads waiting for the tasks of the parallel runs, so that
+// the sibling operations of a run don't pay for starting threads.
+class PassWorkerPool {
+ public:
+  explicit PassWorkerPool(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this, i] { Loop(i); });
+    }
+  }
+
+  ~PassWorkerPool() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  size_t size() const { return threads_.size(); }
+
+  // Runs task(i) on the i-th thread for every i < num_tasks, Wait returns
+  // once they are done.
+  void Start(size_t num_tasks, const std::function<void(size_t)>& task) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      task_ = &task;
+      num_tasks_ = std::min(num_tasks, threads_.size());
+      pending_ = num_tasks_;
+      ++generation_;
+    }
+    start_cv_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    task_ = nullptr;
+  }
+
+ private:
+  void Loop(size_t index) {
+    uint64_t generation = 0;
+    while (true) {
+      const std::function<void(size_t)>* task = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_cv_.wait(
+            lock, [&] { return stop_ || generation_ != generation; });
+        if (stop_) return;
+        generation = generation_;
+        if (index >= num_tasks_) continue;
+        task = task_;
+      }
+      (*task)(index);
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (--pending_ == 0) done_cv_.notify_all();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(size_t)>* task_{nullptr};
+  size_t num_tasks_{0};
+  size_t pending_{0};
+  uint64_t generation_{0};
+  bool stop_{false};
+};
+}  // namespace detail
+
 //----------------------------------------------------------------------------------------------//
 // PassAdaptor
 //----------------------------------------------------------------------------------------------//
@@ -39,24 +127,138 @@ void detail::PassAdaptor::Run(Operation* op, uint8_t opt_level, bool verify) {
   RunImpl(op, opt_level, verify);
 }
 
+namespace {
+// Set on the threads executing the pipeline on isolated operations, the
+// nested pass adaptors of these threads run sequentially.
+thread_local bool in_parallel_execution = false;
+
+class ParallelExecutionGuard {
+ public:
+  ParallelExecutionGuard() : prev_(in_parallel_execution) {
+    in_parallel_execution = true;
+  }
+  ~ParallelExecutionGuard() { in_parallel_execution = prev_; }
+
+ private:
+  bool prev_;
+};
+
+// Whether target is op itself or nested in the regions of op.
+bool IsAncestor(Operation* op, Operation* target) {
+  for (; target; target = target->GetParentOp()) {
+    if (target == op) return true;
+  }
+  return false;
+}
+
+bool IsDefinedInside(Value value, Operation* op) {
+  if (auto result = value.dyn_cast<OpResult>()) {
+    return result.owner() != op && IsAncestor(op, result.owner());
+  }
+  if (auto arg = value.dyn_cast<BlockArgument>()) {
+    return IsAncestor(op, arg.owner()->GetParentOp());
+  }
+  return false;
+}
+
+bool IsIsolatedFromAbove(Operation* op, Operation* scope) {
+  for (size_t i = 0; i < op->num_regions(); ++i) {
+    for (auto* block : op->region(i)) {
+      for (auto nested_op : *block) {
+        for (uint32_t j = 0; j < nested_op->num_operands(); ++j) {
+          auto value = nested_op->operand_source(j);
+          if (value && !IsDefinedInside(value, scope)) return false;
+        }
+        if (!IsIsolatedFromAbove(nested_op, scope)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Operations whose regions don't use any value defined outside them can be
+// optimized independently of their siblings.
+bool IsIsolatedFromAbove(Operation* op) {
+  return op->num_regions() > 0 && IsIsolatedFromAbove(op, op);
+}
+}  // namespace
+
 void detail::PassAdaptor::RunImpl(Operation* op,
                                   uint8_t opt_level,
                                   bool verify) {
   auto last_am = analysis_manager();
+  bool parallel = pm_->num_threads_ > 1 && !pm_->workers_.empty() &&
+                  !in_parallel_execution;
+
+  // Consecutive isolated siblings run in parallel with each other, but the
+  // operations before them finish first and the operations after them
+  // start after them, as in the sequential execution.
+  std::vector<Operation*> isolated_ops;
+  auto run_isolated_ops = [&]() {
+    bool succeeded =
+        isolated_ops.empty() ||
+        RunParallel(
+            isolated_ops, last_am.GetPassInstrumentor(), opt_level, verify);
+    isolated_ops.clear();
+    return succeeded;
+  };
 
   for (size_t i = 0; i < op->num_regions(); ++i) {
     auto& region = op->region(i);
     for (auto* block : region) {
       for (auto op : *block) {
+        if (parallel && IsIsolatedFromAbove(op)) {
+          isolated_ops.push_back(op);
+          continue;
+        }
+        if (!run_isolated_ops()) return SignalPassFailure();
         AnalysisManagerHolder am(op, last_am.GetPassInstrumentor());
         if (!RunPipeline(*pm_, op, am, opt_level, verify))
           return SignalPassFailure();
       }
+      if (!run_isolated_ops()) return SignalPassFailure();
     }
   }
   return;
 }
 
+bool detail::PassAdaptor::RunParallel(const std::vector<Operation*>& ops,
+                                      PassInstrumentor* instrumentor,
+                                      uint8_t opt_level,
+                                      bool verify) {
+  size_t num_workers = std::min(pm_->workers_.size() + 1, ops.size());
+  std::atomic<size_t> next_op{0};
+  std::vector<char> succeeded(ops.size(), 1);
+  std::vector<std::exception_ptr> exceptions(ops.size());
+
+  auto run_worker = [&](const PassManager& pm) {
+    ParallelExecutionGuard guard;
+    for (size_t i = next_op++; i < ops.size(); i = next_op++) {
+      try {
+        AnalysisManagerHolder am(ops[i], instrumentor);
+        succeeded[i] = RunPipeline(pm, ops[i], am, opt_level, verify);
+      } catch (...) {
+        exceptions[i] = std::current_exception();
+      }
+    }
+  };
+
+  std::function<void(size_t)> task = [&](size_t i) {
+    run_worker(*pm_->workers_[i]);
+  };
+  pm_->worker_pool_->Start(num_workers - 1, task);
+  run_worker(*pm_);
+  pm_->worker_pool_->Wait();
+
+  // Report the error of the first failed operation in program order, so
+  // that the result doesn't depend on the scheduling of the threads.
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (exceptions[i]) std::rethrow_exception(exceptions[i]);
+    if (!succeeded[i]) return false;
+  }
+  return true;
+}
+
 bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
                                       Operation* op,
                                       AnalysisManager am,
@@ -124,6 +326,8 @@ PassManager::PassManager(IrContext* context, uint8_t opt_level)
   pass_adaptor_ = std::make_unique<detail::PassAdaptor>(this);
 }
 
+PassManager::~PassManager() = default;
+
 bool PassManager::Run(Program* program) {
   if (!Initialize(context_)) {
     return false;
@@ -143,9 +347,39 @@ bool PassManager::Initialize(IrContext* context) {
     if (!pass->Initialize(context)) return false;
   }
 
+  return InitializeWorkers();
+}
+
+bool PassManager::InitializeWorkers() {
+  workers_.clear();
+  for (size_t i = 1; i < num_threads_; ++i) {
+    auto worker = std::make_unique<PassManager>(context_, opt_level_);
+    worker->verify_ = verify_;
+    for (auto& pass : passes()) {
+      auto cloned_pass = pass->Clone();
+      if (!cloned_pass) {
+        VLOG(3) << "Pass " << pass->name()
+                << " doesn't support Clone, run the passes sequentially.";
+        workers_.clear();
+        return true;
+      }
+      if (!cloned_pass->Initialize(context_)) return false;
+      worker->AddPass(std::move(cloned_pass));
+    }
+    workers_.emplace_back(std::move(worker));
+  }
+  // The threads are started once and reused by the later runs.
+  if (!workers_.empty() &&
+      (!worker_pool_ || worker_pool_->size() != workers_.size())) {
+    worker_pool_ = std::make_unique<detail::PassWorkerPool>(workers_.size());
+  }
   return true;
 }
 
+void PassManager::EnableParallelExecution(size_t num_threads) {
+  num_threads_ = std::max<size_t>(num_threads, 1);
+}
+
 void PassManager::AddInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
   if (!instrumentor_) instrumentor_ = std::make_unique<PassInstrumentor>();
 
@@ -157,7 +391,8 @@ void PassManager::AddInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
 //----------------------------------------------------------------------------------------------//
 namespace detail {
 struct PassInstrumentorImpl {
-  // TODO(wilber): Support multi-thread.
+  // Guards the instrumentations when passes run in parallel.
+  std::mutex mutex;
   std::vector<std::unique_ptr<PassInstrumentation>> instrumentations;
 };
 }  // namespace detail
@@ -169,6 +404,7 @@ PassInstrumentor::~PassInstrumentor() = default;
 
 void PassInstrumentor::RunBeforePipeline(Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforePipeline(op);
   }
@@ -176,6 +412,7 @@ void PassInstrumentor::RunBeforePipeline(Operation* op) {
 
 void PassInstrumentor::RunAfterPipeline(Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -185,6 +422,7 @@ void PassInstrumentor::RunAfterPipeline(Operation* op) {
 
 void PassInstrumentor::RunBeforePass(Pass* pass, Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforePass(pass, op);
   }
@@ -192,6 +430,7 @@ void PassInstrumentor::RunBeforePass(Pass* pass, Operation* op) {
 
 void PassInstrumentor::RunAfterPass(Pass* pass, Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -203,6 +442,7 @@ void PassInstrumentor::RunBeforeAnalysis(const std::string& name,
                                          TypeId id,
                                          Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   for (auto& instr : impl_->instrumentations) {
     instr->RunBeforeAnalysis(name, id, op);
   }
@@ -212,6 +452,7 @@ void PassInstrumentor::RunAfterAnalysis(const std::string& name,
                                         TypeId id,
                                         Operation* op) {
   if (op->num_regions() == 0) return;
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   for (auto it = impl_->instrumentations.rbegin();
        it != impl_->instrumentations.rend();
        ++it) {
@@ -221,6 +462,7 @@ void PassInstrumentor::RunAfterAnalysis(const std::string& name,
 
 void PassInstrumentor::AddInstrumentation(
     std::unique_ptr<PassInstrumentation> pi) {
+  std::lock_guard<std::mutex> guard(impl_->mutex);
   impl_->instrumentations.emplace_back(std::move(pi));
 }
 
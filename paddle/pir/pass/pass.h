@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -89,6 +90,11 @@ class IR_API Pass {
 
   virtual bool Initialize(IrContext* context) { return true; }
 
+  // Create a fresh instance of this pass, which is required to run the pass
+  // concurrently on different operations. Passes that return nullptr make
+  // PassManager fall back to the sequential execution.
+  virtual std::unique_ptr<Pass> Clone() const { return nullptr; }
+
   AnalysisManager analysis_manager() { return pass_state().am; }
 
   detail::PassExecutionState& pass_state() {
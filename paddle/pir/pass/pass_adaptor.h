@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "paddle/pir/pass/pass.h"
 
 namespace pir {
 
 class Operation;
 class PassManager;
+class PassInstrumentor;
 
 namespace detail {
 // Used to run operation passes over nested operations.
@@ -34,6 +37,12 @@ class PassAdaptor final : public Pass {
  private:
   void RunImpl(Operation* op, uint8_t opt_level, bool verify);
 
+  // Run the pipeline on isolated sibling operations with the worker threads.
+  bool RunParallel(const std::vector<Operation*>& ops,
+                   PassInstrumentor* instrumentor,
+                   uint8_t opt_level,
+                   bool verify);
+
   static bool RunPass(Pass* pass,
                       Operation* op,
                       AnalysisManager am,
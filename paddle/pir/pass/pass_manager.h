@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -32,13 +33,14 @@ class PassInstrumentor;
 
 namespace detail {
 class PassAdaptor;
+class PassWorkerPool;
 }
 
 class IR_API PassManager {
  public:
   explicit PassManager(IrContext *context, uint8_t opt_level = 2);
 
-  ~PassManager() = default;
+  ~PassManager();
 
   const std::vector<std::unique_ptr<Pass>> &passes() const { return passes_; }
 
@@ -117,9 +119,19 @@ class IR_API PassManager {
 
   void AddInstrumentation(std::unique_ptr<PassInstrumentation> pi);
 
+  /// @brief Run the pipeline on consecutive sibling operations whose regions
+  /// are isolated from above with num_threads threads. The other siblings
+  /// keep their order relative to them. Every pass needs to implement
+  /// Pass::Clone, otherwise the passes run sequentially.
+  void EnableParallelExecution(size_t num_threads);
+
+  size_t num_threads() const { return num_threads_; }
+
  private:
   bool Initialize(IrContext *context);
 
+  bool InitializeWorkers();
+
   bool Run(Operation *op);
 
  private:
@@ -135,6 +147,15 @@ class IR_API PassManager {
 
   std::unique_ptr<PassInstrumentor> instrumentor_;
 
+  size_t num_threads_{1};
+
+  // The pass managers holding the cloned pipelines used by the other threads
+  // in parallel execution, the calling thread uses this pass manager itself.
+  std::vector<std::unique_ptr<PassManager>> workers_;
+
+  // The threads running the pipelines of workers_, kept across the runs.
+  std::unique_ptr<detail::PassWorkerPool> worker_pool_;
+
   // For access member of pass_adaptor_.
   friend class detail::PassAdaptor;
 };
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "paddle/pir/core/enforce.h"
 #include "paddle/pir/core/operation.h"
@@ -86,6 +87,12 @@ RewritePattern::~RewritePattern() = default;
 //===----------------------------------------------------------------------===//
 RewriterBase::~RewriterBase() = default;
 
+Operation* RewriterBase::Insert(Operation* op) {
+  Builder::Insert(op);
+  NotifyOperationInserted(op);
+  return op;
+}
+
 void RewriterBase::ReplaceOpWithIf(
     Operation* op,
     const std::vector<Value>& new_values,
@@ -133,8 +140,14 @@ void RewriterBase::EraseOp(Operation* op) {
 
 /// Find uses of `from` and replace it with `to`
 void RewriterBase::ReplaceAllUsesWith(Value from, Value to) {
-  // TODO(wilber): Substitue a low level impl.
+  // Collect the users first, their operands are changed by the replacement.
+  std::vector<Operation*> users;
+  for (auto it = from.use_begin(); it != from.use_end(); ++it) {
+    users.push_back(it.owner());
+  }
+  for (auto* user : users) StartRootUpdate(user);
   from.ReplaceAllUsesWith(to);
+  for (auto* user : users) FinalizeRootUpdate(user);
 }
 
 // TODO(wilber): iterator maybe should support modify inplace.
@@ -301,6 +301,9 @@ class RewriterBase : public Builder {
 
   virtual void CancleRootUpdate(Operation* op) {}
 
+  /// Notify the listener of every operation created by this rewriter.
+  Operation* Insert(Operation* op) override;
+
   template <typename CallableT>
   void UpdateRootInplace(Operation* root, CallableT&& callable) {
     StartRootUpdate(root);
@@ -55,35 +55,35 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   }
 
   bool Simplify() {
-    bool changed = false;
+    bool converged = false;
+    bool scan_region = true;
     int64_t iteration = 0;
-    do {
-      // Check if the iteration limit was reached.
-      if (iteration++ >= config_.max_iterations &&
-          config_.max_iterations != pir::GreedyRewriteConfig::kNoLimit)
-        break;
+    // Check if the iteration limit was reached.
+    while (iteration < config_.max_iterations ||
+           config_.max_iterations == pir::GreedyRewriteConfig::kNoLimit) {
+      ++iteration;
       VLOG(6) << "Iteration[" << iteration << "] for PatternRewrite";
-      worklist_.clear();
-      worklist_map_.clear();
-
-      for (auto& block_item : region_) {
-        for (auto& op_item : *block_item) {
-          worklist_.push_back(op_item);
-        }
-      }
-      if (config_.use_top_down_traversal) {
-        // Reverse the list so out pop-back loop process them in-order.
-        std::reverse(worklist_.begin(), worklist_.end());
-      }
-      for (size_t i = 0; i < worklist_.size(); ++i) {
-        worklist_map_[worklist_[i]] = i;
-        VLOG(6) << "worklist[" << i << "] is " << worklist_[i]->name();
+      scan_region = scan_region || config_.rescan_on_change;
+      if (scan_region) {
+        SeedWorklistFromRegion();
+      } else {
+        TakeNextWorklist();
       }
 
-      changed = ProcessWorklist();
-    } while (changed);
+      bool changed = ProcessWorklist();
+      if (!changed && scan_region) {
+        converged = true;
+        break;
+      }
+      // Once the ops affected by the rewrites are done, rescan the region to
+      // make sure that no pattern applies anymore.
+      scan_region = !changed || next_worklist_set_.empty();
+    }
 
-    return !changed;
+    VLOG(4) << "PatternRewrite finished after " << iteration
+            << " iteration(s), visited " << num_visited_ops_
+            << " operation(s) and applied " << num_rewrites_ << " rewrite(s).";
+    return converged;
   }
 
  private:
@@ -99,6 +99,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       auto* op = PopFromWorklist();
       if (op == nullptr) continue;
       VLOG(6) << "PopFromWorklist, get op: " << op->name();
+      ++num_visited_ops_;
 
       // TODO(wilber): ir is dead.
       // ...
@@ -110,19 +111,20 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       if (match_result) {
         changed = true;
         ++num_rewrites;
+        ++num_rewrites_;
       }
     }
 
     return changed;
   }
 
-  // TODO(wilber): OpResult support GetUsers method.
+  // The users of the replaced op get new operands, which may enable new
+  // matches on them.
   void NotifyRootReplaced(pir::Operation* op,
                           const std::vector<pir::Value>& replacement) override {
-    //   for (uint32_t i = 0; i < op->num_results(); ++i) {
-    //     auto res = op->GetResultByIndex(i);
-    //   }
-    // }
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      AddUsersToWorklist(op->result(i));
+    }
   }
 
   void FinalizeRootUpdate(pir::Operation* op) override { AddToWorklist(op); }
@@ -131,18 +133,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     for (uint32_t i = 0; i < op->num_operands(); ++i) {
       AddOperandToWorklist(op->operand_source(i));
     }
-    if (op->num_regions() == 0) {
-      RemoveFromWorklist(op);
-    } else {
-      for (uint32_t i = 0; i < op->num_regions(); ++i) {
-        auto& region = op->region(i);
-        for (auto& block : region) {
-          for (auto& op_item : *block) {
-            RemoveFromWorklist(op_item);
-          }
-        }
-      }
-    }
+    RemoveNestedFromWorklist(op);
 
     if (config_.strict_mode != pir::GreedyRewriteStrictness::AnyOp) {
       strict_mode_filtered_ops_.erase(op);
@@ -155,14 +146,63 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     AddToWorklist(op);
   }
 
-  /// Add the given operation to the worklist.
+  /// Fill the worklist with all the ops of the region.
+  void SeedWorklistFromRegion() {
+    worklist_.clear();
+    worklist_map_.clear();
+    next_worklist_.clear();
+    next_worklist_set_.clear();
+    for (auto& block_item : region_) {
+      for (auto& op_item : *block_item) {
+        worklist_.push_back(op_item);
+      }
+    }
+    IndexWorklist();
+  }
+
+  /// Fill the worklist with the ops affected by the rewrites of the last
+  /// iteration, in the order they were affected.
+  void TakeNextWorklist() {
+    worklist_.clear();
+    worklist_map_.clear();
+    for (auto* op : next_worklist_) {
+      // the erased ops were taken out of the set
+      if (next_worklist_set_.erase(op)) {
+        worklist_.push_back(op);
+      }
+    }
+    next_worklist_.clear();
+    next_worklist_set_.clear();
+    IndexWorklist();
+  }
+
+  void IndexWorklist() {
+    if (config_.use_top_down_traversal) {
+      // Reverse the list so out pop-back loop process them in-order.
+      std::reverse(worklist_.begin(), worklist_.end());
+    }
+    for (size_t i = 0; i < worklist_.size(); ++i) {
+      worklist_map_[worklist_[i]] = i;
+      VLOG(6) << "worklist[" << i << "] is " << worklist_[i]->name();
+    }
+  }
+
+  /// Add the given operation to the worklist of the next iteration. The ops
+  /// affected by a rewrite are not revisited in the same iteration, so that
+  /// patterns undoing each other are bounded by `max_iterations`.
   void AddToWorklist(pir::Operation* op) {
     if (config_.strict_mode == pir::GreedyRewriteStrictness::AnyOp ||
         strict_mode_filtered_ops_.count(op)) {
-      if (worklist_map_.count(op)) return;
+      if (next_worklist_set_.insert(op).second) {
+        next_worklist_.push_back(op);
+      }
+    }
+  }
 
-      worklist_map_[op] = worklist_.size();
-      worklist_.push_back(op);
+  void AddUsersToWorklist(pir::Value value) {
+    if (!value) return;
+    for (auto it = value.use_begin(); it != value.use_end(); ++it) {
+      AddToWorklist(it.owner());
     }
   }
 
@@ -198,15 +238,32 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       worklist_[it->second] = nullptr;
       worklist_map_.erase(it);
     }
+    next_worklist_set_.erase(op);
+  }
+
+  /// Remove the operation and all the operations nested in it.
+  void RemoveNestedFromWorklist(pir::Operation* op) {
+    RemoveFromWorklist(op);
+    for (uint32_t i = 0; i < op->num_regions(); ++i) {
+      for (auto& block : op->region(i)) {
+        for (auto& op_item : *block) {
+          RemoveNestedFromWorklist(op_item);
+        }
+      }
+    }
   }
 
  private:
   std::vector<pir::Operation*> worklist_;
   std::unordered_map<pir::Operation*, unsigned> worklist_map_;
+  std::vector<pir::Operation*> next_worklist_;
+  std::unordered_set<pir::Operation*> next_worklist_set_;
   pir::GreedyRewriteConfig config_;
   std::unordered_set<pir::Operation*> strict_mode_filtered_ops_;
   pir::Region& region_;
   pir::PatternApplicator matcher_;
+  int64_t num_visited_ops_{0};
+  int64_t num_rewrites_{0};
 };
 
 }  // namespace
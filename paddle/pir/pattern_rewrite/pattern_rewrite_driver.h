@@ -42,8 +42,9 @@ class IR_API GreedyRewriteConfig {
   /// pattern, use `kNolimit` to represent unlimited.
   int64_t max_iterations = 10;
 
-  /// Control the upper limit of rewrite times during each iteration, use
-  /// kNoLimit to represent unlimited.
+  /// Optionally stop each iteration after this number of rewrites, use
+  /// kNoLimit to represent unlimited. It does not bound the whole process,
+  /// which `max_iterations` does.
   int64_t max_num_rewrites = kNoLimit;
 
   /// Only the op inside this region will be added to the worklist.
@@ -57,6 +58,14 @@ class IR_API GreedyRewriteConfig {
   /// - ExistingOps: only pre-existing ops are added to the worklist.
   GreedyRewriteStrictness strict_mode = GreedyRewriteStrictness::AnyOp;
 
+  /// By default an iteration only revisits the ops created, updated or made
+  /// single-use through the rewriter in the last iteration, and the whole
+  /// region is rescanned once they are done, to catch the IR modified behind
+  /// the rewriter, until a rescan changes nothing. Set it to true to rescan
+  /// the whole region after every iteration that changed the IR instead.
+  /// Either way the iterations are bounded by `max_iterations`.
+  bool rescan_on_change = false;
+
   static constexpr int64_t kNoLimit = -1;
 };
 
@@ -64,6 +64,10 @@ class DeadCodeEliminationPass : public pir::Pass {
   bool CanApplyOn(pir::Operation *op) const override {
     return op->isa<::pir::ModuleOp>() && op->num_regions() > 0;
   }
+
+  std::unique_ptr<pir::Pass> Clone() const override {
+    return std::make_unique<DeadCodeEliminationPass>();
+  }
 };
 
 }  // namespace
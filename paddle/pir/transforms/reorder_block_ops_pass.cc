@@ -89,6 +89,10 @@ class ReorderBlockOpsPass : public pir::Pass {
   bool CanApplyOn(pir::Operation *op) const override {
     return op->num_regions() > 0;
   }
+
+  std::unique_ptr<pir::Pass> Clone() const override {
+    return std::make_unique<ReorderBlockOpsPass>();
+  }
 };
 
 }  // namespace
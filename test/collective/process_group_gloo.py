@@ -13,6 +13,7 @@
 # limitations under the License.
 
 import random
+import time
 import unittest
 from copy import deepcopy
 
@@ -228,6 +229,79 @@ class TestProcessGroupFp32(unittest.TestCase):
         test_gather(pg.size() - 1)
         print("test gather api ok\n")
 
+        # test alltoall
+        # rank r sends r * size + i to rank i
+        in_list = [
+            paddle.full(self.shape, pg.rank() * pg.size() + i, self.dtype)
+            for i in range(pg.size())
+        ]
+        out_list = [
+            paddle.zeros(self.shape).astype(self.dtype)
+            for _ in range(pg.size())
+        ]
+        task = pg.all_to_all(out_list, in_list, True)
+        task.wait()
+        for i in range(pg.size()):
+            np.testing.assert_array_equal(
+                out_list[i],
+                np.full(self.shape, i * pg.size() + pg.rank(), self.dtype),
+            )
+        print("test alltoall api ok\n")
+
+        # test reduce_scatter
+        x = np.random.random((pg.size(),) + self.shape).astype(self.dtype)
+        tensor_x = paddle.to_tensor(x)
+        in_list = [tensor_x[i] for i in range(pg.size())]
+        tensor_out = paddle.zeros(self.shape).astype(self.dtype)
+        task = pg.reduce_scatter(tensor_out, in_list, core.ReduceOp.SUM, True)
+        task.wait()
+        tensor_sum = paddle.to_tensor(x)
+        pg.all_reduce(tensor_sum, core.ReduceOp.SUM, True).wait()
+        np.testing.assert_allclose(
+            tensor_out, tensor_sum[pg.rank()], rtol=1e-05
+        )
+        print("test reduce_scatter api ok\n")
+
+        # test async allreduce, the tasks complete in the issued order
+        xs = [
+            np.random.random(self.shape).astype(self.dtype) for _ in range(8)
+        ]
+        tensors = [paddle.to_tensor(x) for x in xs]
+        expected = [paddle.to_tensor(x) for x in xs]
+        for t in expected:
+            pg.all_reduce(t, core.ReduceOp.SUM, True).wait()
+        tasks = [
+            pg.all_reduce(t, core.ReduceOp.SUM, False) for t in tensors
+        ]
+        for task in tasks:
+            task.wait()
+            self.assertTrue(task.is_completed())
+        for t, e in zip(tensors, expected):
+            np.testing.assert_array_equal(t, e)
+        print("test async allreduce api ok\n")
+
+        # allreduce bandwidth of one fused bucket against many small ones
+        numel = 1 << 20
+        small = [paddle.ones([numel // 64], self.dtype) for _ in range(64)]
+        fused = paddle.ones([numel], self.dtype)
+        start = time.time()
+        tasks = [pg.all_reduce(t, core.ReduceOp.SUM, False) for t in small]
+        for task in tasks:
+            task.wait()
+        small_time = time.time() - start
+        start = time.time()
+        pg.all_reduce(fused, core.ReduceOp.SUM, True).wait()
+        fused_time = time.time() - start
+        nbytes = numel * np.dtype(self.dtype).itemsize
+        print(
+            "allreduce {} MB: 64 async tasks {:.2f} MB/s, "
+            "one bucket {:.2f} MB/s\n".format(
+                nbytes >> 20,
+                nbytes / (1 << 20) / small_time,
+                nbytes / (1 << 20) / fused_time,
+            )
+        )
+
 
 if __name__ == "__main__":
     unittest.main()
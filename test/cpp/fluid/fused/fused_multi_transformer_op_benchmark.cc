@@ -0,0 +1,274 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// The decoding throughput of fused_multi_transformer on CPU against the ops
+// of the program it replaces. This target is built with the tests but not
+// run by ctest, run it by hand.
+
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "test/cpp/fluid/fused/fused_multi_transformer_test.h"
+
+USE_OP_ITSELF(layer_norm);
+USE_OP_ITSELF(matmul_v2);
+USE_OP_ITSELF(elementwise_add);
+USE_OP_ITSELF(reshape2);
+USE_OP_ITSELF(transpose2);
+USE_OP_ITSELF(split);
+USE_OP_ITSELF(concat);
+USE_OP_ITSELF(assign);
+USE_OP_ITSELF(scale);
+USE_OP_ITSELF(softmax);
+USE_OP_ITSELF(gelu);
+
+PD_DECLARE_KERNEL(layer_norm, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(matmul, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(reshape, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(transpose, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(split_with_num, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(concat, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(assign, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(scale, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(softmax, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(gelu, CPU, ALL_LAYOUT);
+
+namespace {
+
+// The pre layer norm layers as the ops of the program matched by
+// fused_multi_transformer_decoder_fuse_qkv_pass, on the weights created by
+// CreateWeights with trans_qkvw false. The keys and values are concatenated
+// to the caches [1, bsz, num_head, len, dim_head] and assigned back at every
+// decoding step.
+class UnfusedProgram {
+ public:
+  UnfusedProgram(const TransformerConfig& c, f::Scope* scope)
+      : c_(c), scope_(scope) {
+    int64_t e = c.dim_embed();
+    // matmul_v2 and elementwise_add take the qkv weight and bias flattened.
+    for (int i = 0; i < c.layers; ++i) {
+      ShareFlattened(VarName("QKVW", i), VarName("QKVWMat", i), {e, 3 * e});
+      ShareFlattened(VarName("QKVBias", i), VarName("QKVBiasVec", i), {3 * e});
+    }
+  }
+
+  // Runs x [bsz, seq_len, dim_embed] as the context stage, or as the
+  // decoding step time_step > 0 with seq_len 1.
+  std::vector<float> Run(const std::vector<float>& x,
+                         int seq_len,
+                         int time_step) {
+    auto& ops = time_step > 0 ? decode_ops_ : context_ops_;
+    if (ops.empty()) {
+      Build(seq_len, time_step > 0, &ops);
+    }
+    float* x_data = NewTensor(
+        scope_, VarName("UnfusedX", 0), {c_.bsz, seq_len, c_.dim_embed()});
+    std::copy(x.begin(), x.end(), x_data);
+    CreateSrcMask(c_, scope_, seq_len, time_step);
+    for (auto& op : ops) {
+      op->Run(*scope_, p::CPUPlace());
+    }
+    const float* out = Data(*scope_, VarName("UnfusedX", c_.layers));
+    return std::vector<float>(out, out + c_.bsz * seq_len * c_.dim_embed());
+  }
+
+ private:
+  void ShareFlattened(const std::string& src,
+                      const std::string& dst,
+                      const std::vector<int64_t>& shape) {
+    auto* tensor = scope_->Var(dst)->GetMutable<phi::DenseTensor>();
+    tensor->ShareDataWith(scope_->FindVar(src)->Get<phi::DenseTensor>());
+    tensor->Resize(phi::make_ddim(shape));
+  }
+
+  void Build(int seq_len,
+             bool decode,
+             std::vector<std::unique_ptr<f::OperatorBase>>* ops) {
+    auto add_op = [&](const std::string& type,
+                      const f::VariableNameMap& inputs,
+                      const f::VariableNameMap& outputs,
+                      const f::AttributeMap& attrs) {
+      ops->push_back(f::OpRegistry::CreateOp(type, inputs, outputs, attrs));
+      for (const auto* names : {&inputs, &outputs}) {
+        for (const auto& item : *names) {
+          for (const auto& name : item.second) {
+            scope_->Var(name)->GetMutable<phi::DenseTensor>();
+          }
+        }
+      }
+    };
+    auto layer_norm = [&](const std::string& x,
+                          const std::string& scale,
+                          const std::string& bias,
+                          const std::string& out) {
+      add_op("layer_norm",
+             {{"X", {x}}, {"Scale", {scale}}, {"Bias", {bias}}},
+             {{"Y", {out}},
+              {"Mean", {out + "_mean"}},
+              {"Variance", {out + "_var"}}},
+             {{"epsilon", 1e-5f}, {"begin_norm_axis", 2}});
+    };
+    auto matmul = [&](const std::string& x,
+                      const std::string& y,
+                      const std::string& out,
+                      bool trans_y) {
+      add_op("matmul_v2",
+             {{"X", {x}}, {"Y", {y}}},
+             {{"Out", {out}}},
+             {{"trans_x", false}, {"trans_y", trans_y}});
+    };
+    auto add = [&](const std::string& x,
+                   const std::string& y,
+                   const std::string& out) {
+      add_op("elementwise_add",
+             {{"X", {x}}, {"Y", {y}}},
+             {{"Out", {out}}},
+             {{"axis", -1}});
+    };
+    auto reshape = [&](const std::string& x,
+                       const std::string& out,
+                       const std::vector<int>& shape) {
+      add_op("reshape2",
+             {{"X", {x}}},
+             {{"Out", {out}}, {"XShape", {out + "_xshape"}}},
+             {{"shape", shape}});
+    };
+    auto transpose = [&](const std::string& x,
+                         const std::string& out,
+                         const std::vector<int>& axis) {
+      add_op("transpose2",
+             {{"X", {x}}},
+             {{"Out", {out}}, {"XShape", {out + "_xshape"}}},
+             {{"axis", axis}});
+    };
+
+    const int e = c_.dim_embed();
+    for (int i = 0; i < c_.layers; ++i) {
+      auto var = [i](const std::string& name) { return VarName(name, i); };
+      const std::string x = VarName("UnfusedX", i);
+      layer_norm(x, var("LnScale"), var("LnBias"), var("ln_out"));
+      matmul(var("ln_out"), var("QKVWMat"), var("qkv_mm"), false);
+      add(var("qkv_mm"), var("QKVBiasVec"), var("qkv"));
+      reshape(var("qkv"), var("qkv_r"), {0, 0, 3, c_.num_head, c_.dim_head});
+      // [3, bsz, num_head, seq_len, dim_head]
+      transpose(var("qkv_r"), var("qkv_t"), {2, 0, 3, 1, 4});
+      add_op("split",
+             {{"X", {var("qkv_t")}}},
+             {{"Out", {var("q"), var("k"), var("v")}}},
+             {{"axis", 0}, {"num", 3}});
+      for (const std::string kv : {"k", "v"}) {
+        const std::string cache = var(kv == "k" ? "CacheK" : "CacheV");
+        if (decode) {
+          add_op("concat",
+                 {{"X", {cache, var(kv)}}},
+                 {{"Out", {var(kv + "_cat")}}},
+                 {{"axis", 3}});
+          add_op("assign", {{"X", {var(kv + "_cat")}}}, {{"Out", {cache}}}, {});
+        } else {
+          add_op("assign", {{"X", {var(kv)}}}, {{"Out", {cache}}}, {});
+        }
+      }
+      const std::string k = decode ? var("k_cat") : var("k");
+      const std::string v = decode ? var("v_cat") : var("v");
+      matmul(var("q"), k, var("qk"), true);
+      add_op("scale",
+             {{"X", {var("qk")}}},
+             {{"Out", {var("qk_scaled")}}},
+             {{"scale", 1.f / std::sqrt(static_cast<float>(c_.dim_head))}});
+      add(var("qk_scaled"), "SrcMask", var("qk_masked"));
+      add_op("softmax",
+             {{"X", {var("qk_masked")}}},
+             {{"Out", {var("prob")}}},
+             {{"axis", -1}});
+      matmul(var("prob"), v, var("attn"), false);
+      transpose(var("attn"), var("attn_t"), {0, 1, 3, 2, 4});
+      reshape(var("attn_t"), var("attn_r"), {c_.bsz, seq_len, e});
+      matmul(var("attn_r"), var("OutLinearW"), var("linear_mm"), false);
+      add(var("linear_mm"), var("OutLinearBias"), var("linear"));
+      add(var("linear"), x, var("residual"));
+
+      layer_norm(
+          var("residual"), var("FFNLnScale"), var("FFNLnBias"), var("ffn_ln"));
+      matmul(var("ffn_ln"), var("FFN1Weight"), var("ffn1_mm"), false);
+      add(var("ffn1_mm"), var("FFN1Bias"), var("ffn1"));
+      add_op("gelu",
+             {{"X", {var("ffn1")}}},
+             {{"Out", {var("ffn1_act")}}},
+             {{"approximate", false}});
+      matmul(var("ffn1_act"), var("FFN2Weight"), var("ffn2_mm"), false);
+      add(var("ffn2_mm"), var("FFN2Bias"), var("ffn2"));
+      add(var("ffn2"), var("residual"), VarName("UnfusedX", i + 1));
+    }
+  }
+
+  TransformerConfig c_;
+  f::Scope* scope_;
+  std::vector<std::unique_ptr<f::OperatorBase>> context_ops_;
+  std::vector<std::unique_ptr<f::OperatorBase>> decode_ops_;
+};
+
+double DurationMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+TEST(FusedMultiTransformerOp, CPUDecodeBenchmark) {
+  constexpr int kContextLen = 32;
+  constexpr int kSteps = 64;
+  for (int bsz : {1, 4}) {
+    TransformerConfig c{12, 12, 64, 3072, true, 160, bsz, false};
+    f::Scope scope;
+    CreateWeights(c, &scope);
+    UnfusedProgram unfused(c, &scope);
+    auto context = RandomInput(bsz * kContextLen, c.dim_embed(), 0);
+    RunFused(c, &scope, context, kContextLen, 0);
+    unfused.Run(context, kContextLen, 0);
+
+    // Both run the same steps, the first one checks the program is the same.
+    auto x = RandomInput(bsz, c.dim_embed(), kContextLen);
+    auto fused_out = RunFused(c, &scope, x, 1, kContextLen);
+    auto unfused_out = unfused.Run(x, 1, kContextLen);
+    ASSERT_EQ(fused_out.size(), unfused_out.size());
+    for (size_t i = 0; i < fused_out.size(); ++i) {
+      ASSERT_NEAR(fused_out[i], unfused_out[i], 1e-2) << "element " << i;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step = kContextLen + 1; step < kContextLen + kSteps; ++step) {
+      RunFused(c, &scope, RandomInput(bsz, c.dim_embed(), step), 1, step);
+    }
+    double fused_ms = DurationMs(start);
+    start = std::chrono::steady_clock::now();
+    for (int step = kContextLen + 1; step < kContextLen + kSteps; ++step) {
+      unfused.Run(RandomInput(bsz, c.dim_embed(), step), 1, step);
+    }
+    double unfused_ms = DurationMs(start);
+
+    int tokens = bsz * (kSteps - 1);
+    LOG(INFO) << c.layers << " layers of " << c.dim_embed()
+              << " hidden, batch " << bsz << ", decoding: fused "
+              << tokens * 1000 / fused_ms << " tokens/s, unfused ops "
+              << tokens * 1000 / unfused_ms << " tokens/s";
+  }
+}
@@ -0,0 +1,217 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "test/cpp/fluid/fused/fused_multi_transformer_test.h"
+
+namespace {
+
+// The layers as the unfused program runs them, with an op per step writing
+// its own output, and the keys and values concatenated to the caches.
+class UnfusedTransformer {
+ public:
+  UnfusedTransformer(const TransformerConfig& c, const f::Scope* scope)
+      : c_(c),
+        scope_(scope),
+        blas_(phi::funcs::GetBlas<phi::CPUContext, float>(
+            *static_cast<phi::CPUContext*>(
+                p::DeviceContextPool::Instance().Get(p::CPUPlace())))),
+        caches_(c.layers, std::vector<std::vector<float>>(c.bsz)) {}
+
+  // x is [bsz, seq_len, dim_embed].
+  std::vector<float> Run(std::vector<float> x, int seq_len) {
+    int e = c_.dim_embed();
+    for (int i = 0; i < c_.layers; ++i) {
+      auto h =
+          c_.pre_layer_norm ? LayerNorm(x, W("LnScale", i), W("LnBias", i)) : x;
+      auto qkv = MatMul(h, W("QKVW", i), e, 3 * e, c_.trans_qkvw);
+      AddBias(&qkv, W("QKVBias", i), 3 * e);
+      std::vector<float> attn;
+      for (int b = 0; b < c_.bsz; ++b) {
+        auto out = Attention(qkv.data() + b * seq_len * 3 * e,
+                             seq_len,
+                             &caches_[i][b]);
+        attn.insert(attn.end(), out.begin(), out.end());
+      }
+      auto y = MatMul(attn, W("OutLinearW", i), e, e, false);
+      AddBias(&y, W("OutLinearBias", i), e);
+      AddResidual(&y, x);
+      if (!c_.pre_layer_norm) {
+        y = LayerNorm(y, W("LnScale", i), W("LnBias", i));
+      }
+      h = c_.pre_layer_norm
+              ? LayerNorm(y, W("FFNLnScale", i), W("FFNLnBias", i))
+              : y;
+      auto ffn = MatMul(h, W("FFN1Weight", i), e, c_.dim_ffn, false);
+      AddBias(&ffn, W("FFN1Bias", i), c_.dim_ffn);
+      for (auto& v : ffn) {
+        v = 0.5f * v * (1.f + std::erf(v * static_cast<float>(M_SQRT1_2)));
+      }
+      x = MatMul(ffn, W("FFN2Weight", i), c_.dim_ffn, e, false);
+      AddBias(&x, W("FFN2Bias", i), e);
+      AddResidual(&x, y);
+      if (!c_.pre_layer_norm) {
+        x = LayerNorm(x, W("FFNLnScale", i), W("FFNLnBias", i));
+      }
+    }
+    return x;
+  }
+
+ private:
+  const float* W(const std::string& name, int layer) const {
+    return Data(*scope_, VarName(name, layer));
+  }
+
+  std::vector<float> MatMul(
+      const std::vector<float>& x, const float* w, int k, int n, bool trans) {
+    int m = static_cast<int>(x.size()) / k;
+    std::vector<float> out(m * n);
+    blas_.GEMM(CblasNoTrans,
+               trans ? CblasTrans : CblasNoTrans,
+               m,
+               n,
+               k,
+               1.f,
+               x.data(),
+               w,
+               0.f,
+               out.data());
+    return out;
+  }
+
+  void AddBias(std::vector<float>* x, const float* bias, int width) {
+    for (size_t i = 0; i < x->size(); ++i) (*x)[i] += bias[i % width];
+  }
+
+  void AddResidual(std::vector<float>* x, const std::vector<float>& y) {
+    for (size_t i = 0; i < x->size(); ++i) (*x)[i] += y[i];
+  }
+
+  std::vector<float> LayerNorm(const std::vector<float>& x,
+                               const float* scale,
+                               const float* bias) {
+    int e = c_.dim_embed();
+    std::vector<float> out(x.size());
+    for (size_t r = 0; r < x.size() / e; ++r) {
+      const float* row = x.data() + r * e;
+      float mean = 0.f, var = 0.f;
+      for (int j = 0; j < e; ++j) mean += row[j] / e;
+      for (int j = 0; j < e; ++j) var += (row[j] - mean) * (row[j] - mean) / e;
+      for (int j = 0; j < e; ++j) {
+        out[r * e + j] =
+            (row[j] - mean) / std::sqrt(var + 1e-5f) * scale[j] + bias[j];
+      }
+    }
+    return out;
+  }
+
+  // qkv is [seq_len, 3, num_head, dim_head], cache holds the keys and values
+  // of the previous steps as [len, 2, num_head, dim_head] and grows by the
+  // new ones, which every query attends to up to its own position.
+  std::vector<float> Attention(const float* qkv,
+                               int seq_len,
+                               std::vector<float>* cache) {
+    int e = c_.dim_embed();
+    int past = static_cast<int>(cache->size()) / (2 * e);
+    for (int s = 0; s < seq_len; ++s) {
+      cache->insert(
+          cache->end(), qkv + s * 3 * e + e, qkv + (s + 1) * 3 * e);
+    }
+    std::vector<float> out(seq_len * e);
+    for (int s = 0; s < seq_len; ++s) {
+      for (int h = 0; h < c_.num_head; ++h) {
+        const float* q = qkv + s * 3 * e + h * c_.dim_head;
+        int len = past + s + 1;
+        std::vector<float> prob(len);
+        float max_value = -1e30f, sum = 0.f;
+        for (int t = 0; t < len; ++t) {
+          const float* k = cache->data() + t * 2 * e + h * c_.dim_head;
+          float dot = 0.f;
+          for (int d = 0; d < c_.dim_head; ++d) dot += q[d] * k[d];
+          prob[t] = dot / std::sqrt(static_cast<float>(c_.dim_head));
+          max_value = std::max(max_value, prob[t]);
+        }
+        for (auto& v : prob) {
+          v = std::exp(v - max_value);
+          sum += v;
+        }
+        for (int t = 0; t < len; ++t) {
+          const float* v = cache->data() + t * 2 * e + e + h * c_.dim_head;
+          for (int d = 0; d < c_.dim_head; ++d) {
+            out[s * e + h * c_.dim_head + d] += prob[t] / sum * v[d];
+          }
+        }
+      }
+    }
+    return out;
+  }
+
+  TransformerConfig c_;
+  const f::Scope* scope_;
+  phi::funcs::BlasT<phi::CPUContext, float> blas_;
+  // the caches of every layer and sequence
+  std::vector<std::vector<std::vector<float>>> caches_;
+};
+
+void ExpectNear(const std::vector<float>& actual,
+                const std::vector<float>& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    ASSERT_NEAR(actual[i], expected[i], 1e-3) << "element " << i;
+  }
+}
+
+// The context stage and the decoding steps after it against the unfused
+// layers.
+void CheckGeneration(const TransformerConfig& c) {
+  f::Scope scope;
+  CreateWeights(c, &scope);
+  UnfusedTransformer unfused(c, &scope);
+  constexpr int kContextLen = 7;
+  auto x = RandomInput(c.bsz * kContextLen, c.dim_embed(), 1);
+  ExpectNear(RunFused(c, &scope, x, kContextLen, 0),
+             unfused.Run(x, kContextLen));
+  for (int step = kContextLen; step < kContextLen + 4; ++step) {
+    x = RandomInput(c.bsz, c.dim_embed(), step);
+    ExpectNear(RunFused(c, &scope, x, 1, step), unfused.Run(x, 1));
+  }
+}
+
+}  // namespace
+
+TEST(FusedMultiTransformerOp, CPUPreLayerNorm) {
+  CheckGeneration({2, 4, 8, 128, true, 16, 1, true});
+}
+
+TEST(FusedMultiTransformerOp, CPUPostLayerNorm) {
+  CheckGeneration({2, 4, 8, 128, false, 16, 1, true});
+}
+
+TEST(FusedMultiTransformerOp, CPUBatch) {
+  CheckGeneration({2, 4, 8, 128, true, 16, 3, true});
+  CheckGeneration({2, 4, 8, 128, false, 16, 3, true});
+}
+
+TEST(FusedMultiTransformerOp, CPUNotTransQKVW) {
+  CheckGeneration({2, 4, 8, 128, true, 16, 1, false});
+  CheckGeneration({2, 4, 8, 128, false, 16, 3, false});
+}
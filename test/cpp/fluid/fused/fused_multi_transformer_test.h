@@ -0,0 +1,184 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/platform/place.h"
+
+// The weights and the run of fused_multi_transformer on CPU shared by
+// fused_multi_transformer_op_test and fused_multi_transformer_op_benchmark.
+
+namespace f = paddle::framework;
+namespace p = paddle::platform;
+
+USE_OP_ITSELF(fused_multi_transformer);
+
+struct TransformerConfig {
+  int layers;
+  int num_head;
+  int dim_head;
+  int dim_ffn;
+  bool pre_layer_norm;
+  int max_seq_len;
+  int bsz;
+  bool trans_qkvw;
+
+  int dim_embed() const { return num_head * dim_head; }
+};
+
+const char* const kWeightNames[] = {"LnScale",
+                                    "LnBias",
+                                    "QKVW",
+                                    "QKVBias",
+                                    "OutLinearW",
+                                    "OutLinearBias",
+                                    "FFNLnScale",
+                                    "FFNLnBias",
+                                    "FFN1Weight",
+                                    "FFN1Bias",
+                                    "FFN2Weight",
+                                    "FFN2Bias"};
+
+inline std::vector<int64_t> WeightShape(const TransformerConfig& c,
+                                        const std::string& name) {
+  int64_t e = c.dim_embed();
+  if (name == "QKVW") {
+    if (c.trans_qkvw) return {3, c.num_head, c.dim_head, e};
+    return {e, 3, c.num_head, c.dim_head};
+  }
+  if (name == "QKVBias") return {3, c.num_head, c.dim_head};
+  if (name == "OutLinearW") return {e, e};
+  if (name == "FFN1Weight") return {e, c.dim_ffn};
+  if (name == "FFN1Bias") return {c.dim_ffn};
+  if (name == "FFN2Weight") return {c.dim_ffn, e};
+  return {e};
+}
+
+inline std::string VarName(const std::string& name, int layer) {
+  return name + std::to_string(layer);
+}
+
+inline const float* Data(const f::Scope& scope, const std::string& name) {
+  return scope.FindVar(name)->Get<phi::DenseTensor>().data<float>();
+}
+
+inline float* NewTensor(f::Scope* scope,
+                        const std::string& name,
+                        const std::vector<int64_t>& shape) {
+  auto* tensor = scope->Var(name)->GetMutable<phi::DenseTensor>();
+  tensor->Resize(phi::make_ddim(shape));
+  return tensor->mutable_data<float>(p::CPUPlace());
+}
+
+inline void CreateWeights(const TransformerConfig& c, f::Scope* scope) {
+  std::default_random_engine engine(0);
+  std::normal_distribution<float> dist(0.f, 0.05f);
+  for (int i = 0; i < c.layers; ++i) {
+    for (const char* name : kWeightNames) {
+      auto shape = WeightShape(c, name);
+      float* data = NewTensor(scope, VarName(name, i), shape);
+      int64_t numel = 1;
+      for (auto d : shape) numel *= d;
+      bool is_scale = std::string(name).find("LnScale") != std::string::npos;
+      for (int64_t j = 0; j < numel; ++j) {
+        data[j] = (is_scale ? 1.f : 0.f) + dist(engine);
+      }
+    }
+    NewTensor(scope,
+              VarName("CacheKV", i),
+              {2, c.bsz, c.num_head, c.max_seq_len, c.dim_head});
+  }
+}
+
+// The causal mask of the context stage [bsz, 1, seq_len, seq_len], or the
+// mask of a decoding step [bsz, 1, 1, time_step + 1] attending to all the
+// positions before.
+inline void CreateSrcMask(const TransformerConfig& c,
+                          f::Scope* scope,
+                          int seq_len,
+                          int time_step) {
+  if (time_step > 0) {
+    float* mask = NewTensor(scope, "SrcMask", {c.bsz, 1, 1, time_step + 1});
+    std::fill(mask, mask + c.bsz * (time_step + 1), 0.f);
+    return;
+  }
+  float* mask = NewTensor(scope, "SrcMask", {c.bsz, 1, seq_len, seq_len});
+  for (int b = 0; b < c.bsz; ++b) {
+    for (int i = 0; i < seq_len; ++i) {
+      for (int j = 0; j < seq_len; ++j) {
+        mask[(b * seq_len + i) * seq_len + j] = j <= i ? 0.f : -10000.f;
+      }
+    }
+  }
+}
+
+// Runs the fused op on x [bsz, seq_len, dim_embed], at time_step > 0 for a
+// decoding step, or the context stage otherwise.
+inline std::vector<float> RunFused(const TransformerConfig& c,
+                                   f::Scope* scope,
+                                   const std::vector<float>& x,
+                                   int seq_len,
+                                   int time_step) {
+  int64_t e = c.dim_embed();
+  float* x_data = NewTensor(scope, "X", {c.bsz, seq_len, e});
+  std::copy(x.begin(), x.end(), x_data);
+  f::VariableNameMap inputs{{"X", {"X"}}, {"SrcMask", {"SrcMask"}}};
+  for (const char* name : kWeightNames) {
+    for (int i = 0; i < c.layers; ++i) {
+      inputs[name].push_back(VarName(name, i));
+    }
+  }
+  for (int i = 0; i < c.layers; ++i) {
+    inputs["CacheKV"].push_back(VarName("CacheKV", i));
+  }
+  if (time_step > 0) {
+    inputs["TimeStep"] = {"TimeStep"};
+    auto* step = scope->Var("TimeStep")->GetMutable<phi::DenseTensor>();
+    step->Resize({1});
+    step->mutable_data<int>(p::CPUPlace())[0] = time_step;
+  }
+  CreateSrcMask(c, scope, seq_len, time_step);
+
+  f::AttributeMap attrs;
+  attrs["pre_layer_norm"] = c.pre_layer_norm;
+  attrs["epsilon"] = 1e-5f;
+  attrs["dropout_rate"] = 0.f;
+  attrs["is_test"] = true;
+  attrs["act_method"] = std::string("gelu");
+  attrs["trans_qkvw"] = c.trans_qkvw;
+  auto op = f::OpRegistry::CreateOp(
+      "fused_multi_transformer",
+      inputs,
+      {{"Out", {"Out"}}, {"CacheKVOut", inputs["CacheKV"]}},
+      attrs);
+  op->Run(*scope, p::CPUPlace());
+  const float* out = Data(*scope, "Out");
+  return std::vector<float>(out, out + c.bsz * seq_len * e);
+}
+
+inline std::vector<float> RandomInput(int tokens, int dim_embed, int seed) {
+  std::default_random_engine engine(seed);
+  std::normal_distribution<float> dist(0.f, 1.f);
+  std::vector<float> x(tokens * dim_embed);
+  for (auto& v : x) v = dist(engine);
+  return x;
+}
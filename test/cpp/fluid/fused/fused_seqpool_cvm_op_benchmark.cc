@@ -0,0 +1,111 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// The timings of fused_seqpool_cvm on CPU against the sequence_pool and cvm
+// ops it replaces. This target is built with the tests but not run by
+// ctest, run it by hand.
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "test/cpp/fluid/fused/fused_seqpool_cvm_test.h"
+
+USE_OP_ITSELF(sequence_pool);
+USE_OP_ITSELF(cvm);
+
+PD_DECLARE_KERNEL(sequence_pool, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(cvm, CPU, ALL_LAYOUT);
+
+namespace {
+
+// The milliseconds of a call of func, averaged over kRepeats calls after a
+// first one to warm up.
+template <typename Func>
+double AverageMs(const Func& func) {
+  constexpr int kRepeats = 20;
+  func();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeats; ++i) {
+    func();
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         kRepeats;
+}
+
+}  // namespace
+
+TEST(FusedSeqpoolCVMOp, CPUBenchmark) {
+  SeqpoolCVMCase c{400, 512, 11, 6, true, 0.f};
+  f::Scope scope;
+  std::default_random_engine engine(0);
+  CreateInputs(c, &scope, &engine);
+  double fused_ms = AverageMs([&] { RunForward(c, &scope); });
+
+  // The program before the fusion, a sequence_pool and a cvm per slot with
+  // the pooled rows in between.
+  std::vector<std::unique_ptr<f::OperatorBase>> ops;
+  auto x_names = SlotNames("x", c.slot_num);
+  auto pool_names = SlotNames("pool", c.slot_num);
+  auto y_names = SlotNames("y", c.slot_num);
+  for (int s = 0; s < c.slot_num; ++s) {
+    ops.push_back(f::OpRegistry::CreateOp(
+        "sequence_pool",
+        {{"X", {x_names[s]}}},
+        {{"Out", {pool_names[s]}}, {"MaxIndex", {pool_names[s] + "_index"}}},
+        {{"pooltype", std::string("SUM")}, {"pad_value", c.pad_value}}));
+    ops.push_back(f::OpRegistry::CreateOp("cvm",
+                                          {{"X", {pool_names[s]}},
+                                           {"CVM", {"cvm"}}},
+                                          {{"Y", {y_names[s]}}},
+                                          {{"use_cvm", c.use_cvm}}));
+    scope.Var(pool_names[s])->GetMutable<phi::DenseTensor>();
+    scope.Var(pool_names[s] + "_index")->GetMutable<phi::DenseTensor>();
+    scope.Var(y_names[s])->GetMutable<phi::DenseTensor>();
+  }
+  double separate_ms = AverageMs([&] {
+    for (auto& op : ops) {
+      op->Run(scope, p::CPUPlace());
+    }
+  });
+
+  // Both give the same rows.
+  auto out_names = SlotNames("out", c.slot_num);
+  for (int s = 0; s < c.slot_num; ++s) {
+    const auto& out = scope.FindVar(out_names[s])->Get<phi::DenseTensor>();
+    const auto& y = scope.FindVar(y_names[s])->Get<phi::DenseTensor>();
+    ASSERT_EQ(out.numel(), y.numel());
+    for (int64_t i = 0; i < out.numel(); ++i) {
+      ASSERT_NEAR(out.data<float>()[i], y.data<float>()[i], 1e-5)
+          << "slot " << s << ", element " << i;
+    }
+  }
+
+  for (auto& name : SlotNames("out_grad", c.slot_num)) {
+    auto* out_grad = scope.Var(name)->GetMutable<phi::DenseTensor>();
+    out_grad->Resize({c.batch_size, c.embedding_size});
+    FillRandom(out_grad, &engine);
+  }
+  double grad_ms = AverageMs([&] { RunBackward(c, &scope); });
+  LOG(INFO) << c.slot_num << " slots, batch size " << c.batch_size
+            << ": fused_seqpool_cvm " << fused_ms
+            << " ms, sequence_pool and cvm " << separate_ms
+            << " ms, fused_seqpool_cvm_grad " << grad_ms << " ms";
+}
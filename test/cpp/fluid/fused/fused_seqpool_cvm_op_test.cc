@@ -0,0 +1,110 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/cpp/fluid/fused/fused_seqpool_cvm_test.h"
+
+namespace {
+
+// sequence_pool followed by cvm, with the pooled rows of every slot.
+std::vector<float> ReferenceForward(const SeqpoolCVMCase& c,
+                                    const phi::DenseTensor& x) {
+  const auto& lod = x.lod()[0];
+  const float* data = x.data<float>();
+  int width = c.use_cvm ? c.embedding_size : c.embedding_size - 2;
+  std::vector<float> out;
+  for (int i = 0; i < c.batch_size; ++i) {
+    std::vector<float> pooled(c.embedding_size, c.pad_value);
+    for (size_t k = lod[i]; k < lod[i + 1]; ++k) {
+      for (int j = 0; j < c.embedding_size; ++j) {
+        pooled[j] += data[k * c.embedding_size + j];
+      }
+    }
+    if (c.use_cvm) {
+      pooled[0] = std::log(pooled[0] + 1);
+      pooled[1] = std::log(pooled[1] + 1) - pooled[0];
+    }
+    out.insert(out.end(), pooled.end() - width, pooled.end());
+  }
+  return out;
+}
+
+void CheckForwardAndBackward(const SeqpoolCVMCase& c) {
+  f::Scope scope;
+  std::default_random_engine engine(0);
+  CreateInputs(c, &scope, &engine);
+  RunForward(c, &scope);
+
+  int width = c.use_cvm ? c.embedding_size : c.embedding_size - 2;
+  auto out_names = SlotNames("out", c.slot_num);
+  auto x_names = SlotNames("x", c.slot_num);
+  auto out_grad_names = SlotNames("out_grad", c.slot_num);
+  for (int s = 0; s < c.slot_num; ++s) {
+    const auto& x = scope.FindVar(x_names[s])->Get<phi::DenseTensor>();
+    const auto& out = scope.FindVar(out_names[s])->Get<phi::DenseTensor>();
+    ASSERT_EQ(out.dims()[0], c.batch_size);
+    ASSERT_EQ(out.dims()[1], width);
+    auto expected = ReferenceForward(c, x);
+    for (int64_t i = 0; i < out.numel(); ++i) {
+      ASSERT_NEAR(out.data<float>()[i], expected[i], 1e-5)
+          << "slot " << s << ", element " << i;
+    }
+    auto* out_grad =
+        scope.Var(out_grad_names[s])->GetMutable<phi::DenseTensor>();
+    out_grad->Resize({c.batch_size, width});
+    FillRandom(out_grad, &engine);
+  }
+
+  RunBackward(c, &scope);
+  const float* cvm =
+      scope.FindVar("cvm")->Get<phi::DenseTensor>().data<float>();
+  auto x_grad_names = SlotNames("x_grad", c.slot_num);
+  for (int s = 0; s < c.slot_num; ++s) {
+    const auto& x = scope.FindVar(x_names[s])->Get<phi::DenseTensor>();
+    const auto& x_grad =
+        scope.FindVar(x_grad_names[s])->Get<phi::DenseTensor>();
+    const float* out_grad = scope.FindVar(out_grad_names[s])
+                                ->Get<phi::DenseTensor>()
+                                .data<float>();
+    ASSERT_EQ(x_grad.dims(), x.dims());
+    const auto& lod = x.lod()[0];
+    for (int i = 0; i < c.batch_size; ++i) {
+      for (size_t k = lod[i]; k < lod[i + 1]; ++k) {
+        for (int j = 0; j < c.embedding_size; ++j) {
+          float expected = j < 2 ? cvm[i * 2 + j]
+                                 : out_grad[i * width + j - c.embedding_size +
+                                            width];
+          ASSERT_EQ(x_grad.data<float>()[k * c.embedding_size + j], expected)
+              << "slot " << s << ", row " << k << ", column " << j;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FusedSeqpoolCVMOp, CPUWithCVM) {
+  CheckForwardAndBackward({8, 33, 11, 4, true, 0.f});
+  CheckForwardAndBackward({3, 7, 3, 2, true, 0.5f});
+}
+
+TEST(FusedSeqpoolCVMOp, CPUWithoutCVM) {
+  CheckForwardAndBackward({8, 33, 11, 4, false, 0.f});
+  CheckForwardAndBackward({2, 5, 3, 2, false, 0.f});
+}
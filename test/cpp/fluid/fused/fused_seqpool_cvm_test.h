@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/framework/scope.h"
+
+// The inputs and the runs of fused_seqpool_cvm on CPU shared by
+// fused_seqpool_cvm_op_test and fused_seqpool_cvm_op_benchmark.
+
+namespace f = paddle::framework;
+namespace p = paddle::platform;
+
+USE_OP_ITSELF(fused_seqpool_cvm);
+USE_OP_ITSELF(fused_seqpool_cvm_grad);
+
+struct SeqpoolCVMCase {
+  int slot_num;
+  int batch_size;
+  int embedding_size;
+  int max_seq_len;
+  bool use_cvm;
+  float pad_value;
+};
+
+inline std::vector<std::string> SlotNames(const std::string& prefix,
+                                          int slot_num) {
+  std::vector<std::string> names;
+  for (int i = 0; i < slot_num; ++i) {
+    names.push_back(prefix + std::to_string(i));
+  }
+  return names;
+}
+
+inline void FillRandom(phi::DenseTensor* tensor,
+                       std::default_random_engine* engine) {
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  float* data = tensor->mutable_data<float>(p::CPUPlace());
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = dist(*engine);
+  }
+}
+
+// Creates the slots with random lengths, including empty instances.
+inline void CreateInputs(const SeqpoolCVMCase& c,
+                         f::Scope* scope,
+                         std::default_random_engine* engine) {
+  std::uniform_int_distribution<int> len_dist(0, c.max_seq_len);
+  for (auto& name : SlotNames("x", c.slot_num)) {
+    f::LoD lod(1, {0});
+    for (int i = 0; i < c.batch_size; ++i) {
+      lod[0].push_back(lod[0].back() + len_dist(*engine));
+    }
+    auto* x = scope->Var(name)->GetMutable<phi::DenseTensor>();
+    x->Resize({static_cast<int64_t>(lod[0].back()), c.embedding_size});
+    x->set_lod(lod);
+    FillRandom(x, engine);
+  }
+  auto* cvm = scope->Var("cvm")->GetMutable<phi::DenseTensor>();
+  cvm->Resize({c.batch_size, 2});
+  FillRandom(cvm, engine);
+}
+
+inline f::AttributeMap Attrs(const SeqpoolCVMCase& c) {
+  f::AttributeMap attrs;
+  attrs["pooltype"] = std::string("SUM");
+  attrs["pad_value"] = c.pad_value;
+  attrs["use_cvm"] = c.use_cvm;
+  attrs["cvm_offset"] = 2;
+  return attrs;
+}
+
+inline void RunForward(const SeqpoolCVMCase& c, f::Scope* scope) {
+  auto op = f::OpRegistry::CreateOp(
+      "fused_seqpool_cvm",
+      {{"X", SlotNames("x", c.slot_num)}, {"CVM", {"cvm"}}},
+      {{"Out", SlotNames("out", c.slot_num)}},
+      Attrs(c));
+  op->Run(*scope, p::CPUPlace());
+}
+
+inline void RunBackward(const SeqpoolCVMCase& c, f::Scope* scope) {
+  auto op = f::OpRegistry::CreateOp(
+      "fused_seqpool_cvm_grad",
+      {{"X", SlotNames("x", c.slot_num)},
+       {"CVM", {"cvm"}},
+       {f::GradVarName("Out"), SlotNames("out_grad", c.slot_num)}},
+      {{f::GradVarName("X"), SlotNames("x_grad", c.slot_num)}},
+      Attrs(c));
+  op->Run(*scope, p::CPUPlace());
+}
@@ -14,6 +14,9 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
+#include <map>
+#include <random>
+
 #include "gtest/gtest.h"
 #include "paddle/fluid/memory/allocation/allocator_facade.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -279,6 +282,48 @@ TEST(selected_rows_functor, cpu_merge_add_float) {
   EXPECT_EQ(out_data[2 * row_numel], 1.0);
 }
 
+TEST(selected_rows_functor, cpu_merge_add_negative_rows) {
+  paddle::platform::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+  int64_t height = 256;
+  int64_t row_numel = 10;
+
+  // the negative rows, -1 included, are merged like the other rows
+  std::vector<int64_t> rows{-5, 251, -5, 3, -1, 3};
+  std::unique_ptr<phi::SelectedRows> selected_rows{
+      new phi::SelectedRows(rows, height)};
+  auto* in_value = selected_rows->mutable_value();
+  auto* in_data = in_value->mutable_data<float>(
+      phi::make_ddim({static_cast<int64_t>(rows.size()), row_numel}),
+      cpu_place);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    for (int64_t j = 0; j < row_numel; ++j) {
+      in_data[i * row_numel + j] = static_cast<float>(i + 1);
+    }
+  }
+
+  std::unique_ptr<phi::SelectedRows> output{new phi::SelectedRows()};
+
+  phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add_functor;
+  merge_add_functor(ctx, *selected_rows, output.get());
+
+  auto& out_rows = output->rows();
+  ASSERT_EQ(out_rows.size(), 4u);
+  EXPECT_EQ(out_rows[0], -5);
+  EXPECT_EQ(out_rows[1], -1);
+  EXPECT_EQ(out_rows[2], 3);
+  EXPECT_EQ(out_rows[3], 251);
+
+  auto* out_data = output->value().data<float>();
+  EXPECT_EQ(out_data[0 * row_numel], 4.0);
+  EXPECT_EQ(out_data[1 * row_numel], 5.0);
+  EXPECT_EQ(out_data[2 * row_numel], 10.0);
+  EXPECT_EQ(out_data[3 * row_numel], 2.0);
+}
+
 TEST(selected_rows_functor, cpu_merge_add_int) {
   paddle::platform::CPUPlace cpu_place;
   phi::CPUContext ctx(cpu_place);
@@ -428,6 +473,66 @@ TEST(selected_rows_functor, cpu_merge_add_multi_noduplicated) {
   }
 }
 
+TEST(selected_rows_functor, cpu_merge_add_multi_many_duplicated) {
+  paddle::platform::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+
+  // enough rows for the hot rows to be summed by several threads
+  int64_t height = 100000;
+  int64_t row_numel = 16;
+  std::default_random_engine engine(0);
+  std::uniform_int_distribution<int64_t> hot_dist(0, 3);
+  std::uniform_int_distribution<int64_t> cold_dist(0, height - 1);
+
+  std::vector<std::unique_ptr<phi::SelectedRows>> selected_rows;
+  std::map<int64_t, double> expected;
+  for (int k = 0; k < 3; ++k) {
+    std::vector<int64_t> rows(50000);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      rows[i] = i % 2 == 0 ? hot_dist(engine) : cold_dist(engine);
+    }
+    selected_rows.emplace_back(new phi::SelectedRows(rows, height));
+    auto* value = selected_rows.back()->mutable_value();
+    auto* data = value->mutable_data<float>(
+        phi::make_ddim({static_cast<int64_t>(rows.size()), row_numel}),
+        cpu_place);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      // small integers, so that the sums are exact in any order
+      float v = static_cast<float>(i % 7);
+      for (int64_t j = 0; j < row_numel; ++j) {
+        data[i * row_numel + j] = v;
+      }
+      expected[rows[i]] += v;
+    }
+  }
+
+  std::unique_ptr<phi::SelectedRows> output{new phi::SelectedRows()};
+  phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add_functor;
+  std::vector<const phi::SelectedRows*> inputs;
+  for (auto& rows : selected_rows) {
+    inputs.push_back(rows.get());
+  }
+  merge_add_functor(ctx, inputs, output.get());
+
+  EXPECT_EQ(output->height(), height);
+  ASSERT_EQ(output->rows().size(), expected.size());
+  EXPECT_EQ(output->value().dims(),
+            phi::make_ddim({static_cast<int64_t>(expected.size()), row_numel}));
+
+  auto* out_data = output->value().data<float>();
+  size_t i = 0;
+  for (auto& row : expected) {
+    ASSERT_EQ(output->rows()[i], row.first);
+    for (int64_t j = 0; j < row_numel; ++j) {
+      EXPECT_EQ(out_data[i * row_numel + j], row.second);
+    }
+    ++i;
+  }
+}
+
 TEST(selected_rows_functor, cpu_sum_to) {
   paddle::platform::CPUPlace cpu_place;
   phi::CPUContext ctx(cpu_place);
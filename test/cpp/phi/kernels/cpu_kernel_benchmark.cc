@@ -0,0 +1,357 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The timings of the CPU kernels against the implementations they replaced.
+// This target is built with the tests but not run by ctest, run it by hand,
+// e.g. with --gtest_filter=*embedding*.
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/adam_kernel.h"
+#include "paddle/phi/kernels/adamw_kernel.h"
+#include "paddle/phi/kernels/embedding_grad_kernel.h"
+#include "paddle/phi/kernels/funcs/cpu_layer_norm.h"
+#include "paddle/phi/kernels/funcs/embedding_util.h"
+#include "paddle/phi/kernels/funcs/selected_rows_functor.h"
+#include "paddle/phi/kernels/fused_adam_kernel.h"
+#include "paddle/phi/kernels/layer_norm_grad_kernel.h"
+#include "paddle/phi/kernels/layer_norm_kernel.h"
+#include "paddle/phi/kernels/transpose_kernel.h"
+#include "test/cpp/phi/kernels/cpu_kernel_test_helper.h"
+
+namespace phi {
+namespace tests {
+
+// Merges the rows of out_grad of the same id with std::set and
+// std::unordered_map, as the serial merge did.
+void SerialMerge(const std::vector<int64_t>& ids, const DenseTensor& out_grad) {
+  int64_t width = out_grad.dims()[1];
+  std::set<int64_t> row_set(ids.begin(), ids.end());
+  std::vector<int64_t> rows(row_set.begin(), row_set.end());
+  std::unordered_map<int64_t, size_t> rows_to_id;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    rows_to_id[rows[i]] = i;
+  }
+  std::vector<float> merged(rows.size() * width, 0.f);
+  const float* data = out_grad.data<float>();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    float* dst = merged.data() + rows_to_id.at(ids[i]) * width;
+    for (int64_t j = 0; j < width; ++j) {
+      dst[j] += data[i * width + j];
+    }
+  }
+  EXPECT_FALSE(merged.empty());
+}
+
+TEST(CPU_KERNEL_BENCHMARK, embedding_sparse_grad_zipf) {
+  std::default_random_engine engine(0);
+  const int64_t height = 1000000, width = 64, batch = 1 << 18;
+  for (double s : {0.8, 1.05, 1.5}) {
+    auto ids = ZipfIds(batch, height, s, &engine);
+    auto inputs = CreateEmbeddingGradInputs(ids, height, width, &engine);
+
+    constexpr int kRepeats = 5;
+    SelectedRows weight_grad;
+    double sorted_ms = AverageMs(
+        [&] {
+          EmbeddingSparseGradKernel<float, CPUContext>(GetCPUContext(),
+                                                       inputs.ids,
+                                                       inputs.weight,
+                                                       inputs.out_grad,
+                                                       kNoPadding,
+                                                       &weight_grad);
+        },
+        kRepeats);
+
+    // MergeAdd of the SelectedRows of a row for every id
+    SelectedRows unmerged(ids, height);
+    *unmerged.mutable_value() = inputs.out_grad;
+    SelectedRows merged;
+    funcs::scatter::MergeAdd<CPUContext, float> merge_add;
+    double merge_add_ms =
+        AverageMs([&] { merge_add(GetCPUContext(), unmerged, &merged); },
+                  kRepeats);
+    ASSERT_EQ(merged.rows(), weight_grad.rows());
+
+    double serial_ms =
+        AverageMs([&] { SerialMerge(ids, inputs.out_grad); }, kRepeats);
+    LOG(INFO) << "Zipf s = " << s << ", " << weight_grad.rows().size()
+              << " unique ids of " << batch << ": embedding_sparse_grad "
+              << sorted_ms << " ms, MergeAdd " << merge_add_ms
+              << " ms, serial set and hash map merge " << serial_ms << " ms";
+  }
+}
+
+TEST(CPU_KERNEL_BENCHMARK, lazy_sparse_adam) {
+  std::default_random_engine engine(0);
+  const int64_t height = 1000000, width = 64;
+  AdamState state = RandomAdamState(height, width, &engine);
+  for (int64_t rows : {1 << 14, 1 << 17}) {
+    SelectedRows grad = RandomGrad(rows, height, width, &engine);
+    double seconds =
+        AverageMs([&] { RunLazyAdamW(grad, 0.01f, &state); }) / 1e3;
+    LOG(INFO) << "lazy AdamW of " << rows << " rows of [" << height << ", "
+              << width << "]: " << seconds * 1e3 << " ms, "
+              << rows / seconds << " row updates/s, "
+              << rows * width / seconds << " element updates/s";
+  }
+}
+
+TEST(CPU_KERNEL_BENCHMARK, fused_adam) {
+  // a model of 5000 params of 64 to 4096 elements
+  std::default_random_engine engine(0);
+  std::uniform_int_distribution<int64_t> numel_dist(64, 4096);
+  const int num_params = 5000;
+  std::vector<DenseTensor> params, grads, moment1s, moment2s, beta1_pows,
+      beta2_pows;
+  for (int i = 0; i < num_params; ++i) {
+    int64_t numel = numel_dist(engine);
+    params.push_back(RandomTensor({numel}, -1.f, 1.f, &engine));
+    grads.push_back(RandomTensor({numel}, -1.f, 1.f, &engine));
+    moment1s.push_back(RandomTensor({numel}, -0.1f, 0.1f, &engine));
+    moment2s.push_back(RandomTensor({numel}, 0.f, 0.1f, &engine));
+    beta1_pows.push_back(ScalarTensor(0.9f));
+    beta2_pows.push_back(ScalarTensor(0.99f));
+  }
+  DenseTensor lr = ScalarTensor(1e-3f);
+  auto inputs = [](std::vector<DenseTensor>* tensors) {
+    std::vector<const DenseTensor*> ptrs;
+    for (auto& t : *tensors) ptrs.push_back(&t);
+    return ptrs;
+  };
+  auto outputs = [](std::vector<DenseTensor>* tensors) {
+    std::vector<DenseTensor*> ptrs;
+    for (auto& t : *tensors) ptrs.push_back(&t);
+    return ptrs;
+  };
+
+  for (bool use_adamw : {false, true}) {
+    double fused_ms = AverageMs([&] {
+      FusedAdamKernel<float, CPUContext>(GetCPUContext(),
+                                         inputs(&params),
+                                         inputs(&grads),
+                                         lr,
+                                         inputs(&moment1s),
+                                         inputs(&moment2s),
+                                         inputs(&beta1_pows),
+                                         inputs(&beta2_pows),
+                                         paddle::none,
+                                         paddle::none,
+                                         0.9f,
+                                         0.99f,
+                                         1e-6f,
+                                         16384,
+                                         0.1f,
+                                         use_adamw,
+                                         false,
+                                         false,
+                                         outputs(&params),
+                                         outputs(&moment1s),
+                                         outputs(&moment2s),
+                                         outputs(&beta1_pows),
+                                         outputs(&beta2_pows),
+                                         {});
+    });
+    // the dense kernel of every param
+    double serial_ms = AverageMs([&] {
+      for (int i = 0; i < num_params; ++i) {
+        if (use_adamw) {
+          AdamwDenseKernel<float, CPUContext>(GetCPUContext(),
+                                              params[i],
+                                              grads[i],
+                                              lr,
+                                              moment1s[i],
+                                              moment2s[i],
+                                              beta1_pows[i],
+                                              beta2_pows[i],
+                                              paddle::none,
+                                              paddle::none,
+                                              0.9f,
+                                              0.99f,
+                                              1e-6f,
+                                              1.0f,
+                                              0.1f,
+                                              true,
+                                              false,
+                                              1000,
+                                              false,
+                                              false,
+                                              &params[i],
+                                              &moment1s[i],
+                                              &moment2s[i],
+                                              &beta1_pows[i],
+                                              &beta2_pows[i],
+                                              nullptr);
+        } else {
+          AdamDenseKernel<float, CPUContext>(GetCPUContext(),
+                                             params[i],
+                                             grads[i],
+                                             lr,
+                                             moment1s[i],
+                                             moment2s[i],
+                                             beta1_pows[i],
+                                             beta2_pows[i],
+                                             paddle::none,
+                                             paddle::none,
+                                             0.9f,
+                                             0.99f,
+                                             1e-6f,
+                                             false,
+                                             1000,
+                                             false,
+                                             false,
+                                             &params[i],
+                                             &moment1s[i],
+                                             &moment2s[i],
+                                             &beta1_pows[i],
+                                             &beta2_pows[i],
+                                             nullptr);
+        }
+      }
+    });
+    LOG(INFO) << (use_adamw ? "AdamW" : "Adam") << " step of " << num_params
+              << " params: fused_adam " << fused_ms
+              << " ms, a kernel of every param " << serial_ms << " ms";
+  }
+}
+
+TEST(CPU_KERNEL_BENCHMARK, layer_norm) {
+  std::default_random_engine engine(0);
+  const int64_t tokens = 2048;
+  const float epsilon = 1e-5f;
+  for (int64_t hidden : {768, 1024, 4096, 8192}) {
+    DenseTensor x = RandomTensor({tokens, hidden}, -2.f, 3.f, &engine);
+    DenseTensor residual = RandomTensor({tokens, hidden}, -2.f, 2.f, &engine);
+    DenseTensor scale = RandomTensor({hidden}, 0.5f, 1.5f, &engine);
+    DenseTensor bias = RandomTensor({hidden}, -1.f, 1.f, &engine);
+    DenseTensor dy = RandomTensor({tokens, hidden}, -1.f, 1.f, &engine);
+    DenseTensor y, mean, var, dx, dscale, dbias;
+    y.Resize({tokens, hidden});
+    mean.Resize({tokens});
+    var.Resize({tokens});
+    dx.Resize({tokens, hidden});
+    dscale.Resize({hidden});
+    dbias.Resize({hidden});
+
+    double forward_ms = AverageMs([&] {
+      LayerNormKernel<float, CPUContext>(
+          GetCPUContext(), x, scale, bias, epsilon, 1, &y, &mean, &var);
+    });
+    double backward_ms = AverageMs([&] {
+      LayerNormGradKernel<float, CPUContext>(GetCPUContext(),
+                                             x,
+                                             scale,
+                                             bias,
+                                             mean,
+                                             var,
+                                             dy,
+                                             epsilon,
+                                             1,
+                                             &dx,
+                                             &dscale,
+                                             &dbias);
+    });
+
+    // the residual add followed by the layer norm, and the fused rows
+    DenseTensor sum;
+    sum.Resize({tokens, hidden});
+    float* sum_data = GetCPUContext().template Alloc<float>(&sum);
+    double unfused_ms = AverageMs([&] {
+      for (int64_t i = 0; i < tokens * hidden; ++i) {
+        sum_data[i] = x.data<float>()[i] + residual.data<float>()[i];
+      }
+      LayerNormKernel<float, CPUContext>(
+          GetCPUContext(), sum, scale, bias, epsilon, 1, &y, &mean, &var);
+    });
+    std::vector<float> mean_f(tokens), var_f(tokens);
+    float* y_data = GetCPUContext().template Alloc<float>(&y);
+    double fused_ms = AverageMs([&] {
+      funcs::ResidualAddLayerNormRows(x.data<float>(),
+                                      static_cast<const float*>(nullptr),
+                                      residual.data<float>(),
+                                      1.0f,
+                                      scale.data<float>(),
+                                      bias.data<float>(),
+                                      epsilon,
+                                      tokens,
+                                      hidden,
+                                      sum_data,
+                                      y_data,
+                                      mean_f.data(),
+                                      var_f.data(),
+                                      [](float value) { return value; });
+    });
+
+    // the forward reads x and writes y
+    double forward_gb = 2.0 * tokens * hidden * sizeof(float) / 1e9;
+    LOG(INFO) << "layer_norm [" << tokens << ", " << hidden << "]: forward "
+              << forward_ms << " ms, " << forward_gb / forward_ms * 1e3
+              << " GB/s, backward " << backward_ms
+              << " ms, residual add + layer_norm " << unfused_ms
+              << " ms, fused " << fused_ms << " ms";
+  }
+}
+
+TEST(CPU_KERNEL_BENCHMARK, transpose) {
+  struct Case {
+    const char* name;
+    std::vector<int64_t> x_dims;
+    std::vector<int> axis;
+  };
+  std::vector<Case> cases = {
+      {"[B, S, H, D] -> [B, H, S, D]", {8, 512, 12, 64}, {0, 2, 1, 3}},
+      {"[B, H, S, D] -> [B, H, D, S]", {8, 12, 512, 64}, {0, 1, 3, 2}},
+      {"NCHW -> NHWC", {32, 64, 56, 56}, {0, 2, 3, 1}},
+      {"NHWC -> NCHW", {32, 56, 56, 64}, {0, 3, 1, 2}},
+  };
+  for (const auto& c : cases) {
+    DenseTensor x = IotaTensor<float>(c.x_dims);
+    Permuted permuted = Permute(c.x_dims, c.axis);
+    DenseTensor out;
+    out.Resize(make_ddim(permuted.dims));
+    double transpose_ms = AverageMs([&] {
+      TransposeKernel<float, CPUContext>(GetCPUContext(), x, c.axis, &out);
+    });
+
+    // the copy by the index of every element, as the strided kernels did
+    int rank = static_cast<int>(permuted.dims.size());
+    double index_ms = AverageMs([&] {
+      const float* src = x.data<float>();
+      float* dst = out.data<float>();
+      for (int64_t i = 0; i < out.numel(); ++i) {
+        int64_t index = i, offset = 0;
+        for (int d = rank - 1; d >= 0; --d) {
+          offset += index % permuted.dims[d] * permuted.strides[d];
+          index /= permuted.dims[d];
+        }
+        dst[i] = src[offset];
+      }
+    });
+    // every element is read and written once
+    double gb = 2.0 * x.numel() * sizeof(float) / 1e9;
+    LOG(INFO) << c.name << " of " << x.dims() << ": transpose "
+              << transpose_ms << " ms, " << gb / transpose_ms * 1e3
+              << " GB/s, copy by element index " << index_ms << " ms";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
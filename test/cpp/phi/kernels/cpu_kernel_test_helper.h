@@ -0,0 +1,214 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/funcs/cpu_strided_copy.h"
+#include "paddle/phi/kernels/selected_rows/adamw_kernel.h"
+
+// The inputs and helpers shared by the CPU kernel tests and by
+// cpu_kernel_benchmark.
+
+namespace phi {
+namespace tests {
+
+inline const CPUContext& GetCPUContext() {
+  return *static_cast<const CPUContext*>(
+      DeviceContextPool::Instance().Get(CPUPlace()));
+}
+
+inline DenseTensor RandomTensor(const DDim& dims,
+                                float low,
+                                float high,
+                                std::default_random_engine* engine) {
+  DenseTensor t;
+  t.Resize(dims);
+  float* data = GetCPUContext().template Alloc<float>(&t);
+  std::uniform_real_distribution<float> dist(low, high);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = dist(*engine);
+  }
+  return t;
+}
+
+inline DenseTensor ScalarTensor(float value) {
+  DenseTensor t;
+  t.Resize({1});
+  GetCPUContext().template Alloc<float>(&t)[0] = value;
+  return t;
+}
+
+template <typename T>
+DenseTensor IotaTensor(const std::vector<int64_t>& dims) {
+  DenseTensor t;
+  t.Resize(make_ddim(dims));
+  T* data = GetCPUContext().template Alloc<T>(&t);
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = static_cast<T>(i % 127);
+  }
+  return t;
+}
+
+// The milliseconds of a call of func, averaged over repeats calls after a
+// first one to warm up.
+template <typename Func>
+double AverageMs(const Func& func, int repeats = 10) {
+  func();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i) {
+    func();
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         repeats;
+}
+
+// The ids of the Zipfian distribution of exponent s over [0, height), where
+// the id k is drawn in proportion to 1 / (k + 1)^s.
+inline std::vector<int64_t> ZipfIds(int64_t n,
+                                    int64_t height,
+                                    double s,
+                                    std::default_random_engine* engine) {
+  std::vector<double> weights(height);
+  for (int64_t k = 0; k < height; ++k) {
+    weights[k] = 1.0 / std::pow(static_cast<double>(k + 1), s);
+  }
+  std::discrete_distribution<int64_t> dist(weights.begin(), weights.end());
+  std::vector<int64_t> ids(n);
+  for (auto& id : ids) {
+    id = dist(*engine);
+  }
+  return ids;
+}
+
+struct EmbeddingGradInputs {
+  DenseTensor ids;
+  DenseTensor weight;
+  DenseTensor out_grad;
+};
+
+inline EmbeddingGradInputs CreateEmbeddingGradInputs(
+    const std::vector<int64_t>& ids,
+    int64_t height,
+    int64_t width,
+    std::default_random_engine* engine) {
+  EmbeddingGradInputs inputs;
+  inputs.ids.Resize({static_cast<int64_t>(ids.size())});
+  std::copy(ids.begin(),
+            ids.end(),
+            GetCPUContext().template Alloc<int64_t>(&inputs.ids));
+  // only the shape of the weight is used
+  inputs.weight.Resize({height, width});
+  GetCPUContext().template Alloc<float>(&inputs.weight);
+  inputs.out_grad = RandomTensor(
+      {static_cast<int64_t>(ids.size()), width}, -1.f, 1.f, engine);
+  return inputs;
+}
+
+// A gradient of rows drawn from [0, height), with duplicated rows.
+inline SelectedRows RandomGrad(int64_t rows,
+                               int64_t height,
+                               int64_t width,
+                               std::default_random_engine* engine) {
+  std::uniform_int_distribution<int64_t> dist(0, height - 1);
+  std::vector<int64_t> ids(rows);
+  for (auto& id : ids) {
+    id = dist(*engine);
+  }
+  SelectedRows grad(ids, height);
+  *grad.mutable_value() = RandomTensor({rows, width}, -1.f, 1.f, engine);
+  return grad;
+}
+
+struct AdamState {
+  DenseTensor param, moment1, moment2, beta1_pow, beta2_pow, lr;
+};
+
+inline AdamState RandomAdamState(int64_t height,
+                                 int64_t width,
+                                 std::default_random_engine* engine) {
+  AdamState state;
+  state.param = RandomTensor({height, width}, -1.f, 1.f, engine);
+  state.moment1 = RandomTensor({height, width}, -0.1f, 0.1f, engine);
+  state.moment2 = RandomTensor({height, width}, 0.f, 0.1f, engine);
+  state.beta1_pow = ScalarTensor(0.9f * 0.9f);
+  state.beta2_pow = ScalarTensor(0.999f * 0.999f);
+  state.lr = ScalarTensor(0.01f);
+  return state;
+}
+
+// The lazy AdamW update, or Adam when coeff is 0, of the state in place.
+inline void RunLazyAdamW(const SelectedRows& grad,
+                         float coeff,
+                         AdamState* s) {
+  DenseTensor beta1_pow_out, beta2_pow_out;
+  beta1_pow_out.Resize({1});
+  beta2_pow_out.Resize({1});
+  sr::AdamwDenseParamSparseGradKernel<float, CPUContext>(GetCPUContext(),
+                                                         s->param,
+                                                         grad,
+                                                         s->lr,
+                                                         s->moment1,
+                                                         s->moment2,
+                                                         s->beta1_pow,
+                                                         s->beta2_pow,
+                                                         paddle::none,
+                                                         paddle::none,
+                                                         0.9f,
+                                                         0.999f,
+                                                         1e-8f,
+                                                         1.0f,
+                                                         coeff,
+                                                         coeff != 0.0f,
+                                                         true,
+                                                         1000,
+                                                         false,
+                                                         false,
+                                                         &s->param,
+                                                         &s->moment1,
+                                                         &s->moment2,
+                                                         &beta1_pow_out,
+                                                         &beta2_pow_out,
+                                                         nullptr);
+}
+
+// The dims and the strides of x permuted by axis.
+struct Permuted {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> strides;
+};
+
+inline Permuted Permute(const std::vector<int64_t>& x_dims,
+                        const std::vector<int>& axis) {
+  std::vector<int64_t> x_strides = funcs::ContiguousStrides(x_dims);
+  Permuted permuted;
+  for (int a : axis) {
+    permuted.dims.push_back(x_dims[a]);
+    permuted.strides.push_back(x_strides[a]);
+  }
+  return permuted;
+}
+
+}  // namespace tests
+}  // namespace phi
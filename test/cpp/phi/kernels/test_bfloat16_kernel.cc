@@ -0,0 +1,129 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/kernels/activation_kernel.h"
+#include "paddle/phi/kernels/elementwise_add_kernel.h"
+#include "paddle/phi/kernels/elementwise_multiply_kernel.h"
+#include "paddle/phi/kernels/funcs/jit/refer/refer.h"
+#include "paddle/phi/kernels/gelu_kernel.h"
+#include "test/cpp/phi/kernels/cpu_kernel_test_helper.h"
+
+namespace phi {
+namespace tests {
+
+using bfloat16 = phi::dtype::bfloat16;
+
+// The numel is not a multiple of the jit block, so the blocks and the rest
+// are both checked.
+DenseTensor RandomBF16Tensor(int64_t numel, unsigned seed) {
+  std::default_random_engine engine(seed);
+  std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+  DenseTensor t;
+  t.Resize(make_ddim({numel}));
+  bfloat16* data = GetCPUContext().template Alloc<bfloat16>(&t);
+  for (int64_t i = 0; i < numel; ++i) {
+    data[i] = static_cast<bfloat16>(dist(engine));
+  }
+  return t;
+}
+
+// Checks out against func computed in float and rounded to nearest even,
+// within max_ulps.
+void CheckBF16(const DenseTensor& out,
+               const std::function<float(int64_t)>& func,
+               int max_ulps) {
+  auto ordered = [](bfloat16 v) {
+    return v.x & 0x8000 ? -static_cast<int>(v.x & 0x7fff)
+                        : static_cast<int>(v.x);
+  };
+  const bfloat16* data = out.data<bfloat16>();
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    bfloat16 expected = jit::refer::RoundToBF16(func(i));
+    ASSERT_LE(std::abs(ordered(data[i]) - ordered(expected)), max_ulps)
+        << static_cast<float>(data[i]) << " vs "
+        << static_cast<float>(expected) << " at index " << i;
+  }
+}
+
+constexpr int64_t kNumel = 1000;
+
+TEST(DEV_API, bfloat16_add_and_multiply) {
+  DenseTensor x = RandomBF16Tensor(kNumel, 0);
+  DenseTensor y = RandomBF16Tensor(kNumel, 1);
+  const bfloat16* x_data = x.data<bfloat16>();
+  const bfloat16* y_data = y.data<bfloat16>();
+
+  DenseTensor out;
+  AddKernel<bfloat16, CPUContext>(GetCPUContext(), x, y, &out);
+  CheckBF16(
+      out,
+      [&](int64_t i) {
+        return static_cast<float>(x_data[i]) + static_cast<float>(y_data[i]);
+      },
+      0);
+  MultiplyKernel<bfloat16, CPUContext>(GetCPUContext(), x, y, &out);
+  CheckBF16(
+      out,
+      [&](int64_t i) {
+        return static_cast<float>(x_data[i]) * static_cast<float>(y_data[i]);
+      },
+      0);
+}
+
+TEST(DEV_API, bfloat16_activations) {
+  DenseTensor x = RandomBF16Tensor(kNumel, 2);
+  const bfloat16* x_data = x.data<bfloat16>();
+  auto xf = [&](int64_t i) { return static_cast<float>(x_data[i]); };
+
+  DenseTensor out;
+  ReluKernel<bfloat16, CPUContext>(GetCPUContext(), x, &out);
+  CheckBF16(
+      out, [&](int64_t i) { return std::max(xf(i), 0.0f); }, 0);
+  ExpKernel<bfloat16, CPUContext>(GetCPUContext(), x, &out);
+  CheckBF16(
+      out, [&](int64_t i) { return std::exp(xf(i)); }, 1);
+  TanhKernel<bfloat16, CPUContext>(GetCPUContext(), x, &out);
+  CheckBF16(
+      out, [&](int64_t i) { return std::tanh(xf(i)); }, 1);
+  SigmoidKernel<bfloat16, CPUContext>(GetCPUContext(), x, &out);
+  CheckBF16(
+      out, [&](int64_t i) { return 1.0f / (1.0f + std::exp(-xf(i))); }, 1);
+  GeluKernel<bfloat16, CPUContext>(GetCPUContext(), x, false, &out);
+  CheckBF16(
+      out,
+      [&](int64_t i) {
+        return 0.5f * xf(i) * (1.0f + std::erf(xf(i) * M_SQRT1_2));
+      },
+      1);
+  GeluKernel<bfloat16, CPUContext>(GetCPUContext(), x, true, &out);
+  CheckBF16(
+      out,
+      [&](int64_t i) {
+        float v = xf(i);
+        return 0.5f * v *
+               (1.0f + std::tanh(0.79788456f * (v + 0.044715f * v * v * v)));
+      },
+      1);
+}
+
+}  // namespace tests
+}  // namespace phi
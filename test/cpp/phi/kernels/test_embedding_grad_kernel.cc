@@ -0,0 +1,119 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/embedding_grad_kernel.h"
+#include "paddle/phi/kernels/funcs/embedding_util.h"
+#include "test/cpp/phi/kernels/cpu_kernel_test_helper.h"
+
+namespace phi {
+namespace tests {
+
+// The rows of every id summed in the order of the ids.
+std::unordered_map<int64_t, std::vector<double>> ReferenceGrad(
+    const std::vector<int64_t>& ids,
+    const DenseTensor& out_grad,
+    int64_t padding_idx) {
+  int64_t width = out_grad.dims()[1];
+  std::unordered_map<int64_t, std::vector<double>> grad;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (ids[i] == padding_idx) {
+      continue;
+    }
+    auto& row = grad[ids[i]];
+    row.resize(width, 0.0);
+    for (int64_t j = 0; j < width; ++j) {
+      row[j] += out_grad.data<float>()[i * width + j];
+    }
+  }
+  return grad;
+}
+
+void ExpectRowNear(const float* row,
+                   const std::vector<double>& expected,
+                   int64_t id) {
+  for (size_t j = 0; j < expected.size(); ++j) {
+    ASSERT_NEAR(
+        row[j], expected[j], 1e-4 * std::max(1.0, std::abs(expected[j])))
+        << "id " << id << ", column " << j;
+  }
+}
+
+TEST(DEV_API, embedding_grad_zipf) {
+  std::default_random_engine engine(0);
+  const int64_t height = 1000, width = 13, padding_idx = 3;
+  for (double s : {0.0, 1.1, 2.0}) {
+    auto ids = ZipfIds(20000, height, s, &engine);
+    auto inputs = CreateEmbeddingGradInputs(ids, height, width, &engine);
+    DenseTensor weight_grad;
+    weight_grad.Resize({height, width});
+    EmbeddingGradKernel<float, CPUContext>(GetCPUContext(),
+                                           inputs.ids,
+                                           inputs.weight,
+                                           inputs.out_grad,
+                                           padding_idx,
+                                           &weight_grad);
+    auto expected = ReferenceGrad(ids, inputs.out_grad, padding_idx);
+    for (int64_t id = 0; id < height; ++id) {
+      const float* row = weight_grad.data<float>() + id * width;
+      auto it = expected.find(id);
+      if (it == expected.end()) {
+        ExpectRowNear(row, std::vector<double>(width, 0.0), id);
+      } else {
+        ExpectRowNear(row, it->second, id);
+      }
+    }
+  }
+}
+
+TEST(DEV_API, embedding_sparse_grad_zipf) {
+  std::default_random_engine engine(0);
+  const int64_t height = 1000, width = 13;
+  for (double s : {0.0, 1.1, 2.0}) {
+    auto ids = ZipfIds(20000, height, s, &engine);
+    auto inputs = CreateEmbeddingGradInputs(ids, height, width, &engine);
+    SelectedRows weight_grad;
+    EmbeddingSparseGradKernel<float, CPUContext>(GetCPUContext(),
+                                                 inputs.ids,
+                                                 inputs.weight,
+                                                 inputs.out_grad,
+                                                 kNoPadding,
+                                                 &weight_grad);
+    // a row for every unique id in ascending order
+    std::set<int64_t> unique_ids(ids.begin(), ids.end());
+    std::vector<int64_t> expected_rows(unique_ids.begin(), unique_ids.end());
+    ASSERT_EQ(weight_grad.height(), height);
+    ASSERT_EQ(weight_grad.rows(), expected_rows);
+    ASSERT_EQ(weight_grad.value().dims(),
+              make_ddim({static_cast<int64_t>(expected_rows.size()), width}));
+    auto expected = ReferenceGrad(ids, inputs.out_grad, kNoPadding);
+    for (size_t i = 0; i < expected_rows.size(); ++i) {
+      ExpectRowNear(weight_grad.value().data<float>() + i * width,
+                    expected[expected_rows[i]],
+                    expected_rows[i]);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>  // NOLINT
 #include <vector>
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/generator.h"
@@ -449,6 +450,15 @@ TEST(fused_adam, test_fp32_cpu) {
   }
 }
 
+TEST(fused_adam, test_fp32_cpu_chunks) {
+  // params larger than a chunk, which are split among the work items
+  auto shapes = GenerateRandomShapes(50, 0, 20000);
+  float atol = 0.0f;
+  for (auto use_adamw : {false, true}) {
+    TestFusedAdamBase<float, CPUPlace>(shapes, atol, use_adamw);
+  }
+}
+
 #ifdef PADDLE_WITH_CUDA
 TEST(fused_adam, test_fp32_gpu) {
   auto shapes = GenerateRandomShapes(40, 0, 2 << 18);
@@ -0,0 +1,206 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "paddle/phi/kernels/funcs/cpu_layer_norm.h"
+#include "paddle/phi/kernels/layer_norm_grad_kernel.h"
+#include "paddle/phi/kernels/layer_norm_kernel.h"
+#include "test/cpp/phi/kernels/cpu_kernel_test_helper.h"
+
+namespace phi {
+namespace tests {
+
+// The mean, the variance and the normalized rows of x in double.
+struct LayerNormReference {
+  std::vector<double> mean;
+  std::vector<double> var;
+  std::vector<double> x_norm;
+};
+
+LayerNormReference ReferenceLayerNorm(const float* x,
+                                      int64_t rows,
+                                      int64_t cols,
+                                      float epsilon) {
+  LayerNormReference ref;
+  ref.mean.resize(rows);
+  ref.var.resize(rows);
+  ref.x_norm.resize(rows * cols);
+  for (int64_t i = 0; i < rows; ++i) {
+    double sum = 0, square_sum = 0;
+    for (int64_t j = 0; j < cols; ++j) {
+      sum += x[i * cols + j];
+    }
+    ref.mean[i] = sum / cols;
+    for (int64_t j = 0; j < cols; ++j) {
+      double diff = x[i * cols + j] - ref.mean[i];
+      square_sum += diff * diff;
+    }
+    ref.var[i] = square_sum / cols;
+    for (int64_t j = 0; j < cols; ++j) {
+      ref.x_norm[i * cols + j] =
+          (x[i * cols + j] - ref.mean[i]) / std::sqrt(ref.var[i] + epsilon);
+    }
+  }
+  return ref;
+}
+
+TEST(DEV_API, layer_norm) {
+  std::default_random_engine engine(0);
+  const float epsilon = 1e-5f;
+  for (int64_t rows : {1, 7, 300}) {
+    for (int64_t cols : {5, 768, 1030}) {
+      DenseTensor x = RandomTensor({rows, cols}, -2.f, 3.f, &engine);
+      DenseTensor scale = RandomTensor({cols}, 0.5f, 1.5f, &engine);
+      DenseTensor bias = RandomTensor({cols}, -1.f, 1.f, &engine);
+      DenseTensor y, mean, var;
+      y.Resize({rows, cols});
+      mean.Resize({rows});
+      var.Resize({rows});
+      LayerNormKernel<float, CPUContext>(
+          GetCPUContext(), x, scale, bias, epsilon, 1, &y, &mean, &var);
+
+      auto ref = ReferenceLayerNorm(x.data<float>(), rows, cols, epsilon);
+      for (int64_t i = 0; i < rows; ++i) {
+        ASSERT_NEAR(mean.data<float>()[i], ref.mean[i], 1e-5);
+        ASSERT_NEAR(var.data<float>()[i], ref.var[i], 1e-4);
+        for (int64_t j = 0; j < cols; ++j) {
+          double expected = ref.x_norm[i * cols + j] * scale.data<float>()[j] +
+                            bias.data<float>()[j];
+          ASSERT_NEAR(y.data<float>()[i * cols + j], expected, 1e-4)
+              << "row " << i << ", column " << j;
+        }
+      }
+    }
+  }
+}
+
+TEST(DEV_API, layer_norm_grad) {
+  std::default_random_engine engine(0);
+  const float epsilon = 1e-5f;
+  for (int64_t rows : {1, 7, 300}) {
+    for (int64_t cols : {5, 768, 1030}) {
+      DenseTensor x = RandomTensor({rows, cols}, -2.f, 3.f, &engine);
+      DenseTensor scale = RandomTensor({cols}, 0.5f, 1.5f, &engine);
+      DenseTensor dy = RandomTensor({rows, cols}, -1.f, 1.f, &engine);
+      auto ref = ReferenceLayerNorm(x.data<float>(), rows, cols, epsilon);
+      DenseTensor mean, var;
+      mean.Resize({rows});
+      var.Resize({rows});
+      for (int64_t i = 0; i < rows; ++i) {
+        GetCPUContext().template Alloc<float>(&mean)[i] = ref.mean[i];
+        GetCPUContext().template Alloc<float>(&var)[i] = ref.var[i];
+      }
+
+      // dx with and without dscale and dbias, which must not change dx
+      for (bool param_grads : {true, false}) {
+        DenseTensor dx, dscale, dbias;
+        dx.Resize({rows, cols});
+        dscale.Resize({cols});
+        dbias.Resize({cols});
+        LayerNormGradKernel<float, CPUContext>(GetCPUContext(),
+                                               x,
+                                               scale,
+                                               paddle::none,
+                                               mean,
+                                               var,
+                                               dy,
+                                               epsilon,
+                                               1,
+                                               &dx,
+                                               param_grads ? &dscale : nullptr,
+                                               param_grads ? &dbias : nullptr);
+
+        std::vector<double> dscale_ref(cols, 0.0), dbias_ref(cols, 0.0);
+        for (int64_t i = 0; i < rows; ++i) {
+          const float* dy_row = dy.data<float>() + i * cols;
+          const double* x_norm = ref.x_norm.data() + i * cols;
+          double mean_dy = 0, mean_dy_x_norm = 0;
+          for (int64_t j = 0; j < cols; ++j) {
+            double dy_scaled = dy_row[j] * scale.data<float>()[j];
+            mean_dy += dy_scaled / cols;
+            mean_dy_x_norm += dy_scaled * x_norm[j] / cols;
+            dscale_ref[j] += dy_row[j] * x_norm[j];
+            dbias_ref[j] += dy_row[j];
+          }
+          for (int64_t j = 0; j < cols; ++j) {
+            double dy_scaled = dy_row[j] * scale.data<float>()[j];
+            double expected =
+                (dy_scaled - mean_dy - x_norm[j] * mean_dy_x_norm) /
+                std::sqrt(ref.var[i] + epsilon);
+            ASSERT_NEAR(dx.data<float>()[i * cols + j], expected, 1e-3)
+                << "row " << i << ", column " << j;
+          }
+        }
+        if (param_grads) {
+          for (int64_t j = 0; j < cols; ++j) {
+            ASSERT_NEAR(dscale.data<float>()[j], dscale_ref[j], 1e-3);
+            ASSERT_NEAR(dbias.data<float>()[j], dbias_ref[j], 1e-3);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(DEV_API, residual_add_layer_norm) {
+  std::default_random_engine engine(0);
+  const int64_t rows = 300, cols = 768;
+  const float epsilon = 1e-5f, alpha = 0.5f;
+  DenseTensor x = RandomTensor({rows, cols}, -2.f, 3.f, &engine);
+  DenseTensor residual = RandomTensor({rows, cols}, -2.f, 2.f, &engine);
+  DenseTensor bias = RandomTensor({cols}, -1.f, 1.f, &engine);
+  DenseTensor weight = RandomTensor({cols}, 0.5f, 1.5f, &engine);
+  DenseTensor norm_bias = RandomTensor({cols}, -1.f, 1.f, &engine);
+  std::vector<float> residual_out(rows * cols), out(rows * cols);
+  std::vector<float> mean(rows), var(rows);
+  funcs::ResidualAddLayerNormRows(x.data<float>(),
+                                  bias.data<float>(),
+                                  residual.data<float>(),
+                                  alpha,
+                                  weight.data<float>(),
+                                  norm_bias.data<float>(),
+                                  epsilon,
+                                  rows,
+                                  cols,
+                                  residual_out.data(),
+                                  out.data(),
+                                  mean.data(),
+                                  var.data(),
+                                  [](float value) { return value; });
+
+  std::vector<float> sum(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    sum[i] = x.data<float>()[i] + alpha * residual.data<float>()[i] +
+             bias.data<float>()[i % cols];
+    ASSERT_NEAR(residual_out[i], sum[i], 1e-6);
+  }
+  auto ref = ReferenceLayerNorm(sum.data(), rows, cols, epsilon);
+  for (int64_t i = 0; i < rows; ++i) {
+    ASSERT_NEAR(mean[i], ref.mean[i], 1e-5);
+    ASSERT_NEAR(var[i], ref.var[i], 1e-4);
+    for (int64_t j = 0; j < cols; ++j) {
+      double expected = ref.x_norm[i * cols + j] * weight.data<float>()[j] +
+                        norm_bias.data<float>()[j];
+      ASSERT_NEAR(out[i * cols + j], expected, 1e-4);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,207 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/kernels/lamb_kernel.h"
+#include "paddle/phi/kernels/merged_momentum_kernel.h"
+#include "paddle/phi/kernels/momentum_kernel.h"
+#include "test/cpp/phi/kernels/cpu_kernel_test_helper.h"
+
+namespace phi {
+namespace tests {
+
+DenseTensor CopyTensor(const DenseTensor& x) {
+  DenseTensor y;
+  y.Resize(x.dims());
+  std::copy(x.data<float>(),
+            x.data<float>() + x.numel(),
+            GetCPUContext().template Alloc<float>(&y));
+  return y;
+}
+
+void ExpectNear(const DenseTensor& x, const DenseTensor& y, float atol) {
+  ASSERT_EQ(x.numel(), y.numel());
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    ASSERT_NEAR(x.data<float>()[i], y.data<float>()[i], atol) << "at " << i;
+  }
+}
+
+void CheckMergedMomentum(bool use_nesterov, float rescale_grad) {
+  std::default_random_engine engine(0);
+  // params smaller and larger than a chunk, with and without l2_decay
+  std::vector<int64_t> numels = {7, 300, 40000, 1, 16384, 70000};
+  std::vector<std::string> methods;
+  std::vector<float> coeffs;
+  std::vector<DenseTensor> params, grads, velocitys, lrs;
+  for (size_t i = 0; i < numels.size(); ++i) {
+    methods.push_back(i % 2 ? "l2_decay" : "");
+    coeffs.push_back(i % 2 ? 0.01f : 0.0f);
+    params.push_back(RandomTensor({numels[i]}, -1.f, 1.f, &engine));
+    grads.push_back(RandomTensor({numels[i]}, -1.f, 1.f, &engine));
+    velocitys.push_back(RandomTensor({numels[i]}, -0.1f, 0.1f, &engine));
+    lrs.push_back(ScalarTensor(0.01f * (i + 1)));
+  }
+
+  // the momentum of every param on the rescaled grad
+  std::vector<DenseTensor> ref_params, ref_velocitys;
+  for (size_t i = 0; i < numels.size(); ++i) {
+    DenseTensor grad = CopyTensor(grads[i]);
+    for (int64_t j = 0; j < grad.numel(); ++j) {
+      grad.data<float>()[j] *= rescale_grad;
+    }
+    ref_params.push_back(CopyTensor(params[i]));
+    ref_velocitys.push_back(CopyTensor(velocitys[i]));
+    MomentumDenseKernel<float, CPUContext>(GetCPUContext(),
+                                           ref_params[i],
+                                           grad,
+                                           ref_velocitys[i],
+                                           lrs[i],
+                                           paddle::none,
+                                           0.9f,
+                                           use_nesterov,
+                                           methods[i],
+                                           coeffs[i],
+                                           false,
+                                           1.0f,
+                                           &ref_params[i],
+                                           &ref_velocitys[i],
+                                           nullptr);
+  }
+
+  std::vector<const DenseTensor*> param_ins, grad_ins, velocity_ins, lr_ins;
+  std::vector<DenseTensor*> param_outs, velocity_outs;
+  for (size_t i = 0; i < numels.size(); ++i) {
+    param_ins.push_back(&params[i]);
+    grad_ins.push_back(&grads[i]);
+    velocity_ins.push_back(&velocitys[i]);
+    lr_ins.push_back(&lrs[i]);
+    param_outs.push_back(&params[i]);
+    velocity_outs.push_back(&velocitys[i]);
+  }
+  MergedMomentumKernel<float, CPUContext>(GetCPUContext(),
+                                          param_ins,
+                                          grad_ins,
+                                          velocity_ins,
+                                          lr_ins,
+                                          paddle::none,
+                                          0.9f,
+                                          use_nesterov,
+                                          methods,
+                                          coeffs,
+                                          false,
+                                          rescale_grad,
+                                          param_outs,
+                                          velocity_outs,
+                                          {});
+
+  for (size_t i = 0; i < numels.size(); ++i) {
+    ExpectNear(params[i], ref_params[i], 1e-6f);
+    ExpectNear(velocitys[i], ref_velocitys[i], 1e-6f);
+  }
+}
+
+TEST(DEV_API, merged_momentum_cpu) {
+  for (bool use_nesterov : {false, true}) {
+    CheckMergedMomentum(use_nesterov, 1.0f);
+    CheckMergedMomentum(use_nesterov, 0.125f);
+  }
+}
+
+TEST(DEV_API, lamb_cpu) {
+  std::default_random_engine engine(0);
+  // enough elements for the moments and the params to take several chunks
+  const int64_t numel = 100000;
+  const float beta1 = 0.9f, beta2 = 0.999f, epsilon = 1e-6f;
+  const float weight_decay = 0.01f, lr = 0.001f;
+  DenseTensor param = RandomTensor({numel}, -1.f, 1.f, &engine);
+  DenseTensor moment1 = RandomTensor({numel}, -0.1f, 0.1f, &engine);
+  DenseTensor moment2 = RandomTensor({numel}, 0.f, 0.1f, &engine);
+  DenseTensor beta1_pow = ScalarTensor(beta1);
+  DenseTensor beta2_pow = ScalarTensor(beta2);
+  DenseTensor learning_rate = ScalarTensor(lr);
+
+  std::vector<double> ref_param(param.data<float>(),
+                                param.data<float>() + numel);
+  std::vector<double> ref_mom1(moment1.data<float>(),
+                               moment1.data<float>() + numel);
+  std::vector<double> ref_mom2(moment2.data<float>(),
+                               moment2.data<float>() + numel);
+  double ref_beta1_pow = beta1, ref_beta2_pow = beta2;
+
+  for (int step = 0; step < 3; ++step) {
+    DenseTensor grad = RandomTensor({numel}, -1.f, 1.f, &engine);
+
+    // the update of lamb_functors.h, one element after another
+    std::vector<double> trust_ratio_div(numel);
+    double p_norm = 0, t_norm = 0;
+    for (int64_t i = 0; i < numel; ++i) {
+      double g = grad.data<float>()[i];
+      ref_mom1[i] = beta1 * ref_mom1[i] + (1 - beta1) * g;
+      ref_mom2[i] = beta2 * ref_mom2[i] + (1 - beta2) * g * g;
+      double mom1_unbiased = ref_mom1[i] / (1 - ref_beta1_pow);
+      double mom2_unbiased = ref_mom2[i] / (1 - ref_beta2_pow);
+      trust_ratio_div[i] =
+          mom1_unbiased / (std::sqrt(mom2_unbiased) + epsilon) +
+          weight_decay * ref_param[i];
+      p_norm += ref_param[i] * ref_param[i];
+      t_norm += trust_ratio_div[i] * trust_ratio_div[i];
+    }
+    double r = std::sqrt(p_norm) / std::sqrt(t_norm);
+    for (int64_t i = 0; i < numel; ++i) {
+      ref_param[i] -= lr * r * trust_ratio_div[i];
+    }
+    ref_beta1_pow *= beta1;
+    ref_beta2_pow *= beta2;
+
+    LambKernel<float, CPUContext>(GetCPUContext(),
+                                  param,
+                                  grad,
+                                  learning_rate,
+                                  moment1,
+                                  moment2,
+                                  beta1_pow,
+                                  beta2_pow,
+                                  paddle::none,
+                                  paddle::none,
+                                  weight_decay,
+                                  beta1,
+                                  beta2,
+                                  epsilon,
+                                  false,
+                                  false,
+                                  &param,
+                                  &moment1,
+                                  &moment2,
+                                  &beta1_pow,
+                                  &beta2_pow,
+                                  nullptr);
+  }
+
+  EXPECT_NEAR(beta1_pow.data<float>()[0], ref_beta1_pow, 1e-6);
+  EXPECT_NEAR(beta2_pow.data<float>()[0], ref_beta2_pow, 1e-6);
+  for (int64_t i = 0; i < numel; ++i) {
+    ASSERT_NEAR(moment1.data<float>()[i], ref_mom1[i], 1e-6) << "at " << i;
+    ASSERT_NEAR(moment2.data<float>()[i], ref_mom2[i], 1e-6) << "at " << i;
+    ASSERT_NEAR(param.data<float>()[i], ref_param[i], 1e-5) << "at " << i;
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
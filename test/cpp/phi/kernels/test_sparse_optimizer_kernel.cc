@@ -0,0 +1,126 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/adagrad_kernel.h"
+#include "paddle/phi/kernels/selected_rows/adam_kernel.h"
+#include "paddle/phi/kernels/selected_rows/adamw_kernel.h"
+#include "test/cpp/phi/kernels/cpu_kernel_test_helper.h"
+
+namespace phi {
+namespace tests {
+
+// The rows of grad merged into the sum of every row.
+std::map<int64_t, std::vector<double>> MergeRows(const SelectedRows& grad) {
+  int64_t width = grad.value().dims()[1];
+  std::map<int64_t, std::vector<double>> merged;
+  for (size_t i = 0; i < grad.rows().size(); ++i) {
+    auto& row = merged[grad.rows()[i]];
+    row.resize(width, 0.0);
+    for (int64_t j = 0; j < width; ++j) {
+      row[j] += grad.value().data<float>()[i * width + j];
+    }
+  }
+  return merged;
+}
+
+void CheckLazyAdamW(float coeff) {
+  std::default_random_engine engine(0);
+  const int64_t height = 5000, width = 17;
+  AdamState state = RandomAdamState(height, width, &engine);
+  std::vector<float> param(state.param.data<float>(),
+                           state.param.data<float>() + height * width);
+  std::vector<float> mom1(state.moment1.data<float>(),
+                          state.moment1.data<float>() + height * width);
+  std::vector<float> mom2(state.moment2.data<float>(),
+                          state.moment2.data<float>() + height * width);
+  SelectedRows grad = RandomGrad(4000, height, width, &engine);
+  RunLazyAdamW(grad, coeff, &state);
+
+  auto merged = MergeRows(grad);
+  double beta1 = 0.9, beta2 = 0.999, lr = 0.01, eps = 1e-8;
+  double beta1_pow = 0.9 * 0.9, beta2_pow = 0.999 * 0.999;
+  double lr_t = lr * std::sqrt(1 - beta2_pow) / (1 - beta1_pow);
+  for (int64_t r = 0; r < height; ++r) {
+    auto it = merged.find(r);
+    for (int64_t j = 0; j < width; ++j) {
+      int64_t i = r * width + j;
+      double p = param[i], m1 = mom1[i], m2 = mom2[i];
+      if (it != merged.end()) {
+        double g = it->second[j];
+        m1 = beta1 * m1 + (1 - beta1) * g;
+        m2 = beta2 * m2 + (1 - beta2) * g * g;
+        p -= lr * coeff * p;
+        p -= lr_t * m1 / (std::sqrt(m2) + eps * std::sqrt(1 - beta2_pow));
+      }
+      // the rows not in grad are not touched in lazy mode
+      ASSERT_NEAR(state.param.data<float>()[i], p, 1e-5) << "row " << r;
+      ASSERT_NEAR(state.moment1.data<float>()[i], m1, 1e-6) << "row " << r;
+      ASSERT_NEAR(state.moment2.data<float>()[i], m2, 1e-6) << "row " << r;
+    }
+  }
+}
+
+TEST(DEV_API, lazy_sparse_adam) { CheckLazyAdamW(0.0f); }
+
+TEST(DEV_API, lazy_sparse_adamw) { CheckLazyAdamW(0.01f); }
+
+TEST(DEV_API, sparse_adagrad) {
+  std::default_random_engine engine(0);
+  const int64_t height = 5000, width = 17;
+  DenseTensor param = RandomTensor({height, width}, -1.f, 1.f, &engine);
+  DenseTensor moment = RandomTensor({height, width}, 0.f, 0.1f, &engine);
+  DenseTensor lr = ScalarTensor(0.01f);
+  std::vector<float> param_ref(param.data<float>(),
+                               param.data<float>() + height * width);
+  std::vector<float> moment_ref(moment.data<float>(),
+                                moment.data<float>() + height * width);
+  SelectedRows grad = RandomGrad(4000, height, width, &engine);
+  AdagradSparseKernel<float, CPUContext>(GetCPUContext(),
+                                         param,
+                                         grad,
+                                         moment,
+                                         lr,
+                                         paddle::none,
+                                         1e-6f,
+                                         false,
+                                         &param,
+                                         &moment,
+                                         nullptr);
+
+  for (auto& row : MergeRows(grad)) {
+    for (int64_t j = 0; j < width; ++j) {
+      int64_t i = row.first * width + j;
+      double g = row.second[j];
+      double m = moment_ref[i] + g * g;
+      double p = param_ref[i] - 0.01 * g / (std::sqrt(m) + 1e-6);
+      moment_ref[i] = static_cast<float>(m);
+      param_ref[i] = static_cast<float>(p);
+    }
+  }
+  for (int64_t i = 0; i < height * width; ++i) {
+    ASSERT_NEAR(param.data<float>()[i], param_ref[i], 1e-5) << i;
+    ASSERT_NEAR(moment.data<float>()[i], moment_ref[i], 1e-5) << i;
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
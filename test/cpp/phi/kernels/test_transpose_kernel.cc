@@ -0,0 +1,124 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "paddle/phi/kernels/contiguous_kernel.h"
+#include "paddle/phi/kernels/funcs/cpu_strided_copy.h"
+#include "paddle/phi/kernels/transpose_kernel.h"
+#include "test/cpp/phi/kernels/cpu_kernel_test_helper.h"
+
+namespace phi {
+namespace tests {
+
+// Checks out against x read with the strides of the permute, element by
+// element.
+template <typename T>
+void CheckPermuted(const DenseTensor& x,
+                   const Permuted& permuted,
+                   const DenseTensor& out) {
+  ASSERT_EQ(out.dims(), make_ddim(permuted.dims));
+  int rank = static_cast<int>(permuted.dims.size());
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    int64_t index = i, offset = 0;
+    for (int d = rank - 1; d >= 0; --d) {
+      offset += index % permuted.dims[d] * permuted.strides[d];
+      index /= permuted.dims[d];
+    }
+    ASSERT_EQ(out.data<T>()[i], x.data<T>()[offset]) << "element " << i;
+  }
+}
+
+template <typename T>
+void CheckTranspose(const std::vector<int64_t>& x_dims,
+                    const std::vector<int>& axis) {
+  DenseTensor x = IotaTensor<T>(x_dims);
+  Permuted permuted = Permute(x_dims, axis);
+  DenseTensor out;
+  out.Resize(make_ddim(permuted.dims));
+  TransposeKernel<T, CPUContext>(GetCPUContext(), x, axis, &out);
+  CheckPermuted<T>(x, permuted, out);
+}
+
+TEST(DEV_API, transpose_random_permutes) {
+  std::default_random_engine engine(0);
+  std::uniform_int_distribution<int64_t> dim(1, 37);
+  for (int i = 0; i < 100; ++i) {
+    int rank = 1 + i % 7;
+    std::vector<int64_t> x_dims(rank);
+    for (auto& d : x_dims) {
+      d = dim(engine);
+    }
+    std::vector<int> axis(rank);
+    std::iota(axis.begin(), axis.end(), 0);
+    std::shuffle(axis.begin(), axis.end(), engine);
+    CheckTranspose<float>(x_dims, axis);
+    CheckTranspose<double>(x_dims, axis);
+    CheckTranspose<int8_t>(x_dims, axis);
+    CheckTranspose<int16_t>(x_dims, axis);
+  }
+}
+
+TEST(DEV_API, transpose_attention_and_layouts) {
+  // [B, S, H, D] -> [B, H, S, D], NCHW -> NHWC and NHWC -> NCHW
+  CheckTranspose<float>({2, 129, 12, 64}, {0, 2, 1, 3});
+  CheckTranspose<float>({2, 64, 17, 19}, {0, 2, 3, 1});
+  CheckTranspose<float>({2, 17, 19, 64}, {0, 3, 1, 2});
+  CheckTranspose<float>({300, 301}, {1, 0});
+  CheckTranspose<double>({2, 64, 17, 19}, {0, 2, 3, 1});
+}
+
+TEST(DEV_API, contiguous_of_transposed_view) {
+  std::vector<int64_t> x_dims = {2, 64, 17, 19};
+  std::vector<int> axis = {0, 2, 3, 1};
+  DenseTensor x = IotaTensor<float>(x_dims);
+  Permuted permuted = Permute(x_dims, axis);
+  DenseTensor view = x;
+  view.Resize(make_ddim(permuted.dims));
+  view.set_strides(make_ddim(permuted.strides));
+
+  DenseTensor out;
+  ContiguousKernel<float, CPUContext>(GetCPUContext(), view, &out);
+  CheckPermuted<float>(x, permuted, out);
+}
+
+TEST(DEV_API, strided_copy_overlapping_dst) {
+  // The elements of dst written more than once hold the last element of the
+  // serial copy in the order of the dims, whatever the number of threads.
+  std::vector<int64_t> dims = {300, 300};
+  std::vector<int64_t> src_strides = {1, 300};
+  std::vector<float> src(90000);
+  std::iota(src.begin(), src.end(), 0.0f);
+  for (auto dst_strides : std::vector<std::vector<int64_t>>{
+           {1, 2}, {2, 1}, {1, 1}, {3, 1}, {0, 1}}) {
+    std::vector<float> dst(1200, -1.0f), expected(1200, -1.0f);
+    funcs::CPUStridedCopy(
+        src.data(), dst.data(), dims, src_strides, dst_strides);
+    for (int64_t i = 0; i < dims[0]; ++i) {
+      for (int64_t j = 0; j < dims[1]; ++j) {
+        expected[i * dst_strides[0] + j * dst_strides[1]] =
+            src[i * src_strides[0] + j * src_strides[1]];
+      }
+    }
+    EXPECT_EQ(dst, expected);
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,327 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "paddle/pir/core/builder.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_dialect.h"
+#include "paddle/pir/core/builtin_type.h"
+#include "paddle/pir/core/bytecode/bytecode_reader.h"
+#include "paddle/pir/core/bytecode/bytecode_writer.h"
+#include "paddle/pir/core/dialect.h"
+#include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/ir_printer.h"
+#include "paddle/pir/core/op_base.h"
+#include "paddle/pir/core/program.h"
+#include "test/cpp/pir/tools/test_dialect.h"
+#include "test/cpp/pir/tools/test_op.h"
+
+// An operation without any constraint, used to build large programs.
+class ComputeOp : public pir::Op<ComputeOp> {
+ public:
+  using Op::Op;
+  static const char *name() { return "bytecode_test.compute"; }
+  static constexpr uint32_t attributes_num = 0;
+  static constexpr const char **attributes_name = nullptr;
+  void Verify() const {}
+};
+
+class BytecodeTestDialect : public pir::Dialect {
+ public:
+  explicit BytecodeTestDialect(pir::IrContext *context)
+      : pir::Dialect(name(), context, pir::TypeId::get<BytecodeTestDialect>()) {
+    RegisterOps<ComputeOp>();
+  }
+  static const char *name() { return "bytecode_test"; }
+};
+
+IR_DECLARE_EXPLICIT_TYPE_ID(ComputeOp)
+IR_DEFINE_EXPLICIT_TYPE_ID(ComputeOp)
+IR_DECLARE_EXPLICIT_TYPE_ID(BytecodeTestDialect)
+IR_DEFINE_EXPLICIT_TYPE_ID(BytecodeTestDialect)
+
+// Dump the structure of the program, including regions, block arguments and
+// successors which are not covered by the textual printer.
+class StructureDumper {
+ public:
+  explicit StructureDumper(std::ostream &os) : os_(os), printer_(os) {}
+
+  void DumpRegion(const pir::Region &region) {
+    std::map<const pir::Block *, size_t> block_ids;
+    for (auto block : region) {
+      block_ids.emplace(block, block_ids.size());
+    }
+    os_ << "{";
+    for (auto block : region) {
+      os_ << "^(";
+      for (uint32_t i = 0; i < block->args_size(); ++i) {
+        DumpValue(const_cast<pir::Block *>(block)->argument(i));
+        printer_.PrintType(block->argument_type(i));
+        os_ << ",";
+      }
+      os_ << ")";
+      for (auto op : *block) {
+        DumpOperation(op, block_ids);
+      }
+    }
+    os_ << "}";
+  }
+
+ private:
+  void DumpValue(pir::Value value) {
+    if (!value) {
+      os_ << "null:";
+      return;
+    }
+    auto iter = value_ids_.find(value.impl());
+    if (iter == value_ids_.end()) {
+      iter = value_ids_.emplace(value.impl(), value_ids_.size()).first;
+    }
+    os_ << "%" << iter->second << ":";
+  }
+
+  void DumpOperation(pir::Operation *op,
+                     const std::map<const pir::Block *, size_t> &block_ids) {
+    os_ << "\n" << op->name() << "(";
+    for (uint32_t i = 0; i < op->num_operands(); ++i) {
+      DumpValue(op->operand_source(i));
+    }
+    os_ << "){";
+    std::map<std::string, pir::Attribute> attrs(op->attributes().begin(),
+                                                op->attributes().end());
+    for (auto &item : attrs) {
+      os_ << item.first << "=";
+      printer_.PrintAttribute(item.second);
+      os_ << ",";
+    }
+    os_ << "}->(";
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      DumpValue(op->result(i));
+      printer_.PrintType(op->result(i).type());
+      os_ << ",";
+    }
+    os_ << ")[";
+    for (uint32_t i = 0; i < op->num_successors(); ++i) {
+      os_ << block_ids.at(op->successor(i)) << ",";
+    }
+    os_ << "]";
+    for (uint32_t i = 0; i < op->num_regions(); ++i) {
+      DumpRegion(op->region(i));
+    }
+  }
+
+  std::ostream &os_;
+  pir::BasicIrPrinter printer_;
+  std::map<const void *, size_t> value_ids_;
+};
+
+std::string DumpProgram(pir::Program *program) {
+  std::stringstream ss;
+  StructureDumper dumper(ss);
+  dumper.DumpRegion(program->module_op()->region(0));
+  return ss.str();
+}
+
+void BuildControlFlowProgram(pir::IrContext *ctx, pir::Program *program) {
+  pir::Builder builder(ctx, program->block());
+  pir::OpInfo compute_info = ctx->GetRegisteredOpInfo(ComputeOp::name());
+
+  pir::AttributeMap attrs{
+      {"str", builder.str_attr("a \"quoted\"\n string")},
+      {"bool", builder.bool_attr(true)},
+      {"float", builder.float_attr(-1.5f)},
+      {"double", builder.double_attr(3.25)},
+      {"int32", builder.int32_attr(-7)},
+      {"int64", builder.int64_attr(int64_t(1) << 40)},
+      {"array",
+       builder.array_attr({builder.int32_attr(1), builder.str_attr("x")})},
+      {"type", pir::TypeAttribute::get(ctx, pir::Float16Type::get(ctx))}};
+  pir::Type vec_type = pir::VectorType::get(
+      ctx,
+      std::vector<pir::Type>{builder.float32_type(), pir::Int64Type::get(ctx)});
+  pir::Operation *producer = pir::Operation::Create(
+      {}, attrs, {vec_type, builder.bool_type()}, compute_info);
+  program->block()->push_back(producer);
+
+  test::RegionOp region_op = builder.Build<test::RegionOp>();
+  auto &region = region_op->region(0);
+  pir::Block *entry = new pir::Block();
+  pir::Block *exit = new pir::Block();
+  region.push_back(entry);
+  region.push_back(exit);
+  exit->AddArgument(builder.float32_type());
+
+  // The nested region uses a value defined in the enclosing block.
+  pir::Operation *inner = pir::Operation::Create(
+      {producer->result(0), pir::Value()},
+      {{"name", builder.str_attr("inner")}},
+      {builder.float32_type()},
+      compute_info);
+  entry->push_back(inner);
+  builder.SetInsertionPointToEnd(entry);
+  builder.Build<test::BranchOp>(std::vector<pir::OpResult>{inner->result(0)},
+                                exit);
+  pir::Operation *tail = pir::Operation::Create(
+      {exit->argument(0)}, {}, {builder.float32_type()}, compute_info);
+  exit->push_back(tail);
+
+  // Values defined after the region must keep their numbering.
+  program->block()->push_back(pir::Operation::Create(
+      {producer->result(1)}, {}, {builder.int8_type()}, compute_info));
+}
+
+TEST(bytecode_test, round_trip) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  ctx->GetOrRegisterDialect<BytecodeTestDialect>();
+
+  pir::Program program(ctx);
+  BuildControlFlowProgram(ctx, &program);
+
+  std::stringstream ss;
+  pir::WriteBytecode(program, ss);
+  auto new_program = pir::ReadBytecode(ss, ctx);
+  EXPECT_EQ(DumpProgram(&program), DumpProgram(new_program.get()));
+
+  // Serialization is deterministic.
+  std::stringstream ss1, ss2;
+  pir::WriteBytecode(program, ss1);
+  pir::WriteBytecode(*new_program, ss2);
+  EXPECT_EQ(ss1.str(), ss2.str());
+}
+
+TEST(bytecode_test, lazy_region) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  ctx->GetOrRegisterDialect<BytecodeTestDialect>();
+
+  pir::Program program(ctx);
+  BuildControlFlowProgram(ctx, &program);
+  std::stringstream ss;
+  pir::WriteBytecode(program, ss);
+
+  pir::BytecodeReader reader(ctx, ss, /*lazy_regions=*/true);
+  auto new_program = reader.ReadProgram();
+  EXPECT_EQ(new_program->block()->size(), program.block()->size());
+
+  pir::Operation *region_op = nullptr;
+  for (auto op : *new_program->block()) {
+    if (op->num_regions() > 0) region_op = op;
+  }
+  ASSERT_NE(region_op, nullptr);
+  EXPECT_FALSE(reader.IsMaterialized(region_op));
+  EXPECT_TRUE(region_op->region(0).empty());
+
+  reader.Materialize(region_op);
+  EXPECT_TRUE(reader.IsMaterialized(region_op));
+  EXPECT_EQ(region_op->region(0).size(), 2u);
+  EXPECT_EQ(DumpProgram(&program), DumpProgram(new_program.get()));
+}
+
+TEST(bytecode_test, invalid_input) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  ctx->GetOrRegisterDialect<BytecodeTestDialect>();
+
+  std::stringstream bad_magic("NOTPIR");
+  EXPECT_THROW(pir::ReadBytecode(bad_magic, ctx), pir::IrNotMetException);
+
+  pir::Program program(ctx);
+  BuildControlFlowProgram(ctx, &program);
+  std::stringstream ss;
+  pir::WriteBytecode(program, ss);
+  std::string bytes = ss.str();
+
+  std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+  EXPECT_THROW(pir::ReadBytecode(truncated, ctx), pir::IrNotMetException);
+
+  std::string newer = bytes;
+  newer[4] = static_cast<char>(pir::bytecode::kVersion + 1);
+  std::stringstream newer_version(newer);
+  EXPECT_THROW(pir::ReadBytecode(newer_version, ctx), pir::IrNotMetException);
+}
+
+// Compare the bytecode with the textual format on a program shaped like a
+// transformer encoder: every layer has attention and ffn projections with
+// their weights, biases and elementwise epilogues.
+TEST(bytecode_test, compare_with_text) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  ctx->GetOrRegisterDialect<BytecodeTestDialect>();
+  pir::OpInfo compute_info = ctx->GetRegisteredOpInfo(ComputeOp::name());
+  pir::Builder builder(ctx);
+
+  constexpr int kNumLayers = 48;
+  constexpr int kNumOpsPerLayer = 32;
+  pir::Program program(ctx);
+  pir::Type hidden_type = pir::VectorType::get(
+      ctx,
+      std::vector<pir::Type>{builder.float32_type(), pir::Int64Type::get(ctx)});
+  pir::Value hidden;
+  for (int layer = 0; layer < kNumLayers; ++layer) {
+    for (int i = 0; i < kNumOpsPerLayer; ++i) {
+      std::string prefix =
+          "layer_" + std::to_string(layer) + ".op_" + std::to_string(i);
+      pir::AttributeMap attrs{
+          {"name", builder.str_attr(prefix + ".out")},
+          {"weight", builder.str_attr(prefix + ".w_0")},
+          {"shape",
+           builder.array_attr({builder.int64_attr(-1),
+                               builder.int64_attr(128),
+                               builder.int64_attr(768)})},
+          {"transpose_y", builder.bool_attr(i % 2 == 0)},
+          {"epsilon", builder.float_attr(1e-5f)},
+          {"stop_gradient", builder.array_attr({builder.bool_attr(false)})}};
+      std::vector<pir::Value> inputs;
+      if (hidden) inputs.push_back(hidden);
+      pir::Operation *op = pir::Operation::Create(
+          inputs, attrs, {hidden_type}, compute_info);
+      program.block()->push_back(op);
+      hidden = op->result(0);
+    }
+  }
+
+  auto now = [] { return std::chrono::steady_clock::now(); };
+  auto to_ms = [](std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  };
+
+  std::stringstream text;
+  program.Print(text);
+  std::stringstream binary;
+  pir::WriteBytecode(program, binary);
+
+  auto start = now();
+  auto text_program = pir::Program::Parse(text, ctx);
+  double text_ms = to_ms(now() - start);
+
+  start = now();
+  auto binary_program = pir::ReadBytecode(binary, ctx);
+  double binary_ms = to_ms(now() - start);
+
+  EXPECT_EQ(DumpProgram(text_program.get()), DumpProgram(binary_program.get()));
+  EXPECT_LT(binary.str().size(), text.str().size());
+  std::cout << "ops: " << program.block()->size()
+            << ", text: " << text.str().size() << " bytes / " << text_ms
+            << " ms, bytecode: " << binary.str().size() << " bytes / "
+            << binary_ms << " ms" << std::endl;
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/pir/core/builder.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_op.h"
+#include "paddle/pir/core/builtin_type.h"
+#include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/program.h"
+
+// Creates the same sequence of attributes and types in every thread, so all
+// the threads race on the same storages.
+std::vector<const void *> CreateStorages(pir::IrContext *ctx, int num_items) {
+  std::vector<const void *> storages;
+  storages.reserve(num_items * 3);
+  for (int i = 0; i < num_items; ++i) {
+    storages.push_back(
+        pir::StrAttribute::get(ctx, "storage_" + std::to_string(i))
+            .storage());
+    storages.push_back(pir::Int64Attribute::get(ctx, i).storage());
+    storages.push_back(
+        pir::VectorType::get(ctx,
+                             std::vector<pir::Type>(
+                                 i % 8 + 1, pir::Float32Type::get(ctx)))
+            .storage());
+  }
+  return storages;
+}
+
+// Builds a program made of constant ops, which creates attributes and types
+// in the IrContext the same way a model translation does.
+void BuildProgram(pir::IrContext *ctx, int thread_id, int num_ops) {
+  pir::Program program(ctx);
+  pir::Builder builder(ctx, program.block());
+  for (int i = 0; i < num_ops; ++i) {
+    builder.Build<pir::ConstantOp>(
+        pir::Int64Attribute::get(ctx, thread_id * num_ops + i),
+        pir::Int64Type::get(ctx));
+  }
+}
+
+template <typename Fn>
+double RunInThreads(size_t num_threads, Fn fn) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(fn, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+TEST(storage_manager_test, concurrent_uniquing) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  constexpr size_t kNumThreads = 8;
+  constexpr int kNumItems = 20000;
+
+  std::vector<std::vector<const void *>> results(kNumThreads);
+  RunInThreads(kNumThreads, [&](size_t thread_id) {
+    results[thread_id] = CreateStorages(ctx, kNumItems);
+  });
+
+  // Every thread must observe exactly the same storage for the same key.
+  for (size_t i = 1; i < kNumThreads; ++i) {
+    EXPECT_EQ(results[0], results[i]);
+  }
+  EXPECT_EQ(results[0], CreateStorages(ctx, kNumItems));
+}
+
+TEST(storage_manager_test, build_program_contention) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  constexpr int kNumOps = 20000;
+
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    double ms = RunInThreads(num_threads, [&](size_t thread_id) {
+      BuildProgram(ctx, static_cast<int>(thread_id), kNumOps);
+    });
+    std::cout << "build " << num_threads << " programs of " << kNumOps
+              << " ops in " << num_threads << " threads: " << ms << " ms"
+              << std::endl;
+  }
+}
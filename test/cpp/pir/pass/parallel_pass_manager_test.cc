@@ -0,0 +1,332 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "paddle/pir/core/builder.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_type.h"
+#include "paddle/pir/core/bytecode/bytecode_writer.h"
+#include "paddle/pir/core/dialect.h"
+#include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/op_base.h"
+#include "paddle/pir/core/program.h"
+#include "paddle/pir/pass/pass.h"
+#include "paddle/pir/pass/pass_manager.h"
+#include "test/cpp/pir/tools/test_dialect.h"
+#include "test/cpp/pir/tools/test_op.h"
+
+class ChainOp : public pir::Op<ChainOp> {
+ public:
+  using Op::Op;
+  static const char *name() { return "parallel_test.chain"; }
+  static constexpr uint32_t attributes_num = 0;
+  static constexpr const char **attributes_name = nullptr;
+  void Verify() const {}
+};
+
+class ParallelTestDialect : public pir::Dialect {
+ public:
+  explicit ParallelTestDialect(pir::IrContext *context)
+      : pir::Dialect(name(), context, pir::TypeId::get<ParallelTestDialect>()) {
+    RegisterOps<ChainOp>();
+  }
+  static const char *name() { return "parallel_test"; }
+};
+
+IR_DECLARE_EXPLICIT_TYPE_ID(ChainOp)
+IR_DEFINE_EXPLICIT_TYPE_ID(ChainOp)
+IR_DECLARE_EXPLICIT_TYPE_ID(ParallelTestDialect)
+IR_DEFINE_EXPLICIT_TYPE_ID(ParallelTestDialect)
+
+// Annotates every operation nested in a region with attributes computed from
+// its position, which creates many attributes in the IrContext.
+class AnnotatePass : public pir::Pass {
+ public:
+  explicit AnnotatePass(bool clonable = true)
+      : pir::Pass("annotate_pass", 1), clonable_(clonable) {}
+
+  void Run(pir::Operation *op) override {
+    pir::IrContext *ctx = op->ir_context();
+    for (size_t i = 0; i < op->num_regions(); ++i) {
+      for (auto *block : op->region(i)) {
+        int32_t position = 0;
+        for (auto nested_op : *block) {
+          std::vector<pir::Attribute> history;
+          for (int32_t k = 0; k < kWorkPerOp; ++k) {
+            history.push_back(pir::Int32Attribute::get(ctx, position * k));
+          }
+          nested_op->set_attribute("history",
+                                   pir::ArrayAttribute::get(ctx, history));
+          nested_op->set_attribute(
+              "position",
+              pir::StrAttribute::get(ctx, "pos_" + std::to_string(position)));
+          ++position;
+        }
+      }
+    }
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    return op->num_regions() > 0 && op->name() != "builtin.module";
+  }
+
+  std::unique_ptr<pir::Pass> Clone() const override {
+    if (!clonable_) return nullptr;
+    return std::make_unique<AnnotatePass>();
+  }
+
+ private:
+  static constexpr int32_t kWorkPerOp = 64;
+  bool clonable_;
+};
+
+// Builds num_regions region ops, each holding a chain of ops. The last region
+// uses a value defined outside it, so it is not isolated from above.
+void BuildProgram(pir::IrContext *ctx,
+                  pir::Program *program,
+                  int num_regions,
+                  int chain_length) {
+  pir::Builder builder(ctx, program->block());
+  pir::OpInfo chain_info = ctx->GetRegisteredOpInfo(ChainOp::name());
+  pir::Operation *outer = pir::Operation::Create(
+      {}, {}, {builder.float32_type()}, chain_info);
+  program->block()->push_back(outer);
+
+  for (int i = 0; i <= num_regions; ++i) {
+    builder.SetInsertionPointToEnd(program->block());
+    test::RegionOp region_op = builder.Build<test::RegionOp>();
+    pir::Block *block = new pir::Block();
+    region_op->region(0).push_back(block);
+    pir::Value last = i == num_regions ? outer->result(0) : pir::Value();
+    for (int j = 0; j < chain_length; ++j) {
+      std::vector<pir::Value> inputs;
+      if (last) inputs.push_back(last);
+      pir::Operation *op = pir::Operation::Create(
+          inputs, {}, {builder.float32_type()}, chain_info);
+      block->push_back(op);
+      last = op->result(0);
+    }
+  }
+}
+
+std::string Serialize(const pir::Program &program) {
+  std::stringstream ss;
+  pir::WriteBytecode(program, ss);
+  return ss.str();
+}
+
+bool RunPasses(pir::IrContext *ctx,
+               pir::Program *program,
+               size_t num_threads,
+               bool clonable = true) {
+  pir::PassManager pm(ctx);
+  pm.AddPass(std::make_unique<AnnotatePass>(clonable));
+  pm.EnableParallelExecution(num_threads);
+  return pm.Run(program);
+}
+
+TEST(parallel_pass_manager, deterministic_result) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  ctx->GetOrRegisterDialect<ParallelTestDialect>();
+
+  constexpr int kNumRegions = 64;
+  constexpr int kChainLength = 64;
+  pir::Program sequential(ctx);
+  BuildProgram(ctx, &sequential, kNumRegions, kChainLength);
+  EXPECT_TRUE(RunPasses(ctx, &sequential, 1));
+
+  pir::Program parallel(ctx);
+  BuildProgram(ctx, &parallel, kNumRegions, kChainLength);
+  EXPECT_TRUE(RunPasses(ctx, &parallel, 4));
+
+  pir::Program fallback(ctx);
+  BuildProgram(ctx, &fallback, kNumRegions, kChainLength);
+  EXPECT_TRUE(RunPasses(ctx, &fallback, 4, /*clonable=*/false));
+
+  std::string expected = Serialize(sequential);
+  EXPECT_EQ(expected, Serialize(parallel));
+  EXPECT_EQ(expected, Serialize(fallback));
+
+  // The region using the outer value is annotated as well.
+  auto &last_region = parallel.block()->back()->region(0);
+  EXPECT_TRUE(last_region.front()->front()->HasAttribute("position"));
+}
+
+// Records the step at which the pass starts and finishes on every region op.
+class RecordStepsPass : public pir::Pass {
+ public:
+  RecordStepsPass() : pir::Pass("record_steps_pass", 1) {}
+
+  void Run(pir::Operation *op) override {
+    int start = NextStep();
+    for (int i = 0; i < kWork; ++i) {
+      op->set_attribute("work", pir::Int32Attribute::get(op->ir_context(), i));
+    }
+    int end = NextStep();
+    std::lock_guard<std::mutex> guard(mutex_);
+    steps_.emplace_back(op, std::make_pair(start, end));
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    return op->num_regions() > 0 && op->name() != "builtin.module";
+  }
+
+  std::unique_ptr<pir::Pass> Clone() const override {
+    return std::make_unique<RecordStepsPass>();
+  }
+
+  static std::pair<int, int> Steps(pir::Operation *op) {
+    for (auto &steps : steps_) {
+      if (steps.first == op) return steps.second;
+    }
+    return {-1, -1};
+  }
+
+ private:
+  static int NextStep() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return step_++;
+  }
+
+  static constexpr int kWork = 1000;
+  static std::mutex mutex_;
+  static int step_;
+  static std::vector<std::pair<pir::Operation *, std::pair<int, int>>> steps_;
+};
+
+std::mutex RecordStepsPass::mutex_;
+int RecordStepsPass::step_ = 0;
+std::vector<std::pair<pir::Operation *, std::pair<int, int>>>
+    RecordStepsPass::steps_;
+
+TEST(parallel_pass_manager, keep_order_of_siblings) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  ctx->GetOrRegisterDialect<ParallelTestDialect>();
+
+  // isolated, isolated, not isolated, isolated, isolated
+  pir::Program program(ctx);
+  pir::Builder builder(ctx, program.block());
+  pir::OpInfo chain_info = ctx->GetRegisteredOpInfo(ChainOp::name());
+  pir::Operation *outer = pir::Operation::Create(
+      {}, {}, {builder.float32_type()}, chain_info);
+  program.block()->push_back(outer);
+  std::vector<pir::Operation *> region_ops;
+  for (int i = 0; i < 5; ++i) {
+    builder.SetInsertionPointToEnd(program.block());
+    test::RegionOp region_op = builder.Build<test::RegionOp>();
+    pir::Block *block = new pir::Block();
+    region_op->region(0).push_back(block);
+    std::vector<pir::Value> inputs;
+    if (i == 2) inputs.push_back(outer->result(0));
+    block->push_back(pir::Operation::Create(
+        inputs, {}, {builder.float32_type()}, chain_info));
+    region_ops.push_back(region_op);
+  }
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(std::make_unique<RecordStepsPass>());
+  pm.EnableParallelExecution(4);
+  EXPECT_TRUE(pm.Run(&program));
+
+  // The isolated ops run in parallel with each other, but not with the op
+  // in between them.
+  auto middle = RecordStepsPass::Steps(region_ops[2]);
+  for (int i = 0; i < 5; ++i) {
+    auto steps = RecordStepsPass::Steps(region_ops[i]);
+    ASSERT_GE(steps.first, 0) << "region op " << i;
+    if (i < 2) EXPECT_LT(steps.second, middle.first) << "region op " << i;
+    if (i > 2) EXPECT_GT(steps.first, middle.second) << "region op " << i;
+  }
+}
+
+// Counts the threads the pass runs on, a thread is counted the first time.
+class CountThreadsPass : public pir::Pass {
+ public:
+  CountThreadsPass() : pir::Pass("count_threads_pass", 1) {}
+
+  void Run(pir::Operation *op) override {
+    thread_local bool counted = false;
+    if (!counted) {
+      counted = true;
+      ++num_threads_;
+    }
+    // Long enough for the other threads to take some of the ops.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    op->set_attribute("visited",
+                      pir::BoolAttribute::get(op->ir_context(), true));
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    return op->num_regions() > 0 && op->name() != "builtin.module";
+  }
+
+  std::unique_ptr<pir::Pass> Clone() const override {
+    return std::make_unique<CountThreadsPass>();
+  }
+
+  static std::atomic<int> num_threads_;
+};
+
+std::atomic<int> CountThreadsPass::num_threads_{0};
+
+TEST(parallel_pass_manager, reuse_worker_threads) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<test::TestDialect>();
+  ctx->GetOrRegisterDialect<ParallelTestDialect>();
+
+  // Five groups of isolated ops separated by ops that are not isolated, so
+  // that every run of the pass manager runs five groups in parallel.
+  pir::Program program(ctx);
+  pir::Builder builder(ctx, program.block());
+  pir::OpInfo chain_info = ctx->GetRegisteredOpInfo(ChainOp::name());
+  pir::Operation *outer = pir::Operation::Create(
+      {}, {}, {builder.float32_type()}, chain_info);
+  program.block()->push_back(outer);
+  for (int i = 0; i < 45; ++i) {
+    builder.SetInsertionPointToEnd(program.block());
+    test::RegionOp region_op = builder.Build<test::RegionOp>();
+    pir::Block *block = new pir::Block();
+    region_op->region(0).push_back(block);
+    std::vector<pir::Value> inputs;
+    if (i % 9 == 8) inputs.push_back(outer->result(0));
+    block->push_back(pir::Operation::Create(
+        inputs, {}, {builder.float32_type()}, chain_info));
+  }
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(std::make_unique<CountThreadsPass>());
+  pm.EnableParallelExecution(4);
+  for (int run = 0; run < 3; ++run) {
+    EXPECT_TRUE(pm.Run(&program));
+  }
+
+  // The calling thread and the three workers of the pass manager, rather
+  // than new threads for every group of every run.
+  EXPECT_GE(CountThreadsPass::num_threads_, 1);
+  EXPECT_LE(CountThreadsPass::num_threads_, 4);
+  for (auto op : *program.block()) {
+    if (op == outer) continue;
+    EXPECT_TRUE(op->HasAttribute("visited"));
+  }
+}
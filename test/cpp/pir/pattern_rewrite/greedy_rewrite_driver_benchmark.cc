@@ -0,0 +1,96 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The timing of the constant folding pipeline on the greedy rewrite driver.
+// This target is built with the tests but not run by ctest, run it by hand.
+
+#include <gtest/gtest.h>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/transforms/constant_folding_pass.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/pir/core/builder.h"
+#include "paddle/pir/core/builtin_op.h"
+#include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/program.h"
+#include "paddle/pir/pass/pass_manager.h"
+#include "paddle/pir/transforms/dead_code_elimination_pass.h"
+
+PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(transpose, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(fetch, CPU, ALL_LAYOUT);
+
+// Builds num_chains chains of chain_length transposes of a full, which the
+// constant folding folds one op after another into a single parameter.
+void BuildTransposeChains(pir::IrContext *ctx,
+                          pir::Program *program,
+                          int num_chains,
+                          int chain_length) {
+  pir::Builder builder(ctx, program->block());
+  for (int i = 0; i < num_chains; ++i) {
+    pir::Value last = builder
+                          .Build<paddle::dialect::FullOp>(
+                              std::vector<int64_t>{16, 32},
+                              static_cast<float>(i),
+                              phi::DataType::FLOAT32,
+                              phi::CPUPlace())
+                          .out();
+    for (int j = 0; j < chain_length; ++j) {
+      last = builder
+                 .Build<paddle::dialect::TransposeOp>(last,
+                                                      std::vector<int>{1, 0})
+                 .out();
+    }
+    builder.Build<paddle::dialect::FetchOp>(
+        last, "out_" + std::to_string(i), i);
+  }
+}
+
+TEST(greedy_rewrite_driver_benchmark, constant_folding) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+
+  constexpr int kNumChains = 200;
+  for (int chain_length : {2, 8, 32}) {
+    pir::Program program(ctx);
+    BuildTransposeChains(ctx, &program, kNumChains, chain_length);
+
+    pir::PassManager pm(ctx);
+    pm.AddPass(pir::CreateConstantFoldingPass());
+    pm.AddPass(pir::CreateDeadCodeEliminationPass());
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(pm.Run(&program));
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+    // every chain is folded into the parameter of its result
+    for (auto op : *program.block()) {
+      EXPECT_FALSE(op->isa<paddle::dialect::TransposeOp>());
+      EXPECT_FALSE(op->isa<paddle::dialect::FullOp>());
+    }
+
+    int folds = kNumChains * (chain_length + 1);
+    LOG(INFO) << "constant folding of " << kNumChains << " chains of "
+              << chain_length << " transposes: " << ms << " ms, "
+              << ms * 1e3 / folds << " us per folded op";
+  }
+}
@@ -0,0 +1,298 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "paddle/pir/core/builder.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_type.h"
+#include "paddle/pir/core/dialect.h"
+#include "paddle/pir/core/ir_context.h"
+#include "paddle/pir/core/op_base.h"
+#include "paddle/pir/core/program.h"
+#include "paddle/pir/pattern_rewrite/frozen_rewrite_pattern_set.h"
+#include "paddle/pir/pattern_rewrite/pattern_match.h"
+#include "paddle/pir/pattern_rewrite/pattern_rewrite_driver.h"
+
+// A constant producing the integer in its "value" attribute.
+class ConstOp : public pir::Op<ConstOp> {
+ public:
+  using Op::Op;
+  static const char *name() { return "greedy_test.const"; }
+  static constexpr uint32_t attributes_num = 1;
+  static const char *attributes_name[attributes_num];
+  static void Build(pir::Builder &builder,             // NOLINT
+                    pir::OperationArgument &argument,  // NOLINT
+                    int64_t value) {
+    argument.AddAttribute("value", builder.int64_attr(value));
+    argument.output_types.push_back(pir::Int64Type::get(builder.ir_context()));
+  }
+  int64_t value() {
+    return attribute<pir::Int64Attribute>("value").data();
+  }
+  void Verify() const {}
+};
+const char *ConstOp::attributes_name[attributes_num] = {"value"};
+
+// Adds the integer in its "step" attribute to its operand.
+class IncOp : public pir::Op<IncOp> {
+ public:
+  using Op::Op;
+  static const char *name() { return "greedy_test.inc"; }
+  static constexpr uint32_t attributes_num = 1;
+  static const char *attributes_name[attributes_num];
+  static void Build(pir::Builder &builder,             // NOLINT
+                    pir::OperationArgument &argument,  // NOLINT
+                    pir::Value input,
+                    int64_t step) {
+    argument.AddInput(input);
+    argument.AddAttribute("step", builder.int64_attr(step));
+    argument.output_types.push_back(pir::Int64Type::get(builder.ir_context()));
+  }
+  int64_t step() { return attribute<pir::Int64Attribute>("step").data(); }
+  void Verify() const {}
+};
+const char *IncOp::attributes_name[attributes_num] = {"step"};
+
+class GreedyTestDialect : public pir::Dialect {
+ public:
+  explicit GreedyTestDialect(pir::IrContext *context)
+      : pir::Dialect(name(), context, pir::TypeId::get<GreedyTestDialect>()) {
+    RegisterOps<ConstOp, IncOp>();
+  }
+  static const char *name() { return "greedy_test"; }
+};
+
+IR_DECLARE_EXPLICIT_TYPE_ID(ConstOp)
+IR_DEFINE_EXPLICIT_TYPE_ID(ConstOp)
+IR_DECLARE_EXPLICIT_TYPE_ID(IncOp)
+IR_DEFINE_EXPLICIT_TYPE_ID(IncOp)
+IR_DECLARE_EXPLICIT_TYPE_ID(GreedyTestDialect)
+IR_DEFINE_EXPLICIT_TYPE_ID(GreedyTestDialect)
+
+// inc(const(a), b) -> const(a + b)
+class FoldIncPattern : public pir::OpRewritePattern<IncOp> {
+ public:
+  using pir::OpRewritePattern<IncOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(IncOp op,
+                       pir::PatternRewriter &rewriter) const override {
+    auto input = op->operand_source(0).dyn_cast<pir::OpResult>();
+    if (!input || !input.owner()->isa<ConstOp>() ||
+        input.owner()->HasAttribute("opaque"))
+      return false;
+    int64_t value = input.owner()->dyn_cast<ConstOp>().value() + op.step();
+    auto folded = rewriter.Build<ConstOp>(value);
+    rewriter.ReplaceAllUsesWith(op->result(0), folded->result(0));
+    rewriter.EraseOp(op);
+    return true;
+  }
+};
+
+// inc(inc(x, a), b) -> inc(x, a + b)
+class MergeIncPattern : public pir::OpRewritePattern<IncOp> {
+ public:
+  using pir::OpRewritePattern<IncOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(IncOp op,
+                       pir::PatternRewriter &rewriter) const override {
+    auto input = op->operand_source(0).dyn_cast<pir::OpResult>();
+    if (!input || !input.owner()->isa<IncOp>() || !input.HasOneUse())
+      return false;
+    auto prev = input.owner()->dyn_cast<IncOp>();
+    auto merged = rewriter.Build<IncOp>(prev->operand_source(0),
+                                        prev.step() + op.step());
+    rewriter.ReplaceOp(op, {merged->result(0)});
+    rewriter.EraseOp(prev);
+    return true;
+  }
+};
+
+// inc(x, a) -> inc(x, 3 - a), which undoes itself and never converges.
+class FlipIncPattern : public pir::OpRewritePattern<IncOp> {
+ public:
+  using pir::OpRewritePattern<IncOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(IncOp op,
+                       pir::PatternRewriter &rewriter) const override {
+    auto flipped =
+        rewriter.Build<IncOp>(op->operand_source(0), 3 - op.step());
+    rewriter.ReplaceOp(op, {flipped->result(0)});
+    return true;
+  }
+};
+
+// inc(x, 0) -> x
+class EraseZeroIncPattern : public pir::OpRewritePattern<IncOp> {
+ public:
+  using pir::OpRewritePattern<IncOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(IncOp op,
+                       pir::PatternRewriter &rewriter) const override {
+    if (op.step() != 0) return false;
+    rewriter.ReplaceAllUsesWith(op->result(0), op->operand_source(0));
+    rewriter.EraseOp(op);
+    return true;
+  }
+};
+
+// inc(inc(x, a), 5) -> inc(inc(x, 0), a + 5), which sets the steps behind the
+// rewriter, so the driver is not told that the first inc can be erased.
+class ShiftStepPattern : public pir::OpRewritePattern<IncOp> {
+ public:
+  using pir::OpRewritePattern<IncOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(IncOp op,
+                       pir::PatternRewriter &rewriter) const override {
+    auto input = op->operand_source(0).dyn_cast<pir::OpResult>();
+    if (op.step() != 5 || !input || !input.owner()->isa<IncOp>())
+      return false;
+    auto prev = input.owner()->dyn_cast<IncOp>();
+    op->set_attribute("step", rewriter.int64_attr(prev.step() + 5));
+    prev->set_attribute("step", rewriter.int64_attr(0));
+    return true;
+  }
+};
+
+// Builds num_chains chains of chain_length IncOps. The chains with an even
+// index can be folded into a constant, the others start from an opaque
+// constant and are merged into a single IncOp.
+void BuildChains(pir::IrContext *ctx,
+                 pir::Program *program,
+                 int num_chains,
+                 int chain_length) {
+  pir::Builder builder(ctx, program->block());
+  for (int i = 0; i < num_chains; ++i) {
+    auto root = builder.Build<ConstOp>(i);
+    if (i % 2) root->set_attribute("opaque", builder.bool_attr(true));
+    pir::Value last = root->result(0);
+    for (int j = 0; j < chain_length; ++j) {
+      last = builder.Build<IncOp>(last, 1)->result(0);
+    }
+  }
+}
+
+pir::FrozenRewritePatternSet CreatePatterns(pir::IrContext *ctx) {
+  pir::RewritePatternSet ps(ctx);
+  ps.Add<FoldIncPattern>(ctx, 2);
+  ps.Add<MergeIncPattern>(ctx, 1);
+  return pir::FrozenRewritePatternSet(std::move(ps));
+}
+
+bool RunDriver(pir::Program *program,
+               const pir::FrozenRewritePatternSet &patterns,
+               bool rescan_on_change,
+               int64_t max_iterations = 10) {
+  pir::GreedyRewriteConfig cfg;
+  cfg.use_top_down_traversal = true;
+  cfg.max_iterations = max_iterations;
+  cfg.rescan_on_change = rescan_on_change;
+  return pir::ApplyPatternsGreedily(
+      program->module_op()->region(0), patterns, cfg);
+}
+
+void CheckFolded(pir::Program *program, int num_chains, int chain_length) {
+  int64_t num_inc = 0;
+  for (auto op : *program->block()) {
+    if (auto inc = op->dyn_cast<IncOp>()) {
+      ++num_inc;
+      EXPECT_EQ(inc.step(), chain_length);
+    }
+  }
+  EXPECT_EQ(num_inc, num_chains / 2);
+}
+
+TEST(greedy_rewrite_driver, fold_long_chains) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<GreedyTestDialect>();
+  auto patterns = CreatePatterns(ctx);
+
+  // A chain longer than max_iterations is folded in a single top-down
+  // iteration, both when rescanning the region and when following the
+  // rewritten ops.
+  constexpr int kNumChains = 4;
+  constexpr int kChainLength = 32;
+  for (bool rescan_on_change : {true, false}) {
+    pir::Program program(ctx);
+    BuildChains(ctx, &program, kNumChains, kChainLength);
+
+    EXPECT_TRUE(RunDriver(&program, patterns, rescan_on_change));
+    CheckFolded(&program, kNumChains, kChainLength);
+
+    // The folded constant of the last even chain holds the accumulated value.
+    int64_t max_value = 0;
+    for (auto op : *program.block()) {
+      if (auto c = op->dyn_cast<ConstOp>()) {
+        if (!c->result(0).use_empty()) continue;
+        max_value = std::max(max_value, c.value());
+      }
+    }
+    EXPECT_EQ(max_value, kNumChains - 2 + kChainLength);
+  }
+}
+
+TEST(greedy_rewrite_driver, patterns_undoing_each_other) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<GreedyTestDialect>();
+  pir::RewritePatternSet ps(ctx);
+  ps.Add<FlipIncPattern>(ctx, 1);
+  pir::FrozenRewritePatternSet patterns(std::move(ps));
+
+  // Every iteration flips the op once, and the driver gives up after
+  // max_iterations instead of looping forever.
+  for (bool rescan_on_change : {true, false}) {
+    for (int64_t max_iterations : {3, 4}) {
+      pir::Program program(ctx);
+      BuildChains(ctx, &program, /*num_chains=*/2, /*chain_length=*/1);
+
+      EXPECT_FALSE(
+          RunDriver(&program, patterns, rescan_on_change, max_iterations));
+      for (auto op : *program.block()) {
+        if (auto inc = op->dyn_cast<IncOp>()) {
+          EXPECT_EQ(inc.step(), max_iterations % 2 ? 2 : 1);
+        }
+      }
+    }
+  }
+}
+
+TEST(greedy_rewrite_driver, rescan_changes_behind_the_rewriter) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<GreedyTestDialect>();
+  pir::RewritePatternSet ps(ctx);
+  ps.Add<EraseZeroIncPattern>(ctx, 1);
+  ps.Add<ShiftStepPattern>(ctx, 1);
+  pir::FrozenRewritePatternSet patterns(std::move(ps));
+
+  // The first inc is set to 0 after it was visited, and only the rescan of
+  // the region once the worklist is done finds it.
+  for (bool rescan_on_change : {true, false}) {
+    pir::Program program(ctx);
+    pir::Builder builder(ctx, program.block());
+    auto root = builder.Build<ConstOp>(0);
+    auto first = builder.Build<IncOp>(root->result(0), 1);
+    builder.Build<IncOp>(first->result(0), 5);
+
+    EXPECT_TRUE(RunDriver(&program, patterns, rescan_on_change));
+    int64_t num_inc = 0;
+    for (auto op : *program.block()) {
+      if (auto inc = op->dyn_cast<IncOp>()) {
+        ++num_inc;
+        EXPECT_EQ(inc.step(), 6);
+        EXPECT_EQ(inc->operand_source(0), root->result(0));
+      }
+    }
+    EXPECT_EQ(num_inc, 1);
+  }
+}